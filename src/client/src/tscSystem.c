@@ -26,6 +26,7 @@
 #include "tconfig.h"
 #include "ttimezone.h"
 #include "qScript.h"
+#include "tscompression.h"
 
 // global, not configurable
 #define TSC_VAR_NOT_RELEASE 1
@@ -194,6 +195,7 @@ void taos_init_imp(void) {
   errno = TSDB_CODE_SUCCESS;
   srand(taosGetTimestampSec());
   deltaToUtcInitOnce();
+  tsResolveDecompress(true);
 
   if (tscEmbedded == 0) {
 
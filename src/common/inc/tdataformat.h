@@ -331,10 +331,19 @@ typedef struct SDataCol {
   VarDataOffsetT *dataOff;    // For binary and nchar data, the offset in the data column
   void *          pData;      // Actual data pointer
   TSKEY           ts;         // only used in last NULL column
+  int             numOfDict;  // number of dictionary entries if pData only holds the distinct values, 0 otherwise
+  uint8_t *       dictCode;   // For binary and nchar data, the dictionary entry index of each row
+  int             numOfNull;  // number of null rows marked in nullBitmap, -1 if the bitmap is not built
+  uint8_t *       nullBitmap; // For fixed length data, bit i is set if row i is not null
 } SDataCol;
 
 #define isAllRowsNull(pCol) ((pCol)->len == 0)
-static FORCE_INLINE void dataColReset(SDataCol *pDataCol) { pDataCol->len = 0; }
+#define dataColHasNullBitmap(pCol) ((pCol)->nullBitmap != NULL && (pCol)->numOfNull >= 0)
+static FORCE_INLINE void dataColReset(SDataCol *pDataCol) {
+  pDataCol->len = 0;
+  pDataCol->numOfDict = 0;
+  pDataCol->numOfNull = -1;
+}
 
 int tdAllocMemForCol(SDataCol *pCol, int maxPoints);
 
@@ -343,6 +352,8 @@ void dataColInit(SDataCol *pDataCol, STColumn *pCol, int maxPoints);
 int dataColAppendVal(SDataCol *pCol, const void *value, int numOfRows, int maxPoints, int rowOffset);
 
 void dataColSetOffset(SDataCol *pCol, int nEle);
+int  dataColSetDict(SDataCol *pCol, int numOfDict, int nEle);
+void dataColSetNullBitmap(SDataCol *pCol, int nEle);
 
 bool isNEleNull(SDataCol *pCol, int nEle);
 
@@ -358,8 +369,9 @@ static FORCE_INLINE const void *tdGetColDataOfRow(SDataCol *pCol, int row) {
   }
 }
 
+// only for the plain layout, a dictionary column has numOfDict > 0 and keeps the distinct values in pData
 static FORCE_INLINE int32_t dataColGetNEleLen(SDataCol *pDataCol, int rows) {
-  ASSERT(rows > 0);
+  ASSERT(rows > 0 && pDataCol->numOfDict == 0);
 
   if (IS_VAR_DATA_TYPE(pDataCol->type)) {
     return pDataCol->dataOff[rows - 1] + varDataTLen(tdGetColDataOfRow(pDataCol, rows - 1));
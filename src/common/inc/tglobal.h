@@ -54,7 +54,15 @@ extern int32_t  tsShellActivityTimer;
 extern uint32_t tsMaxTmrCtrl;
 extern float    tsNumOfThreadsPerCore;
 extern int32_t  tsNumOfCommitThreads;
+extern int32_t  tsNumOfDecodeThreads;
+extern int32_t  tsNumOfCommitWorkers;
+extern int32_t  tsQueryBlockCacheSize;
+extern int8_t   tsQueryMmapRead;
 extern float    tsRatioOfQueryCores;
+extern int8_t   tsNumaBind;
+extern int8_t   tsBalanceWriteWorkers;
+extern int32_t  tsMinWriteWorkers;
+extern int32_t  tsMaxWriteWorkers;
 extern int8_t   tsDaylight;
 extern char     tsTimezone[];
 extern char     tsLocale[];
@@ -114,6 +122,14 @@ extern int8_t  tsCacheLastRow;
 extern bool    tsdbForceKeepFile;
 extern bool    tsdbForceCompactFile;
 extern int32_t tsdbWalFlushSize;
+extern int8_t  tsdbDictCompression;
+extern int8_t  tsdbFloatCompression;
+extern int8_t  tsdbAdaptiveCompression;
+extern int32_t tsdbBloomFilterBits;
+extern int8_t  tsdbMemTableAppend;
+extern int8_t  tsdbMemTableZeroCopy;
+extern int8_t  tsdbCacheHugePages;
+extern int32_t tsdbRollupInterval;
 
 // balance
 extern int8_t  tsEnableBalance;
@@ -123,6 +139,10 @@ extern int32_t tsOfflineInterval;
 extern int32_t tsOfflineThreshold;
 extern int32_t tsMnodeEqualVnodeNum;
 extern int8_t  tsEnableFlowCtrl;
+extern int32_t tsWriteAdmissionRate;
+extern int8_t  tsWalGroupCommit;
+extern int8_t  tsWalDirectIO;
+extern int32_t tsWalPreallocSize;
 extern int8_t  tsEnableSlaveQuery;
 extern int8_t  tsEnableAdjustMaster;
 
@@ -180,6 +200,7 @@ extern int64_t  tsPageSize;
 extern int64_t  tsOpenMax;
 extern int64_t  tsStreamMax;
 extern int32_t  tsNumOfCores;
+extern int32_t  tsNumOfNumaNodes;
 extern float    tsTotalLogDirGB;
 extern float    tsTotalTmpDirGB;
 extern float    tsTotalDataDirGB;
@@ -34,8 +34,27 @@ typedef struct SDataStatis {
 typedef struct SColumnInfoData {
   SColumnInfo info;
   char* pData;    // the corresponding block data in memory
+  uint8_t* nullBitmap;  // bit i is set if row i is not null, NULL for the binary/nchar columns
+  int32_t  numOfNull;   // number of null rows marked in nullBitmap, -1 if it is not filled for the block
 } SColumnInfoData;
 
+#define COL_HAS_NULL_BITMAP(_c) ((_c)->nullBitmap != NULL && (_c)->numOfNull >= 0)
+
+// dictionary of a binary/nchar column in a data block read from a dictionary encoded file block
+typedef struct SColumnDict {
+  int32_t  numOfEntries;  // number of distinct values
+  int32_t  numOfRows;
+  char*    pEntries;      // distinct values in var-data format, one after another
+  uint8_t* codes;         // entry index of each row
+} SColumnDict;
+
+// column = value condition handed to the storage, pVal is in the column format, i.e. the var data of binary/nchar
+typedef struct SColumnEqualCond {
+  int16_t     colId;
+  int8_t      type;
+  const void* pVal;
+} SColumnEqualCond;
+
 typedef struct SResPair {
   TSKEY  key;
   double avg;
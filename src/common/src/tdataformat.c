@@ -26,7 +26,9 @@ static void tdMergeTwoDataCols(SDataCols *target, SDataCols *src1, int *iter1, i
 int tdAllocMemForCol(SDataCol *pCol, int maxPoints) {
   int spaceNeeded = pCol->bytes * maxPoints;
   if(IS_VAR_DATA_TYPE(pCol->type)) {
-    spaceNeeded += sizeof(VarDataOffsetT) * maxPoints;
+    spaceNeeded += (sizeof(VarDataOffsetT) + sizeof(uint8_t)) * maxPoints;
+  } else {
+    spaceNeeded += NULL_BITMAP_BYTES(maxPoints);
   }
   if(pCol->spaceSize < spaceNeeded) {
     void* ptr = realloc(pCol->pData, spaceNeeded);
@@ -41,7 +43,11 @@ int tdAllocMemForCol(SDataCol *pCol, int maxPoints) {
   }
   if(IS_VAR_DATA_TYPE(pCol->type)) {
     pCol->dataOff = POINTER_SHIFT(pCol->pData, pCol->bytes * maxPoints);
+    pCol->dictCode = POINTER_SHIFT(pCol->dataOff, sizeof(VarDataOffsetT) * maxPoints);
+  } else {
+    pCol->nullBitmap = POINTER_SHIFT(pCol->pData, pCol->bytes * maxPoints);
   }
+  pCol->numOfNull = -1;
   return 0;
 }
 
@@ -238,7 +244,35 @@ void dataColInit(SDataCol *pDataCol, STColumn *pCol, int maxPoints) {
   pDataCol->offset = colOffset(pCol) + TD_DATA_ROW_HEAD_SIZE;
 
   pDataCol->len = 0;
+  pDataCol->numOfDict = 0;
+  pDataCol->numOfNull = -1;
 }
+
+/**
+ * Rewrite a dictionary column to the plain layout, where the values of the first nEle rows are stored one after
+ * another, so new values can be appended.
+ */
+static int dataColExpandDict(SDataCol *pCol, int nEle) {
+  void *pDict = malloc(pCol->len);
+  if (pDict == NULL) {
+    uDebug("malloc failure, size:%" PRId64 " failed, reason:%s", (int64_t)pCol->len, strerror(errno));
+    return -1;
+  }
+  memcpy(pDict, pCol->pData, pCol->len);
+
+  pCol->len = 0;
+  for (int i = 0; i < nEle; i++) {
+    void *value = POINTER_SHIFT(pDict, pCol->dataOff[i]);
+    pCol->dataOff[i] = pCol->len;
+    memcpy(POINTER_SHIFT(pCol->pData, pCol->len), value, varDataTLen(value));
+    pCol->len += varDataTLen(value);
+  }
+  pCol->numOfDict = 0;
+
+  free(pDict);
+  return 0;
+}
+
 /**
  *  value from timestamp should be TKEY here instead of TSKEY.
  *  - rowOffset: 0 for current row, -1 for previous row
@@ -246,6 +280,8 @@ void dataColInit(SDataCol *pDataCol, STColumn *pCol, int maxPoints) {
 int dataColAppendVal(SDataCol *pCol, const void *value, int numOfRows, int maxPoints, int rowOffset) {
   ASSERT(pCol != NULL && value != NULL && (rowOffset == 0 || rowOffset == -1));
 
+  pCol->numOfNull = -1;
+
   if (isAllRowsNull(pCol)) {
     if (isNull(value, pCol->type)) {
       // all null value yet, just return
@@ -260,6 +296,8 @@ int dataColAppendVal(SDataCol *pCol, const void *value, int numOfRows, int maxPo
     }
   }
 
+  if (pCol->numOfDict > 0 && dataColExpandDict(pCol, numOfRows - rowOffset) < 0) return -1;
+
   if (IS_VAR_DATA_TYPE(pCol->type)) {
     if (rowOffset == 0) {
       // set offset
@@ -342,6 +380,47 @@ void dataColSetOffset(SDataCol *pCol, int nEle) {
   }
 }
 
+/**
+ * Mark the null rows of a fixed length column in its null bitmap once the values of the first nEle rows are set, so
+ * the readers of the column need not compare each value against the null value of the type.
+ */
+void dataColSetNullBitmap(SDataCol *pCol, int nEle) {
+  if (IS_VAR_DATA_TYPE(pCol->type) || pCol->nullBitmap == NULL || isAllRowsNull(pCol)) {
+    pCol->numOfNull = -1;
+    return;
+  }
+
+  pCol->numOfNull = buildNullBitmap(pCol->pData, pCol->type, nEle, pCol->nullBitmap);
+}
+
+/**
+ * Point the rows to the dictionary entries. pData holds numOfDict distinct values one after another and dictCode
+ * holds the entry index of each row. Return -1 if the dictionary is broken.
+ */
+int dataColSetDict(SDataCol *pCol, int numOfDict, int nEle) {
+  ASSERT(((pCol->type == TSDB_DATA_TYPE_BINARY) || (pCol->type == TSDB_DATA_TYPE_NCHAR)));
+
+  VarDataOffsetT entryOff[UINT8_MAX + 1];
+  VarDataOffsetT offset = 0;
+
+  if (numOfDict <= 0 || numOfDict > tListLen(entryOff)) return -1;
+
+  for (int i = 0; i < numOfDict; i++) {
+    if (offset + (int)VARSTR_HEADER_SIZE > pCol->len) return -1;
+    entryOff[i] = offset;
+    offset += varDataTLen(POINTER_SHIFT(pCol->pData, offset));
+  }
+  if (offset != pCol->len) return -1;
+
+  for (int i = 0; i < nEle; i++) {
+    if (pCol->dictCode[i] >= numOfDict) return -1;
+    pCol->dataOff[i] = entryOff[pCol->dictCode[i]];
+  }
+
+  pCol->numOfDict = numOfDict;
+  return 0;
+}
+
 SDataCols *tdNewDataCols(int maxCols, int maxRows) {
   SDataCols *pCols = (SDataCols *)calloc(1, sizeof(SDataCols));
   if (pCols == NULL) {
@@ -368,6 +447,7 @@ SDataCols *tdNewDataCols(int maxCols, int maxRows) {
       pCols->cols[i].len = 0;
       pCols->cols[i].pData = NULL;
       pCols->cols[i].dataOff = NULL;
+      pCols->cols[i].dictCode = NULL;
     }
   }
 
@@ -385,6 +465,7 @@ int tdInitDataCols(SDataCols *pCols, STSchema *pSchema) {
     for(i = oldMaxCols; i < pCols->maxCols; i++) {
       pCols->cols[i].pData = NULL;
       pCols->cols[i].dataOff = NULL;
+      pCols->cols[i].dictCode = NULL;
       pCols->cols[i].spaceSize = 0;
     }
   }
@@ -441,6 +522,10 @@ SDataCols *tdDupDataCols(SDataCols *pDataCols, bool keepData) {
         if (IS_VAR_DATA_TYPE(pRet->cols[i].type)) {
           int dataOffSize = sizeof(VarDataOffsetT) * pDataCols->maxPoints;
           memcpy(pRet->cols[i].dataOff, pDataCols->cols[i].dataOff, dataOffSize);
+          if (pDataCols->cols[i].numOfDict > 0) {
+            pRet->cols[i].numOfDict = pDataCols->cols[i].numOfDict;
+            memcpy(pRet->cols[i].dictCode, pDataCols->cols[i].dictCode, pDataCols->numOfRows);
+          }
         }
       }
     }
@@ -58,7 +58,15 @@ int32_t tsMaxConnections = 5000;
 int32_t tsShellActivityTimer = 3;  // second
 float   tsNumOfThreadsPerCore = 1.0f;
 int32_t tsNumOfCommitThreads = 4;
+int32_t tsNumOfDecodeThreads = 0;  // threads decoding the columns of a data block in parallel, 0 to disable
+int32_t tsNumOfCommitWorkers = 0;  // threads committing the tables of a vnode in parallel, 0 to disable
+int32_t tsQueryBlockCacheSize = 0;  // MB of decoded file blocks cached in each vnode for the queries, 0 to disable
+int8_t  tsQueryMmapRead = 0;  // queries read the data files by memory mapping instead of read calls
 float   tsRatioOfQueryCores = 1.0f;
+int8_t  tsNumaBind = 0;  // bind the buffer pool and the worker threads of each vnode to a numa node
+int8_t  tsBalanceWriteWorkers = 0;  // move the write queues of the vnodes between the write workers by their load
+int32_t tsMinWriteWorkers = 1;      // write workers kept running when they are balanced
+int32_t tsMaxWriteWorkers = 0;      // write workers at most, 0 for the number of cores
 int8_t  tsDaylight = 0;
 char    tsTimezone[TSDB_TIMEZONE_LEN] = {0};
 char    tsLocale[TSDB_LOCALE_LEN] = {0};
@@ -159,6 +167,14 @@ int32_t tsTsdbMetaCompactRatio = TSDB_META_COMPACT_RATIO;
 bool    tsdbForceKeepFile = false;
 bool    tsdbForceCompactFile = false;                    // compact TSDB fileset forcibly
 int32_t tsdbWalFlushSize = TSDB_DEFAULT_WAL_FLUSH_SIZE;  // MB
+int8_t  tsdbDictCompression = 0;                         // dictionary encode the binary/nchar columns of data blocks
+int8_t  tsdbFloatCompression = 0;                        // 0: byte aligned xor, 1: chimp bit packing
+int8_t  tsdbAdaptiveCompression = 0;                     // pick the codec of each column chunk at commit
+int32_t tsdbBloomFilterBits = 0;                         // bits per value of the block bloom filters, 0 to disable
+int8_t  tsdbMemTableAppend = 0;                          // append in-order rows of a table to chunks, not the skiplist
+int8_t  tsdbMemTableZeroCopy = 0;                        // the memtable references the rows in the submit msgs
+int8_t  tsdbCacheHugePages = 0;                          // map the buffer blocks of the cache from huge pages
+int32_t tsdbRollupInterval = 0;                          // seconds, the file blocks are cut at the rollup windows
 
 // balance
 int8_t  tsEnableBalance = 1;
@@ -168,6 +184,10 @@ int32_t tsOfflineInterval = 3;            // seconds
 int32_t tsOfflineThreshold = 86400 * 10;  // seconds of 10 days
 int32_t tsMnodeEqualVnodeNum = 4;
 int8_t  tsEnableFlowCtrl = 1;
+int32_t tsWriteAdmissionRate = 0;  // MB per second a vnode admits under memory pressure, 0 to disable
+int8_t  tsWalGroupCommit = 0;      // the wal records of a write batch are written out at once before the fsync
+int8_t  tsWalDirectIO = 0;         // the group commit writes the wal files by direct io
+int32_t tsWalPreallocSize = 0;     // MB reserved on disk each time a wal file grows, 0 to disable
 int8_t  tsEnableSlaveQuery = 1;
 int8_t  tsEnableAdjustMaster = 1;
 
@@ -240,6 +260,7 @@ int64_t  tsPageSize;
 int64_t  tsOpenMax;
 int64_t  tsStreamMax;
 int32_t  tsNumOfCores = 1;
+int32_t  tsNumOfNumaNodes = 0;
 float    tsTotalTmpDirGB = 0;
 float    tsTotalDataDirGB = 0;
 float    tsAvailTmpDirectorySpace = 0;
@@ -574,6 +595,46 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "numOfCommitWorkers";
+  cfg.ptr = &tsNumOfCommitWorkers;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG;
+  cfg.minValue = 0;
+  cfg.maxValue = 100;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "numOfDecodeThreads";
+  cfg.ptr = &tsNumOfDecodeThreads;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG;
+  cfg.minValue = 0;
+  cfg.maxValue = 100;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "queryBlockCacheSize";
+  cfg.ptr = &tsQueryBlockCacheSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 65536;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "queryMmapRead";
+  cfg.ptr = &tsQueryMmapRead;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "ratioOfQueryCores";
   cfg.ptr = &tsRatioOfQueryCores;
   cfg.valType = TAOS_CFG_VTYPE_FLOAT;
@@ -584,6 +645,48 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  // the vnodes are spread over the numa nodes, the memory and the workers of a vnode stay on its node
+  cfg.option = "numaBind";
+  cfg.ptr = &tsNumaBind;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // the write workers grow up to maxWriteWorkers and shrink down to minWriteWorkers by the load of the vnodes
+  cfg.option = "balanceWriteWorkers";
+  cfg.ptr = &tsBalanceWriteWorkers;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "minWriteWorkers";
+  cfg.ptr = &tsMinWriteWorkers;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 1;
+  cfg.maxValue = 1024;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "maxWriteWorkers";
+  cfg.ptr = &tsMaxWriteWorkers;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1024;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
   cfg.option = "maxNumOfDistinctRes";
   cfg.ptr = &tsMaxNumOfDistinctResults;
   cfg.valType = TAOS_CFG_VTYPE_INT32;
@@ -1241,6 +1344,46 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_NONE;
   taosInitConfigOption(cfg);
 
+  cfg.option = "writeAdmissionRate";
+  cfg.ptr = &tsWriteAdmissionRate;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 100000;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "walGroupCommit";
+  cfg.ptr = &tsWalGroupCommit;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "walDirectIO";
+  cfg.ptr = &tsWalDirectIO;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  cfg.option = "walPreallocSize";
+  cfg.ptr = &tsWalPreallocSize;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1024;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_MB;
+  taosInitConfigOption(cfg);
+
   cfg.option = "slaveQuery";
   cfg.ptr = &tsEnableSlaveQuery;
   cfg.valType = TAOS_CFG_VTYPE_INT8;
@@ -1749,6 +1892,94 @@ static void doInitGlobalConfig(void) {
   cfg.unitType = TAOS_CFG_UTYPE_MB;
   taosInitConfigOption(cfg);
 
+  // binary/nchar columns of few distinct values are written as dictionaries, older releases can not read them
+  cfg.option = "dictCompression";
+  cfg.ptr = &tsdbDictCompression;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // lossless codec of the float and double columns written to data files
+  cfg.option = "floatCompression";
+  cfg.ptr = &tsdbFloatCompression;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // codecs of the columns picked by trial compressions, instead of the compression level of the database
+  cfg.option = "adaptiveCompression";
+  cfg.ptr = &tsdbAdaptiveCompression;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // bloom filters of the data blocks, so equal conditions can skip blocks without loading them
+  cfg.option = "bloomFilterBits";
+  cfg.ptr = &tsdbBloomFilterBits;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 32;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // rows of a table arriving in key order are appended to chunks, the skiplist is built on the first late row
+  cfg.option = "memTableAppend";
+  cfg.ptr = &tsdbMemTableAppend;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // the rows of the submit msgs are referenced by the memtable instead of copied, the msgs are pinned until commit
+  cfg.option = "memTableZeroCopy";
+  cfg.ptr = &tsdbMemTableZeroCopy;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // the buffer blocks are mapped from the reserved huge pages, or from transparent huge pages if none is reserved
+  cfg.option = "cacheHugePages";
+  cfg.ptr = &tsdbCacheHugePages;
+  cfg.valType = TAOS_CFG_VTYPE_INT8;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = 1;
+  cfg.ptrLength = 1;
+  cfg.unitType = TAOS_CFG_UTYPE_NONE;
+  taosInitConfigOption(cfg);
+
+  // a file block keeps the rows of one rollup window, its aggregates answer the interval queries of the window
+  cfg.option = "rollupInterval";
+  cfg.ptr = &tsdbRollupInterval;
+  cfg.valType = TAOS_CFG_VTYPE_INT32;
+  cfg.cfgType = TSDB_CFG_CTYPE_B_CONFIG | TSDB_CFG_CTYPE_B_SHOW;
+  cfg.minValue = 0;
+  cfg.maxValue = TSDB_MAX_ROLLUP_INTERVAL;
+  cfg.ptrLength = 0;
+  cfg.unitType = TAOS_CFG_UTYPE_SECOND;
+  taosInitConfigOption(cfg);
+
 #ifdef TD_TSZ
   // lossy compress
   cfg.option = "lossyColumns";
@@ -1869,6 +2100,13 @@ int32_t taosCheckGlobalCfg() {
     tsMaxTablePerVnode = tsMinTablePerVnode;
   }
 
+  // windows shorter than a minute cut sparse tables into blocks of a few rows each
+  if (tsdbRollupInterval > 0 && tsdbRollupInterval < TSDB_MIN_ROLLUP_INTERVAL) {
+    uError("rollupInterval(%d) < %d, reset to %d", tsdbRollupInterval, TSDB_MIN_ROLLUP_INTERVAL,
+           TSDB_MIN_ROLLUP_INTERVAL);
+    tsdbRollupInterval = TSDB_MIN_ROLLUP_INTERVAL;
+  }
+
   // todo refactor
   tsVersion = 0;
   for (int ver = 0, i = 0; i < TSDB_VERSION_LEN; ++i) {
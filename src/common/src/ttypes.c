@@ -524,6 +524,84 @@ void setNullN(void *val, int32_t type, int32_t bytes, int32_t numOfElems) {
   }
 }
 
+// eight rows are compared against the null value for each byte of the bitmap, with no branch on the values
+#define NULL_BITMAP_BUILD(_t, _null)                                          \
+  do {                                                                        \
+    const _t *_d = (const _t *)val;                                           \
+    int32_t   _i = 0;                                                         \
+    for (; _i + 8 <= numOfElems; _i += 8) {                                   \
+      uint8_t _b = 0;                                                         \
+      for (int32_t _k = 0; _k < 8; ++_k) {                                    \
+        _b |= (uint8_t)((_d[_i + _k] != (_t)(_null)) << _k);                  \
+      }                                                                       \
+      pBitmap[_i >> 3] = _b;                                                  \
+      numOfNotNull += (int32_t)bitCount[_b];                                  \
+    }                                                                         \
+    if (_i < numOfElems) {                                                    \
+      uint8_t _b = 0;                                                         \
+      for (int32_t _k = 0; _i + _k < numOfElems; ++_k) {                      \
+        _b |= (uint8_t)((_d[_i + _k] != (_t)(_null)) << _k);                  \
+      }                                                                       \
+      pBitmap[_i >> 3] = _b;                                                  \
+      numOfNotNull += (int32_t)bitCount[_b];                                  \
+    }                                                                         \
+  } while (0)
+
+static const uint8_t bitCount[256] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7,
+    3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8};
+
+/**
+ * Mark the rows that are not null in pBitmap, which holds NULL_BITMAP_BYTES(numOfElems) bytes. Return the number of
+ * null rows, or -1 if the type is not a fixed length one.
+ */
+int32_t buildNullBitmap(const void *val, int32_t type, int32_t numOfElems, uint8_t *pBitmap) {
+  int32_t numOfNotNull = 0;
+
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:      NULL_BITMAP_BUILD(uint8_t, TSDB_DATA_BOOL_NULL); break;
+    case TSDB_DATA_TYPE_TINYINT:   NULL_BITMAP_BUILD(uint8_t, TSDB_DATA_TINYINT_NULL); break;
+    case TSDB_DATA_TYPE_SMALLINT:  NULL_BITMAP_BUILD(uint16_t, TSDB_DATA_SMALLINT_NULL); break;
+    case TSDB_DATA_TYPE_INT:       NULL_BITMAP_BUILD(uint32_t, TSDB_DATA_INT_NULL); break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP: NULL_BITMAP_BUILD(uint64_t, TSDB_DATA_BIGINT_NULL); break;
+    case TSDB_DATA_TYPE_FLOAT:     NULL_BITMAP_BUILD(uint32_t, TSDB_DATA_FLOAT_NULL); break;
+    case TSDB_DATA_TYPE_DOUBLE:    NULL_BITMAP_BUILD(uint64_t, TSDB_DATA_DOUBLE_NULL); break;
+    case TSDB_DATA_TYPE_UTINYINT:  NULL_BITMAP_BUILD(uint8_t, TSDB_DATA_UTINYINT_NULL); break;
+    case TSDB_DATA_TYPE_USMALLINT: NULL_BITMAP_BUILD(uint16_t, TSDB_DATA_USMALLINT_NULL); break;
+    case TSDB_DATA_TYPE_UINT:      NULL_BITMAP_BUILD(uint32_t, TSDB_DATA_UINT_NULL); break;
+    case TSDB_DATA_TYPE_UBIGINT:   NULL_BITMAP_BUILD(uint64_t, TSDB_DATA_UBIGINT_NULL); break;
+    default:
+      return -1;
+  }
+
+  return numOfElems - numOfNotNull;
+}
+
+int32_t countNotNullInBitmap(const uint8_t *pBitmap, int32_t start, int32_t numOfElems) {
+  int32_t num = 0;
+  int32_t i = start;
+  int32_t end = start + numOfElems;
+
+  for (; i < end && (i & 7) != 0; ++i) {
+    num += NULL_BITMAP_NOTNULL(pBitmap, i);
+  }
+  for (; i + 8 <= end; i += 8) {
+    num += bitCount[pBitmap[i >> 3]];
+  }
+  for (; i < end; ++i) {
+    num += NULL_BITMAP_NOTNULL(pBitmap, i);
+  }
+
+  return num;
+}
+
 static uint8_t      nullBool = TSDB_DATA_BOOL_NULL;
 static uint8_t      nullTinyInt = TSDB_DATA_TINYINT_NULL;
 static uint16_t     nullSmallInt = TSDB_DATA_SMALLINT_NULL;
@@ -168,6 +168,7 @@ int32_t dnodeInitSystem() {
   taosIgnSIGPIPE();
   taosBlockSIGPIPE();
   taosResolveCRC();
+  tsResolveDecompress(true);
   taosInitGlobalCfg();
   taosReadGlobalLogCfg();
   dnodeInitTmr();
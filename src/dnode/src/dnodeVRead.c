@@ -22,8 +22,10 @@
 static void *dnodeProcessReadQueue(void *pWorker);
 
 // module global variable
-static SWorkerPool tsVQueryWP;
-static SWorkerPool tsVFetchWP;
+static SWorkerPool *tsVQueryWP;      // one pool for each numa node if the vnodes are bound
+static int32_t      tsVQueryPools;
+static bool         tsVQueryBound;
+static SWorkerPool  tsVFetchWP;
 
 int32_t dnodeInitVRead() {
   const int32_t maxFetchThreads = 4;
@@ -31,11 +33,20 @@ int32_t dnodeInitVRead() {
   // calculate the available query thread
   float threadsForQuery = MAX(tsNumOfCores * tsRatioOfQueryCores, 1);
 
-  tsVQueryWP.name = "vquery";
-  tsVQueryWP.workerFp = dnodeProcessReadQueue;
-  tsVQueryWP.min = (int32_t) threadsForQuery;
-  tsVQueryWP.max = tsVQueryWP.min;
-  if (tWorkerInit(&tsVQueryWP) != 0) return -1;
+  // the query threads are split among the numa nodes, and the vnodes of a node are queried by its threads only
+  tsVQueryBound = (tsNumaBind && tsNumOfNumaNodes > 0);
+  tsVQueryPools = tsVQueryBound ? tsNumOfNumaNodes : 1;
+  tsVQueryWP = calloc(tsVQueryPools, sizeof(SWorkerPool));
+  if (tsVQueryWP == NULL) return -1;
+
+  for (int32_t i = 0; i < tsVQueryPools; ++i) {
+    SWorkerPool *pPool = tsVQueryWP + i;
+    pPool->name = "vquery";
+    pPool->workerFp = dnodeProcessReadQueue;
+    pPool->min = MAX((int32_t)threadsForQuery / tsVQueryPools, 1);
+    pPool->max = pPool->min;
+    if (tWorkerInit(pPool) != 0) return -1;
+  }
 
   tsVFetchWP.name = "vfetch";
   tsVFetchWP.workerFp = dnodeProcessReadQueue;
@@ -48,7 +59,10 @@ int32_t dnodeInitVRead() {
 
 void dnodeCleanupVRead() {
   tWorkerCleanup(&tsVFetchWP);
-  tWorkerCleanup(&tsVQueryWP);
+  for (int32_t i = 0; tsVQueryWP != NULL && i < tsVQueryPools; ++i) {
+    tWorkerCleanup(tsVQueryWP + i);
+  }
+  tfree(tsVQueryWP);
 }
 
 void dnodeDispatchToVReadQueue(SRpcMsg *pMsg) {
@@ -83,7 +97,9 @@ void dnodeDispatchToVReadQueue(SRpcMsg *pMsg) {
 }
 
 void *dnodeAllocVQueryQueue(void *pVnode) {
-  return tWorkerAllocQueue(&tsVQueryWP, pVnode);
+  int32_t numaNode = vnodeGetNumaNode(pVnode);
+  if (numaNode < 0 || numaNode >= tsVQueryPools) numaNode = 0;
+  return tWorkerAllocQueue(tsVQueryWP + numaNode, pVnode);
 }
 
 void *dnodeAllocVFetchQueue(void *pVnode) {
@@ -91,7 +107,7 @@ void *dnodeAllocVFetchQueue(void *pVnode) {
 }
 
 void dnodeFreeVQueryQueue(void *pQqueue) {
-  tWorkerFreeQueue(&tsVQueryWP, pQqueue);
+  tWorkerFreeQueue(tsVQueryWP, pQqueue);
 }
 
 void dnodeFreeVFetchQueue(void *pFqueue) {
@@ -125,6 +141,13 @@ static void *dnodeProcessReadQueue(void *wparam) {
   snprintf(name, tListLen(name), "%s", threadname);
   setThreadName(name);
 
+  if (tsVQueryBound && pPool >= tsVQueryWP && pPool < tsVQueryWP + tsVQueryPools) {
+    int32_t numaNode = (int32_t)(pPool - tsVQueryWP);
+    if (taosBindThreadToNumaNode(numaNode) != 0) {
+      dWarn("dnode vquery worker:%d failed to bind to numa node %d since %s", pWorker->id, numaNode, strerror(errno));
+    }
+  }
+
   while (1) {
     if (taosReadQitemFromQset(pPool->qset, &qtype, (void **)&pRead, &pVnode) == 0) {
       dDebug("dnode vquery got no message from qset:%p, exiting", pPool->qset);
@@ -18,17 +18,50 @@
 #include "tqueue.h"
 #include "dnodeVWrite.h"
 
+// the load of the workers is measured, and the queues are balanced if enabled, once every period
+#define VWRITE_BALANCE_PERIOD_US 1000000
+// a worker busier than this is relieved by moving one of its queues to a worker with less load, or to a new worker
+#define VWRITE_BUSY_RATIO 0.75f
+// a worker less busy than this is stopped if the others stay below it after taking its queues
+#define VWRITE_IDLE_RATIO 0.25f
+
+typedef struct {
+  taos_queue queue;       // NULL if the record is free
+  void *     pVnode;
+  int32_t    numaNode;    // numa node of the vnode, -1 if not bound
+  int32_t    workerId;    // worker whose qset holds the queue
+  int32_t    targetId;    // worker the queue moves to after the current batch of its worker, -1 if it stays
+  int64_t    busyUs;      // time spent on the msgs of the queue
+  int64_t    numOfMsgs;
+  int64_t    lastBusyUs;  // busyUs and numOfMsgs at the last balance
+  int64_t    lastNumOfMsgs;
+} SVWriteQueue;
+
 typedef struct {
   taos_qall qall;
-  taos_qset qset;      // queue set
-  int32_t   workerId;  // worker ID
-  pthread_t thread;    // thread
+  taos_qset qset;         // queue set
+  int32_t   workerId;     // worker ID
+  int32_t   numaNode;     // numa node the worker is bound to, -1 if not bound
+  int32_t   numOfQueues;
+  int8_t    running;      // the thread is processing the qset
+  int8_t    retiring;     // the thread exits once its queues are moved away
+  int8_t    hasMoves;     // some of its queues have a target worker
+  float     utilization;  // ratio of the time busy in the last period
+  int64_t   busyUs;       // time spent on the msgs
+  int64_t   numOfMsgs;
+  int64_t   lastBusyUs;   // busyUs at the last balance
+  pthread_t thread;       // thread
 } SVWriteWorker;
 
 typedef struct {
   int32_t max;     // max number of workers
+  int32_t min;     // min number of running workers if balanced
   int32_t nextId;  // from 0 to max-1, cyclic
+  int32_t numOfQueues;
+  int8_t  stopped;
+  int64_t balanceTime;  // time of the last balance
   SVWriteWorker * worker;
+  SVWriteQueue ** queues;  // the records are kept until cleanup, the workers refer to them after the vnodes are closed
   pthread_mutex_t mutex;
 } SVWriteWorkerPool;
 
@@ -36,20 +69,28 @@ static SVWriteWorkerPool tsVWriteWP;
 static void *dnodeProcessVWriteQueue(void *pWorker);
 
 int32_t dnodeInitVWrite() {
-  tsVWriteWP.max = tsNumOfCores;
+  tsVWriteWP.max = (tsMaxWriteWorkers > 0) ? tsMaxWriteWorkers : tsNumOfCores;
+  tsVWriteWP.min = MIN(tsMinWriteWorkers, tsVWriteWP.max);
+  tsVWriteWP.balanceTime = taosGetTimestampUs();
   tsVWriteWP.worker = tcalloc(sizeof(SVWriteWorker), tsVWriteWP.max);
   if (tsVWriteWP.worker == NULL) return -1;
   pthread_mutex_init(&tsVWriteWP.mutex, NULL);
 
   for (int32_t i = 0; i < tsVWriteWP.max; ++i) {
     tsVWriteWP.worker[i].workerId = i;
+    tsVWriteWP.worker[i].numaNode = (tsNumaBind && tsNumOfNumaNodes > 0) ? (i % tsNumOfNumaNodes) : -1;
   }
 
-  dInfo("dnode vwrite is initialized, max worker %d", tsVWriteWP.max);
+  dInfo("dnode vwrite is initialized, max worker %d, min worker %d, balance %d", tsVWriteWP.max, tsVWriteWP.min,
+        tsBalanceWriteWorkers);
   return 0;
 }
 
 void dnodeCleanupVWrite() {
+  pthread_mutex_lock(&tsVWriteWP.mutex);
+  tsVWriteWP.stopped = 1;
+  pthread_mutex_unlock(&tsVWriteWP.mutex);
+
   for (int32_t i = 0; i < tsVWriteWP.max; ++i) {
     SVWriteWorker *pWorker = tsVWriteWP.worker + i;
     if (taosCheckPthreadValid(pWorker->thread)) {
@@ -61,12 +102,17 @@ void dnodeCleanupVWrite() {
     SVWriteWorker *pWorker = tsVWriteWP.worker + i;
     if (taosCheckPthreadValid(pWorker->thread)) {
       pthread_join(pWorker->thread, NULL);
-      taosFreeQall(pWorker->qall);
-      taosCloseQset(pWorker->qset);
     }
+    taosFreeQall(pWorker->qall);
+    taosCloseQset(pWorker->qset);
+  }
+
+  for (int32_t i = 0; i < tsVWriteWP.numOfQueues; ++i) {
+    tfree(tsVWriteWP.queues[i]);
   }
 
   pthread_mutex_destroy(&tsVWriteWP.mutex);
+  tfree(tsVWriteWP.queues);
   tfree(tsVWriteWP.worker);
   dInfo("dnode vwrite is closed");
 }
@@ -105,8 +151,86 @@ void dnodeDispatchToVWriteQueue(SRpcMsg *pRpcMsg) {
   rpcFreeCont(pRpcMsg->pCont);
 }
 
+// launch the thread of the worker if it is not running, the pool mutex shall be held
+static int32_t dnodeStartVWriteWorker(SVWriteWorker *pWorker) {
+  if (pWorker->running) return 0;
+
+  // the thread of a stopped worker has exited or is exiting
+  if (taosCheckPthreadValid(pWorker->thread)) {
+    pthread_join(pWorker->thread, NULL);
+    taosResetPthread(&pWorker->thread);
+  }
+
+  if (pWorker->qset == NULL) {
+    pWorker->qset = taosOpenQset();
+    if (pWorker->qset == NULL) return -1;
+  }
+
+  if (pWorker->qall == NULL) {
+    pWorker->qall = taosAllocateQall();
+    if (pWorker->qall == NULL) return -1;
+  }
+
+  pthread_attr_t thAttr;
+  pthread_attr_init(&thAttr);
+  pthread_attr_setdetachstate(&thAttr, PTHREAD_CREATE_JOINABLE);
+
+  int32_t code = pthread_create(&pWorker->thread, &thAttr, dnodeProcessVWriteQueue, pWorker);
+  pthread_attr_destroy(&thAttr);
+
+  if (code != 0) {
+    dError("failed to create thread to process vwrite queue since %s", strerror(errno));
+    taosResetPthread(&pWorker->thread);
+    return -1;
+  }
+
+  pWorker->running = 1;
+  dDebug("dnode vwrite worker:%d is launched", pWorker->workerId);
+  return 0;
+}
+
+static bool dnodeVWriteWorkerFits(SVWriteWorker *pWorker, SVWriteQueue *pQueue) {
+  return !pWorker->retiring && (pWorker->numaNode < 0 || pWorker->numaNode == pQueue->numaNode);
+}
+
+static SVWriteQueue *dnodeAllocVWriteRecord() {
+  for (int32_t i = 0; i < tsVWriteWP.numOfQueues; ++i) {
+    if (tsVWriteWP.queues[i]->queue == NULL) return tsVWriteWP.queues[i];
+  }
+
+  SVWriteQueue **queues = realloc(tsVWriteWP.queues, sizeof(SVWriteQueue *) * (tsVWriteWP.numOfQueues + 1));
+  if (queues == NULL) return NULL;
+  tsVWriteWP.queues = queues;
+
+  SVWriteQueue *pQueue = calloc(1, sizeof(SVWriteQueue));
+  if (pQueue == NULL) return NULL;
+
+  tsVWriteWP.queues[tsVWriteWP.numOfQueues++] = pQueue;
+  return pQueue;
+}
+
 void *dnodeAllocVWriteQueue(void *pVnode) {
   pthread_mutex_lock(&tsVWriteWP.mutex);
+
+  SVWriteQueue *pQueue = dnodeAllocVWriteRecord();
+  if (pQueue == NULL) {
+    pthread_mutex_unlock(&tsVWriteWP.mutex);
+    return NULL;
+  }
+
+  pQueue->pVnode = pVnode;
+  pQueue->numaNode = vnodeGetNumaNode(pVnode);
+  pQueue->targetId = -1;
+
+  // a vnode bound to a numa node goes to the next worker on the same node, a retiring worker is skipped
+  for (int32_t i = 0; i < tsVWriteWP.max; ++i) {
+    int32_t workerId = (tsVWriteWP.nextId + i) % tsVWriteWP.max;
+    if (dnodeVWriteWorkerFits(tsVWriteWP.worker + workerId, pQueue)) {
+      tsVWriteWP.nextId = workerId;
+      break;
+    }
+  }
+
   SVWriteWorker *pWorker = tsVWriteWP.worker + tsVWriteWP.nextId;
   taos_queue *queue = taosOpenQueue();
   if (queue == NULL) {
@@ -114,51 +238,267 @@ void *dnodeAllocVWriteQueue(void *pVnode) {
     return NULL;
   }
 
-  if (pWorker->qset == NULL) {
-    pWorker->qset = taosOpenQset();
-    if (pWorker->qset == NULL) {
-      taosCloseQueue(queue);
+  if (dnodeStartVWriteWorker(pWorker) != 0) {
+    taosCloseQueue(queue);
+    pthread_mutex_unlock(&tsVWriteWP.mutex);
+    return NULL;
+  }
+
+  taosAddIntoQset(pWorker->qset, queue, pQueue);
+  pQueue->queue = queue;
+  pQueue->workerId = pWorker->workerId;
+  pQueue->lastBusyUs = pQueue->busyUs;
+  pQueue->lastNumOfMsgs = pQueue->numOfMsgs;
+  pWorker->numOfQueues++;
+  tsVWriteWP.nextId = (tsVWriteWP.nextId + 1) % tsVWriteWP.max;
+
+  pthread_mutex_unlock(&tsVWriteWP.mutex);
+  dDebug("pVnode:%p, dnode vwrite queue:%p is allocated to worker:%d", pVnode, queue, pWorker->workerId);
+
+  return queue;
+}
+
+void dnodeFreeVWriteQueue(void *pWqueue) {
+  pthread_mutex_lock(&tsVWriteWP.mutex);
+
+  for (int32_t i = 0; i < tsVWriteWP.numOfQueues; ++i) {
+    SVWriteQueue *pQueue = tsVWriteWP.queues[i];
+    if (pQueue->queue != pWqueue) continue;
+
+    tsVWriteWP.worker[pQueue->workerId].numOfQueues--;
+    pQueue->queue = NULL;
+    pQueue->pVnode = NULL;
+    pQueue->targetId = -1;
+    break;
+  }
+
+  taosCloseQueue(pWqueue);
+  pthread_mutex_unlock(&tsVWriteWP.mutex);
+}
+
+// move the queues of the worker to their targets, the worker is between two batches so the msgs of a vnode are never
+// processed by two workers at the same time. The pool mutex shall be held.
+static void dnodeMoveVWriteQueues(SVWriteWorker *pWorker) {
+  pWorker->hasMoves = 0;
+
+  for (int32_t i = 0; i < tsVWriteWP.numOfQueues; ++i) {
+    SVWriteQueue *pQueue = tsVWriteWP.queues[i];
+    if (pQueue->queue == NULL || pQueue->workerId != pWorker->workerId || pQueue->targetId < 0) continue;
+
+    SVWriteWorker *pTarget = tsVWriteWP.worker + pQueue->targetId;
+    pQueue->targetId = -1;
+    if (pTarget->retiring || dnodeStartVWriteWorker(pTarget) != 0) continue;
+
+    taosRemoveFromQset(pWorker->qset, pQueue->queue);
+    taosAddIntoQset(pTarget->qset, pQueue->queue, pQueue);
+    pQueue->workerId = pTarget->workerId;
+    pWorker->numOfQueues--;
+    pTarget->numOfQueues++;
+
+    dInfo("pVnode:%p, dnode vwrite queue:%p is moved from worker:%d to worker:%d", pQueue->pVnode, pQueue->queue,
+          pWorker->workerId, pTarget->workerId);
+  }
+}
+
+// the worker got no msg since it is resumed, return true if its thread shall exit
+static bool dnodeStopVWriteWorker(SVWriteWorker *pWorker) {
+  pthread_mutex_lock(&tsVWriteWP.mutex);
+
+  if (!tsVWriteWP.stopped) {
+    dnodeMoveVWriteQueues(pWorker);
+    if (pWorker->numOfQueues > 0) {
+      // some queues can not be moved, keep on processing them
+      pWorker->retiring = 0;
       pthread_mutex_unlock(&tsVWriteWP.mutex);
-      return NULL;
+      return false;
     }
+  }
 
-    taosAddIntoQset(pWorker->qset, queue, pVnode);
-    pWorker->qall = taosAllocateQall();
-    if (pWorker->qall == NULL) {
-      taosCloseQset(pWorker->qset);
-      taosCloseQueue(queue);
-      pthread_mutex_unlock(&tsVWriteWP.mutex);
-      return NULL;
+  pWorker->running = 0;
+  pWorker->retiring = 0;
+  pthread_mutex_unlock(&tsVWriteWP.mutex);
+
+  dInfo("dnode vwrite worker:%d is stopped", pWorker->workerId);
+  return true;
+}
+
+static float dnodeGetVWriteQueueLoad(SVWriteQueue *pQueue, int64_t period) {
+  int64_t busyUs = pQueue->busyUs - pQueue->lastBusyUs;
+  int64_t numOfMsgs = pQueue->numOfMsgs - pQueue->lastNumOfMsgs;
+
+  // the msgs waiting in the queue are counted by the time a msg took in the period
+  int32_t depth = taosGetQueueItemsNumber(pQueue->queue);
+  if (numOfMsgs > 0) busyUs += depth * busyUs / numOfMsgs;
+
+  return (float)busyUs / period;
+}
+
+static SVWriteWorker *dnodeGetVWriteTarget(SVWriteQueue *pQueue, float *load, bool running) {
+  SVWriteWorker *pTarget = NULL;
+
+  for (int32_t i = 0; i < tsVWriteWP.max; ++i) {
+    SVWriteWorker *pWorker = tsVWriteWP.worker + i;
+    if (i == pQueue->workerId || pWorker->running != running || !dnodeVWriteWorkerFits(pWorker, pQueue)) continue;
+    if (pTarget == NULL || load[i] < load[pTarget->workerId]) pTarget = pWorker;
+  }
+
+  return pTarget;
+}
+
+// a queue of the busiest worker is moved to the least busy worker if the move lowers the busier of the two, a new
+// worker is started instead if the least busy one would be saturated. If no worker is saturated the least busy one is
+// stopped when the others can take its queues.
+static void dnodeBalanceVWrite(int64_t now) {
+  pthread_mutex_lock(&tsVWriteWP.mutex);
+
+  int64_t period = now - tsVWriteWP.balanceTime;
+  if (tsVWriteWP.stopped || period < VWRITE_BALANCE_PERIOD_US) {
+    pthread_mutex_unlock(&tsVWriteWP.mutex);
+    return;
+  }
+
+  float * load = calloc(tsVWriteWP.max, sizeof(float));
+  float * qload = calloc(tsVWriteWP.numOfQueues + 1, sizeof(float));
+  int32_t numOfRunning = 0;
+  if (load == NULL || qload == NULL) goto _over;
+
+  for (int32_t i = 0; i < tsVWriteWP.max; ++i) {
+    SVWriteWorker *pWorker = tsVWriteWP.worker + i;
+    int64_t        busyUs = atomic_load_64(&pWorker->busyUs);
+    pWorker->utilization = (float)(busyUs - pWorker->lastBusyUs) / period;
+    pWorker->lastBusyUs = busyUs;
+    if (pWorker->running && !pWorker->retiring) numOfRunning++;
+  }
+
+  // a queue waiting for its move is counted on its target
+  for (int32_t i = 0; i < tsVWriteWP.numOfQueues; ++i) {
+    SVWriteQueue *pQueue = tsVWriteWP.queues[i];
+    if (pQueue->queue == NULL) continue;
+    qload[i] = dnodeGetVWriteQueueLoad(pQueue, period);
+    load[pQueue->targetId >= 0 ? pQueue->targetId : pQueue->workerId] += qload[i];
+  }
+
+  for (int32_t i = 0; i < tsVWriteWP.numOfQueues; ++i) {
+    SVWriteQueue *pQueue = tsVWriteWP.queues[i];
+    pQueue->lastBusyUs = atomic_load_64(&pQueue->busyUs);
+    pQueue->lastNumOfMsgs = atomic_load_64(&pQueue->numOfMsgs);
+  }
+
+  if (!tsBalanceWriteWorkers) goto _over;
+
+  SVWriteWorker *pBusy = NULL;
+  for (int32_t i = 0; i < tsVWriteWP.max; ++i) {
+    SVWriteWorker *pWorker = tsVWriteWP.worker + i;
+    if (!pWorker->running || pWorker->retiring || pWorker->numOfQueues < 2) continue;
+    if (pBusy == NULL || load[i] > load[pBusy->workerId]) pBusy = pWorker;
+  }
+
+  if (pBusy != NULL && load[pBusy->workerId] > VWRITE_BUSY_RATIO) {
+    int32_t        moveIdx = -1;
+    SVWriteWorker *pMoveTo = NULL;
+
+    // the largest queue whose move lowers the busier of the two workers
+    for (int32_t i = 0; i < tsVWriteWP.numOfQueues; ++i) {
+      SVWriteQueue *pQueue = tsVWriteWP.queues[i];
+      if (pQueue->queue == NULL || pQueue->workerId != pBusy->workerId || pQueue->targetId >= 0) continue;
+
+      SVWriteWorker *pTarget = dnodeGetVWriteTarget(pQueue, load, true);
+      if (pTarget == NULL || load[pTarget->workerId] + qload[i] > VWRITE_BUSY_RATIO) {
+        SVWriteWorker *pNew = dnodeGetVWriteTarget(pQueue, load, false);
+        if (pNew != NULL) pTarget = pNew;
+      }
+
+      if (pTarget == NULL || qload[i] >= load[pBusy->workerId] - load[pTarget->workerId]) continue;
+      if (moveIdx < 0 || qload[i] > qload[moveIdx]) {
+        moveIdx = i;
+        pMoveTo = pTarget;
+      }
     }
-    pthread_attr_t thAttr;
-    pthread_attr_init(&thAttr);
-    pthread_attr_setdetachstate(&thAttr, PTHREAD_CREATE_JOINABLE);
-
-    if (pthread_create(&pWorker->thread, &thAttr, dnodeProcessVWriteQueue, pWorker) != 0) {
-      dError("failed to create thread to process vwrite queue since %s", strerror(errno));
-      taosFreeQall(pWorker->qall);
-      taosCloseQset(pWorker->qset);
-      taosCloseQueue(queue);
-      queue = NULL;
+
+    if (moveIdx >= 0) {
+      SVWriteQueue *pMove = tsVWriteWP.queues[moveIdx];
+      pMove->targetId = pMoveTo->workerId;
+      pBusy->hasMoves = 1;
+      dInfo("pVnode:%p, dnode vwrite queue will be moved from worker:%d load:%.2f to worker:%d load:%.2f",
+            pMove->pVnode, pBusy->workerId, load[pBusy->workerId], pMoveTo->workerId, load[pMoveTo->workerId]);
+    }
+    goto _over;
+  }
+
+  if (numOfRunning <= tsVWriteWP.min) goto _over;
+
+  SVWriteWorker *pIdle = NULL;
+  float          total = 0;
+  for (int32_t i = 0; i < tsVWriteWP.max; ++i) {
+    SVWriteWorker *pWorker = tsVWriteWP.worker + i;
+    if (!pWorker->running || pWorker->retiring) continue;
+    total += load[i];
+    if (pIdle == NULL || load[i] < load[pIdle->workerId]) pIdle = pWorker;
+  }
+
+  if (pIdle == NULL || load[pIdle->workerId] >= VWRITE_IDLE_RATIO || total / (numOfRunning - 1) >= VWRITE_IDLE_RATIO) {
+    goto _over;
+  }
+
+  // the queues of the idle worker are spread over the least busy of the others
+  pIdle->retiring = 1;
+  bool moved = true;
+  for (int32_t i = 0; i < tsVWriteWP.numOfQueues && moved; ++i) {
+    SVWriteQueue *pQueue = tsVWriteWP.queues[i];
+    if (pQueue->queue == NULL || pQueue->workerId != pIdle->workerId) continue;
+
+    SVWriteWorker *pTarget = dnodeGetVWriteTarget(pQueue, load, true);
+    if (pTarget == NULL) {
+      moved = false;
     } else {
-      dDebug("dnode vwrite worker:%d is launched", pWorker->workerId);
-      tsVWriteWP.nextId = (tsVWriteWP.nextId + 1) % tsVWriteWP.max;
+      pQueue->targetId = pTarget->workerId;
+      load[pTarget->workerId] += qload[i];
     }
+  }
 
-    pthread_attr_destroy(&thAttr);
-  } else {
-    taosAddIntoQset(pWorker->qset, queue, pVnode);
-    tsVWriteWP.nextId = (tsVWriteWP.nextId + 1) % tsVWriteWP.max;
+  if (!moved) {
+    pIdle->retiring = 0;
+    for (int32_t i = 0; i < tsVWriteWP.numOfQueues; ++i) {
+      if (tsVWriteWP.queues[i]->workerId == pIdle->workerId) tsVWriteWP.queues[i]->targetId = -1;
+    }
+    goto _over;
   }
 
-  pthread_mutex_unlock(&tsVWriteWP.mutex);
-  dDebug("pVnode:%p, dnode vwrite queue:%p is allocated", pVnode, queue);
+  pIdle->hasMoves = 1;
+  taosQsetThreadResume(pIdle->qset);
+  dInfo("dnode vwrite worker:%d load:%.2f will be stopped, running workers:%d load:%.2f", pIdle->workerId,
+        load[pIdle->workerId], numOfRunning, total);
 
-  return queue;
+_over:
+  tsVWriteWP.balanceTime = now;
+  pthread_mutex_unlock(&tsVWriteWP.mutex);
+  tfree(load);
+  tfree(qload);
 }
 
-void dnodeFreeVWriteQueue(void *pWqueue) {
-  taosCloseQueue(pWqueue);
+int32_t dnodeGetVWriteWorkersInfo(SVWriteWorkerInfo *pInfo, int32_t maxNum) {
+  int32_t num = 0;
+
+  pthread_mutex_lock(&tsVWriteWP.mutex);
+
+  // the utilization is refreshed by the workers, an idle pool reports the ratio since the last refresh
+  int64_t now = taosGetTimestampUs();
+  bool    stale = now - tsVWriteWP.balanceTime >= 2 * VWRITE_BALANCE_PERIOD_US;
+
+  for (int32_t i = 0; i < tsVWriteWP.max && num < maxNum; ++i) {
+    SVWriteWorker *pWorker = tsVWriteWP.worker + i;
+    pInfo[num].workerId = pWorker->workerId;
+    pInfo[num].running = pWorker->running;
+    pInfo[num].numOfQueues = pWorker->numOfQueues;
+    pInfo[num].busyUs = atomic_load_64(&pWorker->busyUs);
+    pInfo[num].numOfMsgs = atomic_load_64(&pWorker->numOfMsgs);
+    pInfo[num].utilization = stale ? (float)(pInfo[num].busyUs - pWorker->lastBusyUs) / (now - tsVWriteWP.balanceTime)
+                                   : pWorker->utilization;
+    num++;
+  }
+
+  pthread_mutex_unlock(&tsVWriteWP.mutex);
+  return num;
 }
 
 void dnodeSendRpcVWriteRsp(void *pVnode, void *wparam, int32_t code) {
@@ -184,6 +524,7 @@ void dnodeSendRpcVWriteRsp(void *pVnode, void *wparam, int32_t code) {
 static void *dnodeProcessVWriteQueue(void *wparam) {
   SVWriteWorker *pWorker = wparam;
   SVWriteMsg *   pWrite;
+  SVWriteQueue * pQueue;
   void *         pVnode;
   int32_t        numOfMsgs;
   int32_t        qtype;
@@ -193,13 +534,22 @@ static void *dnodeProcessVWriteQueue(void *wparam) {
 
   setThreadName("dnodeWriteQ");
 
+  if (pWorker->numaNode >= 0 && taosBindThreadToNumaNode(pWorker->numaNode) != 0) {
+    dWarn("dnode vwrite worker:%d failed to bind to numa node %d since %s", pWorker->workerId, pWorker->numaNode,
+          strerror(errno));
+  }
+
   while (1) {
-    numOfMsgs = taosReadAllQitemsFromQset(pWorker->qset, pWorker->qall, &pVnode);
+    numOfMsgs = taosReadAllQitemsFromQset(pWorker->qset, pWorker->qall, (void **)&pQueue);
     if (numOfMsgs == 0) {
+      if (!dnodeStopVWriteWorker(pWorker)) continue;
       dDebug("qset:%p, dnode vwrite got no message from qset, exiting", pWorker->qset);
       break;
     }
 
+    pVnode = pQueue->pVnode;
+    int64_t start = taosGetTimestampUs();
+
     bool forceFsync = false;
     for (int32_t i = 0; i < numOfMsgs; ++i) {
       taosGetQitem(pWorker->qall, &qtype, (void **)&pWrite);
@@ -214,12 +564,14 @@ static void *dnodeProcessVWriteQueue(void *wparam) {
       dTrace("msg:%p is processed in vwrite queue, code:0x%x", pWrite, pWrite->code);
     }
 
-    walFsync(vnodeGetWal(pVnode), forceFsync);
+    // the records of the batch are written out here, none of them is acked before
+    int32_t code = walFsync(vnodeGetWal(pVnode), forceFsync);
 
     // browse all items, and process them one by one
     taosResetQitems(pWorker->qall);
     for (int32_t i = 0; i < numOfMsgs; ++i) {
       taosGetQitem(pWorker->qall, &qtype, (void **)&pWrite);
+      if (code != 0 && pWrite->code == 0) pWrite->code = code;
       if (qtype == TAOS_QTYPE_RPC) {
         dnodeSendRpcVWriteRsp(pVnode, pWrite, pWrite->code);
       } else {
@@ -232,6 +584,20 @@ static void *dnodeProcessVWriteQueue(void *wparam) {
         vnodeFreeFromWQueue(pVnode, pWrite);
       }
     }
+
+    int64_t end = taosGetTimestampUs();
+    atomic_add_fetch_64(&pQueue->busyUs, end - start);
+    atomic_add_fetch_64(&pQueue->numOfMsgs, numOfMsgs);
+    atomic_add_fetch_64(&pWorker->busyUs, end - start);
+    atomic_add_fetch_64(&pWorker->numOfMsgs, numOfMsgs);
+
+    if (atomic_load_8(&pWorker->hasMoves)) {
+      pthread_mutex_lock(&tsVWriteWP.mutex);
+      dnodeMoveVWriteQueues(pWorker);
+      pthread_mutex_unlock(&tsVWriteWP.mutex);
+    }
+
+    if (end - atomic_load_64(&tsVWriteWP.balanceTime) >= VWRITE_BALANCE_PERIOD_US) dnodeBalanceVWrite(end);
   }
 
   return NULL;
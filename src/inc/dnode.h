@@ -24,6 +24,7 @@ extern "C" {
 #include "taosmsg.h"
 
 #define MAX_HTTP_STATUS_CODE_NUM 63
+#define MAX_VWRITE_WORKER_NUM    256  // workers reported in the metrics
 typedef struct {
   int64_t queryReqNum;
   int64_t submitReqNum;
@@ -53,8 +54,18 @@ void  dnodeSendMsgToMnodeRecv(SRpcMsg *rpcMsg, SRpcMsg *rpcRsp);
 void  dnodeSendMsgToDnodeRecv(SRpcMsg *rpcMsg, SRpcMsg *rpcRsp, SRpcEpSet *epSet);
 void *dnodeSendCfgTableToRecv(int32_t vgId, int32_t tid);
 
-void *dnodeAllocVWriteQueue(void *pVnode);
-void  dnodeFreeVWriteQueue(void *pWqueue);
+typedef struct {
+  int32_t workerId;
+  int32_t numOfQueues;
+  int8_t  running;
+  float   utilization;  // ratio of the time busy in the last second
+  int64_t busyUs;       // time spent on the msgs since started
+  int64_t numOfMsgs;
+} SVWriteWorkerInfo;
+
+void *  dnodeAllocVWriteQueue(void *pVnode);
+void    dnodeFreeVWriteQueue(void *pWqueue);
+int32_t dnodeGetVWriteWorkersInfo(SVWriteWorkerInfo *pInfo, int32_t maxNum);
 void  dnodeSendRpcVWriteRsp(void *pVnode, void *pWrite, int32_t code);
 void *dnodeAllocVQueryQueue(void *pVnode);
 void *dnodeAllocVFetchQueue(void *pVnode);
@@ -300,6 +300,9 @@ do { \
 #define TSDB_MAX_WAL_FLUSH_SIZE         10000000 // MB
 #define TSDB_DEFAULT_WAL_FLUSH_SIZE     1024 // MB
 
+#define TSDB_MIN_ROLLUP_INTERVAL        60     // seconds, 0 turns the rollup windows off
+#define TSDB_MAX_ROLLUP_INTERVAL        86400  // seconds
+
 #define TSDB_MIN_TABLES                 4
 #define TSDB_MAX_TABLES                 10000000
 #define TSDB_DEFAULT_TABLES             1000000
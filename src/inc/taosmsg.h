@@ -244,7 +244,7 @@ typedef struct {
 } SShellSubmitRspBlock;
 
 typedef struct {
-  int8_t               extend;
+  int8_t               throttle;      // write admission level of the vnode, 0 if the writes are not throttled
   int32_t              code;          // 0-success, > 0 error code
   int32_t              numOfRows;     // number of records the client is trying to write
   int32_t              affectedRows;  // number of records actually written
@@ -564,6 +564,7 @@ typedef struct {
   uint8_t  role;
   uint8_t  replica;
   uint8_t  compact;
+  int8_t   numaNode;  // numa node the vnode is bound to, -1 if not bound or binding failed
 } SVnodeLoad;
 
 typedef struct {
@@ -716,7 +717,8 @@ typedef struct {
   float       diskAvailable;  // GB
   char        clusterId[TSDB_CLUSTER_ID_LEN];
   uint8_t     alternativeRole;
-  uint8_t     reserve2[15];
+  uint8_t     numaNodes;         // numa nodes the vnodes are bound to, 0 if not bound
+  uint8_t     reserve2[14];
   SClusterCfg clusterCfg;
   SVnodeLoad  load[];
 } SStatusMsg;
@@ -54,6 +54,7 @@ typedef struct {
   int (*eventCallBack)(void *);
   void *(*cqCreateFunc)(void *handle, uint64_t uid, int32_t sid, const char *dstTable, char *sqlStr, STSchema *pSchema, int start);
   void (*cqDropFunc)(void *handle);
+  void (*unpinMsgFunc)(void *pPin);  // release a msg pinned by the memtable referencing its rows
 } STsdbAppH;
 
 // --------- TSDB REPOSITORY CONFIGURATION DEFINITION
@@ -71,6 +72,7 @@ typedef struct {
   int8_t  compression;
   int8_t  update;
   int8_t  cacheLastRow;    // 0:no cache, 1: cache last row, 2: cache last NULL column 3: 1&2
+  int32_t numaNode;        // numa node the buffer pool is bound to, -1 if not bound
 } STsdbCfg;
 
 #define CACHE_NO_LAST(c)          ((c)->cacheLastRow == 0)
@@ -96,6 +98,7 @@ int        tsdbCloseRepo(STsdbRepo *repo, int toCommit);
 int32_t    tsdbConfigRepo(STsdbRepo *repo, STsdbCfg *pCfg);
 int        tsdbGetState(STsdbRepo *repo);
 int8_t     tsdbGetCompactState(STsdbRepo *repo);
+int32_t    tsdbGetNumaNode(STsdbRepo *repo);
 // --------- TSDB TABLE DEFINITION
 typedef struct {
   uint64_t uid;  // the unique table ID
@@ -156,10 +159,12 @@ typedef struct {
  * Insert data to a table in a repository
  * @param pRepo the TSDB repository handle
  * @param pData the data to insert (will give a more specific description)
+ * @param pPin the handle pinning the msg, the rows are referenced by the memtable instead of copied if not NULL, and
+ *             the handle is released by unpinMsgFunc once the memtable is freed
  *
  * @return the number of points inserted, -1 for failure and the error number is set
  */
-int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp);
+int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp, void *pPin);
 
 // -- FOR QUERY TIME SERIES DATA
 
@@ -192,6 +197,8 @@ typedef struct {
   SList *      actList;
   SList *      extraBuffList;
   SList *      bufBlockList;
+  SList *      pinList;     // msgs whose rows are referenced
+  int64_t      pinnedSize;  // bytes of the msgs pinned
   int64_t      pointsAdd;   // TODO
   int64_t      storageAdd;  // TODO
 } SMemTable;
@@ -246,6 +253,17 @@ typedef struct {
   SArray   *dataBlockInfos;
 } STableBlockDist;
 
+typedef struct {
+  uint32_t  numOfReads;         // read syscalls of the column data
+  uint64_t  readSize;           // bytes of the column data read, the gaps between the columns included
+  int64_t   readTime;           // us spent on reading the column data
+  uint32_t  numOfDecodeBlocks;  // blocks with the columns decoded in parallel
+  uint32_t  numOfDecodeCols;    // columns decoded in parallel
+  int64_t   decodeTime;         // us spent on the parallel decoding, the file reads excluded
+  uint32_t  numOfBloomSkipBlocks;  // file blocks skipped by their bloom filters
+  uint32_t  numOfMappedCols;    // columns decoded off the file mappings, not read
+} STsdbReadCost;
+
 /**
  * Get the data block iterator, starting from position according to the query condition
  *
@@ -341,12 +359,26 @@ int32_t tsdbRetrieveDataBlockStatisInfo(TsdbQueryHandleT *pQueryHandle, SDataSta
  * the returned data block must be satisfied with the time window condition in any cases,
  * which means the SData data block is not actually the completed disk data blocks.
  *
+ * If a column id list is given, only these columns and the primary timestamp column of a file data block are loaded,
+ * the content of the other columns is undefined until it is called again with a NULL list for the same block.
+ *
  * @param pQueryHandle      query handle
- * @param pColumnIdList     required data columns id list
+ * @param pColumnIdList     required data columns id list, SArray<int16_t>, NULL for all columns
  * @return
  */
 SArray *tsdbRetrieveDataBlock(TsdbQueryHandleT *pQueryHandle, SArray *pColumnIdList);
 
+/**
+ * Get the dictionary of a binary/nchar column in the data block returned by the last tsdbRetrieveDataBlock, so that
+ * filters can be evaluated once per distinct value.
+ *
+ * @param pQueryHandle      query handle
+ * @param colId             column id
+ * @param pDict             the dictionary, valid until the next data block is retrieved
+ * @return                  false if the column of current data block is not dictionary encoded
+ */
+bool tsdbRetrieveDataBlockDict(TsdbQueryHandleT *pQueryHandle, int16_t colId, SColumnDict *pDict);
+
 /**
  * Get the qualified table id for a super table according to the tag query expression.
  * @param stableid. super table sid
@@ -392,6 +424,21 @@ void tsdbResetQueryHandleForNewTable(TsdbQueryHandleT queryHandle, STsdbQueryCon
 
 int32_t tsdbGetFileBlocksDistInfo(TsdbQueryHandleT* queryHandle, STableBlockDist* pTableBlockInfo);
 
+/**
+ * get the cost of reading and decoding the columns of the data blocks
+ * @param queryHandle
+ * @param pCost the cost of the query handle is added to it
+ */
+void tsdbGetReadCost(TsdbQueryHandleT queryHandle, STsdbReadCost* pCost);
+
+/**
+ * set the equal conditions all the result rows must meet, the file blocks whose bloom filters exclude any of the
+ * values are skipped without being loaded
+ * @param queryHandle
+ * @param pConds SColumnEqualCond array, the values must stay valid until the query handle is cleaned up
+ */
+void tsdbSetQueryEqualConds(TsdbQueryHandleT queryHandle, SArray* pConds);
+
 // obtain queryHandle attribute
 int64_t tsdbSkipOffset(TsdbQueryHandleT queryHandle);
 
@@ -404,8 +451,20 @@ int64_t tsdbSkipOffset(TsdbQueryHandleT queryHandle);
  */
 void tsdbReportStat(void *repo, int64_t *totalPoints, int64_t *totalStorage, int64_t *compStorage);
 
+/**
+ * get the statistics of the block caches of all the repos, the hit and miss counts are reset
+ * @param hits. lookups served by the caches since the last call
+ * @param misses. lookups missed since the last call
+ * @param size. bytes held by the caches
+ */
+void tsdbGetBlockCacheStatis(int64_t *hits, int64_t *misses, int64_t *size);
+
 int  tsdbInitCommitQueue();
 void tsdbDestroyCommitQueue();
+int  tsdbInitDecodeQueue();
+void tsdbDestroyDecodeQueue();
+int  tsdbInitCommitWorkers();
+void tsdbDestroyCommitWorkers();
 int  tsdbSyncCommit(STsdbRepo *repo);
 void tsdbIncCommitRef(int vgId);
 void tsdbDecCommitRef(int vgId);
@@ -424,6 +483,9 @@ int tsdbCompact(STsdbRepo *pRepo);
 bool tsdbNoProblem(STsdbRepo* pRepo);
 // unit of walSize: MB
 int tsdbCheckWal(STsdbRepo *pRepo, uint32_t walSize);
+// percentage of the memory a memtable may take before it is committed, 100 if it spills to system memory,
+// only called from the write thread
+int32_t tsdbGetMemFill(STsdbRepo *pRepo);
 
 // for json tag
 void* getJsonTagValueElment(void* data, char* key, int32_t keyLen, char* out, int16_t bytes);
@@ -280,6 +280,13 @@ void  setNull(void *val, int32_t type, int32_t bytes);
 void  setNullN(void *val, int32_t type, int32_t bytes, int32_t numOfElems);
 const void *getNullValue(int32_t type);
 
+// bit i of a null bitmap is set if row i is not null
+#define NULL_BITMAP_BYTES(_n)        (((_n) + 7) >> 3)
+#define NULL_BITMAP_NOTNULL(_b, _i)  ((((const uint8_t *)(_b))[(_i) >> 3] >> ((_i) & 7)) & 1)
+
+int32_t buildNullBitmap(const void *val, int32_t type, int32_t numOfElems, uint8_t *pBitmap);
+int32_t countNotNullInBitmap(const uint8_t *pBitmap, int32_t start, int32_t numOfElems);
+
 void assignVal(char *val, const char *src, int32_t len, int32_t type);
 void tsDataSwap(void *pLeft, void *pRight, int32_t type, int32_t size, void* buf);
 void operateVal(void *dst, void *s1, void *s2, int32_t optr, int32_t type);
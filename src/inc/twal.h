@@ -46,10 +46,14 @@ typedef struct {
   int32_t  fsyncPeriod;  // millisecond
   EWalType walLevel;     // wal level
   EWalKeep keep;         // keep the wal file when closed
+  int8_t   groupCommit;  // buffer the records until walFsync, the writer shall not ack them before it
+  int8_t   directIO;     // write the buffered records by O_DIRECT, only with groupCommit
+  int32_t  preallocSize; // MB reserved on disk each time the file grows, 0 for none
 } SWalCfg;
 
 typedef void *  twalh;  // WAL HANDLE
 typedef int32_t FWalWrite(void *ahandle, void *pHead, int32_t qtype, void *pMsg);
+typedef void    FWalProgress(void *ahandle, int64_t offset, int64_t size);
 
 int32_t  walInit();
 void     walCleanUp();
@@ -61,8 +65,8 @@ int32_t  walRenew(twalh);
 void     walRemoveOneOldFile(twalh);
 void     walRemoveAllOldFiles(twalh);
 int32_t  walWrite(twalh, SWalHead *);
-void     walFsync(twalh, bool forceFsync);
-int32_t  walRestore(twalh, void *pVnode, FWalWrite writeFp);
+int32_t  walFsync(twalh, bool forceFsync);
+int32_t  walRestore(twalh, void *pVnode, FWalWrite writeFp, FWalProgress progressFp);
 int32_t  walGetWalFile(twalh, char *fileName, int64_t *fileId);
 uint64_t walGetVersion(twalh);
 void     walResetVersion(twalh, uint64_t newVer);
@@ -26,6 +26,9 @@ typedef struct {
   int64_t submitReqSucNum;
   int64_t submitRowNum;
   int64_t submitRowSucNum;
+  int64_t blockCacheHits;
+  int64_t blockCacheMisses;
+  int64_t blockCacheSize;
 } SVnodeStatisInfo;
 
 typedef struct {
@@ -51,6 +54,7 @@ typedef struct {
   int32_t  code;
   int32_t  processedCount;
   int32_t  qtype;
+  int32_t  refCount;  // held by the write queue and by the memtables referencing its rows
   void *   pVnode;
   SRpcMsg  rpcMsg;
   SRspRet  rspRet;
@@ -77,6 +81,7 @@ void*   vnodeAcquire(int32_t vgId);
 void    vnodeRelease(void *pVnode);
 void*   vnodeAcquireNotClose(int32_t vgId);
 void*   vnodeGetWal(void *pVnode);
+int32_t vnodeGetNumaNode(void *pVnode);
 int32_t vnodeGetVnodeList(int32_t vnodeList[], int32_t *numOfVnodes);
 void    vnodeBuildStatusMsg(void *pStatus);
 void    vnodeSetAccess(SVgroupAccess *pAccess, int32_t numOfVnodes);
@@ -69,7 +69,8 @@ typedef struct SDnodeObj {
   int16_t    memoryAvgUsage;   // calc from sys.mem
   int16_t    bandwidthUsage;   // calc from sys.band
   int8_t     offlineReason;
-  int8_t     reserved2[1];
+  uint8_t    numaNodes;        // from dnode status msg
+  int16_t    numaVnodes;       // from vnode status msg, vnodes bound to a numa node
 } SDnodeObj;
 
 typedef struct SMnodeObj {
@@ -153,6 +154,7 @@ typedef struct SVgObj {
   int64_t        totalStorage;
   int64_t        compStorage;
   int64_t        pointsWritten;
+  int8_t         numaNode[TSDB_MAX_REPLICA];  // from vnode status msg, -1 if the vnode is not bound
   struct SDbObj *pDb;
   void *         idPool;
 } SVgObj;
@@ -98,6 +98,7 @@ static int32_t mnodeVgroupActionInsert(SSdbRow *pRow) {
   pVgroup->pDb = pDb;
   pVgroup->status = TAOS_VG_STATUS_CREATING;
   pVgroup->accessState = TSDB_VN_ALL_ACCCESS;
+  memset(pVgroup->numaNode, -1, sizeof(pVgroup->numaNode));
   if (mnodeAllocVgroupIdPool(pVgroup) < 0) {
     mError("vgId:%d, failed to init idpool for vgroups", pVgroup->vgId);
     return -1;
@@ -324,6 +325,7 @@ void mnodeUpdateVgroupStatus(SVgObj *pVgroup, SDnodeObj *pDnode, SVnodeLoad *pVl
              pDnode->dnodeId, syncRole[pVload->role], syncRole[pVgid->role], pVload->vnodeVersion);
       pVgid->role = pVload->role;
       mnodeSetVgidVer(pVgid->vver, pVload->vnodeVersion);
+      pVgroup->numaNode[i] = pVload->numaNode;
       if (pVload->role == TAOS_SYNC_ROLE_MASTER) {
         pVgroup->inUse = i;
       }
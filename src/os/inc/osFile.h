@@ -37,11 +37,28 @@ typedef int32_t FileFd;
 typedef int32_t SocketFd;
 #endif
 
+#if defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32)
+struct iovec {
+  void * iov_base;
+  size_t iov_len;
+};
+#endif
+
 int64_t taosRead(FileFd fd, void *buf, int64_t count);
+// read at the offset into the buffers in turn, the iov array is consumed, return the bytes read
+int64_t taosPReadv(FileFd fd, struct iovec *iov, int32_t iovcnt, int64_t offset);
 int64_t taosWrite(FileFd fd, void *buf, int64_t count);
+// write all the count bytes at the offset, the file position is not used
+int64_t taosPWrite(FileFd fd, void *buf, int64_t count, int64_t offset);
+
+// map the first size bytes of the file for reading, NULL with errno set on failure
+void *  taosMmapReadOnly(FileFd fd, int64_t size);
+int32_t taosMunmap(void *ptr, int64_t size);
 
 int64_t taosLSeek(FileFd fd, int64_t offset, int32_t whence);
 int32_t taosFtruncate(FileFd fd, int64_t length);
+// reserve the disk space of [offset, offset + len) without changing the file size
+int32_t taosFallocate(FileFd fd, int64_t offset, int64_t len);
 int32_t taosFsync(FileFd fd);
 
 int32_t taosRename(char* oldName, char *newName);
@@ -43,6 +43,12 @@ void * taosTZfree(void *ptr);
 size_t taosTSizeof(void *ptr);
 void   taosTMemset(void *ptr, int c);
 
+#define TAOS_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// map anonymous memory of a multiple of TAOS_HUGE_PAGE_SIZE aligned to it, backed by the reserved huge pages if there
+// are enough, or by transparent huge pages otherwise, NULL with errno set on failure, freed by taosMunmap
+void * taosMmapHugePages(int64_t size);
+
 // used in other module
 #define tmalloc(size) malloc(size)
 #define tcalloc(num, size) calloc(num, size)
@@ -29,6 +29,12 @@ typedef struct {
 int32_t taosGetDiskSize(char *dataDir, SysDiskSize *diskSize);
 
 int32_t taosGetCpuCores();
+// numa nodes of the machine, 0 if the topology is not available
+int32_t taosGetNumaNodes();
+// run the calling thread on the cpus of the numa node, and prefer the memory of the node for the pages it touches
+int32_t taosBindThreadToNumaNode(int32_t node);
+// prefer the memory of the numa node for the pages within the range, the pages partly in the range are left alone
+int32_t taosBindMemToNumaNode(void *ptr, int64_t size, int32_t node);
 void taosGetSystemInfo();
 bool taosReadProcIO(int64_t* rchars, int64_t* wchars, int64_t* rbytes, int64_t* wbytes);
 bool taosGetProcIO(float *rcharKB, float *wcharKB, float *rbyteKB, float* wbyteKB);
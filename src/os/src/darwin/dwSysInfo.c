@@ -170,6 +170,12 @@ int32_t taosGetCpuCores() {
   return sysconf(_SC_NPROCESSORS_ONLN);
 }
 
+int32_t taosGetNumaNodes() { return 0; }
+
+int32_t taosBindThreadToNumaNode(int32_t node) { return -1; }
+
+int32_t taosBindMemToNumaNode(void *ptr, int64_t size, int32_t node) { return -1; }
+
 void taosGetSystemInfo() {
   // taosGetProcInfos();
 
@@ -14,6 +14,7 @@
  */
 
 #define _DEFAULT_SOURCE
+#define _GNU_SOURCE
 #include "os.h"
 #include "tglobal.h"
 #include "tulog.h"
@@ -126,6 +127,112 @@ int64_t taosWrite(FileFd fd, void *buf, int64_t n) {
 
 int64_t taosLSeek(FileFd fd, int64_t offset, int32_t whence) { return (int64_t)lseek(fd, (long)offset, whence); }
 
+#if defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32) || defined(_TD_DARWIN_64)
+
+int64_t taosPWrite(FileFd fd, void *buf, int64_t count, int64_t offset) {
+  if (taosLSeek(fd, offset, SEEK_SET) < 0) return -1;
+  return taosWrite(fd, buf, count);
+}
+
+int32_t taosFallocate(FileFd fd, int64_t offset, int64_t len) { return 0; }
+
+int64_t taosPReadv(FileFd fd, struct iovec *iov, int32_t iovcnt, int64_t offset) {
+  int64_t nread = 0;
+
+  if (taosLSeek(fd, offset, SEEK_SET) < 0) return -1;
+
+  for (int32_t i = 0; i < iovcnt; ++i) {
+    int64_t readbytes = taosRead(fd, iov[i].iov_base, (int64_t)iov[i].iov_len);
+    if (readbytes < 0) return -1;
+
+    nread += readbytes;
+    if (readbytes < (int64_t)iov[i].iov_len) break;
+  }
+
+  return nread;
+}
+
+#else
+
+int64_t taosPWrite(FileFd fd, void *buf, int64_t count, int64_t offset) {
+  int64_t nleft = count;
+  int64_t nwritten = 0;
+  char *  tbuf = (char *)buf;
+
+  while (nleft > 0) {
+    nwritten = pwrite(fd, tbuf, (size_t)nleft, offset + (count - nleft));
+    if (nwritten < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    nleft -= nwritten;
+    tbuf += nwritten;
+  }
+
+  return count;
+}
+
+int32_t taosFallocate(FileFd fd, int64_t offset, int64_t len) {
+  return fallocate(fd, FALLOC_FL_KEEP_SIZE, offset, len);
+}
+
+int64_t taosPReadv(FileFd fd, struct iovec *iov, int32_t iovcnt, int64_t offset) {
+  int64_t nread = 0;
+
+  while (iovcnt > 0) {
+    int64_t readbytes = preadv(fd, iov, iovcnt, offset + nread);
+    if (readbytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      } else {
+        return -1;
+      }
+    } else if (readbytes == 0) {
+      break;
+    }
+
+    nread += readbytes;
+
+    // skip the filled buffers and go on from the middle of a partly filled one
+    while (iovcnt > 0 && readbytes >= (int64_t)iov->iov_len) {
+      readbytes -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+
+    if (iovcnt > 0) {
+      iov->iov_base = (char *)iov->iov_base + readbytes;
+      iov->iov_len -= readbytes;
+    }
+  }
+
+  return nread;
+}
+
+#endif
+
+#if defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32)
+
+void *taosMmapReadOnly(FileFd fd, int64_t size) {
+  errno = ENOSYS;
+  return NULL;
+}
+
+int32_t taosMunmap(void *ptr, int64_t size) { return 0; }
+
+#else
+
+void *taosMmapReadOnly(FileFd fd, int64_t size) {
+  void *ptr = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, fd, 0);
+  return (ptr == MAP_FAILED) ? NULL : ptr;
+}
+
+int32_t taosMunmap(void *ptr, int64_t size) { return munmap(ptr, (size_t)size); }
+
+#endif
+
 int64_t taosCopy(char *from, char *to) {
   char    buffer[4096];
   int     fidto = -1, fidfrom = -1;
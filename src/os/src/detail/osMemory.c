@@ -519,3 +519,37 @@ void* taosTZfree(void* ptr) {
   }
   return NULL;
 }
+
+#if defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32)
+
+void *taosMmapHugePages(int64_t size) {
+  errno = ENOSYS;
+  return NULL;
+}
+
+#else
+
+void *taosMmapHugePages(int64_t size) {
+  void *ptr = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  ptr = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  if (ptr != MAP_FAILED) return ptr;
+
+  // the huge page pool is not reserved or it is used up, map one more huge page to align the range to it
+  char *map = mmap(NULL, (size_t)(size + TAOS_HUGE_PAGE_SIZE), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) return NULL;
+
+  char *start = (char *)ALIGN_NUM((uintptr_t)map, TAOS_HUGE_PAGE_SIZE);
+  if (start > map) munmap(map, start - map);
+  if (map + TAOS_HUGE_PAGE_SIZE > start) munmap(start + size, map + TAOS_HUGE_PAGE_SIZE - start);
+
+#ifdef MADV_HUGEPAGE
+  madvise(start, (size_t)size, MADV_HUGEPAGE);
+#endif
+
+  return start;
+}
+
+#endif
@@ -281,6 +281,106 @@ static void taosGetSystemLocale() {  // get and set default locale
 
 int32_t taosGetCpuCores() { return (int32_t)sysconf(_SC_NPROCESSORS_ONLN); }
 
+#define NUMA_MAX_NODES 64
+#define NUMA_MAX_CPUS 1024
+#define NUMA_MPOL_PREFERRED 1  // MPOL_PREFERRED of linux/mempolicy.h, the memory of other nodes is used once it is full
+
+static int32_t taosReadNumaFile(const char *path, char *buf, int32_t size) {
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL) return -1;
+
+  char *line = fgets(buf, size, fp);
+  fclose(fp);
+  return (line == NULL) ? -1 : 0;
+}
+
+int32_t taosGetNumaNodes() {
+  char buf[256];
+  if (taosReadNumaFile("/sys/devices/system/node/online", buf, sizeof(buf)) != 0) return 0;
+
+  // the list is like 0-1,3
+  int32_t maxNode = -1;
+  char *  p = buf;
+  while (*p != 0) {
+    if (isdigit(*p)) {
+      int32_t node = (int32_t)strtol(p, &p, 10);
+      if (node > maxNode) maxNode = node;
+    } else {
+      p++;
+    }
+  }
+
+  return MIN(maxNode + 1, NUMA_MAX_NODES);
+}
+
+int32_t taosBindThreadToNumaNode(int32_t node) {
+#if defined(SYS_sched_setaffinity) && defined(SYS_set_mempolicy)
+  if (node < 0 || node >= NUMA_MAX_NODES) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  char path[64];
+  char buf[1024];
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+  if (taosReadNumaFile(path, buf, sizeof(buf)) != 0) return -1;
+
+  // the list is like 0-15,32-47
+  uint64_t cpus[NUMA_MAX_CPUS / 64] = {0};
+  int32_t  numOfCpus = 0;
+  char *   p = buf;
+  while (isdigit(*p)) {
+    int32_t first = (int32_t)strtol(p, &p, 10);
+    int32_t last = first;
+    if (*p == '-') last = (int32_t)strtol(p + 1, &p, 10);
+    for (int32_t cpu = first; cpu <= last && cpu < NUMA_MAX_CPUS; ++cpu) {
+      cpus[cpu / 64] |= (uint64_t)1 << (cpu % 64);
+      numOfCpus++;
+    }
+    if (*p == ',') p++;
+  }
+
+  if (numOfCpus == 0) {
+    errno = ENOENT;
+    return -1;
+  }
+
+  if (syscall(SYS_sched_setaffinity, 0, sizeof(cpus), cpus) != 0) return -1;
+
+  uint64_t nodes[NUMA_MAX_NODES / 64] = {0};
+  nodes[0] = (uint64_t)1 << node;
+  if (syscall(SYS_set_mempolicy, NUMA_MPOL_PREFERRED, nodes, NUMA_MAX_NODES + 1) != 0) return -1;
+
+  return 0;
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+int32_t taosBindMemToNumaNode(void *ptr, int64_t size, int32_t node) {
+#if defined(SYS_mbind)
+  if (node < 0 || node >= NUMA_MAX_NODES) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+  uint64_t start = ((uint64_t)ptr + pageSize - 1) & ~(pageSize - 1);
+  uint64_t end = ((uint64_t)ptr + size) & ~(pageSize - 1);
+  if (end <= start) return 0;
+
+  uint64_t nodes[NUMA_MAX_NODES / 64] = {0};
+  nodes[0] = (uint64_t)1 << node;
+  if (syscall(SYS_mbind, start, end - start, NUMA_MPOL_PREFERRED, nodes, NUMA_MAX_NODES + 1, 0) != 0) return -1;
+
+  return 0;
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
 bool taosGetCpuUsage(float *sysCpuUsage, float *procCpuUsage) {
   static uint64_t lastSysUsed = 0;
   static uint64_t lastSysTotal = 0;
@@ -558,6 +658,7 @@ void taosGetSystemInfo() {
   taosGetProcInfos();
 
   tsNumOfCores = taosGetCpuCores();
+  tsNumOfNumaNodes = taosGetNumaNodes();
   tsTotalMemoryMB = taosGetTotalMemory();
 
   float tmp1, tmp2, tmp3, tmp4;
@@ -577,6 +678,7 @@ void taosPrintOsInfo() {
   uInfo(" os openMax:             %" PRId64, tsOpenMax);
   uInfo(" os streamMax:           %" PRId64, tsStreamMax);
   uInfo(" os numOfCores:          %d", tsNumOfCores);
+  uInfo(" os numOfNumaNodes:      %d", tsNumOfNumaNodes);
   uInfo(" os totalMemory:         %d(MB)", tsTotalMemoryMB);
 
   struct utsname buf;
@@ -132,6 +132,12 @@ int32_t taosGetCpuCores() {
   return (int32_t)info.dwNumberOfProcessors;
 }
 
+int32_t taosGetNumaNodes() { return 0; }
+
+int32_t taosBindThreadToNumaNode(int32_t node) { return -1; }
+
+int32_t taosBindMemToNumaNode(void *ptr, int64_t size, int32_t node) { return -1; }
+
 bool taosGetCpuUsage(float *sysCpuUsage, float *procCpuUsage) {
   *sysCpuUsage = 0;
   *procCpuUsage = 0;
@@ -175,6 +175,32 @@ bool metricsProcessRequest(HttpContext* pContext) {
     }
   }
 
+  {
+    SVWriteWorkerInfo workers[MAX_VWRITE_WORKER_NUM];
+    int32_t           numOfWorkers = dnodeGetVWriteWorkersInfo(workers, MAX_VWRITE_WORKER_NUM);
+    char*             keyWorkers = "vwrite_workers";
+    httpJsonPairHead(jsonBuf, keyWorkers, (int32_t)strlen(keyWorkers));
+    httpJsonToken(jsonBuf, JsonArrStt);
+    for (int32_t i = 0; i < numOfWorkers; ++i) {
+      httpJsonItemToken(jsonBuf);
+      httpJsonToken(jsonBuf, JsonObjStt);
+      char* keyWorkerId = "worker_id";
+      char* keyRunning = "running";
+      char* keyQueues = "vnodes";
+      char* keyUtilization = "utilization";
+      char* keyBusy = "busy_us";
+      char* keyMsgs = "msgs";
+      httpJsonPairIntVal(jsonBuf, keyWorkerId, (int32_t)strlen(keyWorkerId), workers[i].workerId);
+      httpJsonPairIntVal(jsonBuf, keyRunning, (int32_t)strlen(keyRunning), workers[i].running);
+      httpJsonPairIntVal(jsonBuf, keyQueues, (int32_t)strlen(keyQueues), workers[i].numOfQueues);
+      httpJsonPairFloatVal(jsonBuf, keyUtilization, (int32_t)strlen(keyUtilization), workers[i].utilization);
+      httpJsonPairInt64Val(jsonBuf, keyBusy, (int32_t)strlen(keyBusy), workers[i].busyUs);
+      httpJsonPairInt64Val(jsonBuf, keyMsgs, (int32_t)strlen(keyMsgs), workers[i].numOfMsgs);
+      httpJsonToken(jsonBuf, JsonObjEnd);
+    }
+    httpJsonToken(jsonBuf, JsonArrEnd);
+  }
+
   httpJsonToken(jsonBuf, JsonObjEnd);
 
   httpWriteJsonBufEnd(jsonBuf);
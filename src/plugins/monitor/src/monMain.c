@@ -130,6 +130,8 @@ typedef enum {
   MON_CMD_CREATE_TB_GRANTS,
   MON_CMD_CREATE_MT_RESTFUL,
   MON_CMD_CREATE_TB_RESTFUL,
+  MON_CMD_CREATE_MT_BLOCK_CACHE,
+  MON_CMD_CREATE_TB_BLOCK_CACHE,
   MON_CMD_MAX
 } EMonCmd;
 
@@ -174,6 +176,7 @@ static void  monSaveVgroupsInfo();
 static void  monSaveDisksInfo();
 static void  monSaveGrantsInfo();
 static void  monSaveHttpReqInfo();
+static void  monSaveBlockCacheInfo();
 static void  monGetSysStats();
 static void *monThreadFunc(void *param);
 static void  monBuildMonitorSql(char *sql, int32_t cmd);
@@ -323,6 +326,7 @@ static void *monThreadFunc(void *param) {
         monSaveDisksInfo();
         monSaveGrantsInfo();
         monSaveHttpReqInfo();
+        monSaveBlockCacheInfo();
         monSaveSystemInfo();
       }
     }
@@ -471,6 +475,15 @@ static void monBuildMonitorSql(char *sql, int32_t cmd) {
   } else if (cmd == MON_CMD_CREATE_TB_RESTFUL) {
     snprintf(sql, SQL_LENGTH, "create table if not exists %s.restful_%d using %s.restful_info tags(%d, '%s')", tsMonitorDbName,
              dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
+  } else if (cmd == MON_CMD_CREATE_MT_BLOCK_CACHE) {
+    snprintf(sql, SQL_LENGTH,
+             "create table if not exists %s.block_cache_info(ts timestamp"
+             ", hits bigint, misses bigint, hit_rate float, mem_used float"
+             ") tags (dnode_id int, dnode_ep binary(%d))",
+             tsMonitorDbName, TSDB_EP_LEN);
+  } else if (cmd == MON_CMD_CREATE_TB_BLOCK_CACHE) {
+    snprintf(sql, SQL_LENGTH, "create table if not exists %s.block_cache_%d using %s.block_cache_info tags(%d, '%s')",
+             tsMonitorDbName, dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
   }
 
   sql[SQL_LENGTH] = 0;
@@ -1316,6 +1329,31 @@ static void monSaveHttpReqInfo() {
   }
 }
 
+static void monSaveBlockCacheInfo() {
+  int64_t ts = taosGetTimestampUs();
+  char *  sql = tsMonitor.sql;
+  int64_t hits = tsMonStat.vInfo.blockCacheHits;
+  int64_t misses = tsMonStat.vInfo.blockCacheMisses;
+  float   hitRate = (hits + misses > 0) ? (float)hits / (hits + misses) : 0;
+
+  snprintf(sql, SQL_LENGTH, "insert into %s.block_cache_%d values(%" PRId64 ", %" PRId64 ", %" PRId64 ", %f, %f)",
+           tsMonitorDbName, dnodeGetDnodeId(), ts, hits, misses, hitRate,
+           tsMonStat.vInfo.blockCacheSize / (1024.0 * 1024.0));
+
+  monDebug("save block cache, sql:%s", sql);
+
+  void *res = taos_query(tsMonitor.conn, tsMonitor.sql);
+  int32_t code = taos_errno(res);
+  taos_free_result(res);
+
+  if (code != 0) {
+    monError("failed to save block_cache_%d info, reason:%s, sql:%s", dnodeGetDnodeId(), tstrerror(code), tsMonitor.sql);
+  } else {
+    monIncSubmitReqCnt();
+    monDebug("successfully to save block_cache_%d info, sql:%s", dnodeGetDnodeId(), tsMonitor.sql);
+  }
+}
+
 static void monExecSqlCb(void *param, TAOS_RES *result, int32_t code) {
   int32_t c = taos_errno(result);
   if (c != TSDB_CODE_SUCCESS) {
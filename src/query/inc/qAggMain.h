@@ -184,6 +184,8 @@ typedef struct SQLFunctionCtx {
   int32_t      outputBytes;   // size of results, determined by function and input column data type
   int32_t      interBufBytes; // internal buffer size
   bool         hasNull;       // null value exist in current block
+  const uint8_t *nullBitmap;  // bit i is set if row i of the block is not null, NULL if the block has no bitmap
+  int32_t      startRow;      // row of the block that pInput points to
   bool         requireNull;   // require null in some function
   bool         stableQuery;
   int16_t      functionId;    // function id
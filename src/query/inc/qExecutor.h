@@ -20,6 +20,7 @@
 #include "hash.h"
 #include "qAggMain.h"
 #include "qFill.h"
+#include "qGroupHash.h"
 #include "qResultbuf.h"
 #include "qSqlparser.h"
 #include "qTableMeta.h"
@@ -186,6 +187,8 @@ typedef struct SQueryCostInfo {
   uint32_t loadBlocks;
   uint32_t loadBlockStatis;
   uint32_t discardBlocks;
+  uint32_t filterOutBlocks;  // blocks discarded by the filter before the columns out of the filter are loaded
+  STsdbReadCost readCost;   // column data of the data blocks read and decoded
   uint64_t elapsedTime;
   uint64_t firstStageMergeTime;
   uint64_t winInfoSize;
@@ -310,6 +313,7 @@ typedef struct SQueryRuntimeEnv {
   SArray*               prevResult;       // intermediate result, SArray<SInterResult>
   STSBuf*               pTsBuf;           // timestamp filter list
   STSCursor             cur;
+  SArray*               pFilterColIds;    // columns of the filter, loaded and filtered before the other columns
 
   char*                 tagVal;           // tag value of current data block
   SScalarExprSupport*sasArray;
@@ -543,9 +547,21 @@ typedef struct SFillOperatorInfo {
 } SFillOperatorInfo;
 
 typedef struct SGroupbyOperatorInfo {
-  SOptrBasicInfo binfo;
-  int32_t        colIndex;
-  char          *prevData;   // previous group by value
+  SOptrBasicInfo   binfo;
+  int32_t          numOfGroupCols;  // number of normal columns in the group by clause
+  int32_t         *colIndex;        // index of the group by columns in the input data block
+  char           **pColData;        // data of the group by columns of the current block
+  SGroupHashTable *pGroupHash;      // group by values -> result row
+  int32_t          rowCapacity;
+  int32_t         *pGroupOfRow;     // group of each row of the current block
+  int32_t         *pRowIndex;       // rows of the current block ordered by group
+  int32_t         *pBlockGroup;     // groups of the current block, in the order of their first row
+  int32_t         *pGroupStart;     // start of the rows of each group of the current block in pRowIndex
+  int32_t         *pGroupRows;      // number of rows of each group of the current block
+  int32_t         *pGroupSeq;       // group -> index in pBlockGroup, -1 if the group is not in the current block
+  int32_t          groupSeqCapacity;
+  SSDataBlock     *pGatherBlock;    // rows of the current block gathered by group
+  int32_t          gatherCapacity;
 } SGroupbyOperatorInfo;
 
 typedef struct SSWindowOperatorInfo {
@@ -35,6 +35,7 @@ extern "C" {
 #define MAX_NUM_STR_SIZE 40
 
 #define FILTER_RM_UNIT_MIN_ROWS 100
+#define FILTER_DICT_MAX_ENTRIES 256
 
 enum {
   FLD_TYPE_COLUMN = 1,
@@ -106,6 +107,7 @@ typedef int32_t(*filter_desc_compare_func)(const void *, const void *);
 typedef bool(*filter_exec_func)(void *, int32_t, int8_t**, SDataStatis *, int16_t);
 typedef int32_t (*filer_get_col_from_id)(void *, int32_t, void **);
 typedef int32_t (*filer_get_col_from_name)(void *, int32_t, char*, void **);
+typedef bool (*filer_get_col_dict_from_id)(void *, int16_t, SColumnDict *);
 
 typedef struct SFilterRangeCompare {
   int64_t s;
@@ -212,6 +214,7 @@ typedef struct SFilterComUnit {
   uint8_t optr;
   int8_t func;
   int8_t rfunc;
+  SColumnDict *dict;  // dictionary of the column in current block, NULL if the column is not dictionary encoded
 } SFilterComUnit;
 
 typedef struct SFilterPCtx {
@@ -239,6 +242,12 @@ typedef struct SFilterInfo {
   uint32_t         *blkUnits;
   int8_t           *blkUnitRes;
   void             *pTable;
+  uint32_t          dictUnitNum;   // units with a column dictionary in current block
+  SColumnDict      *colDict;       // dictionary of each column field
+  int8_t           *dictRes;       // unit result of each dictionary entry
+  int8_t           *vecRes;        // unit and group results of the rows of a block by the batch kernels
+  int32_t           vecRows;       // rows vecRes holds
+  uint32_t         *vecUnits;      // groups of the batch kernels, listed as blkUnits does
 
   SFilterPCtx       pctx;
 } SFilterInfo;
@@ -327,13 +336,19 @@ typedef struct SFilterInfo {
 
 extern int32_t filterInitFromTree(tExprNode* tree, void **pinfo, uint32_t options);
 extern bool filterExecute(SFilterInfo *info, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols);
+// evaluates all the units row by row, whatever the executor chosen for the filter
+extern bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols);
 extern int32_t filterSetColFieldData(SFilterInfo *info, void *param, filer_get_col_from_id fp);
 extern int32_t filterSetJsonColFieldData(SFilterInfo *info, void *param, filer_get_col_from_name fp);
+extern int32_t filterSetColFieldDict(SFilterInfo *info, void *param, filer_get_col_dict_from_id fp);
+extern int32_t filterGetColumnIds(SFilterInfo *info, SArray *pColIds);
+extern int32_t filterGetEqualConds(SFilterInfo *info, SArray *pConds);
 extern int32_t filterGetTimeRange(SFilterInfo *info, STimeWindow *win);
 extern int32_t filterConverNcharColumns(SFilterInfo* pFilterInfo, int32_t rows, bool *gotNchar);
 extern int32_t filterFreeNcharColumns(SFilterInfo* pFilterInfo);
 extern void filterFreeInfo(SFilterInfo *info);
 extern bool filterRangeExecute(SFilterInfo *info, SDataStatis *pDataStatis, int32_t numOfCols, int32_t numOfRows);
+extern bool filterRangeAllPass(SFilterInfo *info, SDataStatis *pDataStatis, int32_t numOfCols, int32_t numOfRows);
 extern int32_t filterIsIndexedColumnQuery(SFilterInfo* info, int32_t idxId, bool *res);
 extern int32_t filterGetIndexedColumnInfo(SFilterInfo* info, char** val, int32_t *order, int32_t *flag);
 
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_QGROUPHASH_H
+#define TDENGINE_QGROUPHASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+typedef struct SGroupKeyCol {
+  int16_t type;
+  int16_t bytes;
+} SGroupKeyCol;
+
+typedef struct SGroupHashSlot {
+  uint32_t hash;
+  int32_t  group;      // index of the group in pEntries, -1 if the slot is empty
+} SGroupHashSlot;
+
+typedef struct SGroupHashEntry {
+  uint32_t hash;
+  int32_t  keyLen;
+  int64_t  keyOffset;  // offset of the key of the group in pKeyBuf
+  void    *pData;      // aggregate state of the group, set by the caller
+} SGroupHashEntry;
+
+/*
+ * Open addressing hash table of the groups of a group by query. The key of a group is the table group id followed by
+ * the normalized values of the group by columns, the binary/nchar values are kept with their length header. The groups
+ * are numbered in the order they are created, and the rows of a data block are looked up in one batch.
+ */
+typedef struct SGroupHashTable {
+  int32_t          numOfCols;
+  SGroupKeyCol    *pCols;
+  uint32_t         numOfSlots;     // power of 2, more than twice of the number of groups
+  SGroupHashSlot  *pSlots;
+  int32_t          numOfGroups;
+  int32_t          groupCapacity;
+  SGroupHashEntry *pEntries;
+  char            *pKeyBuf;        // keys of all groups
+  int64_t          keyBufLen;
+  int64_t          keyBufCapacity;
+
+  // buffers of the batch lookup of a data block
+  int32_t          rowCapacity;
+  uint32_t        *pRowHash;
+  int32_t         *pRowKeyOffset;  // numOfRows + 1 offsets of the keys of the rows in pRowKeyBuf
+  int32_t         *pRowKeyPos;
+  char            *pRowKeyBuf;
+  int32_t          rowKeyBufCapacity;
+} SGroupHashTable;
+
+#define tGroupHashSize(_t)             ((_t)->numOfGroups)
+#define tGroupHashGetData(_t, _g)      ((_t)->pEntries[(_g)].pData)
+#define tGroupHashSetData(_t, _g, _d)  ((_t)->pEntries[(_g)].pData = (_d))
+
+SGroupHashTable* tGroupHashCreate(const SGroupKeyCol* pCols, int32_t numOfCols);
+
+void* tGroupHashDestroy(SGroupHashTable* pTable);
+
+/**
+ * Find the group of each row, the rows of a new key create a new group with NULL data.
+ * @param pTable
+ * @param tableGroupId  table group that all rows belong to
+ * @param pColData      data of each group by column, in the order of the columns of the table
+ * @param numOfRows
+ * @param pGroupOfRow   group of each row
+ * @return
+ */
+int32_t tGroupHashAssign(SGroupHashTable* pTable, uint64_t tableGroupId, char** pColData, int32_t numOfRows,
+                         int32_t* pGroupOfRow);
+
+/**
+ * The values of the group by columns of a group, without the table group id.
+ */
+const char* tGroupHashGetKey(SGroupHashTable* pTable, int32_t group, int32_t* keyLen);
+
+int64_t tGroupHashMemSize(SGroupHashTable* pTable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_QGROUPHASH_H
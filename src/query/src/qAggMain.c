@@ -556,7 +556,9 @@ static void count_function(SQLFunctionCtx *pCtx) {
   if (pCtx->preAggVals.isSet) {
     numOfElem = pCtx->size - pCtx->preAggVals.statis.numOfNull;
   } else {
-    if (pCtx->hasNull) {
+    if (pCtx->hasNull && pCtx->nullBitmap != NULL) {
+      numOfElem = countNotNullInBitmap(pCtx->nullBitmap, pCtx->startRow, pCtx->size);
+    } else if (pCtx->hasNull) {
       for (int32_t i = 0; i < pCtx->size; ++i) {
         char *val = GET_INPUT_DATA(pCtx, i);
         if (isNull(val, pCtx->inputType)) {
@@ -608,40 +610,54 @@ int32_t countRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
 int32_t noDataRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
   return BLK_DATA_NO_NEEDED;
 }
-#define LIST_ADD_N_DOUBLE_FLOAT(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      SET_DOUBLE_VAL(&(x) , GET_DOUBLE_VAL(&(x)) + GET_FLOAT_VAL(&(d)[i]));                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
-  } while(0)
-#define LIST_ADD_N_DOUBLE(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      SET_DOUBLE_VAL(&(x) , (x) + (d)[i]);                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
-  } while(0)
-
-#define LIST_ADD_N(x, ctx, p, t, numOfElem, tsdbType)              \
-  do {                                                                \
-    t *d = (t *)(p);                                               \
-    for (int32_t i = 0; i < (ctx)->size; ++i) {                    \
-      if (((ctx)->hasNull) && isNull((char *)&(d)[i], tsdbType)) { \
-        continue;                                                  \
-      };                                                           \
-      (x) += (d)[i];                                               \
-      (numOfElem)++;                                               \
-    }                                                              \
-  } while(0)
+
+/*
+ * The rows of a block without null value are summed up with no check on the values, so the loop on the integer
+ * columns can be vectorized. Otherwise the null bitmap of the block, if any, tells the null rows instead of comparing
+ * each value against the null value of the type.
+ */
+#define INPUT_ROW_IS_NULL(ctx, i, val, tsdbType)                                           \
+  ((ctx)->hasNull && (((ctx)->nullBitmap != NULL)                                          \
+                          ? !NULL_BITMAP_NOTNULL((ctx)->nullBitmap, (ctx)->startRow + (i)) \
+                          : isNull((char *)(val), tsdbType)))
+
+#define LIST_ADD_N_IMPL(ctx, p, t, numOfElem, tsdbType, _st, _init, _set)              \
+  do {                                                                                    \
+    t *     d = (t *)(p);                                                                 \
+    _st     _sum = (_init);                                                               \
+    int32_t _size = (ctx)->size;                                                          \
+    if (!(ctx)->hasNull) {                                                                \
+      for (int32_t i = 0; i < _size; ++i) {                                               \
+        _sum += (_st)(d)[i];                                                              \
+      }                                                                                   \
+      (numOfElem) += _size;                                                               \
+    } else if ((ctx)->nullBitmap != NULL) {                                               \
+      const uint8_t *_bm = (ctx)->nullBitmap;                                             \
+      int32_t        _r = (ctx)->startRow;                                                \
+      for (int32_t i = 0; i < _size; ++i) {                                               \
+        if (NULL_BITMAP_NOTNULL(_bm, _r + i)) {                                           \
+          _sum += (_st)(d)[i];                                                            \
+          (numOfElem)++;                                                                  \
+        }                                                                                 \
+      }                                                                                   \
+    } else {                                                                              \
+      for (int32_t i = 0; i < _size; ++i) {                                               \
+        if (isNull((char *)&(d)[i], tsdbType)) {                                          \
+          continue;                                                                       \
+        }                                                                                 \
+        _sum += (_st)(d)[i];                                                              \
+        (numOfElem)++;                                                                    \
+      }                                                                                   \
+    }                                                                                     \
+    _set;                                                                                 \
+  } while (0)
+
+#define LIST_ADD_N_DOUBLE_FLOAT(x, ctx, p, t, numOfElem, tsdbType) \
+  LIST_ADD_N_IMPL(ctx, p, t, numOfElem, tsdbType, double, GET_DOUBLE_VAL(&(x)), SET_DOUBLE_VAL(&(x), _sum))
+#define LIST_ADD_N_DOUBLE(x, ctx, p, t, numOfElem, tsdbType) \
+  LIST_ADD_N_IMPL(ctx, p, t, numOfElem, tsdbType, double, (x), SET_DOUBLE_VAL(&(x), _sum))
+#define LIST_ADD_N(st, x, ctx, p, t, numOfElem, tsdbType) \
+  LIST_ADD_N_IMPL(ctx, p, t, numOfElem, tsdbType, st, (x), (x) = _sum)
 
 #define UPDATE_DATA(ctx, left, right, num, sign, k) \
   do {                                              \
@@ -663,7 +679,7 @@ int32_t noDataRequired(SQLFunctionCtx *pCtx, STimeWindow* w, int32_t colId) {
 
 #define LOOPCHECK_N(val, list, ctx, tsdbType, sign, num)          \
   for (int32_t i = 0; i < ((ctx)->size); ++i) {                   \
-    if ((ctx)->hasNull && isNull((char *)&(list)[i], tsdbType)) { \
+    if (INPUT_ROW_IS_NULL(ctx, i, &(list)[i], tsdbType)) {        \
       continue;                                                   \
     }                                                             \
     TSKEY key = (ctx)->ptsList != NULL? GET_TS_DATA(ctx, i):0;    \
@@ -703,25 +719,25 @@ static void do_sum(SQLFunctionCtx *pCtx) {
       int64_t *retVal = (int64_t *)pCtx->pOutput;
 
       if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(int64_t, *retVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(int64_t, *retVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(int64_t, *retVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(int64_t, *retVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
       }
     } else if (IS_UNSIGNED_NUMERIC_TYPE(pCtx->inputType)) {
       uint64_t *retVal = (uint64_t *)pCtx->pOutput;
 
       if (pCtx->inputType == TSDB_DATA_TYPE_UTINYINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint8_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(uint64_t, *retVal, pCtx, pData, uint8_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_USMALLINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint16_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(uint64_t, *retVal, pCtx, pData, uint16_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_UINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint32_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(uint64_t, *retVal, pCtx, pData, uint32_t, notNullElems, pCtx->inputType);
       } else if (pCtx->inputType == TSDB_DATA_TYPE_UBIGINT) {
-        LIST_ADD_N(*retVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
+        LIST_ADD_N(uint64_t, *retVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
       }
     } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
       double *retVal = (double *)pCtx->pOutput;
@@ -888,25 +904,25 @@ static void avg_function(SQLFunctionCtx *pCtx) {
     void *pData = GET_INPUT_DATA_LIST(pCtx);
 
     if (pCtx->inputType == TSDB_DATA_TYPE_TINYINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(double, *pVal, pCtx, pData, int8_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_SMALLINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(double, *pVal, pCtx, pData, int16_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_INT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(double, *pVal, pCtx, pData, int32_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_BIGINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(double, *pVal, pCtx, pData, int64_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_DOUBLE) {
       LIST_ADD_N_DOUBLE(*pVal, pCtx, pData, double, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_FLOAT) {
       LIST_ADD_N_DOUBLE_FLOAT(*pVal, pCtx, pData, float, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_UTINYINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint8_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(double, *pVal, pCtx, pData, uint8_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_USMALLINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint16_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(double, *pVal, pCtx, pData, uint16_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_UINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint32_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(double, *pVal, pCtx, pData, uint32_t, notNullElems, pCtx->inputType);
     } else if (pCtx->inputType == TSDB_DATA_TYPE_UBIGINT) {
-      LIST_ADD_N(*pVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
+      LIST_ADD_N(double, *pVal, pCtx, pData, uint64_t, notNullElems, pCtx->inputType);
     }
   }
 
@@ -251,14 +251,15 @@ static void doSetOperatorCompleted(SOperatorInfo* pOperator) {
 static int32_t doCopyToSDataBlock(SQueryRuntimeEnv* pRuntimeEnv, SGroupResInfo* pGroupResInfo, int32_t orderType, SSDataBlock* pBlock);
 
 static int32_t getGroupbyColumnIndex(SGroupbyExpr *pGroupbyExpr, SSDataBlock* pDataBlock);
-static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binf, int32_t numOfCols, char *pData, int16_t type, int16_t bytes, int32_t groupIndex);
+static SResultRow* doCreateGroupResultRow(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, char *pData, int16_t type, int32_t groupIndex);
 
 static void initCtxOutputBuffer(SQLFunctionCtx* pCtx, int32_t size);
 static void getAlignQueryTimeWindow(SQueryAttr *pQueryAttr, int64_t key, int64_t keyFirst, int64_t keyLast, STimeWindow *win);
 static void setResultBufSize(SQueryAttr* pQueryAttr, SRspResultInfo* pResultInfo);
 static void setCtxTagForJoin(SQueryRuntimeEnv* pRuntimeEnv, SQLFunctionCtx* pCtx, SExprInfo* pExprInfo, void* pTable);
 static void setParamForStableStddev(SQueryRuntimeEnv* pRuntimeEnv, SQLFunctionCtx* pCtx, int32_t numOfOutput, SExprInfo* pExpr);
-static void setParamForStableStddevByColData(SQueryRuntimeEnv* pRuntimeEnv, SQLFunctionCtx* pCtx, int32_t numOfOutput, SExprInfo* pExpr, char* val, int16_t bytes);
+static void setParamForStableStddevByColData(SQueryRuntimeEnv* pRuntimeEnv, SGroupbyOperatorInfo* pInfo, SQLFunctionCtx* pCtx,
+                                             int32_t numOfOutput, SExprInfo* pExpr, const char* key);
 static void doSetTableGroupOutputBuf(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo,
                                      SQLFunctionCtx* pCtx, int32_t* rowCellInfoOffset, int32_t numOfOutput, int32_t tableGroupId);
 
@@ -267,8 +268,9 @@ SArray* getOrderCheckColumns(SQueryAttr* pQuery);
 
 typedef struct SRowCompSupporter {
   SQueryRuntimeEnv *pRuntimeEnv;
-  int16_t           dataOffset;
-  __compar_fn_t     comFunc;
+  int32_t           numOfCols;  // the order by column, followed by the other group by columns in the results
+  int16_t           dataOffset[TSDB_MAX_TAGS];
+  __compar_fn_t     comFunc[TSDB_MAX_TAGS];
 } SRowCompSupporter;
 
 static int compareRowData(const void *a, const void *b, const void *userData) {
@@ -281,15 +283,46 @@ static int compareRowData(const void *a, const void *b, const void *userData) {
   tFilePage *page1 = getResBufPage(pRuntimeEnv->pResultBuf, pRow1->pageId);
   tFilePage *page2 = getResBufPage(pRuntimeEnv->pResultBuf, pRow2->pageId);
 
-  int16_t offset = supporter->dataOffset;
-  char *in1  = getPosInResultPage(pRuntimeEnv->pQueryAttr, page1, pRow1->offset, offset);
-  char *in2  = getPosInResultPage(pRuntimeEnv->pQueryAttr, page2, pRow2->offset, offset);
+  for (int32_t i = 0; i < supporter->numOfCols; ++i) {
+    int16_t offset = supporter->dataOffset[i];
+    char *in1  = getPosInResultPage(pRuntimeEnv->pQueryAttr, page1, pRow1->offset, offset);
+    char *in2  = getPosInResultPage(pRuntimeEnv->pQueryAttr, page2, pRow2->offset, offset);
 
-  return (in1 != NULL && in2 != NULL) ? supporter->comFunc(in1, in2) : 0;
+    int32_t ret = (in1 != NULL && in2 != NULL) ? supporter->comFunc[i](in1, in2) : 0;
+    if (ret != 0) {
+      return ret;
+    }
+  }
+
+  return 0;
+}
+
+static int32_t getResultColumnIndex(SSDataBlock* pDataBlock, SQLFunctionCtx *pCtx, int32_t colId, int16_t* dataOffset) {
+  int32_t index = -1;
+  for (int32_t j = 0; j < pDataBlock->info.numOfCols; ++j) {
+    if (pCtx[j].colId == colId) {
+      index = j;
+      break;
+    }
+  }
+
+  if (index < 0) {
+    return -1;
+  }
+
+  *dataOffset = 0;
+  for (int32_t j = 0; j < index; ++j) {
+    SColumnInfoData* pColInfoData = (SColumnInfoData *)taosArrayGet(pDataBlock->pDataBlock, j);
+    *dataOffset += pColInfoData->info.bytes;
+  }
+
+  return index;
 }
 
 static void sortGroupResByOrderList(SGroupResInfo *pGroupResInfo, SQueryRuntimeEnv *pRuntimeEnv, SSDataBlock* pDataBlock, SQLFunctionCtx *pCtx) {
-  SArray *columnOrderList = getOrderCheckColumns(pRuntimeEnv->pQueryAttr);
+  SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
+
+  SArray *columnOrderList = getOrderCheckColumns(pQueryAttr);
   size_t size = taosArrayGetSize(columnOrderList);
   taosArrayDestroy(&columnOrderList);
 
@@ -297,41 +330,35 @@ static void sortGroupResByOrderList(SGroupResInfo *pGroupResInfo, SQueryRuntimeE
     return;
   }
 
-  int32_t orderId = pRuntimeEnv->pQueryAttr->order.orderColId;
+  int32_t orderId = pQueryAttr->order.orderColId;
   if (orderId <= 0) {
     return;
   }
 
-  int32_t orderIndex = -1;
-  for (int32_t j = 0; j < pDataBlock->info.numOfCols; ++j) {
-    if (pCtx[j].colId == orderId) {
-      orderIndex = j;
-      break;
-    }
-  }
+  SRowCompSupporter support = {.pRuntimeEnv = pRuntimeEnv, .numOfCols = 0};
+
+  int32_t orderIndex = getResultColumnIndex(pDataBlock, pCtx, orderId, &support.dataOffset[0]);
   if (orderIndex < 0) {
     return;
   }
 
-  bool found = false;
-  int16_t dataOffset = 0;
+  support.comFunc[0] = getComparFunc(pQueryAttr->pExpr1[orderIndex].base.resType, 0);
+  support.numOfCols = 1;
 
-  for (int32_t j = 0; j < pDataBlock->info.numOfCols; ++j) {
-    SColumnInfoData* pColInfoData = (SColumnInfoData *)taosArrayGet(pDataBlock->pDataBlock, j);
-    if (orderIndex == j) {
-      found = true;
-      break;
+  // the groups with the same value of the order by column are ordered by the other group by columns
+  SGroupbyExpr* pGroupbyExpr = pQueryAttr->pGroupbyExpr;
+  for (int32_t i = 0; pGroupbyExpr != NULL && i < pGroupbyExpr->numOfGroupCols && support.numOfCols < TSDB_MAX_TAGS; ++i) {
+    SColIndex* pColIndex = taosArrayGet(pGroupbyExpr->columnInfo, i);
+    if (TSDB_COL_IS_TAG(pColIndex->flag) || pColIndex->colId == orderId) {
+      continue;
     }
 
-    dataOffset += pColInfoData->info.bytes;
-  }
-
-  if (found == false) {
-    return;
+    int32_t index = getResultColumnIndex(pDataBlock, pCtx, pColIndex->colId, &support.dataOffset[support.numOfCols]);
+    if (index >= 0) {
+      support.comFunc[support.numOfCols++] = getComparFunc(pQueryAttr->pExpr1[index].base.resType, 0);
+    }
   }
 
-  int16_t type = pRuntimeEnv->pQueryAttr->pExpr1[orderIndex].base.resType;
-  SRowCompSupporter support = {.pRuntimeEnv = pRuntimeEnv, .dataOffset = dataOffset, .comFunc = getComparFunc(type, 0)};
   taosArraySortPWithExt(pGroupResInfo->pRows, compareRowData, &support);
 }
 
@@ -462,7 +489,7 @@ static bool isProjQuery(SQueryAttr *pQueryAttr) {
   return true;
 }
 
-static bool hasNull(SColIndex* pColIndex, SDataStatis *pStatis) {
+static bool hasNull(SColIndex* pColIndex, SDataStatis *pStatis, SColumnInfoData* pColInfo) {
   if (TSDB_COL_IS_TAG(pColIndex->flag) || TSDB_COL_IS_UD_COL(pColIndex->flag) || pColIndex->colId == PRIMARYKEY_TIMESTAMP_COL_INDEX) {
     return false;
   }
@@ -471,6 +498,10 @@ static bool hasNull(SColIndex* pColIndex, SDataStatis *pStatis) {
     return false;
   }
 
+  if (pColInfo != NULL && COL_HAS_NULL_BITMAP(pColInfo) && pColInfo->numOfNull == 0) {
+    return false;
+  }
+
   return true;
 }
 
@@ -962,6 +993,7 @@ static void doApplyFunctions(SQueryRuntimeEnv* pRuntimeEnv, SQLFunctionCtx* pCtx
     int32_t pos = (QUERY_IS_ASC_QUERY(pQueryAttr)) ? offset : offset - (forwardStep - 1);
     if (pCtx[k].pInput != NULL) {
       pCtx[k].pInput = (char *)pCtx[k].pInput + pos * pCtx[k].inputBytes;
+      pCtx[k].startRow = pos;
     }
 
     if (tsCol != NULL) {
@@ -989,6 +1021,7 @@ static void doApplyFunctions(SQueryRuntimeEnv* pRuntimeEnv, SQLFunctionCtx* pCtx
     // restore it
     pCtx[k].preAggVals.isSet = hasAggregates;
     pCtx[k].pInput = start;
+    pCtx[k].startRow = 0;
   }
 }
 
@@ -1575,83 +1608,273 @@ static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResul
   updateResultRowInfoActiveIndex(pResultRowInfo, pQueryAttr, pRuntimeEnv->current->lastKey);
 }
 
-static void doHashGroupbyAgg(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pInfo, SSDataBlock *pSDataBlock) {
-  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
-  STableQueryInfo*  item = pRuntimeEnv->current;
+static void doEnsureGroupbyBuf(SQueryRuntimeEnv* pRuntimeEnv, SGroupbyOperatorInfo *pInfo, int32_t numOfRows) {
+  if (numOfRows > pInfo->rowCapacity) {
+    int32_t** pBuf[] = {&pInfo->pGroupOfRow, &pInfo->pRowIndex, &pInfo->pBlockGroup, &pInfo->pGroupStart, &pInfo->pGroupRows};
 
-  SColumnInfoData* pColInfoData = taosArrayGet(pSDataBlock->pDataBlock, pInfo->colIndex);
+    for (int32_t i = 0; i < tListLen(pBuf); ++i) {
+      int32_t* p = realloc(*pBuf[i], numOfRows * sizeof(int32_t));
+      if (p == NULL) {
+        longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+      }
 
-  SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
-  int16_t     bytes = pColInfoData->info.bytes;
-  int16_t     type = pColInfoData->info.type;
+      *pBuf[i] = p;
+    }
 
-  if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
-    qError("QInfo:0x%"PRIx64" group by not supported on double/float columns, abort", GET_QID(pRuntimeEnv));
-    return;
+    pInfo->rowCapacity = numOfRows;
   }
+}
 
-  SColumnInfoData* pFirstColData = taosArrayGet(pSDataBlock->pDataBlock, 0);
-  int64_t* tsList = (pFirstColData->info.type == TSDB_DATA_TYPE_TIMESTAMP)? (int64_t*) pFirstColData->pData:NULL;
+static void doEnsureGroupSeqBuf(SQueryRuntimeEnv* pRuntimeEnv, SGroupbyOperatorInfo *pInfo) {
+  int32_t numOfGroups = tGroupHashSize(pInfo->pGroupHash);
+  if (numOfGroups > pInfo->groupSeqCapacity) {
+    int32_t capacity = MAX(numOfGroups, pInfo->groupSeqCapacity * 2);
 
-  STimeWindow w = TSWINDOW_INITIALIZER;
+    int32_t* p = realloc(pInfo->pGroupSeq, capacity * sizeof(int32_t));
+    if (p == NULL) {
+      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+    }
 
-  int32_t num = 0;
-  for (int32_t j = 0; j < pSDataBlock->info.rows; ++j) {
-    char* val = ((char*)pColInfoData->pData) + bytes * j;
+    for (int32_t i = pInfo->groupSeqCapacity; i < capacity; ++i) {
+      p[i] = -1;
+    }
 
-    // Compare with the previous row of this column, and do not set the output buffer again if they are identical.
-    if (pInfo->prevData == NULL) {
-      pInfo->prevData = malloc(bytes);
-      memcpy(pInfo->prevData, val, bytes);
-      num++;
-      continue;
+    pInfo->pGroupSeq = p;
+    pInfo->groupSeqCapacity = capacity;
+  }
+}
+
+#define GATHER_ROWS(_dst, _src, _type, _index, _rows) \
+  do {                                                \
+    const _type *_s = (const _type *)(_src);          \
+    _type       *_d = (_type *)(_dst);                \
+    for (int32_t _i = 0; _i < (_rows); ++_i) {        \
+      _d[_i] = _s[(_index)[_i]];                      \
+    }                                                 \
+  } while (0)
+
+static SSDataBlock* doPrepareGatherBlock(SQueryRuntimeEnv* pRuntimeEnv, SGroupbyOperatorInfo *pInfo, SSDataBlock *pSDataBlock) {
+  int32_t numOfCols = (int32_t) taosArrayGetSize(pSDataBlock->pDataBlock);
+  int32_t numOfRows = pSDataBlock->info.rows;
+
+  if (pInfo->pGatherBlock == NULL) {
+    pInfo->pGatherBlock = calloc(1, sizeof(SSDataBlock));
+    if (pInfo->pGatherBlock == NULL) {
+      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
     }
 
-    if (IS_VAR_DATA_TYPE(type)) {
-      int32_t len = varDataLen(val);
-      if(len == varDataLen(pInfo->prevData) && memcmp(varDataVal(pInfo->prevData), varDataVal(val), len) == 0) {
-        num++;
-        continue;
+    pInfo->pGatherBlock->pDataBlock = taosArrayInit(numOfCols, sizeof(SColumnInfoData));
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      SColumnInfoData* pSrc = taosArrayGet(pSDataBlock->pDataBlock, i);
+      SColumnInfoData  idata = {.info = pSrc->info, .numOfNull = -1};
+      taosArrayPush(pInfo->pGatherBlock->pDataBlock, &idata);
+    }
+  }
+
+  SSDataBlock* pBlock = pInfo->pGatherBlock;
+  if (numOfRows > pInfo->gatherCapacity) {
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+
+      char* p = realloc(pCol->pData, (size_t) pCol->info.bytes * numOfRows);
+      if (p == NULL) {
+        longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
       }
-    } else {
-      if (memcmp(pInfo->prevData, val, bytes) == 0) {
-        num++;
-        continue;
+      pCol->pData = p;
+
+      if (!IS_VAR_DATA_TYPE(pCol->info.type)) {
+        uint8_t* pBitmap = realloc(pCol->nullBitmap, NULL_BITMAP_BYTES(numOfRows));
+        if (pBitmap == NULL) {
+          longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+        }
+        pCol->nullBitmap = pBitmap;
       }
     }
 
-    if (pQueryAttr->stableQuery && pQueryAttr->stabledev && (pRuntimeEnv->prevResult != NULL)) {
-      setParamForStableStddevByColData(pRuntimeEnv, pInfo->binfo.pCtx, pOperator->numOfOutput, pOperator->pExpr, pInfo->prevData, bytes);
+    pInfo->gatherCapacity = numOfRows;
+  }
+
+  return pBlock;
+}
+
+// copy the rows of the block into the gather block, in the order of pRowIndex
+static void doGatherGroupRows(SQueryRuntimeEnv* pRuntimeEnv, SGroupbyOperatorInfo *pInfo, SSDataBlock *pSDataBlock) {
+  SSDataBlock* pBlock = doPrepareGatherBlock(pRuntimeEnv, pInfo, pSDataBlock);
+
+  int32_t  numOfRows = pSDataBlock->info.rows;
+  int32_t* pRowIndex = pInfo->pRowIndex;
+
+  // the statistics of the block are kept, the rows are the same ones
+  pBlock->info         = pSDataBlock->info;
+  pBlock->pBlockStatis = pSDataBlock->pBlockStatis;
+
+  for (int32_t i = 0; i < pBlock->info.numOfCols; ++i) {
+    SColumnInfoData* pSrc = taosArrayGet(pSDataBlock->pDataBlock, i);
+    SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, i);
+    int16_t          bytes = pSrc->info.bytes;
+
+    assert(pSrc->info.colId == pDst->info.colId && bytes == pDst->info.bytes);
+
+    if (IS_VAR_DATA_TYPE(pSrc->info.type)) {
+      for (int32_t j = 0; j < numOfRows; ++j) {
+        char* val = pSrc->pData + (int64_t) bytes * pRowIndex[j];
+        memcpy(pDst->pData + (int64_t) bytes * j, val, varDataTLen(val));
+      }
+
+      continue;
     }
 
-    int32_t ret = setGroupResultOutputBuf(pRuntimeEnv, &(pInfo->binfo), pOperator->numOfOutput, pInfo->prevData, type, bytes, item->groupIndex);
-    if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_APP_ERROR);
+    switch (bytes) {
+      case sizeof(int8_t):  GATHER_ROWS(pDst->pData, pSrc->pData, int8_t, pRowIndex, numOfRows);  break;
+      case sizeof(int16_t): GATHER_ROWS(pDst->pData, pSrc->pData, int16_t, pRowIndex, numOfRows); break;
+      case sizeof(int32_t): GATHER_ROWS(pDst->pData, pSrc->pData, int32_t, pRowIndex, numOfRows); break;
+      case sizeof(int64_t): GATHER_ROWS(pDst->pData, pSrc->pData, int64_t, pRowIndex, numOfRows); break;
+      default:
+        for (int32_t j = 0; j < numOfRows; ++j) {
+          memcpy(pDst->pData + (int64_t) bytes * j, pSrc->pData + (int64_t) bytes * pRowIndex[j], bytes);
+        }
+        break;
+    }
+
+    if (COL_HAS_NULL_BITMAP(pSrc)) {
+      pDst->numOfNull = buildNullBitmap(pDst->pData, pDst->info.type, numOfRows, pDst->nullBitmap);
+    } else {
+      pDst->numOfNull = -1;
     }
+  }
+}
+
+static void* destroyGatherBlock(SSDataBlock* pBlock) {
+  if (pBlock == NULL) {
+    return NULL;
+  }
+
+  size_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
+    tfree(pColInfoData->pData);
+    tfree(pColInfoData->nullBitmap);
+  }
+
+  // the block statistics belong to the input data block
+  taosArrayDestroy(&pBlock->pDataBlock);
+  tfree(pBlock);
+  return NULL;
+}
 
-    doApplyFunctions(pRuntimeEnv, pInfo->binfo.pCtx, &w, j - num, num, tsList, pSDataBlock->info.rows, pOperator->numOfOutput);
+static void doApplyGroupFunctions(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pInfo, int32_t group, int32_t start,
+                                  int32_t num, TSKEY* tsList, int32_t numOfRows) {
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  SQueryAttr*       pQueryAttr = pRuntimeEnv->pQueryAttr;
+  SResultRow*       pResultRow = tGroupHashGetData(pInfo->pGroupHash, group);
 
-    num = 1;
-    memcpy(pInfo->prevData, val, bytes);
+  if (pQueryAttr->stableQuery && pQueryAttr->stabledev && (pRuntimeEnv->prevResult != NULL)) {
+    int32_t     keyLen = 0;
+    const char* key = tGroupHashGetKey(pInfo->pGroupHash, group, &keyLen);
+    setParamForStableStddevByColData(pRuntimeEnv, pInfo, pInfo->binfo.pCtx, pOperator->numOfOutput, pOperator->pExpr, key);
   }
 
-  if (num > 0) {
-    char* val = ((char*)pColInfoData->pData) + bytes * (pSDataBlock->info.rows - num);
-    memcpy(pInfo->prevData, val, bytes);
+  setResultOutputBuf(pRuntimeEnv, pResultRow, pInfo->binfo.pCtx, pOperator->numOfOutput, pInfo->binfo.rowCellInfoOffset);
+  initCtxOutputBuffer(pInfo->binfo.pCtx, pOperator->numOfOutput);
 
-    if (pQueryAttr->stableQuery && pQueryAttr->stabledev && (pRuntimeEnv->prevResult != NULL)) {
-      setParamForStableStddevByColData(pRuntimeEnv, pInfo->binfo.pCtx, pOperator->numOfOutput, pOperator->pExpr, val, bytes);
+  STimeWindow w = TSWINDOW_INITIALIZER;
+  doApplyFunctions(pRuntimeEnv, pInfo->binfo.pCtx, &w, start, num, tsList, numOfRows, pOperator->numOfOutput);
+}
+
+/*
+ * The rows of a block are assigned to their groups in one batch by the group hash table. If the rows of each group are
+ * adjacent, the functions are applied on the runs of the block. Otherwise the rows are gathered by group into another
+ * block, so that the functions are applied once for each group of the block.
+ */
+static void doHashGroupbyAgg(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pInfo, SSDataBlock *pSDataBlock) {
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  STableQueryInfo*  item = pRuntimeEnv->current;
+  int32_t           numOfRows = pSDataBlock->info.rows;
+
+  if (numOfRows <= 0) {
+    return;
+  }
+
+  for (int32_t k = 0; k < pInfo->numOfGroupCols; ++k) {
+    SColumnInfoData* pColInfoData = taosArrayGet(pSDataBlock->pDataBlock, pInfo->colIndex[k]);
+    pInfo->pColData[k] = pColInfoData->pData;
+  }
+
+  doEnsureGroupbyBuf(pRuntimeEnv, pInfo, numOfRows);
+
+  int32_t code = tGroupHashAssign(pInfo->pGroupHash, item->groupIndex, pInfo->pColData, numOfRows, pInfo->pGroupOfRow);
+  if (code != TSDB_CODE_SUCCESS) {
+    longjmp(pRuntimeEnv->env, code);
+  }
+
+  doEnsureGroupSeqBuf(pRuntimeEnv, pInfo);
+
+  // the key of the result row is the value of the first group by column
+  SColumnInfoData* pKeyColData = taosArrayGet(pSDataBlock->pDataBlock, pInfo->colIndex[0]);
+
+  int32_t* pGroupOfRow = pInfo->pGroupOfRow;
+  int32_t  numOfGroups = 0;
+  int32_t  numOfRuns = 0;
+  for (int32_t j = 0; j < numOfRows; ++j) {
+    int32_t group = pGroupOfRow[j];
+    if (j == 0 || group != pGroupOfRow[j - 1]) {
+      numOfRuns += 1;
     }
 
-    int32_t ret = setGroupResultOutputBuf(pRuntimeEnv, &(pInfo->binfo), pOperator->numOfOutput, val, type, bytes, item->groupIndex);
-    if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_APP_ERROR);
+    int32_t seq = pInfo->pGroupSeq[group];
+    if (seq < 0) {
+      seq = numOfGroups++;
+      pInfo->pGroupSeq[group] = seq;
+      pInfo->pBlockGroup[seq] = group;
+      pInfo->pGroupRows[seq] = 0;
+
+      if (tGroupHashGetData(pInfo->pGroupHash, group) == NULL) {
+        char*       val = pKeyColData->pData + (int64_t) pKeyColData->info.bytes * j;
+        SResultRow* pResultRow = doCreateGroupResultRow(pRuntimeEnv, &pInfo->binfo, val, pKeyColData->info.type, item->groupIndex);
+        tGroupHashSetData(pInfo->pGroupHash, group, pResultRow);
+      }
     }
 
-    doApplyFunctions(pRuntimeEnv, pInfo->binfo.pCtx, &w, pSDataBlock->info.rows - num, num, tsList, pSDataBlock->info.rows, pOperator->numOfOutput);
+    pInfo->pGroupRows[seq] += 1;
   }
 
-  tfree(pInfo->prevData);
+  if (numOfRuns == numOfGroups) {
+    SColumnInfoData* pFirstColData = taosArrayGet(pSDataBlock->pDataBlock, 0);
+    int64_t* tsList = (pFirstColData->info.type == TSDB_DATA_TYPE_TIMESTAMP)? (int64_t*) pFirstColData->pData:NULL;
+
+    int32_t start = 0;
+    for (int32_t i = 0; i < numOfGroups; ++i) {
+      doApplyGroupFunctions(pOperator, pInfo, pInfo->pBlockGroup[i], start, pInfo->pGroupRows[i], tsList, numOfRows);
+      start += pInfo->pGroupRows[i];
+    }
+  } else {
+    int32_t start = 0;
+    for (int32_t i = 0; i < numOfGroups; ++i) {
+      pInfo->pGroupStart[i] = start;
+      start += pInfo->pGroupRows[i];
+    }
+
+    // the rows of a group are kept in their original order
+    for (int32_t j = 0; j < numOfRows; ++j) {
+      int32_t seq = pInfo->pGroupSeq[pGroupOfRow[j]];
+      pInfo->pRowIndex[pInfo->pGroupStart[seq]++] = j;
+    }
+
+    doGatherGroupRows(pRuntimeEnv, pInfo, pSDataBlock);
+    setInputDataBlock(pOperator, pInfo->binfo.pCtx, pInfo->pGatherBlock, pRuntimeEnv->pQueryAttr->order.order);
+
+    SColumnInfoData* pFirstColData = taosArrayGet(pInfo->pGatherBlock->pDataBlock, 0);
+    int64_t* tsList = (pFirstColData->info.type == TSDB_DATA_TYPE_TIMESTAMP)? (int64_t*) pFirstColData->pData:NULL;
+
+    for (int32_t i = 0; i < numOfGroups; ++i) {
+      int32_t num = pInfo->pGroupRows[i];
+      doApplyGroupFunctions(pOperator, pInfo, pInfo->pBlockGroup[i], pInfo->pGroupStart[i] - num, num, tsList, numOfRows);
+    }
+  }
+
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    pInfo->pGroupSeq[pInfo->pBlockGroup[i]] = -1;
+  }
 }
 
 static void doSessionWindowAggImpl(SOperatorInfo* pOperator, SSWindowOperatorInfo *pInfo, SSDataBlock *pSDataBlock) {
@@ -1740,36 +1963,78 @@ static void setResultRowKey(SResultRow* pResultRow, char* pData, int16_t type) {
   }
 }
 
-static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, int32_t numOfCols, char *pData, int16_t type, int16_t bytes, int32_t groupIndex) {
-  SDiskbasedResultBuf *pResultBuf = pRuntimeEnv->pResultBuf;
-
-  int32_t        *rowCellInfoOffset = binfo->rowCellInfoOffset;
-  SResultRowInfo *pResultRowInfo    = &binfo->resultRowInfo;
-  SQLFunctionCtx *pCtx              = binfo->pCtx;
+static SResultRow* doCreateGroupResultRow(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, char *pData, int16_t type, int32_t groupIndex) {
+  SResultRowInfo *pResultRowInfo = &binfo->resultRowInfo;
+  prepareResultListBuffer(pResultRowInfo, pRuntimeEnv);
 
-  // not assign result buffer yet, add new result buffer, TODO remove it
-  char* d = pData;
-  int16_t len = bytes;
-  if (IS_VAR_DATA_TYPE(type)) {
-    d = varDataVal(pData);
-    len = varDataLen(pData);
+  SResultRow *pResultRow = getNewResultRow(pRuntimeEnv->pool);
+  int32_t ret = initResultRow(pResultRow);
+  if (ret != TSDB_CODE_SUCCESS) {
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
   }
 
-  int64_t tid = 0;
-  SResultRow *pResultRow = doSetResultOutBufByKey(pRuntimeEnv, pResultRowInfo, tid, d, len, true, groupIndex);
-  assert (pResultRow != NULL);
+  SResultRowCell cell = {.groupId = groupIndex, .pRow = pResultRow};
+  taosArrayPush(pRuntimeEnv->pResultRowArrayList, &cell);
+
+  pResultRowInfo->curPos = pResultRowInfo->size;
+  pResultRowInfo->pResult[pResultRowInfo->size++] = pResultRow;
+
+  // too many groups in query
+  if (pResultRowInfo->size > MAX_INTERVAL_TIME_WINDOW) {
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_TOO_MANY_TIMEWINDOW);
+  }
 
   setResultRowKey(pResultRow, pData, type);
-  if (pResultRow->pageId == -1) {
-    int32_t ret = addNewWindowResultBuf(pResultRow, pResultBuf, groupIndex, pRuntimeEnv->pQueryAttr->resultRowSize);
-    if (ret != 0) {
-      return -1;
+
+  // the states of the groups are kept in the pages of the result buffer, which are flushed to disk if there are too many
+  ret = addNewWindowResultBuf(pResultRow, pRuntimeEnv->pResultBuf, groupIndex, pRuntimeEnv->pQueryAttr->resultRowSize);
+  if (ret != 0) {  // null data, too many state code
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_APP_ERROR);
+  }
+
+  return pResultRow;
+}
+
+static void doInitGroupbyColumns(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pInfo, SSDataBlock* pDataBlock) {
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  SGroupbyExpr*     pGroupbyExpr = pRuntimeEnv->pQueryAttr->pGroupbyExpr;
+
+  SGroupKeyCol* pKeyCols = calloc(pGroupbyExpr->numOfGroupCols, sizeof(SGroupKeyCol));
+  pInfo->colIndex = calloc(pGroupbyExpr->numOfGroupCols, sizeof(int32_t));
+  pInfo->pColData = calloc(pGroupbyExpr->numOfGroupCols, POINTER_BYTES);
+  if (pKeyCols == NULL || pInfo->colIndex == NULL || pInfo->pColData == NULL) {
+    tfree(pKeyCols);
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+  }
+
+  int32_t numOfCols = 0;
+  for (int32_t k = 0; k < pGroupbyExpr->numOfGroupCols; ++k) {
+    SColIndex* pColIndex = taosArrayGet(pGroupbyExpr->columnInfo, k);
+    if (TSDB_COL_IS_TAG(pColIndex->flag)) {
+      continue;
+    }
+
+    for (int32_t i = 0; i < pDataBlock->info.numOfCols; ++i) {
+      SColumnInfoData* pColInfo = taosArrayGet(pDataBlock->pDataBlock, i);
+      if (pColInfo->info.colId == pColIndex->colId) {
+        pInfo->colIndex[numOfCols] = i;
+        pKeyCols[numOfCols].type  = pColInfo->info.type;
+        pKeyCols[numOfCols].bytes = pColInfo->info.bytes;
+        numOfCols += 1;
+        break;
+      }
     }
   }
 
-  setResultOutputBuf(pRuntimeEnv, pResultRow, pCtx, numOfCols, rowCellInfoOffset);
-  initCtxOutputBuffer(pCtx, numOfCols);
-  return TSDB_CODE_SUCCESS;
+  assert(numOfCols > 0);
+  pInfo->numOfGroupCols = numOfCols;
+
+  pInfo->pGroupHash = tGroupHashCreate(pKeyCols, numOfCols);
+  tfree(pKeyCols);
+
+  if (pInfo->pGroupHash == NULL) {
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+  }
 }
 
 static int32_t getGroupbyColumnIndex(SGroupbyExpr *pGroupbyExpr, SSDataBlock* pDataBlock) {
@@ -1838,7 +2103,19 @@ void setBlockStatisInfo(SQLFunctionCtx *pCtx, SSDataBlock* pSDataBlock, SColInde
     pCtx->preAggVals.isSet = false;
   }
 
-  pCtx->hasNull = hasNull(pColIndex, pStatis);
+  // the null bitmap of the column is used if the block statistics are not loaded, or not valid after filtering
+  SColumnInfoData* pColInfo = NULL;
+  if (pSDataBlock->pDataBlock != NULL && TSDB_COL_IS_NORMAL_COL(pColIndex->flag) &&
+      pColIndex->colIndex < taosArrayGetSize(pSDataBlock->pDataBlock)) {
+    pColInfo = taosArrayGet(pSDataBlock->pDataBlock, pColIndex->colIndex);
+    if (pColInfo->info.colId != pColIndex->colId) {
+      pColInfo = NULL;
+    }
+  }
+
+  pCtx->nullBitmap = (pColInfo != NULL && COL_HAS_NULL_BITMAP(pColInfo)) ? pColInfo->nullBitmap : NULL;
+  pCtx->startRow   = 0;
+  pCtx->hasNull    = hasNull(pColIndex, pStatis, pColInfo);
 
   // set the statistics data for primary time stamp column
   if ((pCtx->functionId == TSDB_FUNC_SPREAD || pCtx->functionId == TSDB_FUNC_ELAPSED) && pColIndex->colId == PRIMARYKEY_TIMESTAMP_COL_INDEX) {
@@ -2017,6 +2294,41 @@ static void* destroySQLFunctionCtx(SQLFunctionCtx* pCtx, int32_t numOfOutput) {
   return NULL;
 }
 
+// the columns of the filter are worth loading ahead only if some other columns are left to load
+static SArray* getFilterColumnIds(SQueryAttr* pQueryAttr) {
+  if (pQueryAttr->pFilters == NULL) {
+    return NULL;
+  }
+
+  SArray* pColIds = taosArrayInit(4, sizeof(int16_t));
+  if (pColIds == NULL || filterGetColumnIds(pQueryAttr->pFilters, pColIds) != TSDB_CODE_SUCCESS) {
+    taosArrayDestroy(&pColIds);
+    return NULL;
+  }
+
+  int32_t numOfCols = 1;  // the primary timestamp column is always loaded
+  for (int32_t i = 0; i < taosArrayGetSize(pColIds); ++i) {
+    int16_t colId = *(int16_t*)taosArrayGet(pColIds, i);
+    int32_t j = 0;
+    while (j < pQueryAttr->numOfCols && pQueryAttr->tableCols[j].colId != colId) {
+      ++j;
+    }
+
+    if (j >= pQueryAttr->numOfCols) {  // not a column of the table, e.g. a json tag
+      taosArrayDestroy(&pColIds);
+      return NULL;
+    }
+
+    numOfCols += (colId != PRIMARYKEY_TIMESTAMP_COL_INDEX);
+  }
+
+  if (numOfCols >= pQueryAttr->numOfCols) {
+    taosArrayDestroy(&pColIds);
+  }
+
+  return pColIds;
+}
+
 static int32_t setupQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv, int32_t numOfTables, SArray* pOperator, void* merger) {
   qDebug("QInfo:0x%"PRIx64" setup runtime env", GET_QID(pRuntimeEnv));
   SQueryAttr *pQueryAttr = pRuntimeEnv->pQueryAttr;
@@ -2037,6 +2349,7 @@ static int32_t setupQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv, int32_t numOf
   pRuntimeEnv->pTableRetrieveTsMap = taosHashInit(numOfTables, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, HASH_NO_LOCK);
 
   pRuntimeEnv->sasArray = calloc(pQueryAttr->numOfOutput, sizeof(SScalarExprSupport));
+  pRuntimeEnv->pFilterColIds = getFilterColumnIds(pQueryAttr);
 
   if (pRuntimeEnv->sasArray == NULL || pRuntimeEnv->pResultRowHashTable == NULL || pRuntimeEnv->keyBuf == NULL ||
       pRuntimeEnv->prevRow == NULL  || pRuntimeEnv->tagVal == NULL) {
@@ -2287,6 +2600,7 @@ static void teardownQueryRuntimeEnv(SQueryRuntimeEnv *pRuntimeEnv) {
   destroyTsComp(pRuntimeEnv, pQueryAttr);
 
   pRuntimeEnv->pTsBuf = tsBufDestroy(pRuntimeEnv->pTsBuf);
+  taosArrayDestroy(&pRuntimeEnv->pFilterColIds);
 
   tfree(pRuntimeEnv->keyBuf);
   tfree(pRuntimeEnv->prevRow);
@@ -2852,6 +3166,15 @@ void doCompactSDataBlock(SSDataBlock* pBlock, int32_t numOfRows, int8_t* p) {
   pBlock->info.rows = start;
   pBlock->pBlockStatis = NULL;  // clean the block statistics info
 
+  // the null bitmaps take the place of the statistics to tell the columns without null value in the rows left
+  for (int32_t i = 0; i < pBlock->info.numOfCols; ++i) {
+    SColumnInfoData* pColumnInfoData = taosArrayGet(pBlock->pDataBlock, i);
+    if (COL_HAS_NULL_BITMAP(pColumnInfoData)) {
+      pColumnInfoData->numOfNull =
+          buildNullBitmap(pColumnInfoData->pData, pColumnInfoData->info.type, start, pColumnInfoData->nullBitmap);
+    }
+  }
+
   if (start > 0) {
     SColumnInfoData* pColumnInfoData = taosArrayGet(pBlock->pDataBlock, 0);
     if (pColumnInfoData->info.type == TSDB_DATA_TYPE_TIMESTAMP &&
@@ -2961,6 +3284,43 @@ void filterColRowsInDataBlock(SQueryRuntimeEnv* pRuntimeEnv, SSDataBlock* pBlock
 
                            
 
+// the data block holds the columns of the filter only, load the others if any row is left by the filter
+static int32_t filterAndLoadDataBlock(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTableScanInfo, SSDataBlock* pBlock) {
+  SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
+  int32_t     numOfRows = pBlock->info.rows;
+  int8_t*     p = NULL;
+
+  bool all = filterExecute(pQueryAttr->pFilters, numOfRows, &p, pBlock->pBlockStatis, pQueryAttr->numOfCols);
+
+  bool qualified = all;
+  for (int32_t i = 0; i < numOfRows && !qualified && p != NULL; ++i) {
+    qualified = (p[i] != 0);
+  }
+
+  if (!qualified) {
+    SQInfo* pQInfo = pRuntimeEnv->qinfo;
+    pQInfo->summary.filterOutBlocks += 1;
+
+    pBlock->info.rows = 0;
+    pBlock->pBlockStatis = NULL;  // clean the block statistics info
+    tfree(p);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pBlock->pDataBlock = tsdbRetrieveDataBlock(pTableScanInfo->pQueryHandle, NULL);
+  if (pBlock->pDataBlock == NULL) {
+    tfree(p);
+    return terrno;
+  }
+
+  if (!all) {
+    doCompactSDataBlock(pBlock, numOfRows, p);
+  }
+
+  tfree(p);
+  return TSDB_CODE_SUCCESS;
+}
+
 static SColumnInfo* doGetTagColumnInfoById(SColumnInfo* pTagColList, int32_t numOfTags, int16_t colId);
 static void doSetTagValueInParam(void* pTable, char* param, int32_t paraLen, int32_t tagColId,  tVariant *tag, int16_t type, int16_t bytes);
 
@@ -3017,6 +3377,9 @@ FORCE_INLINE int32_t getColumnDataFromId(void *param, int32_t id, void **data) {
   return TSDB_CODE_SUCCESS;
 }
 
+static bool getColumnDictFromId(void *param, int16_t colId, SColumnDict *pDict) {
+  return tsdbRetrieveDataBlockDict(param, colId, pDict);
+}
 
 int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTableScanInfo, SSDataBlock* pBlock,
                               uint32_t* status) {
@@ -3060,11 +3423,24 @@ int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTa
 
   // Calculate all time windows that are overlapping or contain current data block.
   // If current data block is contained by all possible time window, do not load current data block.
-  if (pQueryAttr->pFilters || pQueryAttr->groupbyColumn || pQueryAttr->sw.gap > 0 ||
+  if (pQueryAttr->groupbyColumn || pQueryAttr->sw.gap > 0 ||
       (QUERY_IS_INTERVAL_QUERY(pQueryAttr) && overlapWithTimeWindow(pQueryAttr, &pBlock->info))) {
     (*status) = BLK_DATA_ALL_NEEDED;
   }
 
+  // If the block statistics show that all rows meet the filter, the block is aggregated the same way as the one of
+  // a query without filter, by its statistics if the functions allow.
+  bool statisLoaded = false;
+  if ((*status) != BLK_DATA_ALL_NEEDED && pQueryAttr->pFilters != NULL) {
+    pCost->loadBlockStatis += 1;
+    tsdbRetrieveDataBlockStatisInfo(pTableScanInfo->pQueryHandle, &pBlock->pBlockStatis);
+    statisLoaded = true;
+
+    if (!filterRangeAllPass(pQueryAttr->pFilters, pBlock->pBlockStatis, pQueryAttr->numOfCols, pBlock->info.rows)) {
+      (*status) = BLK_DATA_ALL_NEEDED;
+    }
+  }
+
   // check if this data block is required to load
   if ((*status) != BLK_DATA_ALL_NEEDED) {
     // the pCtx[i] result is belonged to previous time window since the outputBuf has not been set yet,
@@ -3097,10 +3473,13 @@ int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTa
     qDebug("QInfo:0x%"PRIx64" data block discard, brange:%" PRId64 "-%" PRId64 ", rows:%d", pQInfo->qId, pBlockInfo->window.skey,
            pBlockInfo->window.ekey, pBlockInfo->rows);
     pCost->discardBlocks += 1;
+    pBlock->pBlockStatis = NULL;
   } else if ((*status) == BLK_DATA_STATIS_NEEDED) {
     // this function never returns error?
-    pCost->loadBlockStatis += 1;
-    tsdbRetrieveDataBlockStatisInfo(pTableScanInfo->pQueryHandle, &pBlock->pBlockStatis);
+    if (!statisLoaded) {
+      pCost->loadBlockStatis += 1;
+      tsdbRetrieveDataBlockStatisInfo(pTableScanInfo->pQueryHandle, &pBlock->pBlockStatis);
+    }
 
     if (pBlock->pBlockStatis == NULL) {  // data block statistics does not exist, load data block
       pBlock->pDataBlock = tsdbRetrieveDataBlock(pTableScanInfo->pQueryHandle, NULL);
@@ -3110,8 +3489,10 @@ int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTa
     assert((*status) == BLK_DATA_ALL_NEEDED);
 
     // load the data block statistics to perform further filter
-    pCost->loadBlockStatis += 1;
-    tsdbRetrieveDataBlockStatisInfo(pTableScanInfo->pQueryHandle, &pBlock->pBlockStatis);
+    if (!statisLoaded) {
+      pCost->loadBlockStatis += 1;
+      tsdbRetrieveDataBlockStatisInfo(pTableScanInfo->pQueryHandle, &pBlock->pBlockStatis);
+    }
 
     if (pQueryAttr->topBotQuery && pBlock->pBlockStatis != NULL) {
       { // set previous window
@@ -3157,7 +3538,10 @@ int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTa
 
     pCost->totalCheckedRows += pBlockInfo->rows;
     pCost->loadBlocks += 1;
-    pBlock->pDataBlock = tsdbRetrieveDataBlock(pTableScanInfo->pQueryHandle, NULL);
+
+    // load the columns of the filter only, the other ones are loaded after the filter leaves any rows
+    SArray* pFilterColIds = (pRuntimeEnv->pTsBuf == NULL) ? pRuntimeEnv->pFilterColIds : NULL;
+    pBlock->pDataBlock = tsdbRetrieveDataBlock(pTableScanInfo->pQueryHandle, pFilterColIds);
     if (pBlock->pDataBlock == NULL) {
       return terrno;
     }
@@ -3165,9 +3549,12 @@ int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTa
     if (pQueryAttr->pFilters != NULL) {
       SColumnDataParam param = {.numOfCols = pBlock->info.numOfCols, .pDataBlock = pBlock->pDataBlock};
       filterSetColFieldData(pQueryAttr->pFilters, &param, getColumnDataFromId);
+      filterSetColFieldDict(pQueryAttr->pFilters, pTableScanInfo->pQueryHandle, getColumnDictFromId);
     }
-    
-    if (pQueryAttr->pFilters != NULL || pRuntimeEnv->pTsBuf != NULL) {
+
+    if (pFilterColIds != NULL) {
+      return filterAndLoadDataBlock(pRuntimeEnv, pTableScanInfo, pBlock);
+    } else if (pQueryAttr->pFilters != NULL || pRuntimeEnv->pTsBuf != NULL) {
       filterColRowsInDataBlock(pRuntimeEnv, pBlock, ascQuery);
     }
   }
@@ -4045,7 +4432,114 @@ void setParamForStableStddev(SQueryRuntimeEnv* pRuntimeEnv, SQLFunctionCtx* pCtx
 
 }
 
-void setParamForStableStddevByColData(SQueryRuntimeEnv* pRuntimeEnv, SQLFunctionCtx* pCtx, int32_t numOfOutput, SExprInfo* pExpr, char* val, int16_t bytes) {
+// value of the group by column colId in the key of a group, NULL if colId is not a group by column
+static const char* getGroupKeyColVal(SQueryAttr* pQueryAttr, SGroupbyOperatorInfo* pInfo, const char* key, int16_t colId,
+                                     int16_t* type) {
+  SGroupbyExpr* pGroupbyExpr = pQueryAttr->pGroupbyExpr;
+  SGroupKeyCol* pCols = pInfo->pGroupHash->pCols;
+
+  int32_t k = 0;
+  for (int32_t i = 0; i < pGroupbyExpr->numOfGroupCols && k < pInfo->numOfGroupCols; ++i) {
+    SColIndex* pColIndex = taosArrayGet(pGroupbyExpr->columnInfo, i);
+    if (TSDB_COL_IS_TAG(pColIndex->flag)) {
+      continue;
+    }
+
+    if (pColIndex->colId == colId) {
+      *type = pCols[k].type;
+      return key;
+    }
+
+    key += IS_VAR_DATA_TYPE(pCols[k].type)? varDataTLen(key) : pCols[k].bytes;
+    k += 1;
+  }
+
+  return NULL;
+}
+
+// the client keeps a binary/nchar value without its length header, padded by zero to the bytes of the column
+static bool isStddevGroupColValEqual(const char* p, const char* val, int16_t type, int16_t bytes) {
+  if (IS_VAR_DATA_TYPE(type)) {
+    if (isNull(val, type)) {
+      return memcmp(p, val, varDataTLen(val)) == 0;
+    }
+
+    int32_t len = varDataLen(val);
+    if (memcmp(p, varDataVal(val), len) != 0) {
+      return false;
+    }
+
+    for (int32_t i = len; i < bytes; ++i) {
+      if (p[i] != 0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  if (memcmp(p, val, tDataTypes[type].bytes) == 0) {
+    return true;
+  }
+
+  // +0.0 and -0.0 are the same group in the key
+  if (type == TSDB_DATA_TYPE_FLOAT) {
+    return GET_FLOAT_VAL(p) == 0 && GET_FLOAT_VAL(val) == 0;
+  } else if (type == TSDB_DATA_TYPE_DOUBLE) {
+    return GET_DOUBLE_VAL(p) == 0 && GET_DOUBLE_VAL(val) == 0;
+  }
+
+  return false;
+}
+
+/*
+ * The client keeps the tags and the group by columns of a group of the first round in the order of the select list,
+ * each one in the bytes of its result column. The key of a group has the values of the group by columns in the order
+ * of the group by clause, so the values are compared one by one.
+ */
+static bool isStddevInterResultOfGroup(SQueryRuntimeEnv* pRuntimeEnv, SGroupbyOperatorInfo* pInfo, SExprInfo* pExpr,
+                                       int32_t numOfExprs, const char* tags, const char* key) {
+  if (tags == NULL) {
+    return true;
+  }
+
+  int32_t offset = 0;
+  int32_t tagOffset = 0;
+  for (int32_t i = 0; i < numOfExprs; ++i) {
+    SSqlExpr* pExpr1 = &pExpr[i].base;
+
+    if (TSDB_COL_IS_TAG(pExpr1->colInfo.flag)) {
+      if (memcmp(tags + offset, pRuntimeEnv->tagVal + tagOffset, pExpr1->resBytes) != 0) {
+        return false;
+      }
+
+      tagOffset += pExpr1->resBytes;
+      offset += pExpr1->resBytes;
+      continue;
+    }
+
+    if (pExpr1->functionId != TSDB_FUNC_PRJ) {
+      continue;
+    }
+
+    int16_t     type = 0;
+    const char* val = getGroupKeyColVal(pRuntimeEnv->pQueryAttr, pInfo, key, pExpr1->colInfo.colId, &type);
+    if (val == NULL) {
+      continue;
+    }
+
+    if (!isStddevGroupColValEqual(tags + offset, val, type, pExpr1->resBytes)) {
+      return false;
+    }
+
+    offset += pExpr1->resBytes;
+  }
+
+  return true;
+}
+
+void setParamForStableStddevByColData(SQueryRuntimeEnv* pRuntimeEnv, SGroupbyOperatorInfo* pInfo, SQLFunctionCtx* pCtx,
+                                      int32_t numOfOutput, SExprInfo* pExpr, const char* key) {
   SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
 
   int32_t numOfExprs = pQueryAttr->numOfOutput;
@@ -4062,7 +4556,7 @@ void setParamForStableStddevByColData(SQueryRuntimeEnv* pRuntimeEnv, SQLFunction
     int32_t numOfGroup = (int32_t)taosArrayGetSize(pRuntimeEnv->prevResult);
     for (int32_t j = 0; j < numOfGroup; ++j) {
       SInterResult* p = taosArrayGet(pRuntimeEnv->prevResult, j);
-      if (bytes == 0 || memcmp(p->tags, val, bytes) == 0) {
+      if (isStddevInterResultOfGroup(pRuntimeEnv, pInfo, pExpr, numOfExprs, p->tags, key)) {
         int32_t numOfCols = (int32_t)taosArrayGetSize(p->pResult);
         for (int32_t k = 0; k < numOfCols; ++k) {
           SStddevInterResult* pres = taosArrayGet(p->pResult, k);
@@ -4428,6 +4922,9 @@ void queryCostStatis(SQInfo *pQInfo) {
   hashSize += taosHashGetMemSize(pRuntimeEnv->tableqinfoGroupInfo.map);
   pSummary->hashSize = hashSize;
 
+  memset(&pSummary->readCost, 0, sizeof(pSummary->readCost));
+  tsdbGetReadCost(pRuntimeEnv->pQueryHandle, &pSummary->readCost);
+
   // add the merge time
   pSummary->elapsedTime += pSummary->firstStageMergeTime;
 
@@ -4443,9 +4940,17 @@ void queryCostStatis(SQInfo *pQInfo) {
   calculateOperatorProfResults(pQInfo);
 
   qDebug("QInfo:0x%"PRIx64" :cost summary: elapsed time:%"PRId64" us, first merge:%"PRId64" us, total blocks:%d, "
-         "load block statis:%d, load data block:%d, total rows:%"PRId64 ", check rows:%"PRId64,
+         "load block statis:%d, load data block:%d, filter out block:%d, total rows:%"PRId64 ", check rows:%"PRId64,
          pQInfo->qId, pSummary->elapsedTime, pSummary->firstStageMergeTime, pSummary->totalBlocks, pSummary->loadBlockStatis,
-         pSummary->loadBlocks, pSummary->totalRows, pSummary->totalCheckedRows);
+         pSummary->loadBlocks, pSummary->filterOutBlocks, pSummary->totalRows, pSummary->totalCheckedRows);
+
+  STsdbReadCost* pReadCost = &pSummary->readCost;
+  qDebug("QInfo:0x%"PRIx64" :cost summary: column reads:%d, read size:%.2f Kb, read time:%"PRId64" us, "
+         "parallel decode blocks:%d, cols:%d, decode time:%"PRId64" us, bloom filter out blocks:%d, "
+         "mapped cols:%d",
+         pQInfo->qId, pReadCost->numOfReads, pReadCost->readSize / 1024.0, pReadCost->readTime,
+         pReadCost->numOfDecodeBlocks, pReadCost->numOfDecodeCols, pReadCost->decodeTime,
+         pReadCost->numOfBloomSkipBlocks, pReadCost->numOfMappedCols);
 
   qDebug("QInfo:0x%"PRIx64" :cost summary: winResPool size:%.2f Kb, numOfWin:%"PRId64", tableInfoSize:%.2f Kb, hashTable:%.2f Kb", pQInfo->qId, pSummary->winInfoSize/1024.0,
       pSummary->numOfTimeWindows, pSummary->tableInfoSize/1024.0, pSummary->hashSize/1024.0);
@@ -4760,6 +5265,16 @@ static int32_t setupQueryHandle(void* tsdb, SQueryRuntimeEnv* pRuntimeEnv, int64
     pRuntimeEnv->pQueryHandle = tsdbQueryRowsInExternalWindow(tsdb, &cond, &pQueryAttr->tableGroupInfo, qId, &pQueryAttr->memRef);
   } else {
     pRuntimeEnv->pQueryHandle = tsdbQueryTables(tsdb, &cond, &pQueryAttr->tableGroupInfo, qId, &pQueryAttr->memRef);
+
+    // the equal conditions of the filter skip file blocks by their bloom filters, the rows skipped by the offset are
+    // counted on the unfiltered blocks
+    if (pRuntimeEnv->pQueryHandle != NULL && pQueryAttr->pFilters != NULL && cond.offset == 0) {
+      SArray* pConds = taosArrayInit(4, sizeof(SColumnEqualCond));
+      if (pConds != NULL && filterGetEqualConds(pQueryAttr->pFilters, pConds) == TSDB_CODE_SUCCESS) {
+        tsdbSetQueryEqualConds(pRuntimeEnv->pQueryHandle, pConds);
+      }
+      taosArrayDestroy(&pConds);
+    }
   }
 
   return terrno;
@@ -5895,6 +6410,7 @@ static SSDataBlock* doLimit(void* param, bool* newgroup) {
 
         int16_t bytes = pColInfoData->info.bytes;
         memmove(pColInfoData->pData, pColInfoData->pData + skip * bytes, remain * bytes);
+        pColInfoData->numOfNull = -1;
       }
 
       pRuntimeEnv->currentOffset = 0;
@@ -6792,8 +7308,8 @@ static SSDataBlock* hashGroupbyAggregate(void* param, bool* newgroup) {
     // the pDataBlock are always the same one, no need to call this again
     setInputDataBlock(pOperator, pInfo->binfo.pCtx, pBlock, pRuntimeEnv->pQueryAttr->order.order);
     setTagValue(pOperator, pRuntimeEnv->current->pTable, pInfo->binfo.pCtx, pOperator->numOfOutput);
-    if (pInfo->colIndex == -1) {
-      pInfo->colIndex = getGroupbyColumnIndex(pRuntimeEnv->pQueryAttr->pGroupbyExpr, pBlock);
+    if (pInfo->pGroupHash == NULL) {
+      doInitGroupbyColumns(pOperator, pInfo, pBlock);
     }
 
     doHashGroupbyAgg(pOperator, pInfo, pBlock);
@@ -7028,7 +7544,16 @@ static void destroySFillOperatorInfo(void* param, int32_t numOfOutput) {
 static void destroyGroupbyOperatorInfo(void* param, int32_t numOfOutput) {
   SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*) param;
   doDestroyBasicInfo(&pInfo->binfo, numOfOutput);
-  tfree(pInfo->prevData);
+  pInfo->pGroupHash = tGroupHashDestroy(pInfo->pGroupHash);
+  pInfo->pGatherBlock = destroyGatherBlock(pInfo->pGatherBlock);
+  tfree(pInfo->colIndex);
+  tfree(pInfo->pColData);
+  tfree(pInfo->pGroupOfRow);
+  tfree(pInfo->pRowIndex);
+  tfree(pInfo->pBlockGroup);
+  tfree(pInfo->pGroupStart);
+  tfree(pInfo->pGroupRows);
+  tfree(pInfo->pGroupSeq);
 }
 
 static void destroyProjectOperatorInfo(void* param, int32_t numOfOutput) {
@@ -7333,8 +7858,6 @@ SOperatorInfo* createMultiTableTimeIntervalOperatorInfo(SQueryRuntimeEnv* pRunti
 
 SOperatorInfo* createGroupbyOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, SOperatorInfo* upstream, SExprInfo* pExpr, int32_t numOfOutput) {
   SGroupbyOperatorInfo* pInfo = calloc(1, sizeof(SGroupbyOperatorInfo));
-  pInfo->colIndex = -1;  // group by column index
-
 
   pInfo->binfo.pCtx = createSQLFunctionCtx(pRuntimeEnv, pExpr, numOfOutput, &pInfo->binfo.rowCellInfoOffset);
 
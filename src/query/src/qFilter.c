@@ -1790,6 +1790,14 @@ void filterFreeInfo(SFilterInfo *info) {
 
   tfree(info->unitFlags);
 
+  tfree(info->colDict);
+
+  tfree(info->dictRes);
+
+  tfree(info->vecRes);
+
+  tfree(info->vecUnits);
+
   for (uint32_t i = 0; i < info->colRangeNum; ++i) {
     filterFreeRangeCtx(info->colRange[i]);
   }
@@ -2639,6 +2647,7 @@ int32_t filterGenerateComInfo(SFilterInfo *info) {
     info->cunits[i].rfunc = filterGetRangeCompFuncFromOptrs(unit->compare.optr, unit->compare.optr2);
     info->cunits[i].optr = FILTER_UNIT_OPTR(unit);
     info->cunits[i].colData = NULL;
+    info->cunits[i].dict = NULL;
     info->cunits[i].colId = FILTER_UNIT_COL_ID(info, unit);
     
     if (unit->right.type == FLD_TYPE_VALUE) {
@@ -2748,13 +2757,18 @@ int32_t filterRmUnitByRange(SFilterInfo *info, SDataStatis *pDataStatis, int32_t
 
     bool minRes = false, maxRes = false;
 
+    // the null values never meet a comparison, all rows meet the unit only if the column has no null value
+    bool hasNull = (pDataStatis[index].numOfNull > 0);
+
     if (cunit->rfunc >= 0) {
       minRes = (*gRangeCompare[cunit->rfunc])(minVal, minVal, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
       maxRes = (*gRangeCompare[cunit->rfunc])(maxVal, maxVal, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
 
       if (minRes && maxRes) {
-        info->blkUnitRes[k] = 1;
-        rmUnit = 1;
+        if (!hasNull) {
+          info->blkUnitRes[k] = 1;
+          rmUnit = 1;
+        }
       } else if ((!minRes) && (!maxRes)) {
         minRes = filterDoCompare(gDataCompare[cunit->func], TSDB_RELATION_LESS_EQUAL, minVal, cunit->valData);
         maxRes = filterDoCompare(gDataCompare[cunit->func], TSDB_RELATION_GREATER_EQUAL, maxVal, cunit->valData2);
@@ -2771,8 +2785,10 @@ int32_t filterRmUnitByRange(SFilterInfo *info, SDataStatis *pDataStatis, int32_t
       maxRes = filterDoCompare(gDataCompare[cunit->func], cunit->optr, maxVal, cunit->valData);
 
       if (minRes && maxRes) {
-        info->blkUnitRes[k] = 1;
-        rmUnit = 1;
+        if (!hasNull) {
+          info->blkUnitRes[k] = 1;
+          rmUnit = 1;
+        }
       } else if ((!minRes) && (!maxRes)) {
         if (cunit->optr == TSDB_RELATION_EQUAL) {
           minRes = filterDoCompare(gDataCompare[cunit->func], TSDB_RELATION_GREATER, minVal, cunit->valData);
@@ -2851,6 +2867,239 @@ _return:
   return TSDB_CODE_SUCCESS;
 }
 
+// the batch kernels evaluate a unit on a numeric column for all the rows of a block, setting res[i] to 0 or 1 in a
+// branch free loop of the column type that the compiler vectorizes
+typedef void (*filter_vec_func)(SFilterComUnit *, int32_t, int8_t *);
+
+enum {
+  FILTER_VEC_EQUAL = 8,  // after the range functions of gRangeCompare
+  FILTER_VEC_NOT_EQUAL,
+};
+
+// the range function of the unit, or FILTER_VEC_EQUAL or FILTER_VEC_NOT_EQUAL
+static FORCE_INLINE int32_t filterVecOp(SFilterComUnit *cunit) {
+  if (cunit->rfunc >= 0) {
+    return cunit->rfunc;
+  }
+
+  return (cunit->optr == TSDB_RELATION_EQUAL) ? FILTER_VEC_EQUAL : FILTER_VEC_NOT_EQUAL;
+}
+
+#define FILTER_VEC_LOOP(_cond)                                                                      \
+  do {                                                                                              \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                       \
+      res[i] = (_cond);                                                                             \
+    }                                                                                               \
+  } while (0)
+
+#define FILTER_VEC_INT_FUNC(_name, _type)                                                           \
+  static void _name(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {                        \
+    const _type *v = (const _type *)cunit->colData;                                                 \
+    _type        c = *(_type *)cunit->valData;                                                      \
+    _type        c2 = *(_type *)cunit->valData2;                                                    \
+                                                                                                    \
+    switch (filterVecOp(cunit)) {                                                                   \
+      case 0: FILTER_VEC_LOOP((v[i] > c) & (v[i] < c2)); break;                                     \
+      case 1: FILTER_VEC_LOOP((v[i] > c) & (v[i] <= c2)); break;                                    \
+      case 2: FILTER_VEC_LOOP((v[i] >= c) & (v[i] < c2)); break;                                    \
+      case 3: FILTER_VEC_LOOP((v[i] >= c) & (v[i] <= c2)); break;                                   \
+      case 4: FILTER_VEC_LOOP(v[i] > c); break;                                                     \
+      case 5: FILTER_VEC_LOOP(v[i] >= c); break;                                                    \
+      case 6: FILTER_VEC_LOOP(v[i] < c2); break;                                                    \
+      case 7: FILTER_VEC_LOOP(v[i] <= c2); break;                                                   \
+      case FILTER_VEC_EQUAL: FILTER_VEC_LOOP(v[i] == c); break;                                     \
+      default: FILTER_VEC_LOOP(v[i] != c); break;                                                   \
+    }                                                                                               \
+  }
+
+// same tolerance as compareFloatVal and compareDoubleVal, a NaN is less than any value
+#define FILTER_VEC_FEQ(_abs, _v, _c) (_abs((_v) - (_c)) <= tol)
+#define FILTER_VEC_FGT(_abs, _v, _c) (((_v) > (_c)) & !FILTER_VEC_FEQ(_abs, _v, _c))
+#define FILTER_VEC_FGE(_abs, _v, _c) (((_v) > (_c)) | FILTER_VEC_FEQ(_abs, _v, _c))
+
+#define FILTER_VEC_FLOAT_FUNC(_name, _type, _abs)                                                   \
+  static void _name(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {                        \
+    const _type *v = (const _type *)cunit->colData;                                                 \
+    _type        c = *(_type *)cunit->valData;                                                      \
+    _type        c2 = *(_type *)cunit->valData2;                                                    \
+    const _type  tol = FLT_COMPAR_TOL_FACTOR * FLT_EPSILON;                                         \
+                                                                                                    \
+    switch (filterVecOp(cunit)) {                                                                   \
+      case 0: FILTER_VEC_LOOP(FILTER_VEC_FGT(_abs, v[i], c) & !FILTER_VEC_FGE(_abs, v[i], c2)); break; \
+      case 1: FILTER_VEC_LOOP(FILTER_VEC_FGT(_abs, v[i], c) & !FILTER_VEC_FGT(_abs, v[i], c2)); break; \
+      case 2: FILTER_VEC_LOOP(FILTER_VEC_FGE(_abs, v[i], c) & !FILTER_VEC_FGE(_abs, v[i], c2)); break; \
+      case 3: FILTER_VEC_LOOP(FILTER_VEC_FGE(_abs, v[i], c) & !FILTER_VEC_FGT(_abs, v[i], c2)); break; \
+      case 4: FILTER_VEC_LOOP(FILTER_VEC_FGT(_abs, v[i], c)); break;                                \
+      case 5: FILTER_VEC_LOOP(FILTER_VEC_FGE(_abs, v[i], c)); break;                                \
+      case 6: FILTER_VEC_LOOP(!FILTER_VEC_FGE(_abs, v[i], c2)); break;                              \
+      case 7: FILTER_VEC_LOOP(!FILTER_VEC_FGT(_abs, v[i], c2)); break;                              \
+      case FILTER_VEC_EQUAL: FILTER_VEC_LOOP(FILTER_VEC_FEQ(_abs, v[i], c)); break;                 \
+      default: FILTER_VEC_LOOP(!FILTER_VEC_FEQ(_abs, v[i], c)); break;                              \
+    }                                                                                               \
+  }
+
+FILTER_VEC_INT_FUNC(filterVecCompareInt8, int8_t)
+FILTER_VEC_INT_FUNC(filterVecCompareInt16, int16_t)
+FILTER_VEC_INT_FUNC(filterVecCompareInt32, int32_t)
+FILTER_VEC_INT_FUNC(filterVecCompareInt64, int64_t)
+FILTER_VEC_INT_FUNC(filterVecCompareUint8, uint8_t)
+FILTER_VEC_INT_FUNC(filterVecCompareUint16, uint16_t)
+FILTER_VEC_INT_FUNC(filterVecCompareUint32, uint32_t)
+FILTER_VEC_INT_FUNC(filterVecCompareUint64, uint64_t)
+FILTER_VEC_FLOAT_FUNC(filterVecCompareFloat, float, fabsf)
+FILTER_VEC_FLOAT_FUNC(filterVecCompareDouble, double, fabs)
+
+static filter_vec_func filterGetVecFunc(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:   return filterVecCompareInt8;
+    case TSDB_DATA_TYPE_SMALLINT:  return filterVecCompareInt16;
+    case TSDB_DATA_TYPE_INT:       return filterVecCompareInt32;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP: return filterVecCompareInt64;
+    case TSDB_DATA_TYPE_UTINYINT:  return filterVecCompareUint8;
+    case TSDB_DATA_TYPE_USMALLINT: return filterVecCompareUint16;
+    case TSDB_DATA_TYPE_UINT:      return filterVecCompareUint32;
+    case TSDB_DATA_TYPE_UBIGINT:   return filterVecCompareUint64;
+    case TSDB_DATA_TYPE_FLOAT:     return filterVecCompareFloat;
+    case TSDB_DATA_TYPE_DOUBLE:    return filterVecCompareDouble;
+    default:                       return NULL;
+  }
+}
+
+static bool filterVecUnitSupported(SFilterComUnit *cunit) {
+  if (filterGetVecFunc(cunit->dataType) == NULL) {
+    return false;
+  }
+
+  return cunit->optr == TSDB_RELATION_ISNULL || cunit->optr == TSDB_RELATION_NOTNULL || cunit->rfunc >= 0 ||
+         cunit->optr == TSDB_RELATION_EQUAL || cunit->optr == TSDB_RELATION_NOT_EQUAL;
+}
+
+#define FILTER_VEC_NULL_LOOP(_type, _stmt)                              \
+  do {                                                                  \
+    const _type *v = (const _type *)cunit->colData;                     \
+    _type        n = *(const _type *)getNullValue(cunit->dataType);     \
+    for (int32_t i = 0; i < numOfRows; ++i) {                           \
+      _stmt;                                                            \
+    }                                                                   \
+  } while (0)
+
+// null values are compared by their bits, as in isNull
+static void filterVecIsNull(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {
+  switch (cunit->dataSize) {
+    case sizeof(uint8_t):  FILTER_VEC_NULL_LOOP(uint8_t, res[i] = (v[i] == n)); break;
+    case sizeof(uint16_t): FILTER_VEC_NULL_LOOP(uint16_t, res[i] = (v[i] == n)); break;
+    case sizeof(uint32_t): FILTER_VEC_NULL_LOOP(uint32_t, res[i] = (v[i] == n)); break;
+    default:               FILTER_VEC_NULL_LOOP(uint64_t, res[i] = (v[i] == n)); break;
+  }
+}
+
+static void filterVecClearNull(SFilterComUnit *cunit, int32_t numOfRows, int8_t *res) {
+  switch (cunit->dataSize) {
+    case sizeof(uint8_t):  FILTER_VEC_NULL_LOOP(uint8_t, res[i] &= (v[i] != n)); break;
+    case sizeof(uint16_t): FILTER_VEC_NULL_LOOP(uint16_t, res[i] &= (v[i] != n)); break;
+    case sizeof(uint32_t): FILTER_VEC_NULL_LOOP(uint32_t, res[i] &= (v[i] != n)); break;
+    default:               FILTER_VEC_NULL_LOOP(uint64_t, res[i] &= (v[i] != n)); break;
+  }
+}
+
+// a column without block statistics may have null values
+static bool filterVecMayHaveNull(SFilterComUnit *cunit, SDataStatis *statis, int16_t numOfCols) {
+  for (int32_t i = 0; statis != NULL && i < numOfCols; ++i) {
+    if (statis[i].colId == cunit->colId) {
+      return statis[i].numOfNull > 0;
+    }
+  }
+
+  return true;
+}
+
+static void filterVecExecuteUnit(SFilterComUnit *cunit, int32_t numOfRows, SDataStatis *statis, int16_t numOfCols, int8_t *res) {
+  uint8_t optr = cunit->optr;
+
+  if (cunit->colData == NULL) {
+    memset(res, optr == TSDB_RELATION_ISNULL, numOfRows);
+    return;
+  }
+
+  bool hasNull = filterVecMayHaveNull(cunit, statis, numOfCols);
+
+  if (optr == TSDB_RELATION_ISNULL || optr == TSDB_RELATION_NOTNULL) {
+    if (!hasNull) {
+      memset(res, optr == TSDB_RELATION_NOTNULL, numOfRows);
+      return;
+    }
+
+    filterVecIsNull(cunit, numOfRows, res);
+    if (optr == TSDB_RELATION_NOTNULL) {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        res[i] ^= 1;
+      }
+    }
+    return;
+  }
+
+  (*filterGetVecFunc(cunit->dataType))(cunit, numOfRows, res);
+
+  if (hasNull) {
+    filterVecClearNull(cunit, numOfRows, res);
+  }
+}
+
+static bool filterVecPrepare(SFilterInfo *info, int32_t numOfRows, int8_t **p) {
+  if (info->vecRows < numOfRows) {
+    int8_t *vecRes = realloc(info->vecRes, (size_t)numOfRows * 2);
+    if (vecRes == NULL) {
+      return false;
+    }
+
+    info->vecRes = vecRes;
+    info->vecRows = numOfRows;
+  }
+
+  if (*p == NULL) {
+    *p = malloc(numOfRows);
+  }
+
+  return *p != NULL;
+}
+
+// the units of a group are ANDed and the groups are ORed byte by byte, unitIdx lists the groups as blkUnits does
+static bool filterVecExecuteGroups(SFilterInfo *info, uint32_t groupNum, uint32_t *unitIdx, int32_t numOfRows, int8_t *p,
+                                   SDataStatis *statis, int16_t numOfCols) {
+  int8_t *gres = info->vecRes;
+  int8_t *ures = info->vecRes + numOfRows;
+
+  for (uint32_t g = 0; g < groupNum; ++g) {
+    uint32_t unitNum = *(unitIdx++);
+    int8_t  *res = (g == 0) ? p : gres;
+
+    filterVecExecuteUnit(&info->cunits[unitIdx[0]], numOfRows, statis, numOfCols, res);
+    for (uint32_t u = 1; u < unitNum; ++u) {
+      filterVecExecuteUnit(&info->cunits[unitIdx[u]], numOfRows, statis, numOfCols, ures);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        res[i] &= ures[i];
+      }
+    }
+
+    if (g > 0) {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        p[i] |= gres[i];
+      }
+    }
+
+    unitIdx += unitNum;
+  }
+
+  int8_t all = 1;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    all &= p[i];
+  }
+
+  return all;
+}
+
 bool filterExecuteBasedOnStatisImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
   bool all = true;
@@ -2932,7 +3181,11 @@ int32_t filterExecuteBasedOnStatis(SFilterInfo *info, int32_t numOfRows, int8_t*
 
       assert(info->unitNum > 1);
       
-      *all = filterExecuteBasedOnStatisImpl(info, numOfRows, p, statis, numOfCols);
+      if (info->vecUnits != NULL && filterVecPrepare(info, numOfRows, p)) {
+        *all = filterVecExecuteGroups(info, info->blkGroupNum, info->blkUnits, numOfRows, *p, statis, numOfCols);
+      } else {
+        *all = filterExecuteBasedOnStatisImpl(info, numOfRows, p, statis, numOfCols);
+      }
 
       goto _return;
     }
@@ -3148,6 +3401,41 @@ bool filterExecuteImplMisc(void *pinfo, int32_t numOfRows, int8_t** p, SDataStat
   return all;
 }
 
+static FORCE_INLINE int8_t filterExecuteUnit(SFilterComUnit *cunit, void *colData) {
+  int8_t  res = 0;
+  uint8_t optr = cunit->optr;
+
+  if (colData == NULL || isNull(colData, cunit->dataType)) {
+    return optr == TSDB_RELATION_ISNULL ? true : false;
+  }
+
+  if (optr == TSDB_RELATION_NOTNULL) {
+    res = 1;
+  } else if (optr == TSDB_RELATION_ISNULL) {
+    res = 0;
+  } else if (cunit->rfunc >= 0) {
+    res = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
+  } else {
+    if(cunit->dataType == TSDB_DATA_TYPE_NCHAR && (cunit->optr == TSDB_RELATION_MATCH || cunit->optr == TSDB_RELATION_NMATCH)){
+      char *newColData = calloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
+      int32_t len = taosUcs4ToMbs(varDataVal(colData), varDataLen(colData), varDataVal(newColData));
+      if (len < 0){
+        qError("castConvert1 taosUcs4ToMbs error");
+      }else{
+        varDataSetLen(newColData, len);
+        res = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
+      }
+      tfree(newColData);
+    }else if(cunit->dataType == TSDB_DATA_TYPE_JSON){
+      doJsonCompare(cunit, &res, colData);
+    }else{
+      res = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
+    }
+  }
+
+  return res;
+}
+
 bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
   SFilterInfo *info = (SFilterInfo *)pinfo;
   bool all = true;
@@ -3170,41 +3458,7 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *
         SFilterComUnit *cunit = &info->cunits[uidx];
         void *colData = (char *)cunit->colData + cunit->dataSize * i;
       
-        //if (FILTER_UNIT_GET_F(info, uidx)) {
-        //  p[i] = FILTER_UNIT_GET_R(info, uidx);
-        //} else {
-          uint8_t optr = cunit->optr;
-
-          if (colData == NULL || isNull(colData, cunit->dataType)) {
-            (*p)[i] = optr == TSDB_RELATION_ISNULL ? true : false;
-          } else {
-            if (optr == TSDB_RELATION_NOTNULL) {
-              (*p)[i] = 1;
-            } else if (optr == TSDB_RELATION_ISNULL) {
-              (*p)[i] = 0;
-            } else if (cunit->rfunc >= 0) {
-              (*p)[i] = (*gRangeCompare[cunit->rfunc])(colData, colData, cunit->valData, cunit->valData2, gDataCompare[cunit->func]);
-            } else {
-              if(cunit->dataType == TSDB_DATA_TYPE_NCHAR && (cunit->optr == TSDB_RELATION_MATCH || cunit->optr == TSDB_RELATION_NMATCH)){
-                char *newColData = calloc(cunit->dataSize * TSDB_NCHAR_SIZE + VARSTR_HEADER_SIZE, 1);
-                int32_t len = taosUcs4ToMbs(varDataVal(colData), varDataLen(colData), varDataVal(newColData));
-                if (len < 0){
-                  qError("castConvert1 taosUcs4ToMbs error");
-                }else{
-                  varDataSetLen(newColData, len);
-                  (*p)[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, newColData, cunit->valData);
-                }
-                tfree(newColData);
-              }else if(cunit->dataType == TSDB_DATA_TYPE_JSON){
-                doJsonCompare(cunit, &(*p)[i], colData);
-              }else{
-                (*p)[i] = filterDoCompare(gDataCompare[cunit->func], cunit->optr, colData, cunit->valData);
-              }
-            }
-          
-          //FILTER_UNIT_SET_R(info, uidx, p[i]);
-          //FILTER_UNIT_SET_F(info, uidx);
-          }
+        (*p)[i] = filterExecuteUnit(cunit, colData);
 
         if ((*p)[i] == 0) {
           break;
@@ -3224,11 +3478,123 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *
   return all;
 }
 
+static bool filterExecuteImplVec(void *pinfo, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  bool all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, p, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  if (!filterVecPrepare(info, numOfRows, p)) {
+    return filterExecuteImpl(info, numOfRows, p, statis, numOfCols);
+  }
+
+  return filterVecExecuteGroups(info, info->groupNum, info->vecUnits, numOfRows, *p, statis, numOfCols);
+}
+
+// units on dictionary columns are evaluated once per distinct value, and rows just pick the result of their entry
+static bool filterExecuteImplDict(SFilterInfo *info, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
+  bool all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, p, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  for (uint32_t u = 0; u < info->unitNum; ++u) {
+    SFilterComUnit *cunit = &info->cunits[u];
+    if (cunit->dict == NULL) {
+      continue;
+    }
+
+    if (cunit->dict->numOfRows != numOfRows) {
+      cunit->dict = NULL;
+      continue;
+    }
+
+    int8_t *res = info->dictRes + u * FILTER_DICT_MAX_ENTRIES;
+    char   *entry = cunit->dict->pEntries;
+    for (int32_t e = 0; e < cunit->dict->numOfEntries; ++e) {
+      res[e] = filterExecuteUnit(cunit, entry);
+      entry += varDataTLen(entry);
+    }
+  }
+
+  if (*p == NULL) {
+    *p = calloc(numOfRows, sizeof(int8_t));
+  }
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    for (uint32_t g = 0; g < info->groupNum; ++g) {
+      SFilterGroup *group = &info->groups[g];
+      for (uint32_t u = 0; u < group->unitNum; ++u) {
+        uint32_t uidx = group->unitIdxs[u];
+        SFilterComUnit *cunit = &info->cunits[uidx];
+
+        if (cunit->dict) {
+          (*p)[i] = info->dictRes[uidx * FILTER_DICT_MAX_ENTRIES + cunit->dict->codes[i]];
+        } else {
+          (*p)[i] = filterExecuteUnit(cunit, (char *)cunit->colData + cunit->dataSize * i);
+        }
+
+        if ((*p)[i] == 0) {
+          break;
+        }
+      }
+
+      if ((*p)[i]) {
+        break;
+      }
+    }
+
+    if ((*p)[i] == 0) {
+      all = false;
+    }
+  }
+
+  return all;
+}
+
 
 FORCE_INLINE bool filterExecute(SFilterInfo *info, int32_t numOfRows, int8_t** p, SDataStatis *statis, int16_t numOfCols) {
+  if (info->dictUnitNum > 0) {
+    return filterExecuteImplDict(info, numOfRows, p, statis, numOfCols);
+  }
+
   return (*info->func)(info, numOfRows, p, statis, numOfCols);
 }
 
+// the batch kernels are used when all the units have one
+static int32_t filterSetVecUnits(SFilterInfo *info) {
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    if (!filterVecUnitSupported(&info->cunits[i])) {
+      return TSDB_CODE_QRY_APP_ERROR;
+    }
+  }
+
+  uint32_t num = info->groupNum;
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    num += info->groups[g].unitNum;
+  }
+
+  uint32_t *unitIdx = malloc(sizeof(*unitIdx) * num);
+  if (unitIdx == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  tfree(info->vecUnits);
+  info->vecUnits = unitIdx;
+
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup *group = &info->groups[g];
+    *(unitIdx++) = group->unitNum;
+    memcpy(unitIdx, group->unitIdxs, sizeof(*unitIdx) * group->unitNum);
+    unitIdx += group->unitNum;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t filterSetExecFunc(SFilterInfo *info) {
   if (FILTER_ALL_RES(info)) {
     info->func = filterExecuteImplAll;
@@ -3240,6 +3606,11 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (filterSetVecUnits(info) == TSDB_CODE_SUCCESS) {
+    info->func = filterExecuteImplVec;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->unitNum > 1) {
     info->func = filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
@@ -3325,6 +3696,99 @@ int32_t filterSetColFieldData(SFilterInfo *info, void *param, filer_get_col_from
 
   filterUpdateComUnits(info);
 
+  // dictionaries belong to the previous data block
+  if (info->dictUnitNum > 0) {
+    for (uint32_t i = 0; i < info->unitNum; ++i) {
+      info->cunits[i].dict = NULL;
+    }
+    info->dictUnitNum = 0;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t filterSetColFieldDict(SFilterInfo *info, void *param, filer_get_col_dict_from_id fp) {
+  CHK_LRET(info == NULL, TSDB_CODE_QRY_APP_ERROR, "info NULL");
+
+  if (FILTER_ALL_RES(info) || FILTER_EMPTY_RES(info)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  uint32_t colNum = info->fields[FLD_TYPE_COLUMN].num;
+  if (info->colDict == NULL) {
+    info->colDict = calloc(colNum, sizeof(*info->colDict));
+    info->dictRes = malloc(info->unitNum * FILTER_DICT_MAX_ENTRIES * sizeof(*info->dictRes));
+    if (info->colDict == NULL || info->dictRes == NULL) {
+      tfree(info->colDict);
+      tfree(info->dictRes);
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+  }
+
+  for (uint32_t i = 0; i < colNum; ++i) {
+    SFilterField* fi = &info->fields[FLD_TYPE_COLUMN].fields[i];
+    SSchema* sch = fi->desc;
+
+    info->colDict[i].numOfEntries = 0;
+    if (sch->type == TSDB_DATA_TYPE_BINARY || sch->type == TSDB_DATA_TYPE_NCHAR) {
+      if (!(*fp)(param, sch->colId, &info->colDict[i]) || info->colDict[i].numOfEntries > FILTER_DICT_MAX_ENTRIES) {
+        info->colDict[i].numOfEntries = 0;
+      }
+    }
+  }
+
+  info->dictUnitNum = 0;
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    SColumnDict *pDict = &info->colDict[FILTER_UNIT_COL_IDX(&info->units[i])];
+
+    info->cunits[i].dict = (pDict->numOfEntries > 0) ? pDict : NULL;
+    if (info->cunits[i].dict) {
+      ++info->dictUnitNum;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t filterGetColumnIds(SFilterInfo *info, SArray *pColIds) {
+  CHK_LRET(info == NULL, TSDB_CODE_QRY_APP_ERROR, "info NULL");
+  CHK_LRET(info->fields[FLD_TYPE_COLUMN].num <= 0, TSDB_CODE_QRY_APP_ERROR, "no column fileds");
+
+  for (uint32_t i = 0; i < info->fields[FLD_TYPE_COLUMN].num; ++i) {
+    SSchema* sch = info->fields[FLD_TYPE_COLUMN].fields[i].desc;
+    taosArrayPush(pColIds, &sch->colId);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the column = value units every result row must meet, i.e. the ones of a filter with a single group
+int32_t filterGetEqualConds(SFilterInfo *info, SArray *pConds) {
+  CHK_LRET(info == NULL, TSDB_CODE_QRY_APP_ERROR, "info NULL");
+
+  if (FILTER_ALL_RES(info) || FILTER_EMPTY_RES(info) || info->groupNum != 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SFilterGroup *group = &info->groups[0];
+  for (uint32_t u = 0; u < group->unitNum; ++u) {
+    SFilterUnit *unit = &info->units[group->unitIdxs[u]];
+    if (FILTER_UNIT_OPTR(unit) != TSDB_RELATION_EQUAL || unit->right.type != FLD_TYPE_VALUE) {
+      continue;
+    }
+
+    SSchema *sch = FILTER_UNIT_COL_DESC(info, unit);
+    if (sch->colId == PRIMARYKEY_TIMESTAMP_COL_INDEX || sch->type != FILTER_UNIT_DATA_TYPE(unit) ||
+        sch->type == TSDB_DATA_TYPE_JSON) {
+      continue;
+    }
+
+    SColumnEqualCond cond = {.colId = sch->colId, .type = sch->type, .pVal = FILTER_UNIT_VAL_DATA(info, unit)};
+    if (cond.pVal != NULL) {
+      taosArrayPush(pConds, &cond);
+    }
+  }
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -3489,6 +3953,29 @@ bool filterRangeExecute(SFilterInfo *info, SDataStatis *pDataStatis, int32_t num
   return ret;
 }
 
+// all the rows of a data block meet the filter according to the block statistics
+bool filterRangeAllPass(SFilterInfo *info, SDataStatis *pDataStatis, int32_t numOfCols, int32_t numOfRows) {
+  if (FILTER_EMPTY_RES(info)) {
+    return false;
+  }
+
+  if (FILTER_ALL_RES(info)) {
+    return true;
+  }
+
+  if (pDataStatis == NULL) {
+    return false;
+  }
+
+  info->blkFlag = 0;
+  filterRmUnitByRange(info, pDataStatis, numOfCols, numOfRows);
+
+  bool all = FILTER_GET_FLAG(info->blkFlag, FI_STATUS_BLK_ALL);
+  info->blkFlag = 0;
+
+  return all;
+}
+
 
 
 int32_t filterGetTimeRange(SFilterInfo *info, STimeWindow       *win) {
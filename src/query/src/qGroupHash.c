@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qGroupHash.h"
+#include "hashfunc.h"
+#include "taosdef.h"
+#include "tdataformat.h"
+#include "taoserror.h"
+#include "ttype.h"
+#include "tutil.h"
+
+#define GROUP_HASH_MIN_SLOTS          64
+#define GROUP_HASH_PREFETCH_DISTANCE  16
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GROUP_HASH_PREFETCH(_p) __builtin_prefetch((_p))
+#else
+#define GROUP_HASH_PREFETCH(_p)
+#endif
+
+// append the values of a fixed length column to the keys of the rows
+#define GROUP_KEY_COPY_COL(_pos, _keyBuf, _data, _type, _rows) \
+  do {                                                         \
+    const _type *_v = (const _type *)(_data);                  \
+    for (int32_t _i = 0; _i < (_rows); ++_i) {                 \
+      _type _x = _v[_i];                                       \
+      memcpy((_keyBuf) + (_pos)[_i], &_x, sizeof(_type));      \
+      (_pos)[_i] += sizeof(_type);                             \
+    }                                                          \
+  } while (0)
+
+// +0.0 and -0.0 are the same group
+#define GROUP_KEY_COPY_FLOAT_COL(_pos, _keyBuf, _data, _type, _rows) \
+  do {                                                               \
+    const _type *_v = (const _type *)(_data);                        \
+    for (int32_t _i = 0; _i < (_rows); ++_i) {                       \
+      _type _x = (_v[_i] == 0) ? 0 : _v[_i];                         \
+      memcpy((_keyBuf) + (_pos)[_i], &_x, sizeof(_type));            \
+      (_pos)[_i] += sizeof(_type);                                   \
+    }                                                                \
+  } while (0)
+
+static int32_t doResizeSlots(SGroupHashTable* pTable, uint32_t numOfSlots) {
+  SGroupHashSlot* pSlots = malloc(numOfSlots * sizeof(SGroupHashSlot));
+  if (pSlots == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  for (uint32_t i = 0; i < numOfSlots; ++i) {
+    pSlots[i].hash  = 0;
+    pSlots[i].group = -1;
+  }
+
+  uint32_t mask = numOfSlots - 1;
+  for (int32_t g = 0; g < pTable->numOfGroups; ++g) {
+    uint32_t pos = pTable->pEntries[g].hash & mask;
+    while (pSlots[pos].group >= 0) {
+      pos = (pos + 1) & mask;
+    }
+
+    pSlots[pos].hash  = pTable->pEntries[g].hash;
+    pSlots[pos].group = g;
+  }
+
+  tfree(pTable->pSlots);
+  pTable->pSlots     = pSlots;
+  pTable->numOfSlots = numOfSlots;
+  return TSDB_CODE_SUCCESS;
+}
+
+SGroupHashTable* tGroupHashCreate(const SGroupKeyCol* pCols, int32_t numOfCols) {
+  SGroupHashTable* pTable = calloc(1, sizeof(SGroupHashTable));
+  if (pTable == NULL) {
+    return NULL;
+  }
+
+  pTable->numOfCols = numOfCols;
+  pTable->pCols     = malloc(numOfCols * sizeof(SGroupKeyCol));
+  if (pTable->pCols == NULL || doResizeSlots(pTable, GROUP_HASH_MIN_SLOTS) != TSDB_CODE_SUCCESS) {
+    return tGroupHashDestroy(pTable);
+  }
+
+  memcpy(pTable->pCols, pCols, numOfCols * sizeof(SGroupKeyCol));
+  return pTable;
+}
+
+void* tGroupHashDestroy(SGroupHashTable* pTable) {
+  if (pTable == NULL) {
+    return NULL;
+  }
+
+  tfree(pTable->pCols);
+  tfree(pTable->pSlots);
+  tfree(pTable->pEntries);
+  tfree(pTable->pKeyBuf);
+  tfree(pTable->pRowHash);
+  tfree(pTable->pRowKeyOffset);
+  tfree(pTable->pRowKeyPos);
+  tfree(pTable->pRowKeyBuf);
+  tfree(pTable);
+  return NULL;
+}
+
+static int32_t doEnsureRowBuf(SGroupHashTable* pTable, int32_t numOfRows) {
+  if (numOfRows <= pTable->rowCapacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  uint32_t* pHash   = realloc(pTable->pRowHash, numOfRows * sizeof(uint32_t));
+  if (pHash != NULL) {
+    pTable->pRowHash = pHash;
+  }
+
+  int32_t*  pOffset = realloc(pTable->pRowKeyOffset, (numOfRows + 1) * sizeof(int32_t));
+  if (pOffset != NULL) {
+    pTable->pRowKeyOffset = pOffset;
+  }
+
+  int32_t*  pPos    = realloc(pTable->pRowKeyPos, numOfRows * sizeof(int32_t));
+  if (pPos != NULL) {
+    pTable->pRowKeyPos = pPos;
+  }
+
+  if (pHash == NULL || pOffset == NULL || pPos == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  pTable->rowCapacity = numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+// the keys of all rows may create new groups, so the buffers are prepared before the lookup
+static int32_t doEnsureGroupBuf(SGroupHashTable* pTable, int32_t numOfRows, int32_t keyBytes) {
+  int32_t numOfGroups = pTable->numOfGroups + numOfRows;
+
+  if (numOfGroups > pTable->groupCapacity) {
+    int32_t capacity = MAX(numOfGroups, pTable->groupCapacity * 2);
+
+    SGroupHashEntry* p = realloc(pTable->pEntries, capacity * sizeof(SGroupHashEntry));
+    if (p == NULL) {
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+
+    pTable->pEntries      = p;
+    pTable->groupCapacity = capacity;
+  }
+
+  if ((uint64_t) numOfGroups * 2 > pTable->numOfSlots) {
+    uint32_t numOfSlots = pTable->numOfSlots;
+    while ((uint64_t) numOfGroups * 2 > numOfSlots) {
+      numOfSlots <<= 1;
+    }
+
+    int32_t code = doResizeSlots(pTable, numOfSlots);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  if (pTable->keyBufLen + keyBytes > pTable->keyBufCapacity) {
+    int64_t capacity = MAX(pTable->keyBufLen + keyBytes, pTable->keyBufCapacity * 2);
+
+    char* p = realloc(pTable->pKeyBuf, (size_t) capacity);
+    if (p == NULL) {
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+
+    pTable->pKeyBuf        = p;
+    pTable->keyBufCapacity = capacity;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// build the keys of all rows one column after another
+static int32_t doBuildRowKeys(SGroupHashTable* pTable, uint64_t tableGroupId, char** pColData, int32_t numOfRows) {
+  int32_t* pOffset = pTable->pRowKeyOffset;
+  int32_t* pPos    = pTable->pRowKeyPos;
+
+  int32_t fixedLen = sizeof(uint64_t);
+  bool    varKey   = false;
+  for (int32_t c = 0; c < pTable->numOfCols; ++c) {
+    if (IS_VAR_DATA_TYPE(pTable->pCols[c].type)) {
+      varKey = true;
+    } else {
+      fixedLen += pTable->pCols[c].bytes;
+    }
+  }
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pPos[i] = fixedLen;
+  }
+
+  for (int32_t c = 0; varKey && c < pTable->numOfCols; ++c) {
+    if (IS_VAR_DATA_TYPE(pTable->pCols[c].type)) {
+      int16_t bytes = pTable->pCols[c].bytes;
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        pPos[i] += varDataTLen(pColData[c] + (int64_t) i * bytes);
+      }
+    }
+  }
+
+  pOffset[0] = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pOffset[i + 1] = pOffset[i] + pPos[i];
+  }
+
+  if (pOffset[numOfRows] > pTable->rowKeyBufCapacity) {
+    char* p = realloc(pTable->pRowKeyBuf, pOffset[numOfRows]);
+    if (p == NULL) {
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+
+    pTable->pRowKeyBuf        = p;
+    pTable->rowKeyBufCapacity = pOffset[numOfRows];
+  }
+
+  char* pKeyBuf = pTable->pRowKeyBuf;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    memcpy(pKeyBuf + pOffset[i], &tableGroupId, sizeof(uint64_t));
+    pPos[i] = pOffset[i] + sizeof(uint64_t);
+  }
+
+  for (int32_t c = 0; c < pTable->numOfCols; ++c) {
+    int16_t type  = pTable->pCols[c].type;
+    int16_t bytes = pTable->pCols[c].bytes;
+    char*   pData = pColData[c];
+
+    switch (type) {
+      case TSDB_DATA_TYPE_FLOAT:
+        GROUP_KEY_COPY_FLOAT_COL(pPos, pKeyBuf, pData, float, numOfRows);
+        break;
+      case TSDB_DATA_TYPE_DOUBLE:
+        GROUP_KEY_COPY_FLOAT_COL(pPos, pKeyBuf, pData, double, numOfRows);
+        break;
+      case TSDB_DATA_TYPE_BINARY:
+      case TSDB_DATA_TYPE_NCHAR:
+        for (int32_t i = 0; i < numOfRows; ++i) {
+          char*   val = pData + (int64_t) i * bytes;
+          int32_t len = varDataTLen(val);
+          memcpy(pKeyBuf + pPos[i], val, len);
+          pPos[i] += len;
+        }
+        break;
+      default:
+        if (bytes == sizeof(int8_t)) {
+          GROUP_KEY_COPY_COL(pPos, pKeyBuf, pData, int8_t, numOfRows);
+        } else if (bytes == sizeof(int16_t)) {
+          GROUP_KEY_COPY_COL(pPos, pKeyBuf, pData, int16_t, numOfRows);
+        } else if (bytes == sizeof(int32_t)) {
+          GROUP_KEY_COPY_COL(pPos, pKeyBuf, pData, int32_t, numOfRows);
+        } else if (bytes == sizeof(int64_t)) {
+          GROUP_KEY_COPY_COL(pPos, pKeyBuf, pData, int64_t, numOfRows);
+        } else {
+          for (int32_t i = 0; i < numOfRows; ++i) {
+            memcpy(pKeyBuf + pPos[i], pData + (int64_t) i * bytes, bytes);
+            pPos[i] += bytes;
+          }
+        }
+        break;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static FORCE_INLINE int32_t doFindOrAddGroup(SGroupHashTable* pTable, uint32_t hash, const char* key, int32_t keyLen) {
+  uint32_t mask = pTable->numOfSlots - 1;
+  uint32_t pos  = hash & mask;
+
+  while (1) {
+    SGroupHashSlot* pSlot = &pTable->pSlots[pos];
+    if (pSlot->group < 0) {
+      break;
+    }
+
+    if (pSlot->hash == hash) {
+      SGroupHashEntry* pEntry = &pTable->pEntries[pSlot->group];
+      if (pEntry->keyLen == keyLen && memcmp(pTable->pKeyBuf + pEntry->keyOffset, key, keyLen) == 0) {
+        return pSlot->group;
+      }
+    }
+
+    pos = (pos + 1) & mask;
+  }
+
+  int32_t group = pTable->numOfGroups++;
+
+  SGroupHashEntry* pEntry = &pTable->pEntries[group];
+  pEntry->hash      = hash;
+  pEntry->keyLen    = keyLen;
+  pEntry->keyOffset = pTable->keyBufLen;
+  pEntry->pData     = NULL;
+
+  memcpy(pTable->pKeyBuf + pTable->keyBufLen, key, keyLen);
+  pTable->keyBufLen += keyLen;
+
+  pTable->pSlots[pos].hash  = hash;
+  pTable->pSlots[pos].group = group;
+  return group;
+}
+
+int32_t tGroupHashAssign(SGroupHashTable* pTable, uint64_t tableGroupId, char** pColData, int32_t numOfRows,
+                         int32_t* pGroupOfRow) {
+  if (numOfRows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = doEnsureRowBuf(pTable, numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  code = doBuildRowKeys(pTable, tableGroupId, pColData, numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  const int32_t* pOffset = pTable->pRowKeyOffset;
+  const char*    pKeyBuf = pTable->pRowKeyBuf;
+
+  code = doEnsureGroupBuf(pTable, numOfRows, pOffset[numOfRows]);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  uint32_t* pHash = pTable->pRowHash;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pHash[i] = MurmurHash3_32(pKeyBuf + pOffset[i], pOffset[i + 1] - pOffset[i]);
+  }
+
+  // the slots of the next rows are loaded while the current row is probed, the slots are not moved during the loop
+  uint32_t mask = pTable->numOfSlots - 1;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (i + GROUP_HASH_PREFETCH_DISTANCE < numOfRows) {
+      GROUP_HASH_PREFETCH(&pTable->pSlots[pHash[i + GROUP_HASH_PREFETCH_DISTANCE] & mask]);
+    }
+
+    const char* key    = pKeyBuf + pOffset[i];
+    int32_t     keyLen = pOffset[i + 1] - pOffset[i];
+
+    // rows of the same group often come one after another
+    if (i > 0 && pHash[i] == pHash[i - 1] && keyLen == pOffset[i] - pOffset[i - 1] &&
+        memcmp(key, pKeyBuf + pOffset[i - 1], keyLen) == 0) {
+      pGroupOfRow[i] = pGroupOfRow[i - 1];
+      continue;
+    }
+
+    pGroupOfRow[i] = doFindOrAddGroup(pTable, pHash[i], key, keyLen);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+const char* tGroupHashGetKey(SGroupHashTable* pTable, int32_t group, int32_t* keyLen) {
+  assert(group >= 0 && group < pTable->numOfGroups);
+
+  SGroupHashEntry* pEntry = &pTable->pEntries[group];
+  *keyLen = pEntry->keyLen - (int32_t) sizeof(uint64_t);
+  return pTable->pKeyBuf + pEntry->keyOffset + sizeof(uint64_t);
+}
+
+int64_t tGroupHashMemSize(SGroupHashTable* pTable) {
+  if (pTable == NULL) {
+    return 0;
+  }
+
+  return sizeof(SGroupHashTable) + pTable->numOfSlots * sizeof(SGroupHashSlot) +
+         pTable->groupCapacity * sizeof(SGroupHashEntry) + pTable->keyBufCapacity +
+         pTable->rowCapacity * (sizeof(uint32_t) + sizeof(int32_t) * 2) + pTable->rowKeyBufCapacity;
+}
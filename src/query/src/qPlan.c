@@ -429,11 +429,16 @@ static int32_t doPrintPlan(char* buf, SQueryNode* pQueryNode, int32_t level, int
       }
 
       SGroupbyExpr* pGroupbyExpr = pQueryNode->pExtInfo;
-      SColIndex* pIndex = taosArrayGet(pGroupbyExpr->columnInfo, 0);
 
-      len1 = sprintf(buf + len,") groupby_col: [%s #%d]\n", pIndex->name, pIndex->colId);
+      len1 = sprintf(buf + len,") groupby_col: ");
       len += len1;
 
+      for (int32_t i = 0; i < pGroupbyExpr->numOfGroupCols; ++i) {
+        SColIndex* pIndex = taosArrayGet(pGroupbyExpr->columnInfo, i);
+        len1 = sprintf(buf + len,"[%s #%d]%s", pIndex->name, pIndex->colId, (i < pGroupbyExpr->numOfGroupCols - 1)? ", ":"\n");
+        len += len1;
+      }
+
       break;
     }
 
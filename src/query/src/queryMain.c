@@ -131,10 +131,11 @@ int32_t qCreateQueryInfo(void* tsdb, int32_t vgId, SQueryTableMsg* pQueryMsg, qi
     if (!TSDB_QUERY_HAS_TYPE(pQueryMsg->queryType, TSDB_QUERY_TYPE_MULTITABLE_QUERY)) {
       STableIdInfo *id = taosArrayGet(param.pTableIdList, 0);
 
-      // group by normal column, do not pass the group by condition to tsdb to group table into different group
-      int32_t numOfGroupByCols = pQueryMsg->numOfGroupCols;
-      if (pQueryMsg->numOfGroupCols == 1 && !TSDB_COL_IS_TAG(param.pGroupColIndex->flag)) {
-        numOfGroupByCols = 0;
+      // group by normal columns, do not pass them to tsdb to group table into different group. The normal columns
+      // are always after the tags in the group by clause.
+      int32_t numOfGroupByCols = 0;
+      while (numOfGroupByCols < pQueryMsg->numOfGroupCols && TSDB_COL_IS_TAG(param.pGroupColIndex[numOfGroupByCols].flag)) {
+        numOfGroupByCols += 1;
       }
 
       qDebug("qmsg:%p query stable, uid:%"PRIu64", tid:%d", pQueryMsg, id->uid, id->tid);
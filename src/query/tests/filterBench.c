@@ -0,0 +1,202 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "os.h"
+#include "qFilter.h"
+#include "taosdef.h"
+#include "ttype.h"
+
+// rows of one tsdb block by default
+#define BENCH_ROWS   4096
+#define BENCH_ROUNDS 20000
+
+enum { BENCH_COL_INT = 1, BENCH_COL_BIGINT, BENCH_COL_DOUBLE, BENCH_COL_NUM = BENCH_COL_DOUBLE };
+
+typedef struct {
+  int32_t     numOfRows;
+  char       *data[BENCH_COL_NUM];
+  SDataStatis statis[BENCH_COL_NUM];
+} SBenchBlock;
+
+static int32_t benchColTypes[BENCH_COL_NUM] = {TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_DOUBLE};
+
+static tExprNode *createColNode(int16_t colId) {
+  tExprNode *pNode = calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_COL;
+  pNode->pSchema = calloc(1, sizeof(SSchema));
+  snprintf(pNode->pSchema->name, sizeof(pNode->pSchema->name), "c%d", colId);
+  pNode->pSchema->type = benchColTypes[colId - 1];
+  pNode->pSchema->bytes = tDataTypes[pNode->pSchema->type].bytes;
+  pNode->pSchema->colId = colId;
+  return pNode;
+}
+
+static tExprNode *createExpr(uint8_t optr, tExprNode *pLeft, tExprNode *pRight) {
+  tExprNode *pRoot = calloc(1, sizeof(tExprNode));
+  pRoot->nodeType = TSQL_NODE_EXPR;
+  pRoot->_node.optr = optr;
+  pRoot->_node.pLeft = pLeft;
+  pRoot->_node.pRight = pRight;
+  return pRoot;
+}
+
+static tExprNode *createUnit(uint8_t optr, int16_t colId, double val) {
+  tExprNode *pRight = calloc(1, sizeof(tExprNode));
+  pRight->nodeType = TSQL_NODE_VALUE;
+  pRight->pVal = calloc(1, sizeof(tVariant));
+  pRight->pVal->nType = TSDB_DATA_TYPE_DOUBLE;
+  pRight->pVal->dKey = val;
+  pRight->pVal->nLen = sizeof(double);
+
+  return createExpr(optr, createColNode(colId), pRight);
+}
+
+// the values of all the columns are uniform in [0, 1000)
+static tExprNode *createFilter(int32_t index, const char **name) {
+  switch (index) {
+    case 0:
+      *name = "int > c";
+      return createUnit(TSDB_RELATION_GREATER, BENCH_COL_INT, 500);
+    case 1:
+      *name = "double between";
+      return createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_GREATER_EQUAL, BENCH_COL_DOUBLE, 250.5),
+                        createUnit(TSDB_RELATION_LESS_EQUAL, BENCH_COL_DOUBLE, 750.5));
+    case 2:
+      *name = "bigint and int";
+      return createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_GREATER_EQUAL, BENCH_COL_BIGINT, 100),
+                        createUnit(TSDB_RELATION_LESS, BENCH_COL_INT, 900));
+    case 3:
+      *name = "and or";
+      return createExpr(TSDB_RELATION_OR,
+                        createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_GREATER, BENCH_COL_INT, 300),
+                                   createUnit(TSDB_RELATION_LESS, BENCH_COL_DOUBLE, 600.5)),
+                        createUnit(TSDB_RELATION_EQUAL, BENCH_COL_BIGINT, 7));
+    default:
+      return NULL;
+  }
+}
+
+static int32_t getColData(void *param, int32_t id, void **data) {
+  *data = ((SBenchBlock *)param)->data[id - 1];
+  return TSDB_CODE_SUCCESS;
+}
+
+// one row of 100 is null unless noNull, the statistics cover the whole value range so no unit is removed by them
+static void initBlock(SBenchBlock *pBlock, int32_t numOfRows, bool noNull) {
+  pBlock->numOfRows = numOfRows;
+  for (int32_t c = 0; c < BENCH_COL_NUM; ++c) {
+    int32_t      type = benchColTypes[c];
+    int32_t      bytes = tDataTypes[type].bytes;
+    SDataStatis *pStatis = &pBlock->statis[c];
+
+    memset(pStatis, 0, sizeof(*pStatis));
+    pStatis->colId = c + 1;
+    if (type == TSDB_DATA_TYPE_DOUBLE) {
+      *(double *)&pStatis->min = 0;
+      *(double *)&pStatis->max = 1000;
+    } else {
+      pStatis->min = 0;
+      pStatis->max = 1000;
+    }
+
+    pBlock->data[c] = malloc((size_t)numOfRows * bytes);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      char *val = pBlock->data[c] + (size_t)i * bytes;
+      if (!noNull && random() % 100 == 0) {
+        setNull(val, type, bytes);
+        pStatis->numOfNull++;
+        continue;
+      }
+
+      int64_t v = random() % 1000;
+      switch (type) {
+        case TSDB_DATA_TYPE_INT:    *(int32_t *)val = (int32_t)v; break;
+        case TSDB_DATA_TYPE_BIGINT: *(int64_t *)val = v; break;
+        default:                    *(double *)val = v + (random() % 100) / 100.0; break;
+      }
+    }
+  }
+}
+
+static void freeBlock(SBenchBlock *pBlock) {
+  for (int32_t c = 0; c < BENCH_COL_NUM; ++c) {
+    free(pBlock->data[c]);
+  }
+}
+
+static double benchFilter(SFilterInfo *info, filter_exec_func fp, SBenchBlock *pBlock, SDataStatis *statis,
+                          int32_t rounds, int8_t *res) {
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < rounds; ++i) {
+    (*fp)(info, pBlock->numOfRows, &res, statis, BENCH_COL_NUM);
+  }
+  int64_t et = taosGetTimestampUs();
+
+  // million rows per second
+  return (double)pBlock->numOfRows * rounds / (et - st);
+}
+
+static bool filterExecuteFunc(void *info, int32_t numOfRows, int8_t **p, SDataStatis *statis, int16_t numOfCols) {
+  return filterExecute(info, numOfRows, p, statis, numOfCols);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t numOfRows = BENCH_ROWS;
+  int32_t rounds = BENCH_ROUNDS;
+  int32_t code = 0;
+
+  if (argc > 1) numOfRows = atoi(argv[1]);
+  if (argc > 2) rounds = atoi(argv[2]);
+  if (numOfRows <= 0 || rounds <= 0) {
+    printf("usage: %s [rows] [rounds]\n", argv[0]);
+    return 1;
+  }
+
+  int8_t *expect = malloc(numOfRows);
+  int8_t *res = malloc(numOfRows);
+
+  srandom(0);
+  printf("%-16s %8s %10s %14s %14s %14s\n", "filter", "nulls", "rows", "row(Mrows/s)", "batch(Mrows/s)", "speedup");
+  for (int32_t f = 0;; ++f) {
+    const char *name = NULL;
+    tExprNode  *pExpr = createFilter(f, &name);
+    if (pExpr == NULL) break;
+
+    SFilterInfo *info = NULL;
+    if (filterInitFromTree(pExpr, (void **)&info, 0) != TSDB_CODE_SUCCESS) {
+      printf("%s: failed to create the filter\n", name);
+      return 1;
+    }
+
+    for (int32_t noNull = 0; noNull < 2; ++noNull) {
+      SBenchBlock block;
+      initBlock(&block, numOfRows, noNull);
+      filterSetColFieldData(info, &block, getColData);
+
+      // the statistics of a block without null values let the kernels skip the null checks
+      SDataStatis *statis = noNull ? block.statis : NULL;
+
+      double rowSpeed = benchFilter(info, filterExecuteImpl, &block, NULL, rounds, expect);
+      double vecSpeed = benchFilter(info, filterExecuteFunc, &block, statis, rounds, res);
+
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        if ((expect[i] != 0) != (res[i] != 0)) {
+          printf("%s: result mismatch at row %d\n", name, i);
+          code = 1;
+          break;
+        }
+      }
+
+      printf("%-16s %8s %10d %14.1f %14.1f %13.1fx\n", name, noNull ? "no" : "1%", numOfRows, rowSpeed, vecSpeed,
+             vecSpeed / rowSpeed);
+      freeBlock(&block);
+    }
+
+    filterFreeInfo(info);
+    tExprTreeDestroy(pExpr, NULL);
+  }
+
+  free(expect);
+  free(res);
+  return code;
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "os.h"
+#include "qFilter.h"
+#include "taosdef.h"
+
+namespace {
+
+const int32_t colBytes = 16 + VARSTR_HEADER_SIZE;
+const char   *dictValues[] = {"ok", "warn", "error", NULL};
+
+tExprNode *createColExpr(uint8_t optr, const char *val) {
+  auto *pLeft = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pLeft->nodeType = TSQL_NODE_COL;
+  pLeft->pSchema = (SSchema *)calloc(1, sizeof(SSchema));
+  strcpy(pLeft->pSchema->name, "st");
+  pLeft->pSchema->type = TSDB_DATA_TYPE_BINARY;
+  pLeft->pSchema->bytes = colBytes;
+  pLeft->pSchema->colId = 1;
+
+  auto *pRight = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pRight->nodeType = TSQL_NODE_VALUE;
+  pRight->pVal = (tVariant *)calloc(1, sizeof(tVariant));
+  pRight->pVal->nType = TSDB_DATA_TYPE_BINARY;
+  pRight->pVal->pz = strdup(val);
+  pRight->pVal->nLen = (int32_t)strlen(val);
+
+  auto *pRoot = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pRoot->nodeType = TSQL_NODE_EXPR;
+  pRoot->_node.optr = optr;
+  pRoot->_node.pLeft = pLeft;
+  pRoot->_node.pRight = pRight;
+  return pRoot;
+}
+
+void setDictValue(char *dst, int32_t code) {
+  if (dictValues[code] == NULL) {
+    setVardataNull(dst, TSDB_DATA_TYPE_BINARY);
+  } else {
+    STR_TO_VARSTR(dst, dictValues[code]);
+  }
+}
+
+struct SDictBlock {
+  std::vector<char>    data;     // fixed stride column data, as in SColumnInfoData
+  std::vector<char>    entries;  // distinct values one after another
+  std::vector<uint8_t> codes;
+  SColumnDict          dict;
+  bool                 useDict;
+};
+
+int32_t getColData(void *param, int32_t id, void **data) {
+  *data = ((SDictBlock *)param)->data.data();
+  return TSDB_CODE_SUCCESS;
+}
+
+bool getColDict(void *param, int16_t colId, SColumnDict *pDict) {
+  SDictBlock *pBlock = (SDictBlock *)param;
+  if (!pBlock->useDict) return false;
+  *pDict = pBlock->dict;
+  return true;
+}
+
+void initBlock(SDictBlock *pBlock, int32_t numOfRows) {
+  int32_t numOfDict = tListLen(dictValues);
+
+  pBlock->data.resize(numOfRows * colBytes);
+  pBlock->codes.resize(numOfRows);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pBlock->codes[i] = (uint8_t)((i * 7 + i / 3) % numOfDict);
+    setDictValue(pBlock->data.data() + i * colBytes, pBlock->codes[i]);
+  }
+
+  pBlock->entries.resize(numOfDict * colBytes);
+  char *entry = pBlock->entries.data();
+  for (int32_t i = 0; i < numOfDict; ++i) {
+    setDictValue(entry, i);
+    entry += varDataTLen(entry);
+  }
+
+  pBlock->dict.numOfEntries = numOfDict;
+  pBlock->dict.numOfRows = numOfRows;
+  pBlock->dict.pEntries = pBlock->entries.data();
+  pBlock->dict.codes = pBlock->codes.data();
+}
+
+void checkDictFilter(tExprNode *pExpr, int32_t numOfRows) {
+  SFilterInfo *info = NULL;
+  SDictBlock   block;
+  initBlock(&block, numOfRows);
+
+  ASSERT_EQ(filterInitFromTree(pExpr, (void **)&info, 0), TSDB_CODE_SUCCESS);
+  ASSERT_NE(info, nullptr);
+
+  std::vector<int8_t> res[2];
+  bool                all[2];
+  for (int32_t useDict = 0; useDict < 2; ++useDict) {
+    int8_t *p = NULL;
+    block.useDict = useDict;
+    filterSetColFieldData(info, &block, getColData);
+    filterSetColFieldDict(info, &block, getColDict);
+    ASSERT_EQ(info->dictUnitNum, (uint32_t)useDict);
+
+    all[useDict] = filterExecute(info, numOfRows, &p, NULL, 0);
+    res[useDict].assign(p, p + numOfRows);
+    tfree(p);
+  }
+
+  ASSERT_EQ(all[0], all[1]);
+  ASSERT_EQ(res[0], res[1]);
+
+  filterFreeInfo(info);
+  tExprTreeDestroy(pExpr, NULL);
+}
+
+}  // namespace
+
+TEST(filterDictTest, equal) { checkDictFilter(createColExpr(TSDB_RELATION_EQUAL, "ok"), 1000); }
+
+TEST(filterDictTest, not_equal) { checkDictFilter(createColExpr(TSDB_RELATION_NOT_EQUAL, "warn"), 1000); }
+
+TEST(filterDictTest, like) { checkDictFilter(createColExpr(TSDB_RELATION_LIKE, "%r%"), 1000); }
+
+TEST(filterDictTest, block_mismatch) {
+  // a dictionary of another block must be ignored
+  SFilterInfo *info = NULL;
+  SDictBlock   block;
+  tExprNode   *pExpr = createColExpr(TSDB_RELATION_EQUAL, "error");
+  initBlock(&block, 100);
+  block.dict.numOfRows = 99;
+  block.useDict = true;
+
+  ASSERT_EQ(filterInitFromTree(pExpr, (void **)&info, 0), TSDB_CODE_SUCCESS);
+  filterSetColFieldData(info, &block, getColData);
+  filterSetColFieldDict(info, &block, getColDict);
+
+  int8_t *p = NULL;
+  filterExecute(info, 100, &p, NULL, 0);
+  for (int32_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(p[i], block.codes[i] == 2);
+  }
+  tfree(p);
+
+  filterFreeInfo(info);
+  tExprTreeDestroy(pExpr, NULL);
+}
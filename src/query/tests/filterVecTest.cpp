@@ -0,0 +1,266 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "os.h"
+#include "qFilter.h"
+#include "taosdef.h"
+#include "ttype.h"
+
+namespace {
+
+const int32_t numOfRows = 1000;
+const int32_t numOfCols = 2;
+
+struct SVecBlock {
+  std::vector<char>        data[numOfCols];
+  std::vector<SDataStatis> statis;
+};
+
+tExprNode *createColNode(int32_t type, int16_t colId) {
+  auto *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_COL;
+  pNode->pSchema = (SSchema *)calloc(1, sizeof(SSchema));
+  snprintf(pNode->pSchema->name, sizeof(pNode->pSchema->name), "c%d", colId);
+  pNode->pSchema->type = type;
+  pNode->pSchema->bytes = tDataTypes[type].bytes;
+  pNode->pSchema->colId = colId;
+  return pNode;
+}
+
+tExprNode *createExpr(uint8_t optr, tExprNode *pLeft, tExprNode *pRight) {
+  auto *pRoot = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pRoot->nodeType = TSQL_NODE_EXPR;
+  pRoot->_node.optr = optr;
+  pRoot->_node.pLeft = pLeft;
+  pRoot->_node.pRight = pRight;
+  return pRoot;
+}
+
+tExprNode *createUnit(uint8_t optr, int32_t type, int16_t colId, double val) {
+  tExprNode *pRight = NULL;
+  if (optr != TSDB_RELATION_ISNULL && optr != TSDB_RELATION_NOTNULL) {
+    pRight = (tExprNode *)calloc(1, sizeof(tExprNode));
+    pRight->nodeType = TSQL_NODE_VALUE;
+    pRight->pVal = (tVariant *)calloc(1, sizeof(tVariant));
+    if (IS_FLOAT_TYPE(type)) {
+      pRight->pVal->nType = TSDB_DATA_TYPE_DOUBLE;
+      pRight->pVal->dKey = val;
+    } else {
+      pRight->pVal->nType = TSDB_DATA_TYPE_BIGINT;
+      pRight->pVal->i64 = (int64_t)val;
+    }
+    pRight->pVal->nLen = sizeof(int64_t);
+  }
+
+  return createExpr(optr, createColNode(type, colId), pRight);
+}
+
+int32_t getColData(void *param, int32_t id, void **data) {
+  *data = ((SVecBlock *)param)->data[id - 1].data();
+  return TSDB_CODE_SUCCESS;
+}
+
+// small values around the filter constants, with nulls unless noNull
+void initBlock(SVecBlock *pBlock, int32_t type, bool noNull) {
+  int32_t bytes = tDataTypes[type].bytes;
+
+  pBlock->statis.resize(numOfCols);
+  for (int32_t c = 0; c < numOfCols; ++c) {
+    SDataStatis *pStatis = &pBlock->statis[c];
+    memset(pStatis, 0, sizeof(*pStatis));
+    pStatis->colId = c + 1;
+
+    double minv = 0, maxv = 0;
+    pBlock->data[c].resize(numOfRows * bytes);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      char *val = pBlock->data[c].data() + i * bytes;
+      if (!noNull && (i * 7 + c) % 10 == 0) {
+        setNull(val, type, bytes);
+        pStatis->numOfNull++;
+        continue;
+      }
+
+      double v = (double)((i * 13 + c * 5) % 21);
+      if (!IS_UNSIGNED_NUMERIC_TYPE(type) && type != TSDB_DATA_TYPE_BOOL) v -= 10;
+      if (type == TSDB_DATA_TYPE_BOOL) v = (i + c) % 2;
+      if (IS_FLOAT_TYPE(type) && i % 3 == 0) v += 0.5;
+
+      switch (type) {
+        case TSDB_DATA_TYPE_BOOL:
+        case TSDB_DATA_TYPE_TINYINT:   *(int8_t *)val = (int8_t)v; break;
+        case TSDB_DATA_TYPE_SMALLINT:  *(int16_t *)val = (int16_t)v; break;
+        case TSDB_DATA_TYPE_INT:       *(int32_t *)val = (int32_t)v; break;
+        case TSDB_DATA_TYPE_BIGINT:
+        case TSDB_DATA_TYPE_TIMESTAMP: *(int64_t *)val = (int64_t)v; break;
+        case TSDB_DATA_TYPE_UTINYINT:  *(uint8_t *)val = (uint8_t)v; break;
+        case TSDB_DATA_TYPE_USMALLINT: *(uint16_t *)val = (uint16_t)v; break;
+        case TSDB_DATA_TYPE_UINT:      *(uint32_t *)val = (uint32_t)v; break;
+        case TSDB_DATA_TYPE_UBIGINT:   *(uint64_t *)val = (uint64_t)v; break;
+        case TSDB_DATA_TYPE_FLOAT:     *(float *)val = (float)v; break;
+        case TSDB_DATA_TYPE_DOUBLE:    *(double *)val = v; break;
+      }
+
+      if (i == 0 || v < minv) minv = v;
+      if (i == 0 || v > maxv) maxv = v;
+    }
+
+    if (IS_FLOAT_TYPE(type)) {
+      *(double *)&pStatis->min = minv;
+      *(double *)&pStatis->max = maxv;
+    } else {
+      pStatis->min = (int64_t)minv;
+      pStatis->max = (int64_t)maxv;
+    }
+  }
+}
+
+// the batch kernels must give the results of the row by row evaluation
+void checkVecFilter(tExprNode *pExpr, int32_t type) {
+  SFilterInfo *info = NULL;
+  ASSERT_EQ(filterInitFromTree(pExpr, (void **)&info, 0), TSDB_CODE_SUCCESS);
+  ASSERT_NE(info, nullptr);
+
+  for (int32_t noNull = 0; noNull < 2; ++noNull) {
+    SVecBlock block;
+    initBlock(&block, type, noNull);
+    filterSetColFieldData(info, &block, getColData);
+
+    if (!FILTER_ALL_RES(info) && !FILTER_EMPTY_RES(info)) {
+      ASSERT_NE(info->vecUnits, nullptr);
+    }
+
+    int8_t *expect = NULL;
+    bool    expectAll = filterExecuteImpl(info, numOfRows, &expect, NULL, 0);
+
+    for (int32_t withStatis = 0; withStatis < 2; ++withStatis) {
+      int8_t *p = NULL;
+      bool    all = filterExecute(info, numOfRows, &p, withStatis ? block.statis.data() : NULL, numOfCols);
+
+      ASSERT_EQ(all, expectAll);
+      if (all) {
+        tfree(p);
+        continue;
+      }
+
+      ASSERT_NE(p, nullptr);
+      ASSERT_NE(expect, nullptr);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        ASSERT_EQ(p[i] != 0, expect[i] != 0) << "type:" << type << " row:" << i << " statis:" << withStatis;
+      }
+      tfree(p);
+    }
+
+    tfree(expect);
+  }
+
+  filterFreeInfo(info);
+  tExprTreeDestroy(pExpr, NULL);
+}
+
+// the statistics of a block tell that all its rows meet the filter only if the column has no null value
+void checkRangeAllPass(tExprNode *pExpr, int32_t type, bool allInRange) {
+  SFilterInfo *info = NULL;
+  ASSERT_EQ(filterInitFromTree(pExpr, (void **)&info, 0), TSDB_CODE_SUCCESS);
+  ASSERT_NE(info, nullptr);
+
+  for (int32_t noNull = 0; noNull < 2; ++noNull) {
+    SVecBlock block;
+    initBlock(&block, type, noNull);
+    filterSetColFieldData(info, &block, getColData);
+
+    bool all = filterRangeAllPass(info, block.statis.data(), numOfCols, numOfRows);
+    ASSERT_EQ(all, allInRange && noNull) << "type:" << type << " noNull:" << noNull;
+
+    if (all) {
+      int8_t *p = NULL;
+      ASSERT_TRUE(filterExecuteImpl(info, numOfRows, &p, NULL, 0));
+      tfree(p);
+    }
+  }
+
+  filterFreeInfo(info);
+  tExprTreeDestroy(pExpr, NULL);
+}
+
+const int32_t numericTypes[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT,  TSDB_DATA_TYPE_INT,
+                                TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_TIMESTAMP, TSDB_DATA_TYPE_UTINYINT,
+                                TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_UBIGINT,
+                                TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE};
+
+}  // namespace
+
+TEST(filterVecTest, compare) {
+  // != of the numeric columns is rewritten into < or > by the parser
+  const uint8_t optrs[] = {TSDB_RELATION_LESS, TSDB_RELATION_LESS_EQUAL, TSDB_RELATION_GREATER,
+                           TSDB_RELATION_GREATER_EQUAL, TSDB_RELATION_EQUAL};
+
+  for (int32_t type : numericTypes) {
+    for (uint8_t optr : optrs) {
+      checkVecFilter(createUnit(optr, type, 1, 4), type);
+    }
+  }
+}
+
+TEST(filterVecTest, float_tolerance) {
+  checkVecFilter(createUnit(TSDB_RELATION_EQUAL, TSDB_DATA_TYPE_FLOAT, 1, 4.5000001), TSDB_DATA_TYPE_FLOAT);
+  checkVecFilter(createUnit(TSDB_RELATION_GREATER, TSDB_DATA_TYPE_DOUBLE, 1, 4.5000001), TSDB_DATA_TYPE_DOUBLE);
+  checkVecFilter(createUnit(TSDB_RELATION_LESS_EQUAL, TSDB_DATA_TYPE_DOUBLE, 1, 4.4999999), TSDB_DATA_TYPE_DOUBLE);
+}
+
+TEST(filterVecTest, range) {
+  for (int32_t type : numericTypes) {
+    // c1 > 2 and c1 <= 8 is merged into a range unit
+    checkVecFilter(createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_GREATER, type, 1, 2),
+                              createUnit(TSDB_RELATION_LESS_EQUAL, type, 1, 8)),
+                   type);
+    checkVecFilter(createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_GREATER_EQUAL, type, 1, 2),
+                              createUnit(TSDB_RELATION_LESS, type, 1, 8)),
+                   type);
+  }
+}
+
+TEST(filterVecTest, and_or_groups) {
+  for (int32_t type : numericTypes) {
+    // (c1 > 3 and c2 < 6) or c2 = 1 or c1 is null
+    tExprNode *pAnd = createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_GREATER, type, 1, 3),
+                                 createUnit(TSDB_RELATION_LESS, type, 2, 6));
+    tExprNode *pOr = createExpr(TSDB_RELATION_OR, pAnd, createUnit(TSDB_RELATION_EQUAL, type, 2, 1));
+    checkVecFilter(createExpr(TSDB_RELATION_OR, pOr, createUnit(TSDB_RELATION_ISNULL, type, 1, 0)), type);
+
+    // c1 is not null and c2 >= 5
+    checkVecFilter(createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_NOTNULL, type, 1, 0),
+                              createUnit(TSDB_RELATION_GREATER_EQUAL, type, 2, 5)),
+                   type);
+  }
+}
+
+TEST(filterVecTest, bool_column) {
+  checkVecFilter(createUnit(TSDB_RELATION_EQUAL, TSDB_DATA_TYPE_BOOL, 1, 1), TSDB_DATA_TYPE_BOOL);
+  checkVecFilter(createUnit(TSDB_RELATION_NOT_EQUAL, TSDB_DATA_TYPE_BOOL, 1, 1), TSDB_DATA_TYPE_BOOL);
+  checkVecFilter(createExpr(TSDB_RELATION_OR, createUnit(TSDB_RELATION_EQUAL, TSDB_DATA_TYPE_BOOL, 1, 0),
+                            createUnit(TSDB_RELATION_ISNULL, TSDB_DATA_TYPE_BOOL, 2, 0)),
+                 TSDB_DATA_TYPE_BOOL);
+}
+
+TEST(filterVecTest, range_all_pass) {
+  const int32_t types[] = {TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_FLOAT,
+                           TSDB_DATA_TYPE_DOUBLE};
+
+  // the values of the columns are within [-10, 10.5]
+  for (int32_t type : types) {
+    checkRangeAllPass(createUnit(TSDB_RELATION_GREATER, type, 1, -20), type, true);
+    checkRangeAllPass(createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_GREATER_EQUAL, type, 1, -10),
+                                 createUnit(TSDB_RELATION_LESS_EQUAL, type, 2, 11)),
+                      type, true);
+    checkRangeAllPass(createUnit(TSDB_RELATION_GREATER, type, 1, 0), type, false);
+    checkRangeAllPass(createExpr(TSDB_RELATION_OR, createUnit(TSDB_RELATION_LESS, type, 1, -5),
+                                 createUnit(TSDB_RELATION_GREATER, type, 2, 5)),
+                      type, false);
+
+    // the rows of the null values are left out by the statistics, as the rows are
+    checkVecFilter(createUnit(TSDB_RELATION_GREATER, type, 1, -20), type);
+    checkVecFilter(createExpr(TSDB_RELATION_AND, createUnit(TSDB_RELATION_GREATER_EQUAL, type, 1, -10),
+                              createUnit(TSDB_RELATION_LESS_EQUAL, type, 2, 11)),
+                   type);
+  }
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "os.h"
+#include "qGroupHash.h"
+#include "taosdef.h"
+#include "taoserror.h"
+#include "tdataformat.h"
+#include "tutil.h"
+#include "ttype.h"
+
+namespace {
+
+const int16_t binaryBytes = 12 + VARSTR_HEADER_SIZE;
+
+struct SKeyBlock {
+  std::vector<int32_t> a;
+  std::vector<char>    b;  // binary column
+  std::vector<double>  c;
+
+  explicit SKeyBlock(int32_t rows) : a(rows), b((size_t)rows * binaryBytes), c(rows) {}
+
+  void set(int32_t i, int32_t va, const std::string &vb, double vc) {
+    a[i] = va;
+    c[i] = vc;
+
+    char *p = b.data() + (size_t)i * binaryBytes;
+    memset(p, 0, binaryBytes);
+    STR_WITH_SIZE_TO_VARSTR(p, vb.c_str(), vb.length());
+  }
+
+  // a key that identifies the values of a row, the same as the group by clause does
+  std::string key(uint64_t tableGroupId, int32_t i) const {
+    const char *p = b.data() + (size_t)i * binaryBytes;
+    double      v = (c[i] == 0) ? 0 : c[i];
+    return std::to_string(tableGroupId) + "|" + std::to_string(a[i]) + "|" + std::string((const char *)varDataVal(p), varDataLen(p)) +
+           "|" + std::string((const char *)&v, sizeof(v));
+  }
+};
+
+const SGroupKeyCol keyCols[] = {{TSDB_DATA_TYPE_INT, sizeof(int32_t)},
+                                {TSDB_DATA_TYPE_BINARY, binaryBytes},
+                                {TSDB_DATA_TYPE_DOUBLE, sizeof(double)}};
+
+void checkAssign(SGroupHashTable *pTable, SKeyBlock &block, int32_t rows, uint64_t tableGroupId,
+                 std::map<std::string, int32_t> &groups) {
+  char *pColData[] = {(char *)block.a.data(), block.b.data(), (char *)block.c.data()};
+
+  std::vector<int32_t> groupOfRow(rows);
+  ASSERT_EQ(tGroupHashAssign(pTable, tableGroupId, pColData, rows, groupOfRow.data()), TSDB_CODE_SUCCESS);
+
+  for (int32_t i = 0; i < rows; ++i) {
+    std::string key = block.key(tableGroupId, i);
+    auto        it = groups.find(key);
+    if (it == groups.end()) {
+      // the groups are numbered in the order of their first rows
+      ASSERT_EQ(groupOfRow[i], (int32_t)groups.size()) << "row:" << i;
+      groups[key] = groupOfRow[i];
+    } else {
+      ASSERT_EQ(groupOfRow[i], it->second) << "row:" << i;
+    }
+  }
+
+  ASSERT_EQ(tGroupHashSize(pTable), (int32_t)groups.size());
+}
+
+}  // namespace
+
+TEST(groupHashTest, assign) {
+  SGroupHashTable *pTable = tGroupHashCreate(keyCols, tListLen(keyCols));
+  ASSERT_NE(pTable, nullptr);
+
+  std::map<std::string, int32_t> groups;
+  const int32_t                  rows = 4096;
+
+  for (int32_t b = 0; b < 20; ++b) {
+    SKeyBlock block(rows);
+    for (int32_t i = 0; i < rows; ++i) {
+      int32_t r = rand();
+      block.set(i, r % 7, std::string("m") + std::to_string((r / 7) % 5), (double)((r / 35) % 3) * 0.5);
+    }
+
+    checkAssign(pTable, block, rows, b % 3, groups);
+  }
+
+  // 7 * 5 * 3 values in each one of 3 table groups
+  ASSERT_LE(tGroupHashSize(pTable), 7 * 5 * 3 * 3);
+  tGroupHashDestroy(pTable);
+}
+
+TEST(groupHashTest, many_groups) {
+  SGroupHashTable *pTable = tGroupHashCreate(keyCols, tListLen(keyCols));
+  ASSERT_NE(pTable, nullptr);
+
+  std::map<std::string, int32_t> groups;
+  const int32_t                  rows = 1000;
+
+  for (int32_t b = 0; b < 100; ++b) {
+    SKeyBlock block(rows);
+    for (int32_t i = 0; i < rows; ++i) {
+      // runs of the same group, and groups of the previous blocks
+      int32_t n = (b * rows + i) / 2 - (i % 10 == 0 ? rows : 0);
+      block.set(i, n, std::to_string(n % 100), n % 2);
+    }
+
+    checkAssign(pTable, block, rows, 0, groups);
+  }
+
+  ASSERT_EQ(tGroupHashSize(pTable), (int32_t)groups.size());
+  ASSERT_GT(tGroupHashMemSize(pTable), 0);
+  tGroupHashDestroy(pTable);
+}
+
+TEST(groupHashTest, normalized_key) {
+  SGroupHashTable *pTable = tGroupHashCreate(keyCols, tListLen(keyCols));
+  ASSERT_NE(pTable, nullptr);
+
+  SKeyBlock block(5);
+  block.set(0, 1, "abc", 0.0);
+  block.set(1, 1, "abc", -0.0);
+  block.set(2, 1, "abcd", 0.0);
+  block.set(3, 1, "abc", 0.0);
+  block.set(4, 1, "abc", 0.0);
+  setNull((char *)&block.c[4], TSDB_DATA_TYPE_DOUBLE, sizeof(double));
+
+  char                *pColData[] = {(char *)block.a.data(), block.b.data(), (char *)block.c.data()};
+  std::vector<int32_t> groupOfRow(5);
+  ASSERT_EQ(tGroupHashAssign(pTable, 0, pColData, 5, groupOfRow.data()), TSDB_CODE_SUCCESS);
+
+  // +0.0 and -0.0 are the same value, the null value is a group of its own
+  ASSERT_EQ(groupOfRow[0], 0);
+  ASSERT_EQ(groupOfRow[1], 0);
+  ASSERT_EQ(groupOfRow[2], 1);
+  ASSERT_EQ(groupOfRow[3], 0);
+  ASSERT_EQ(groupOfRow[4], 2);
+
+  // the key is the values of the columns, the binary value with its length
+  int32_t     keyLen = 0;
+  const char *key = tGroupHashGetKey(pTable, 1, &keyLen);
+  ASSERT_EQ(keyLen, (int32_t)(sizeof(int32_t) + VARSTR_HEADER_SIZE + 4 + sizeof(double)));
+  ASSERT_EQ(*(int32_t *)key, 1);
+  ASSERT_EQ(varDataLen(key + sizeof(int32_t)), 4);
+  ASSERT_EQ(memcmp(varDataVal(key + sizeof(int32_t)), "abcd", 4), 0);
+
+  // the payload of a group is kept by the table
+  int32_t payload = 10;
+  tGroupHashSetData(pTable, 2, &payload);
+  ASSERT_EQ(tGroupHashGetData(pTable, 2), (void *)&payload);
+  ASSERT_EQ(tGroupHashGetData(pTable, 0), nullptr);
+
+  tGroupHashDestroy(pTable);
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "os.h"
+#include "qAggMain.h"
+#include "taosdef.h"
+#include "tdataformat.h"
+#include "ttype.h"
+
+namespace {
+
+const int32_t numOfRows = 1000;
+
+const int32_t fixedTypes[] = {TSDB_DATA_TYPE_BOOL,      TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT,
+                              TSDB_DATA_TYPE_INT,       TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_TIMESTAMP,
+                              TSDB_DATA_TYPE_FLOAT,     TSDB_DATA_TYPE_DOUBLE,   TSDB_DATA_TYPE_UTINYINT,
+                              TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_UBIGINT};
+
+// one row of every nullEvery rows is null, no row is null if nullEvery is 0
+std::vector<char> createColumn(int32_t type, int32_t rows, int32_t nullEvery) {
+  int32_t           bytes = tDataTypes[type].bytes;
+  std::vector<char> data(rows * bytes);
+
+  for (int32_t i = 0; i < rows; ++i) {
+    char *val = data.data() + i * bytes;
+    if (nullEvery > 0 && i % nullEvery == 3) {
+      setNull(val, type, bytes);
+      continue;
+    }
+
+    int64_t v = (i * 7) % 100;
+    switch (type) {
+      case TSDB_DATA_TYPE_BOOL:      *(int8_t *)val = (int8_t)(v % 2); break;
+      case TSDB_DATA_TYPE_TINYINT:
+      case TSDB_DATA_TYPE_UTINYINT:  *(int8_t *)val = (int8_t)v; break;
+      case TSDB_DATA_TYPE_SMALLINT:
+      case TSDB_DATA_TYPE_USMALLINT: *(int16_t *)val = (int16_t)v; break;
+      case TSDB_DATA_TYPE_INT:
+      case TSDB_DATA_TYPE_UINT:      *(int32_t *)val = (int32_t)v; break;
+      case TSDB_DATA_TYPE_FLOAT:     *(float *)val = (float)v + 0.5f; break;
+      case TSDB_DATA_TYPE_DOUBLE:    *(double *)val = (double)v + 0.25; break;
+      default:                       *(int64_t *)val = v; break;
+    }
+  }
+
+  return data;
+}
+
+// run the function on rows [start, start + size) of the column the way a time window of the block does
+void runAggFunction(int32_t functionId, int32_t type, std::vector<char> &data, const uint8_t *pBitmap, bool hasNull,
+                    int32_t start, int32_t size, char *pOutput) {
+  SQLFunctionCtx     ctx;
+  SResultRowCellInfo resInfo;
+  memset(&ctx, 0, sizeof(ctx));
+  memset(&resInfo, 0, sizeof(resInfo));
+
+  ctx.inputType = type;
+  ctx.inputBytes = tDataTypes[type].bytes;
+  ctx.functionId = functionId;
+  ctx.resultInfo = &resInfo;
+  ctx.pOutput = pOutput;
+  ctx.hasNull = hasNull;
+  ctx.nullBitmap = pBitmap;
+  ctx.startRow = start;
+  ctx.pInput = data.data() + start * ctx.inputBytes;
+  ctx.size = size;
+
+  aAggs[functionId].xFunction(&ctx);
+}
+
+}  // namespace
+
+TEST(nullBitmapTest, build) {
+  for (int32_t type : fixedTypes) {
+    for (int32_t nullEvery : {0, 1, 5, 64}) {
+      for (int32_t rows : {1, 7, 8, 9, numOfRows}) {
+        std::vector<char>    data = createColumn(type, rows, nullEvery);
+        std::vector<uint8_t> bitmap(NULL_BITMAP_BYTES(rows), 0xff);
+
+        int32_t numOfNull = buildNullBitmap(data.data(), type, rows, bitmap.data());
+
+        int32_t expect = 0;
+        for (int32_t i = 0; i < rows; ++i) {
+          bool null = isNull(data.data() + i * tDataTypes[type].bytes, type);
+          expect += null;
+          ASSERT_EQ(NULL_BITMAP_NOTNULL(bitmap.data(), i), null ? 0 : 1) << "type:" << type << " row:" << i;
+        }
+        ASSERT_EQ(numOfNull, expect) << "type:" << type << " rows:" << rows;
+
+        // the bits after the last row are clear
+        for (int32_t i = rows; i < NULL_BITMAP_BYTES(rows) * 8; ++i) {
+          ASSERT_EQ(NULL_BITMAP_NOTNULL(bitmap.data(), i), 0);
+        }
+      }
+    }
+  }
+
+  uint8_t bitmap[1];
+  char    binary[16] = {0};
+  ASSERT_EQ(buildNullBitmap(binary, TSDB_DATA_TYPE_BINARY, 1, bitmap), -1);
+  ASSERT_EQ(buildNullBitmap(binary, TSDB_DATA_TYPE_NCHAR, 1, bitmap), -1);
+}
+
+TEST(nullBitmapTest, count_range) {
+  std::vector<char>    data = createColumn(TSDB_DATA_TYPE_INT, numOfRows, 3);
+  std::vector<uint8_t> bitmap(NULL_BITMAP_BYTES(numOfRows));
+  buildNullBitmap(data.data(), TSDB_DATA_TYPE_INT, numOfRows, bitmap.data());
+
+  for (int32_t start : {0, 1, 7, 8, 13, 500}) {
+    for (int32_t size : {0, 1, 5, 8, 17, 400}) {
+      int32_t expect = 0;
+      for (int32_t i = start; i < start + size; ++i) {
+        expect += !isNull(data.data() + i * sizeof(int32_t), TSDB_DATA_TYPE_INT);
+      }
+      ASSERT_EQ(countNotNullInBitmap(bitmap.data(), start, size), expect) << "start:" << start << " size:" << size;
+    }
+  }
+}
+
+TEST(nullBitmapTest, data_col) {
+  STColumn col = {0};
+  colSetType(&col, TSDB_DATA_TYPE_INT);
+  colSetColId(&col, 2);
+  colSetBytes(&col, sizeof(int32_t));
+  colSetOffset(&col, 0);
+
+  SDataCols *pCols = tdNewDataCols(1, numOfRows);
+  ASSERT_NE(pCols, nullptr);
+  SDataCol *pCol = &pCols->cols[0];
+  dataColInit(pCol, &col, numOfRows);
+  ASSERT_FALSE(dataColHasNullBitmap(pCol));
+
+  // the column is filled the way a file block is decoded
+  std::vector<char> data = createColumn(TSDB_DATA_TYPE_INT, numOfRows, 10);
+  ASSERT_EQ(tdAllocMemForCol(pCol, numOfRows), 0);
+  memcpy(pCol->pData, data.data(), data.size());
+  pCol->len = (int)data.size();
+  dataColSetNullBitmap(pCol, numOfRows);
+
+  ASSERT_TRUE(dataColHasNullBitmap(pCol));
+  ASSERT_EQ(pCol->numOfNull, numOfRows / 10);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    ASSERT_EQ(NULL_BITMAP_NOTNULL(pCol->nullBitmap, i), isNull(tdGetColDataOfRow(pCol, i), TSDB_DATA_TYPE_INT) ? 0 : 1);
+  }
+
+  // any write to the column invalidates the bitmap
+  int32_t val = 1;
+  dataColAppendVal(pCol, &val, numOfRows - 1, numOfRows, -1);
+  ASSERT_FALSE(dataColHasNullBitmap(pCol));
+
+  dataColSetNullBitmap(pCol, numOfRows);
+  ASSERT_TRUE(dataColHasNullBitmap(pCol));
+  dataColReset(pCol);
+  ASSERT_FALSE(dataColHasNullBitmap(pCol));
+
+  tdFreeDataCols(pCols);
+}
+
+// the bitmap and the no null paths of the aggregates give the results of the null value checks
+TEST(nullBitmapTest, aggregates) {
+  const int32_t types[] = {TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_INT,  TSDB_DATA_TYPE_BIGINT,
+                           TSDB_DATA_TYPE_UINT,    TSDB_DATA_TYPE_FLOAT, TSDB_DATA_TYPE_DOUBLE};
+
+  for (int32_t type : types) {
+    for (int32_t nullEvery : {0, 4}) {
+      std::vector<char>    data = createColumn(type, numOfRows, nullEvery);
+      std::vector<uint8_t> bitmap(NULL_BITMAP_BYTES(numOfRows));
+      int32_t              numOfNull = buildNullBitmap(data.data(), type, numOfRows, bitmap.data());
+
+      for (int32_t functionId : {TSDB_FUNC_COUNT, TSDB_FUNC_SUM}) {
+        for (int32_t start : {0, 13}) {
+          int32_t size = numOfRows - start - 11;
+          char    expect[16] = {0};
+          char    res[16] = {0};
+
+          runAggFunction(functionId, type, data, NULL, true, start, size, expect);
+          runAggFunction(functionId, type, data, bitmap.data(), numOfNull > 0, start, size, res);
+          ASSERT_EQ(memcmp(expect, res, sizeof(res)), 0) << "type:" << type << " func:" << functionId;
+        }
+      }
+    }
+  }
+}
@@ -153,6 +153,12 @@ static int32_t syncReadOneWalRecord(int32_t sfd, SWalHead *pHead) {
     return 0;
   }
 
+  if (pHead->signature == 0) {
+    // zero padding of direct io, the records after it are not written yet
+    sInfo("sfd:%d, read to the end of written records", sfd);
+    return 0;
+  }
+
   assert(pHead->len <= TSDB_MAX_WAL_SIZE);
 
   ret = read(sfd, pHead->cont, pHead->len);
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_BLOCK_CACHE_H_
+#define _TD_TSDB_BLOCK_CACHE_H_
+
+// A decoded column chunk of a file block, fid and offset locate the block in a file system version
+typedef struct {
+  int32_t fid;
+  int16_t colId;
+  int8_t  last;  // block in the last file or in the data file
+  int8_t  reserved;
+  int64_t offset;
+} SBlockCacheKey;
+
+typedef struct SBlockCache SBlockCache;
+
+SBlockCache *tsdbNewBlockCache(int64_t capacity);
+void         tsdbFreeBlockCache(SBlockCache *pCache);
+// Drop all the chunks of the file system versions older than fsVersion
+void         tsdbInvalidateBlockCache(SBlockCache *pCache, uint32_t fsVersion);
+// Copy a cached chunk to pDataCol, return true if found
+bool         tsdbGetBlockCacheCol(SBlockCache *pCache, uint32_t fsVersion, SBlockCacheKey *pKey, SDataCol *pDataCol,
+                                  int numOfRows, int maxPoints);
+void         tsdbPutBlockCacheCol(SBlockCache *pCache, uint32_t fsVersion, SBlockCacheKey *pKey, SDataCol *pDataCol,
+                                  int numOfRows);
+
+#endif /* _TD_TSDB_BLOCK_CACHE_H_ */
@@ -20,6 +20,7 @@ typedef struct {
   int64_t blockId;
   int     offset;
   int     remain;
+  int64_t mapSize;  // bytes mapped from huge pages for the block, 0 if it is allocated from the heap
   char    data[];
 } STsdbBufBlock;
 
@@ -31,6 +32,7 @@ typedef struct {
   int            nRecycleBlocks;
   int            nElasticBlocks;
   int64_t        index;
+  int32_t        numaNode;
   SList*         bufBlockList;  
 } STsdbBufPool;
 
@@ -45,7 +47,7 @@ int           tsdbExpandPool(STsdbRepo* pRepo, int32_t oldTotalBlocks);
 void          tsdbRecycleBufferBlock(STsdbBufPool* pPool, SListNode *pNode, bool bELastic);
 
 // health cite
-STsdbBufBlock *tsdbNewBufBlock(int bufBlockSize);
+STsdbBufBlock *tsdbNewBufBlock(int bufBlockSize, int32_t *numaNode);
 void tsdbFreeBufBlock(STsdbBufBlock *pBufBlock);
 
 #endif /* _TD_TSDB_BUFFER_H_ */
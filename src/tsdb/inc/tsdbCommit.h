@@ -54,4 +54,21 @@ static FORCE_INLINE int tsdbGetFidLevel(int fid, SRtn *pRtn) {
   }
 }
 
+// Last key of the rollup window of key, the windows are aligned to the epoch like the interval windows below a day.
+// The blocks of a table are cut at the windows so the aggregates of a block are those of a window, INT64_MAX is
+// returned if the blocks are not cut.
+static FORCE_INLINE TSKEY tsdbRollupWindowLast(int8_t precision, TSKEY key) {
+  if (tsdbRollupInterval <= 0) return INT64_MAX;
+
+  int64_t interval = tsdbRollupInterval * (tsTickPerDay[precision] / 86400);
+  int64_t start = key - (key % interval + interval) % interval;
+  return start + (interval - 1);
+}
+
+// The keys of a block that starts from key are limited to its rollup window
+static FORCE_INLINE TSKEY tsdbRollupKeyLimit(int8_t precision, TSKEY key, TSKEY keyLimit) {
+  if (key == TSDB_DATA_TIMESTAMP_NULL) return keyLimit;
+  return MIN(keyLimit, tsdbRollupWindowLast(precision, key));
+}
+
 #endif /* _TD_TSDB_COMMIT_H_ */
\ No newline at end of file
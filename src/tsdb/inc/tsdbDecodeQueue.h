@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_DECODE_QUEUE_H_
+#define _TD_TSDB_DECODE_QUEUE_H_
+
+typedef void (*__tsdb_batch_fn_t)(void *param, int32_t idx);
+
+// Number of decode threads, 0 if the column data are decoded by the calling thread only
+int32_t tsdbDecodeThreads();
+// Call fp(param, idx) for idx in [0, num) on the decode threads and the calling thread, return when all finished
+void tsdbParallelDecode(__tsdb_batch_fn_t fp, void *param, int32_t num);
+
+// Number of commit worker threads, 0 if the tables of a vnode are committed by the commit thread only
+int32_t tsdbCommitWorkers();
+// Call fp(param, idx) for idx in [0, num) on the commit workers and the calling thread, return when all finished
+void tsdbParallelCommit(__tsdb_batch_fn_t fp, void *param, int32_t num);
+
+#endif /* _TD_TSDB_DECODE_QUEUE_H_ */
@@ -286,6 +286,19 @@ static FORCE_INLINE int64_t tsdbReadDFile(SDFile* pDFile, void* buf, int64_t nby
   return nread;
 }
 
+// read into the buffers one after another from the offset, the file position is not changed
+static FORCE_INLINE int64_t tsdbPReadvDFile(SDFile* pDFile, struct iovec* iov, int iovcnt, int64_t offset) {
+  ASSERT(TSDB_FILE_OPENED(pDFile));
+
+  int64_t nread = taosPReadv(pDFile->fd, iov, iovcnt, offset);
+  if (nread < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  return nread;
+}
+
 static FORCE_INLINE int tsdbCopyDFile(SDFile* pSrc, SDFile* pDest) {
   if (tfscopy(TSDB_FILE_F(pSrc), TSDB_FILE_F(pDest)) < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
@@ -26,17 +26,38 @@ typedef struct {
   TSKEY keyLast;
 } SMergeInfo;
 
+// A chunk of rows appended in key order, the keys are kept contiguous for searching
+typedef struct STableDataChunk {
+  struct STableDataChunk *prev;
+  struct STableDataChunk *next;
+  int32_t                 capacity;
+  int32_t                 numOfRows;
+  TSKEY *                 keys;
+  SMemRow *               rows;
+} STableDataChunk;
+
+// Iterator over the rows of a table in memory, in the skiplist or in the append chunks
 typedef struct {
-  STable *           pTable;
-  SSkipListIterator *pIter;
+  bool              chunked;
+  SSkipListIterator slIter;
+  STableDataChunk * pChunk;  // NULL if the iterator reaches the end
+  int32_t           pos;
+  int32_t           order;
+} STableDataIter;
+
+typedef struct {
+  STable *        pTable;
+  STableDataIter *pIter;
 } SCommitIter;
 
 struct STableData {
-  uint64_t   uid;
-  TSKEY      keyFirst;
-  TSKEY      keyLast;
-  int64_t    numOfRows;
-  SSkipList* pData;
+  uint64_t         uid;
+  TSKEY            keyFirst;
+  TSKEY            keyLast;
+  int64_t          numOfRows;
+  SSkipList*       pData;  // NULL while the rows arrive in order and are appended to the chunks
+  STableDataChunk* pHead;
+  STableDataChunk* pTail;
   T_REF_DECLARE()
 };
 
@@ -67,27 +88,39 @@ void  tsdbUnTakeMemSnapShot(STsdbRepo* pRepo, SMemSnapshot* pSnapshot);
 void* tsdbAllocBytes(STsdbRepo* pRepo, int bytes);
 int   tsdbAsyncCommit(STsdbRepo* pRepo);
 int   tsdbSyncCommitConfig(STsdbRepo* pRepo);
-int   tsdbLoadDataFromCache(STable* pTable, SSkipListIterator* pIter, TSKEY maxKey, int maxRowsToRead, SDataCols* pCols,
+int   tsdbLoadDataFromCache(STable* pTable, STableDataIter* pIter, TSKEY maxKey, int maxRowsToRead, SDataCols* pCols,
                             TKEY* filterKeys, int nFilterKeys, bool keepDup, SMergeInfo* pMergeInfo);
 void* tsdbCommitData(STsdbRepo* pRepo);
 
-static FORCE_INLINE SMemRow tsdbNextIterRow(SSkipListIterator* pIter) {
+// pKey NULL to iterate from the first(ASC) or the last(DESC) row, call tsdbTableDataIterNext before reading a row
+STableDataIter* tsdbCreateTableDataIter(STableData* pTableData, TKEY* pKey, int32_t order);
+bool            tsdbTableDataIterNext(STableDataIter* pIter);
+void*           tsdbDestroyTableDataIter(STableDataIter* pIter);
+
+static FORCE_INLINE SMemRow tsdbNextIterRow(STableDataIter* pIter) {
   if (pIter == NULL) return NULL;
 
-  SSkipListNode* node = tSkipListIterGet(pIter);
+  if (pIter->chunked) {
+    STableDataChunk* pChunk = pIter->pChunk;
+    if (pChunk == NULL || pIter->pos < 0 || pIter->pos >= pChunk->numOfRows) return NULL;
+
+    return pChunk->rows[pIter->pos];
+  }
+
+  SSkipListNode* node = tSkipListIterGet(&pIter->slIter);
   if (node == NULL) return NULL;
 
   return (SMemRow)SL_GET_NODE_DATA(node);
 }
 
-static FORCE_INLINE TSKEY tsdbNextIterKey(SSkipListIterator* pIter) {
+static FORCE_INLINE TSKEY tsdbNextIterKey(STableDataIter* pIter) {
   SMemRow row = tsdbNextIterRow(pIter);
   if (row == NULL) return TSDB_DATA_TIMESTAMP_NULL;
 
   return memRowKey(row);
 }
 
-static FORCE_INLINE TKEY tsdbNextIterTKey(SSkipListIterator* pIter) {
+static FORCE_INLINE TKEY tsdbNextIterTKey(STableDataIter* pIter) {
   SMemRow row = tsdbNextIterRow(pIter);
   if (row == NULL) return TKEY_NULL;
 
@@ -21,7 +21,9 @@
 #include "os.h"
 #include "tsdbFile.h"
 #include "tskiplist.h"
+#include "tscompression.h"
 #include "tsdbMeta.h"
+#include "tsdbBlockCache.h"
 
 typedef struct SReadH SReadH;
 
@@ -68,7 +70,7 @@ typedef struct {
 
 /**
  * aggrStat;   // only valid when blkVer > 0. 0 - no aggr part in .data/.last/.smad/.smal, 1 - has aggr in .smad/.smal
- * blkVer;     // 0 - original block, 1 - block since importing .smad/.smal
+ * blkVer;     // 0 - original block, 1 - block since importing .smad/.smal, 2 - aggr part followed by bloom filters
  * aggrOffset; // only valid when blkVer > 0 and aggrStat > 0
  */
 #define SBlockFieldsP1   \
@@ -88,9 +90,10 @@ typedef struct {
 typedef enum {
   TSDB_SBLK_VER_0 = 0,
   TSDB_SBLK_VER_1,
+  TSDB_SBLK_VER_2,  // same layout as TSDB_SBLK_VER_1, the aggr part in .smad/.smal is followed by a bloom filter part
 } ESBlockVer;
 
-#define SBlockVerLatest TSDB_SBLK_VER_1
+#define SBlockVerLatest TSDB_SBLK_VER_2
 
 #define SBlock SBlockV1      // latest SBlock definition
 
@@ -120,7 +123,7 @@ typedef struct {
 typedef struct {
   int16_t  colId;
   uint8_t  offsetH;
-  uint8_t  reserved;  // reserved field, not used
+  uint8_t  encode;    // column data encoding, TSDB_COL_ENCODE_*, was reserved and always 0 before
   int32_t  len;
   uint32_t type : 8;
   uint32_t offset : 24;
@@ -128,6 +131,28 @@ typedef struct {
 
 #define SBlockCol SBlockColV1      // latest SBlockCol definition
 
+#define TSDB_COL_ENCODE_PLAIN 0  // values stored one after another
+#define TSDB_COL_ENCODE_DICT  1  // binary/nchar: distinct values + one byte entry index per row + uint16_t count
+
+// the low 4 bits of SBlockCol.encode are the encoding, the high 4 bits the compression algorithm picked for the column
+#define TSDB_COL_ENCODE(encode) ((encode)&0x0F)
+
+/**
+ * the algorithm is kept as 1 + stage, plus 4 for the chimp float codec, and 0 means the algorithm of the block, which
+ * is what columns written before the per column algorithms have
+ */
+static FORCE_INLINE uint8_t tsdbSetColAlgorithm(uint8_t encode, int8_t algorithm) {
+  uint8_t code = (uint8_t)(1 + COMP_STAGE(algorithm) + ((algorithm & COMP_FLOAT_CHIMP) ? 4 : 0));
+  return (uint8_t)(TSDB_COL_ENCODE(encode) | (code << 4));
+}
+
+static FORCE_INLINE int8_t tsdbGetColAlgorithm(int8_t blkAlgorithm, uint8_t encode) {
+  uint8_t code = (uint8_t)(encode >> 4);
+  if (code == 0) return blkAlgorithm;
+  code--;
+  return (int8_t)((code & 0x03) | ((code & 0x04) ? COMP_FLOAT_CHIMP : 0));
+}
+
 typedef struct {
   int16_t colId;
   int16_t maxIndex;
@@ -140,6 +165,47 @@ typedef struct {
 
 #define SAggrBlkCol SAggrBlkColV1  // latest SAggrBlkCol definition
 
+typedef struct {
+  int16_t  colId;
+  int16_t  reserved;
+  uint32_t offset;  // offset of the filter bits from the beginning of the bloom filter part
+  uint32_t len;     // bytes of the filter bits
+} SBlockBloomCol;
+
+/**
+ * bloom filter part of a block, written right behind the aggr part: the head, the filter bits of each column, and the
+ * checksum of the whole part. Columns of the filter types with any value in the block have a filter.
+ */
+typedef struct {
+  uint32_t       len;  // bytes of the whole part
+  int16_t        numOfCols;
+  uint8_t        numOfHashes;
+  uint8_t        reserved;
+  SBlockBloomCol cols[];
+} SBlockBloomData;
+
+#define TSDB_BLOOM_FILTER_TYPE(t)                                                                 \
+  ((t) != TSDB_DATA_TYPE_BOOL && (t) != TSDB_DATA_TYPE_FLOAT && (t) != TSDB_DATA_TYPE_DOUBLE && \
+   (t) != TSDB_DATA_TYPE_JSON)
+
+/**
+ * the bytes of a value put into the bloom filter. Values equal to the query compare functions must get the same key:
+ * compareLenPrefixedStr stops at the first '\0' of binary values, and compareLenPrefixedWStr leaves the last two bytes
+ * of nchar values out.
+ */
+static FORCE_INLINE void tsdbGetBloomFilterKey(int8_t type, const void *pVal, const void **pKey, int32_t *len) {
+  if (type == TSDB_DATA_TYPE_BINARY) {
+    *pKey = varDataVal(pVal);
+    *len = (int32_t)strnlen(varDataVal(pVal), varDataLen(pVal));
+  } else if (type == TSDB_DATA_TYPE_NCHAR) {
+    *pKey = varDataVal(pVal);
+    *len = (varDataLen(pVal) > sizeof(VarDataLenT)) ? varDataLen(pVal) - sizeof(VarDataLenT) : 0;
+  } else {
+    *pKey = pVal;
+    *len = TYPE_BYTES[type];
+  }
+}
+
 // Code here just for back-ward compatibility
 static FORCE_INLINE void tsdbSetBlockColOffset(SBlockCol *pBlockCol, uint32_t offset) {
   pBlockCol->offset = offset & ((((uint32_t)1) << 24) - 1);
@@ -161,6 +227,11 @@ typedef struct {
 
 typedef void SAggrBlkData;  // SBlockCol cols[];
 
+typedef struct {
+  void *  pAddr;  // NULL if the file is not mapped
+  int64_t size;
+} SDFileMap;
+
 struct SReadH {
   STsdbRepo * pRepo;
   SDFileSet   rSet;     // FSET to read
@@ -171,10 +242,21 @@ struct SReadH {
   SBlockInfo *  pBlkInfo;  // SBlockInfoV#
   SBlockData *pBlkData;  // Block info
   SAggrBlkData *pAggrBlkData;  // Aggregate Block info
+  SBlockBloomData *pBlkBloom;  // bloom filters of a block
+  void *      pBlkInfoBuf;  // buffers the four parts above are read into, unused if they point into the mappings
+  void *      pBlkDataBuf;
+  void *      pAggrBuf;
+  void *      pBloomBuf;
   SDataCols * pDCols[2];
   void *      pBuf;   // buffer
   void *      pCBuf;  // compression buffer
   void *      pExBuf;  // extra buffer
+  void *      pDecTasks;  // column decode tasks of a block, for the parallel decoding
+  STsdbReadCost readCost;
+  SBlockCache *pBlockCache;  // NULL if the decoded columns are not cached
+  uint32_t     fsVersion;    // file system version of the file set to read
+  bool         mmapRead;     // map the files of a file set when it is opened, and read them from the mappings
+  SDFileMap    maps[TSDB_FILE_MAX];
 };
 
 #define TSDB_READ_REPO(rh) ((rh)->pRepo)
@@ -198,6 +280,7 @@ static FORCE_INLINE size_t tsdbBlockStatisSize(int nCols, uint32_t blkVer) {
     case TSDB_SBLK_VER_0:
       return TSDB_BLOCK_STATIS_SIZE(nCols, 0);
     case TSDB_SBLK_VER_1:
+    case TSDB_SBLK_VER_2:
     default:
       return TSDB_BLOCK_STATIS_SIZE(nCols, 1);
   }
@@ -211,6 +294,7 @@ static FORCE_INLINE size_t tsdbBlockAggrSize(int nCols, uint32_t blkVer) {
       ASSERT(false);
       return 0;
     case TSDB_SBLK_VER_1:
+    case TSDB_SBLK_VER_2:
     default:
       return TSDB_BLOCK_AGGR_SIZE(nCols, 1);
   }
@@ -227,6 +311,8 @@ int   tsdbLoadBlockData(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlockInfo);
 int   tsdbLoadBlockDataCols(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo, int16_t *colIds, int numOfColsIds);
 int   tsdbLoadBlockStatis(SReadH *pReadh, SBlock *pBlock);
 int   tsdbLoadBlockOffset(SReadH *pReadh, SBlock *pBlock);
+int   tsdbLoadBlockBloom(SReadH *pReadh, SBlock *pBlock);
+bool  tsdbBlockBloomMayContain(SReadH *pReadh, int16_t colId, int8_t type, const void *pVal);
 int   tsdbEncodeSBlockIdx(void **buf, SBlockIdx *pIdx);
 void *tsdbDecodeSBlockIdx(void *buf, SBlockIdx *pIdx);
 void  tsdbGetBlockStatis(SReadH *pReadh, SDataStatis *pStatis, int numOfCols, SBlock *pBlock);
@@ -254,7 +340,7 @@ static FORCE_INLINE int tsdbMakeRoom(void **ppBuf, size_t size) {
 
 static FORCE_INLINE SBlockCol *tsdbGetSBlockCol(SBlock *pBlock, SBlockCol **pDestBlkCol, SBlockCol *pBlkCols,
                                                 int colIdx) {
-  if (pBlock->blkVer == SBlockVerLatest) {
+  if (pBlock->blkVer > TSDB_SBLK_VER_0) {
     *pDestBlkCol = pBlkCols + colIdx;
     return *pDestBlkCol;
   }
@@ -38,6 +38,7 @@
 #include "tlockfree.h"
 #include "tlist.h"
 #include "hash.h"
+#include "tbloomfilter.h"
 #include "tarray.h"
 #include "tfs.h"
 #include "tsocket.h"
@@ -68,6 +69,8 @@ extern "C" {
 #include "tsdbCompact.h"
 // Commit Queue
 #include "tsdbCommitQueue.h"
+// Decode Queue
+#include "tsdbDecodeQueue.h"
 
 #include "tsdbRowMergeBuf.h"
 // Main definitions
@@ -98,6 +101,7 @@ struct STsdbRepo {
   SMergeBuf       mergeBuf;  //used when update=2
   int8_t          compactState;  // compact state: inCompact/noCompact/waitingCompact?
   pthread_t*      pthread;
+  SBlockCache*    pBlockCache;  // decoded column chunks shared by the queries
 };
 
 #define REPO_ID(r) (r)->config.tsdbId
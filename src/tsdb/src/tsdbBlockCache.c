@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+
+typedef struct {
+  SBlockCacheKey key;
+  int32_t        size;  // bytes charged to the cache
+  int8_t         type;
+  int32_t        numOfRows;
+  int32_t        len;
+  int32_t        numOfDict;
+  char           data[];  // column data, followed by the dictionary codes of the rows if numOfDict > 0
+} SBlockCacheEntry;
+
+struct SBlockCache {
+  pthread_mutex_t lock;
+  uint32_t        version;   // file system version of the cached chunks
+  int64_t         capacity;  // memory budget in bytes
+  int64_t         size;      // bytes in use
+  SHashObj *      map;       // SBlockCacheKey -> SListNode *
+  SList *         lru;       // most recently used first
+};
+
+// dnode wide statistics, fetched and reset by the monitor
+static int64_t tsBlockCacheHits = 0;
+static int64_t tsBlockCacheMisses = 0;
+static int64_t tsBlockCacheUsed = 0;
+
+#define TSDB_BLOCK_CACHE_ENTRY(n) ((SBlockCacheEntry *)((n)->data))
+
+static void tsdbEmptyBlockCache(SBlockCache *pCache);
+static void tsdbRemoveBlockCacheNode(SBlockCache *pCache, SListNode *pNode);
+static bool tsdbCheckBlockCacheVersion(SBlockCache *pCache, uint32_t fsVersion);
+
+SBlockCache *tsdbNewBlockCache(int64_t capacity) {
+  SBlockCache *pCache = (SBlockCache *)calloc(1, sizeof(*pCache));
+  if (pCache == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pCache->capacity = capacity;
+  pCache->map = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  pCache->lru = tdListNew(0);
+  if (pCache->map == NULL || pCache->lru == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    taosHashCleanup(pCache->map);
+    tdListFree(pCache->lru);
+    free(pCache);
+    return NULL;
+  }
+
+  pthread_mutex_init(&(pCache->lock), NULL);
+  return pCache;
+}
+
+void tsdbFreeBlockCache(SBlockCache *pCache) {
+  if (pCache == NULL) return;
+
+  tsdbEmptyBlockCache(pCache);
+  taosHashCleanup(pCache->map);
+  tdListFree(pCache->lru);
+  pthread_mutex_destroy(&(pCache->lock));
+  free(pCache);
+}
+
+void tsdbInvalidateBlockCache(SBlockCache *pCache, uint32_t fsVersion) {
+  if (pCache == NULL) return;
+
+  pthread_mutex_lock(&(pCache->lock));
+  tsdbCheckBlockCacheVersion(pCache, fsVersion);
+  pthread_mutex_unlock(&(pCache->lock));
+}
+
+bool tsdbGetBlockCacheCol(SBlockCache *pCache, uint32_t fsVersion, SBlockCacheKey *pKey, SDataCol *pDataCol,
+                          int numOfRows, int maxPoints) {
+  bool found = false;
+
+  pthread_mutex_lock(&(pCache->lock));
+
+  SListNode **ppNode = NULL;
+  if (tsdbCheckBlockCacheVersion(pCache, fsVersion)) {
+    ppNode = (SListNode **)taosHashGet(pCache->map, pKey, sizeof(*pKey));
+  }
+
+  if (ppNode != NULL) {
+    SListNode *       pNode = *ppNode;
+    SBlockCacheEntry *pEntry = TSDB_BLOCK_CACHE_ENTRY(pNode);
+
+    // the column may be altered since the chunk was cached
+    if (pEntry->type == pDataCol->type && pEntry->numOfRows == numOfRows && pEntry->len <= pDataCol->bytes * maxPoints &&
+        tdAllocMemForCol(pDataCol, maxPoints) == 0) {
+      memcpy(pDataCol->pData, pEntry->data, pEntry->len);
+      pDataCol->len = pEntry->len;
+      pDataCol->numOfDict = 0;
+      found = true;
+      if (pEntry->numOfDict > 0) {
+        memcpy(pDataCol->dictCode, POINTER_SHIFT(pEntry->data, pEntry->len), numOfRows);
+        // a bad entry is dropped as a miss, the chunk is read from the file and cached again
+        if (dataColSetDict(pDataCol, pEntry->numOfDict, numOfRows) < 0) {
+          pDataCol->len = 0;
+          pDataCol->numOfDict = 0;
+          found = false;
+        }
+      } else if (IS_VAR_DATA_TYPE(pDataCol->type)) {
+        dataColSetOffset(pDataCol, numOfRows);
+      } else {
+        dataColSetNullBitmap(pDataCol, numOfRows);
+      }
+
+      if (found) {
+        tdListPopNode(pCache->lru, pNode);
+        tdListPrependNode(pCache->lru, pNode);
+      } else {
+        tsdbRemoveBlockCacheNode(pCache, pNode);
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&(pCache->lock));
+
+  atomic_add_fetch_64(found ? &tsBlockCacheHits : &tsBlockCacheMisses, 1);
+  return found;
+}
+
+void tsdbPutBlockCacheCol(SBlockCache *pCache, uint32_t fsVersion, SBlockCacheKey *pKey, SDataCol *pDataCol,
+                          int numOfRows) {
+  int32_t codeLen = (pDataCol->numOfDict > 0) ? numOfRows : 0;
+  int32_t size = (int32_t)(sizeof(SListNode) + sizeof(SBlockCacheEntry)) + pDataCol->len + codeLen;
+
+  if (size > pCache->capacity) return;
+
+  SListNode *pNode = (SListNode *)malloc(size);
+  if (pNode == NULL) return;
+
+  SBlockCacheEntry *pEntry = TSDB_BLOCK_CACHE_ENTRY(pNode);
+  pEntry->key = *pKey;
+  pEntry->size = size;
+  pEntry->type = pDataCol->type;
+  pEntry->numOfRows = numOfRows;
+  pEntry->len = pDataCol->len;
+  pEntry->numOfDict = pDataCol->numOfDict;
+  memcpy(pEntry->data, pDataCol->pData, pDataCol->len);
+  if (codeLen > 0) {
+    memcpy(POINTER_SHIFT(pEntry->data, pDataCol->len), pDataCol->dictCode, codeLen);
+  }
+
+  pthread_mutex_lock(&(pCache->lock));
+
+  if (!tsdbCheckBlockCacheVersion(pCache, fsVersion) || taosHashGet(pCache->map, pKey, sizeof(*pKey)) != NULL ||
+      taosHashPut(pCache->map, pKey, sizeof(*pKey), &pNode, sizeof(pNode)) != 0) {
+    pthread_mutex_unlock(&(pCache->lock));
+    free(pNode);
+    return;
+  }
+
+  tdListPrependNode(pCache->lru, pNode);
+  pCache->size += size;
+  atomic_add_fetch_64(&tsBlockCacheUsed, size);
+
+  while (pCache->size > pCache->capacity) {
+    tsdbRemoveBlockCacheNode(pCache, tsListGetTail(pCache->lru));
+  }
+
+  pthread_mutex_unlock(&(pCache->lock));
+}
+
+void tsdbGetBlockCacheStatis(int64_t *hits, int64_t *misses, int64_t *size) {
+  *hits = atomic_exchange_64(&tsBlockCacheHits, 0);
+  *misses = atomic_exchange_64(&tsBlockCacheMisses, 0);
+  *size = atomic_load_64(&tsBlockCacheUsed);
+}
+
+// chunks of an old version are not served nor cached, a newer version empties the cache
+static bool tsdbCheckBlockCacheVersion(SBlockCache *pCache, uint32_t fsVersion) {
+  if (fsVersion > pCache->version) {
+    tsdbEmptyBlockCache(pCache);
+    pCache->version = fsVersion;
+  }
+
+  return fsVersion == pCache->version;
+}
+
+static void tsdbEmptyBlockCache(SBlockCache *pCache) {
+  while (!isListEmpty(pCache->lru)) {
+    tsdbRemoveBlockCacheNode(pCache, tsListGetTail(pCache->lru));
+  }
+}
+
+static void tsdbRemoveBlockCacheNode(SBlockCache *pCache, SListNode *pNode) {
+  SBlockCacheEntry *pEntry = TSDB_BLOCK_CACHE_ENTRY(pNode);
+
+  taosHashRemove(pCache->map, &(pEntry->key), sizeof(pEntry->key));
+  tdListPopNode(pCache->lru, pNode);
+  pCache->size -= pEntry->size;
+  atomic_sub_fetch_64(&tsBlockCacheUsed, pEntry->size);
+  free(pNode);
+}
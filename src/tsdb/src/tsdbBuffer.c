@@ -17,6 +17,8 @@
 #include "tsdbHealth.h"
 
 #define POOL_IS_EMPTY(b) (listNEles((b)->bufBlockList) == 0)
+// a block mapped from huge pages takes the whole last huge page, which would be faulted in for a few bytes otherwise
+#define BUF_BLOCK_CAPACITY(p, b) (((b)->mapSize > 0) ? (int)((b)->mapSize - sizeof(STsdbBufBlock)) : (p)->bufBlockSize)
 
 // ---------------- INTERNAL FUNCTIONS ----------------
 STsdbBufPool *tsdbNewBufPool() {
@@ -69,9 +71,10 @@ int tsdbOpenBufPool(STsdbRepo *pRepo) {
   pPool->nElasticBlocks = 0;
   pPool->index = 0;
   pPool->nRecycleBlocks = 0;
+  pPool->numaNode = pCfg->numaNode;
 
   for (int i = 0; i < pCfg->totalBlocks; i++) {
-    STsdbBufBlock *pBufBlock = tsdbNewBufBlock(pPool->bufBlockSize);
+    STsdbBufBlock *pBufBlock = tsdbNewBufBlock(pPool->bufBlockSize, &pPool->numaNode);
     if (pBufBlock == NULL) goto _err;
 
     if (tdListAppend(pPool->bufBlockList, (void *)(&pBufBlock)) < 0) {
@@ -142,28 +145,60 @@ SListNode *tsdbAllocBufBlockFromPool(STsdbRepo *pRepo) {
 
   pBufBlock->blockId = pBufPool->index++;
   pBufBlock->offset = 0;
-  pBufBlock->remain = pBufPool->bufBlockSize;
+  pBufBlock->remain = BUF_BLOCK_CAPACITY(pBufPool, pBufBlock);
 
   tsdbDebug("vgId:%d, buffer block is allocated, blockId:%" PRId64, REPO_ID(pRepo), pBufBlock->blockId);
   return pNode;
 }
 
 // ---------------- LOCAL FUNCTIONS ----------------
-STsdbBufBlock *tsdbNewBufBlock(int bufBlockSize) {
-  STsdbBufBlock *pBufBlock = (STsdbBufBlock *)malloc(sizeof(*pBufBlock) + bufBlockSize);
+STsdbBufBlock *tsdbNewBufBlock(int bufBlockSize, int32_t *numaNode) {
+  STsdbBufBlock *pBufBlock = NULL;
+  int64_t        mapSize = 0;
+
+  // the skiplist traversal touches the rows all over the blocks, huge pages take the tlb misses away
+  if (tsdbCacheHugePages) {
+    mapSize = ALIGN_NUM(sizeof(*pBufBlock) + bufBlockSize, TAOS_HUGE_PAGE_SIZE);
+    pBufBlock = (STsdbBufBlock *)taosMmapHugePages(mapSize);
+    if (pBufBlock == NULL) {
+      tsdbDebug("failed to map buffer block from huge pages since %s, allocate it from heap", strerror(errno));
+      mapSize = 0;
+    }
+  }
+
   if (pBufBlock == NULL) {
-    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
-    return NULL;
+    pBufBlock = (STsdbBufBlock *)malloc(sizeof(*pBufBlock) + bufBlockSize);
+    if (pBufBlock == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return NULL;
+    }
   }
 
   pBufBlock->blockId = 0;
   pBufBlock->offset = 0;
-  pBufBlock->remain = bufBlockSize;
+  pBufBlock->mapSize = mapSize;
+  pBufBlock->remain = (mapSize > 0) ? (int)(mapSize - sizeof(*pBufBlock)) : bufBlockSize;
+
+  // the pages are not touched yet, they are placed on the node once they are written. If binding fails the pool falls
+  // back to the default policy and reports itself as not bound
+  if (*numaNode >= 0 && taosBindMemToNumaNode(pBufBlock->data, pBufBlock->remain, *numaNode) != 0) {
+    tsdbWarn("failed to bind buffer block to numa node %d since %s, the buffer pool is not bound", *numaNode,
+             strerror(errno));
+    *numaNode = -1;
+  }
 
   return pBufBlock;
 }
 
- void tsdbFreeBufBlock(STsdbBufBlock *pBufBlock) { tfree(pBufBlock); }
+void tsdbFreeBufBlock(STsdbBufBlock *pBufBlock) {
+  if (pBufBlock == NULL) return;
+
+  if (pBufBlock->mapSize > 0) {
+    taosMunmap(pBufBlock, pBufBlock->mapSize);
+  } else {
+    free(pBufBlock);
+  }
+}
 
 int tsdbExpandPool(STsdbRepo* pRepo, int32_t oldTotalBlocks) {
   if (oldTotalBlocks == pRepo->config.totalBlocks) {
@@ -177,7 +212,7 @@ int tsdbExpandPool(STsdbRepo* pRepo, int32_t oldTotalBlocks) {
 
   if (pRepo->config.totalBlocks > oldTotalBlocks) {
     for (int i = 0; i < pRepo->config.totalBlocks - oldTotalBlocks; i++) {
-      STsdbBufBlock *pBufBlock = tsdbNewBufBlock(pPool->bufBlockSize);
+      STsdbBufBlock *pBufBlock = tsdbNewBufBlock(pPool->bufBlockSize, &pPool->numaNode);
       if (pBufBlock == NULL) goto err;
 
       if (tdListAppend(pPool->bufBlockList, (void *)(&pBufBlock)) < 0) {
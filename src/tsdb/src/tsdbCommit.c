@@ -13,10 +13,14 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 #include "tsdbint.h"
+#include "tglobal.h"
 
 extern int32_t tsTsdbMetaCompactRatio;
 
 #define TSDB_MAX_SUBBLOCKS 8
+#define TSDB_COL_DICT_HASH_SLOTS 512  // open addressing slots for at most 256 dictionary entries
+#define TSDB_COL_COMP_SAMPLE_BYTES 16384  // bytes of a column compressed by each candidate codec
+#define TSDB_COL_COMP_MIN_GAIN 10  // percent of the bytes a codec slower to decode must save over a faster one
 static FORCE_INLINE int TSDB_KEY_FID(TSKEY key, int32_t days, int8_t precision) {
   if (key < 0) {
     return (int)((key + 1) / tsTickPerDay[precision] / days - 1);
@@ -25,7 +29,26 @@ static FORCE_INLINE int TSDB_KEY_FID(TSKEY key, int32_t days, int8_t precision)
   }
 }
 
+// The bytes a commit worker writes to a file for a table, appended to the file by the ordered merge
 typedef struct {
+  void *  pBuf;
+  int64_t size;
+  int64_t fsize;  // size of the file when the batch starts, staged offsets are fsize + position in the stage
+  SArray *aCksm;  // TSCKSUM to chain into the file magic, in the order they are computed
+} SCommitStage;
+
+// The blocks of a table committed by a commit worker
+typedef struct {
+  int          tid;
+  int32_t      code;
+  SArray *     aSupBlk;
+  SArray *     aSubBlk;
+  SCommitStage stages[TSDB_FILE_MAX];
+} STableCommit;
+
+typedef struct SCommitH SCommitH;
+
+struct SCommitH {
   SRtn         rtn;     // retention snapshot
   SFSIter      fsIter;  // tsdb file iterator
   int          niters;  // memory iterators
@@ -42,7 +65,19 @@ typedef struct {
   SArray *     aSupBlk;  // Table super-block array
   SArray *     aSubBlk;  // table sub-block array
   SDataCols *  pDataCols;
-} SCommitH;
+  SCommitStage *stages;    // stages of a worker handle, NULL to write the files directly
+  int           nWorkers;  // worker handles to commit the tables of a file set in parallel, 0 to commit one by one
+  SCommitH *    workers;   // share the memory iterators of the commit handle
+  STableCommit *tCommits;  // results of a batch of tables
+};
+
+typedef struct {
+  SCommitH *pCommith;
+  int32_t   ntables;
+  int32_t   next;  // next table of the batch to commit, taken atomically
+} SCommitBatch;
+
+#define TSDB_COMMIT_BATCH_TABLES(ch) (4 * ((ch)->nWorkers))
 
 #define TSDB_COMMIT_REPO(ch) TSDB_READ_REPO(&(ch->readh))
 #define TSDB_COMMIT_REPO_ID(ch) REPO_ID(TSDB_READ_REPO(&(ch->readh)))
@@ -75,6 +110,19 @@ static void tsdbDestroyCommitH(SCommitH *pCommith);
 static int  tsdbGetFidLevel(int fid, SRtn *pRtn);
 static int  tsdbNextCommitFid(SCommitH *pCommith);
 static int  tsdbCommitToTable(SCommitH *pCommith, int tid);
+static int  tsdbCommitTableData(SCommitH *pCommith, int tid);
+static int  tsdbCommitTablesInParallel(SCommitH *pCommith);
+static void tsdbCommitBatchWorker(void *param, int32_t idx);
+static int  tsdbMergeTableCommit(SCommitH *pCommith, STableCommit *pTCommit);
+static int  tsdbInitCommitWorkerH(SCommitH *pCommith, STsdbRepo *pRepo, SCommitH *pWorker);
+static void tsdbDestroyCommitWorkerH(SCommitH *pWorker);
+static int  tsdbSetCommitWorkerFile(SCommitH *pCommith, SDFileSet *pSet);
+static void tsdbCloseCommitWorkerFile(SCommitH *pCommith);
+static int  tsdbCommitAppend(SDFile *pDFile, SCommitStage *pStage, void *buf, int64_t nbyte, int64_t *offset);
+static int  tsdbCommitUpdateMagic(SDFile *pDFile, SCommitStage *pStage, void *pCksm);
+static int  tsdbWriteBlockImplEx(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile *pDFileAggr,
+                                 SCommitStage *pStage, SCommitStage *pStageAggr, SDataCols *pDataCols, SBlock *pBlock,
+                                 bool isLast, bool isSuper, void **ppBuf, void **ppCBuf, void **ppExBuf);
 static int  tsdbSetCommitTable(SCommitH *pCommith, STable *pTable);
 static int  tsdbComparKeyBlock(const void *arg1, const void *arg2);
 static int  tsdbWriteBlockInfo(SCommitH *pCommih);
@@ -91,6 +139,10 @@ static void tsdbCloseCommitFile(SCommitH *pCommith, bool hasError);
 static bool tsdbCanAddSubBlock(SCommitH *pCommith, SBlock *pBlock, SMergeInfo *pInfo);
 static void tsdbLoadAndMergeFromCache(SDataCols *pDataCols, int *iter, SCommitIter *pCommitIter, SDataCols *pTarget,
                                       TSKEY maxKey, int maxRows, int8_t update);
+static int32_t tsdbEncodeColDict(SDataCol *pDataCol, int rows, char *output);
+static int32_t tsdbEncodeBlockBloom(SDataCols *pDataCols, int rows, void **ppBuf, uint32_t offset);
+static int8_t  tsdbPickColAlgorithm(SDataCol *pDataCol, const void *data, int32_t len, int rows, int8_t algorithm,
+                                    void **ppBuf);
 
 void *tsdbCommitData(STsdbRepo *pRepo) {
   if (pRepo->imem == NULL) {
@@ -733,18 +785,29 @@ static int tsdbCommitToFile(SCommitH *pCommith, SDFileSet *pSet, int fid) {
     return -1;
   }
 
-  // Loop to commit each table data
-  for (int tid = 1; tid < pCommith->niters; tid++) {
-    SCommitIter *pIter = pCommith->iters + tid;
-
-    if (pIter->pTable == NULL) continue;
-
-    if (tsdbCommitToTable(pCommith, tid) < 0) {
+  if (pCommith->nWorkers > 0) {
+    if (tsdbSetCommitWorkerFile(pCommith, pSet) < 0 || tsdbCommitTablesInParallel(pCommith) < 0) {
+      tsdbCloseCommitWorkerFile(pCommith);
       tsdbCloseCommitFile(pCommith, true);
       // revert the file change
       tsdbApplyDFileSetChange(TSDB_COMMIT_WRITE_FSET(pCommith), pSet);
       return -1;
     }
+    tsdbCloseCommitWorkerFile(pCommith);
+  } else {
+    // Loop to commit each table data
+    for (int tid = 1; tid < pCommith->niters; tid++) {
+      SCommitIter *pIter = pCommith->iters + tid;
+
+      if (pIter->pTable == NULL) continue;
+
+      if (tsdbCommitToTable(pCommith, tid) < 0) {
+        tsdbCloseCommitFile(pCommith, true);
+        // revert the file change
+        tsdbApplyDFileSetChange(TSDB_COMMIT_WRITE_FSET(pCommith), pSet);
+        return -1;
+      }
+    }
   }
 
   if (tsdbWriteBlockIdx(TSDB_COMMIT_HEAD_FILE(pCommith), pCommith->aBlkIdx, (void **)(&(TSDB_COMMIT_BUF(pCommith)))) <
@@ -801,12 +864,12 @@ static int tsdbCreateCommitIters(SCommitH *pCommith) {
   for (int i = 0; i < pMem->maxTables; i++) {
     if ((pCommith->iters[i].pTable != NULL) && (pMem->tData[i] != NULL) &&
         (TABLE_UID(pCommith->iters[i].pTable) == pMem->tData[i]->uid)) {
-      if ((pCommith->iters[i].pIter = tSkipListCreateIter(pMem->tData[i]->pData)) == NULL) {
+      if ((pCommith->iters[i].pIter = tsdbCreateTableDataIter(pMem->tData[i], NULL, TSDB_ORDER_ASC)) == NULL) {
         terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
         return -1;
       }
 
-      tSkipListIterNext(pCommith->iters[i].pIter);
+      tsdbTableDataIterNext(pCommith->iters[i].pIter);
     }
   }
 
@@ -819,7 +882,7 @@ static void tsdbDestroyCommitIters(SCommitH *pCommith) {
   for (int i = 1; i < pCommith->niters; i++) {
     if (pCommith->iters[i].pTable != NULL) {
       tsdbUnRefTable(pCommith->iters[i].pTable);
-      tSkipListDestroyIter(pCommith->iters[i].pIter);
+      tsdbDestroyTableDataIter(pCommith->iters[i].pIter);
     }
   }
 
@@ -887,10 +950,70 @@ static int tsdbInitCommitH(SCommitH *pCommith, STsdbRepo *pRepo) {
     return -1;
   }
 
+  if (tsdbCommitWorkers() > 0) {
+    // the commit thread works on a batch too
+    pCommith->nWorkers = tsdbCommitWorkers() + 1;
+    pCommith->workers = (SCommitH *)calloc(pCommith->nWorkers, sizeof(SCommitH));
+    pCommith->tCommits = (STableCommit *)calloc(TSDB_COMMIT_BATCH_TABLES(pCommith), sizeof(STableCommit));
+    if (pCommith->workers == NULL || pCommith->tCommits == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      tsdbDestroyCommitH(pCommith);
+      return -1;
+    }
+
+    for (int i = 0; i < pCommith->nWorkers; i++) {
+      if (tsdbInitCommitWorkerH(pCommith, pRepo, pCommith->workers + i) < 0) {
+        tsdbDestroyCommitH(pCommith);
+        return -1;
+      }
+    }
+
+    for (int i = 0; i < TSDB_COMMIT_BATCH_TABLES(pCommith); i++) {
+      STableCommit *pTCommit = pCommith->tCommits + i;
+
+      pTCommit->aSupBlk = taosArrayInit(1024, sizeof(SBlock));
+      pTCommit->aSubBlk = taosArrayInit(1024, sizeof(SBlock));
+      if (pTCommit->aSupBlk == NULL || pTCommit->aSubBlk == NULL) {
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        tsdbDestroyCommitH(pCommith);
+        return -1;
+      }
+
+      for (int ftype = TSDB_FILE_DATA; ftype < TSDB_FILE_MAX; ftype++) {
+        pTCommit->stages[ftype].aCksm = taosArrayInit(64, sizeof(TSCKSUM));
+        if (pTCommit->stages[ftype].aCksm == NULL) {
+          terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+          tsdbDestroyCommitH(pCommith);
+          return -1;
+        }
+      }
+    }
+  }
+
   return 0;
 }
 
 static void tsdbDestroyCommitH(SCommitH *pCommith) {
+  if (pCommith->tCommits) {
+    for (int i = 0; i < TSDB_COMMIT_BATCH_TABLES(pCommith); i++) {
+      STableCommit *pTCommit = pCommith->tCommits + i;
+
+      pTCommit->aSupBlk = taosArrayDestroy(&pTCommit->aSupBlk);
+      pTCommit->aSubBlk = taosArrayDestroy(&pTCommit->aSubBlk);
+      for (int ftype = TSDB_FILE_DATA; ftype < TSDB_FILE_MAX; ftype++) {
+        pTCommit->stages[ftype].pBuf = taosTZfree(pTCommit->stages[ftype].pBuf);
+        pTCommit->stages[ftype].aCksm = taosArrayDestroy(&pTCommit->stages[ftype].aCksm);
+      }
+    }
+    tfree(pCommith->tCommits);
+  }
+  if (pCommith->workers) {
+    for (int i = 0; i < pCommith->nWorkers; i++) {
+      tsdbDestroyCommitWorkerH(pCommith->workers + i);
+    }
+    tfree(pCommith->workers);
+  }
+  pCommith->nWorkers = 0;
   pCommith->pDataCols = tdFreeDataCols(pCommith->pDataCols);
   pCommith->aSubBlk = taosArrayDestroy(&pCommith->aSubBlk);
   pCommith->aSupBlk = taosArrayDestroy(&pCommith->aSupBlk);
@@ -924,6 +1047,19 @@ static int tsdbNextCommitFid(SCommitH *pCommith) {
 }
 
 static int tsdbCommitToTable(SCommitH *pCommith, int tid) {
+  if (tsdbCommitTableData(pCommith, tid) < 0) return -1;
+
+  if (tsdbWriteBlockInfo(pCommith) < 0) {
+    tsdbError("vgId:%d failed to write SBlockInfo part into file %s since %s", TSDB_COMMIT_REPO_ID(pCommith),
+              TSDB_FILE_FULL_NAME(TSDB_COMMIT_HEAD_FILE(pCommith)), tstrerror(terrno));
+    return -1;
+  }
+
+  return 0;
+}
+
+// Commit the memory data of a table to the data blocks, the blocks are kept in aSupBlk and aSubBlk
+static int tsdbCommitTableData(SCommitH *pCommith, int tid) {
   SCommitIter *pIter = pCommith->iters + tid;
   TSKEY        nextKey = tsdbNextIterKey(pIter->pIter);
 
@@ -1014,12 +1150,6 @@ static int tsdbCommitToTable(SCommitH *pCommith, int tid) {
 
   TSDB_RUNLOCK_TABLE(pIter->pTable);
 
-  if (tsdbWriteBlockInfo(pCommith) < 0) {
-    tsdbError("vgId:%d failed to write SBlockInfo part into file %s since %s", TSDB_COMMIT_REPO_ID(pCommith),
-              TSDB_FILE_FULL_NAME(TSDB_COMMIT_HEAD_FILE(pCommith)), tstrerror(terrno));
-    return -1;
-  }
-
   return 0;
 }
 
@@ -1058,11 +1188,21 @@ static int tsdbComparKeyBlock(const void *arg1, const void *arg2) {
 
 int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile *pDFileAggr, SDataCols *pDataCols,
                        SBlock *pBlock, bool isLast, bool isSuper, void **ppBuf, void **ppCBuf, void **ppExBuf) {
+  return tsdbWriteBlockImplEx(pRepo, pTable, pDFile, pDFileAggr, NULL, NULL, pDataCols, pBlock, isLast, isSuper, ppBuf,
+                              ppCBuf, ppExBuf);
+}
+
+static int tsdbWriteBlockImplEx(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile *pDFileAggr,
+                                SCommitStage *pStage, SCommitStage *pStageAggr, SDataCols *pDataCols, SBlock *pBlock,
+                                bool isLast, bool isSuper, void **ppBuf, void **ppCBuf, void **ppExBuf) {
   STsdbCfg *  pCfg = REPO_CFG(pRepo);
   SBlockData *pBlockData;
   SAggrBlkData *pAggrBlkData = NULL;
   int64_t     offset = 0, offsetAggr = 0;
   int         rowsToWrite = pDataCols->numOfRows;
+  int8_t      algorithm = pCfg->compression;
+
+  if (algorithm != NO_COMPRESSION && tsdbFloatCompression) algorithm |= COMP_FLOAT_CHIMP;
 
   ASSERT(rowsToWrite > 0 && rowsToWrite <= pCfg->maxRowsPerFileBlock);
   ASSERT((!isLast) || rowsToWrite < pCfg->minRowsPerFileBlock);
@@ -1096,7 +1236,12 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
     pBlockCol->type = pDataCol->type;
     pAggrBlkCol->colId = pDataCol->colId;
 
-    if (tDataTypes[pDataCol->type].statisFunc) {
+    if (pDataCol->numOfDict > 0) {
+      // values are not stored one after another, and binary/nchar statistics only count the NULL values
+      for (int i = 0; i < rowsToWrite; i++) {
+        if (isNull(tdGetColDataOfRow(pDataCol, i), pDataCol->type)) pAggrBlkCol->numOfNull++;
+      }
+    } else if (tDataTypes[pDataCol->type].statisFunc) {
 #if 0
       (*tDataTypes[pDataCol->type].statisFunc)(pDataCol->pData, rowsToWrite, &(pBlockCol->min), &(pBlockCol->max),
                                                &(pBlockCol->sum), &(pBlockCol->minIndex), &(pBlockCol->maxIndex),
@@ -1119,6 +1264,14 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
   int32_t  keyLen = 0;
 
   uint32_t tsizeAggr = (uint32_t)tsdbBlockAggrSize(nColsNotAllNull, SBlockVerLatest);
+  int32_t  tsizeBloom = 0;
+
+  // the bloom filter part follows the aggr part in the extra buffer
+  if (tsdbBloomFilterBits > 0 && nColsNotAllNull > 0) {
+    tsizeBloom = tsdbEncodeBlockBloom(pDataCols, rowsToWrite, ppExBuf, tsizeAggr);
+    if (tsizeBloom < 0) return -1;
+    pAggrBlkData = (SAggrBlkData *)(*ppExBuf);
+  }
 
   for (int ncol = 0; ncol < pDataCols->numOfCols; ncol++) {
     // All not NULL columns finish
@@ -1129,42 +1282,72 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
 
     if (ncol != 0 && (pDataCol->colId != pBlockCol->colId)) continue;
 
-    int32_t flen;  // final length
-    int32_t tlen = dataColGetNEleLen(pDataCol, rowsToWrite);
+    int32_t flen;      // final length
+    int32_t tlen;      // length of the data to compress or copy
+    int32_t dlen = 0;  // max length of the dictionary encoded data
     void *  tptr;
+    void *  tdata = pDataCol->pData;
+    uint8_t encode = TSDB_COL_ENCODE_PLAIN;
+
+    // a column loaded from a dictionary block is encoded as is, even if the dictionaries are turned off
+    if (ncol != 0 && IS_VAR_DATA_TYPE(pDataCol->type) && (tsdbDictCompression || pDataCol->numOfDict > 0)) {
+      // distinct values never exceed the plain data, plus one byte entry index per row and the number of entries
+      dlen = ((pDataCol->numOfDict > 0) ? pDataCol->len : dataColGetNEleLen(pDataCol, rowsToWrite)) + rowsToWrite +
+             sizeof(uint16_t);
+    }
+    tlen = (pDataCol->numOfDict > 0) ? dlen : dataColGetNEleLen(pDataCol, rowsToWrite);
 
-    // Make room
-    if (tsdbMakeRoom(ppBuf, lsize + tlen + COMP_OVERFLOW_BYTES + sizeof(TSCKSUM)) < 0) {
+    // Make room, the dictionary is encoded behind the room of the final data
+    if (tsdbMakeRoom(ppBuf, lsize + tlen + COMP_OVERFLOW_BYTES + sizeof(TSCKSUM) + dlen) < 0) {
       return -1;
     }
     pBlockData = (SBlockData *)(*ppBuf);
     pBlockCol = pBlockData->cols + tcol;
     tptr = POINTER_SHIFT(pBlockData, lsize);
 
-    if (pCfg->compression == TWO_STAGE_COMP &&
+    if (dlen > 0) {
+      void *  dptr = POINTER_SHIFT(tptr, tlen + COMP_OVERFLOW_BYTES + sizeof(TSCKSUM));
+      int32_t elen = tsdbEncodeColDict(pDataCol, rowsToWrite, dptr);
+      // a column loaded from a dictionary block must be written as is, for others the dictionary must pay off
+      if (elen > 0 && (pDataCol->numOfDict > 0 || elen < tlen)) {
+        tdata = dptr;
+        tlen = elen;
+        encode = TSDB_COL_ENCODE_DICT;
+      }
+    }
+
+    int8_t calgorithm = algorithm;
+    if (ncol != 0 && tsdbAdaptiveCompression && algorithm != NO_COMPRESSION) {
+      calgorithm = tsdbPickColAlgorithm(pDataCol, tdata, tlen, rowsToWrite, algorithm, ppCBuf);
+      if (calgorithm < 0) return -1;
+      if (calgorithm != algorithm) encode = tsdbSetColAlgorithm(encode, calgorithm);
+    }
+
+    if (COMP_STAGE(calgorithm) == TWO_STAGE_COMP &&
         tsdbMakeRoom(ppCBuf, tlen + COMP_OVERFLOW_BYTES) < 0) {
       return -1;
     }
 
     // Compress or just copy
-    if (pCfg->compression) {
-      flen = (*(tDataTypes[pDataCol->type].compFunc))((char *)pDataCol->pData, tlen, rowsToWrite, tptr,
-                                                      tlen + COMP_OVERFLOW_BYTES, pCfg->compression, *ppCBuf,
+    if (calgorithm) {
+      flen = (*(tDataTypes[pDataCol->type].compFunc))((char *)tdata, tlen, rowsToWrite, tptr,
+                                                      tlen + COMP_OVERFLOW_BYTES, calgorithm, *ppCBuf,
                                                       tlen + COMP_OVERFLOW_BYTES);
     } else {
       flen = tlen;
-      memcpy(tptr, pDataCol->pData, flen);
+      memcpy(tptr, tdata, flen);
     }
 
     // Add checksum
     ASSERT(flen > 0);
     flen += sizeof(TSCKSUM);
     taosCalcChecksumAppend(0, (uint8_t *)tptr, flen);
-    tsdbUpdateDFileMagic(pDFile, POINTER_SHIFT(tptr, flen - sizeof(TSCKSUM)));
+    if (tsdbCommitUpdateMagic(pDFile, pStage, POINTER_SHIFT(tptr, flen - sizeof(TSCKSUM))) < 0) return -1;
 
     if (ncol != 0) {
       tsdbSetBlockColOffset(pBlockCol, toffset);
       pBlockCol->len = flen;
+      pBlockCol->encode = encode;
       tcol++;
     } else {
       keyLen = flen;
@@ -1179,10 +1362,10 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
   pBlockData->numOfCols = nColsNotAllNull;
 
   taosCalcChecksumAppend(0, (uint8_t *)pBlockData, tsize);
-  tsdbUpdateDFileMagic(pDFile, POINTER_SHIFT(pBlockData, tsize - sizeof(TSCKSUM)));
+  if (tsdbCommitUpdateMagic(pDFile, pStage, POINTER_SHIFT(pBlockData, tsize - sizeof(TSCKSUM))) < 0) return -1;
 
   // Write the whole block to file
-  if (tsdbAppendDFile(pDFile, (void *)pBlockData, lsize, &offset) < lsize) {
+  if (tsdbCommitAppend(pDFile, pStage, (void *)pBlockData, lsize, &offset) < lsize) {
     return -1;
   }
 
@@ -1190,10 +1373,21 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
   if (aggrStatus > 0) {
 
     taosCalcChecksumAppend(0, (uint8_t *)pAggrBlkData, tsizeAggr);
-    tsdbUpdateDFileMagic(pDFileAggr, POINTER_SHIFT(pAggrBlkData, tsizeAggr - sizeof(TSCKSUM)));
+    if (tsdbCommitUpdateMagic(pDFileAggr, pStageAggr, POINTER_SHIFT(pAggrBlkData, tsizeAggr - sizeof(TSCKSUM))) < 0) {
+      return -1;
+    }
+
+    if (tsizeBloom > 0) {
+      void *pBloom = POINTER_SHIFT(pAggrBlkData, tsizeAggr);
+      taosCalcChecksumAppend(0, (uint8_t *)pBloom, tsizeBloom);
+      if (tsdbCommitUpdateMagic(pDFileAggr, pStageAggr, POINTER_SHIFT(pBloom, tsizeBloom - sizeof(TSCKSUM))) < 0) {
+        return -1;
+      }
+    }
 
     // Write the whole block to file
-    if (tsdbAppendDFile(pDFileAggr, (void *)pAggrBlkData, tsizeAggr, &offsetAggr) < tsizeAggr) {
+    if (tsdbCommitAppend(pDFileAggr, pStageAggr, (void *)pAggrBlkData, tsizeAggr + tsizeBloom, &offsetAggr) <
+        tsizeAggr + tsizeBloom) {
       return -1;
     }
   }
@@ -1201,7 +1395,7 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
   // Update pBlock membership variables
   pBlock->last = isLast;
   pBlock->offset = offset;
-  pBlock->algorithm = pCfg->compression;
+  pBlock->algorithm = algorithm;
   pBlock->numOfRows = rowsToWrite;
   pBlock->len = lsize;
   pBlock->keyLen = keyLen;
@@ -1211,7 +1405,7 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
   pBlock->keyLast = dataColsKeyLast(pDataCols);
   // since blkVer1
   pBlock->aggrStat = aggrStatus;
-  pBlock->blkVer = SBlockVerLatest;
+  pBlock->blkVer = (tsizeBloom > 0) ? TSDB_SBLK_VER_2 : TSDB_SBLK_VER_1;
   pBlock->aggrOffset = (uint64_t)offsetAggr;
 
   tsdbDebug("vgId:%d tid:%d a block of data is written to file %s, offset %" PRId64
@@ -1222,12 +1416,226 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDFile
   return 0;
 }
 
+/*
+ * Pick the codec of a column chunk by compressing a sample of it with each candidate. The candidates go from the
+ * fastest to decode to the slowest: raw, the codec of the type (delta-of-delta, simple8b, bool RLE, XOR or chimp
+ * floats, LZ4 strings), then the codec of the type followed by LZ4. A slower one is only picked if it saves enough
+ * bytes over the current pick, and the compression level of the database bounds the stages.
+ */
+static int8_t tsdbPickColAlgorithm(SDataCol *pDataCol, const void *data, int32_t len, int rows, int8_t algorithm,
+                                   void **ppBuf) {
+  bool    isFloat = (pDataCol->type == TSDB_DATA_TYPE_FLOAT || pDataCol->type == TSDB_DATA_TYPE_DOUBLE);
+  int8_t  candidates[5];
+  int     numOfCandidates = 0;
+  int32_t slen = len;
+  int     srows = rows;
+
+#ifdef TD_TSZ
+  // lossy codecs are configured by columns, not picked
+  if ((pDataCol->type == TSDB_DATA_TYPE_FLOAT && lossyFloat) || (pDataCol->type == TSDB_DATA_TYPE_DOUBLE && lossyDouble)) {
+    return algorithm;
+  }
+#endif
+
+  candidates[numOfCandidates++] = NO_COMPRESSION;
+  candidates[numOfCandidates++] = ONE_STAGE_COMP;
+  if (isFloat) candidates[numOfCandidates++] = ONE_STAGE_COMP | COMP_FLOAT_CHIMP;
+  // strings are compressed by LZ4 in both stages
+  if (COMP_STAGE(algorithm) == TWO_STAGE_COMP && !IS_VAR_DATA_TYPE(pDataCol->type)) {
+    candidates[numOfCandidates++] = TWO_STAGE_COMP;
+    if (isFloat) candidates[numOfCandidates++] = TWO_STAGE_COMP | COMP_FLOAT_CHIMP;
+  }
+
+  // the codecs of strings see bytes only, others whole values
+  if (len > TSDB_COL_COMP_SAMPLE_BYTES) {
+    if (IS_VAR_DATA_TYPE(pDataCol->type)) {
+      slen = TSDB_COL_COMP_SAMPLE_BYTES;
+    } else {
+      srows = TSDB_COL_COMP_SAMPLE_BYTES / TYPE_BYTES[pDataCol->type];
+      slen = srows * TYPE_BYTES[pDataCol->type];
+    }
+  }
+
+  int32_t bsize = slen + COMP_OVERFLOW_BYTES;
+  if (tsdbMakeRoom(ppBuf, bsize * 2) < 0) return -1;
+  char *output = (char *)(*ppBuf);
+  char *buffer = output + bsize;
+
+  int8_t  picked = NO_COMPRESSION;
+  int32_t psize = slen;
+  for (int i = 1; i < numOfCandidates; i++) {
+    int32_t csize = (*(tDataTypes[pDataCol->type].compFunc))((char *)data, slen, srows, output, bsize, candidates[i],
+                                                             buffer, bsize);
+    if (csize <= 0) continue;
+
+    // codecs of the same cost compete by size only
+    bool sameCost = (COMP_STAGE(candidates[i]) == COMP_STAGE(picked));
+    if (sameCost ? (csize < psize) : (csize * 100 < psize * (100 - TSDB_COL_COMP_MIN_GAIN))) {
+      picked = candidates[i];
+      psize = csize;
+    }
+  }
+
+  return picked;
+}
+
+/**
+ * Encode a binary/nchar column as its distinct values, followed by a one byte entry index per row and the uint16_t
+ * number of entries. Return the encoded length, or -1 if there are too many distinct values.
+ */
+static int32_t tsdbEncodeColDict(SDataCol *pDataCol, int rows, char *output) {
+  uint16_t numOfDict = 0;
+  int32_t  dictLen = 0;
+
+  if (pDataCol->numOfDict > 0) {
+    // loaded from a dictionary block, pData only holds the entries
+    numOfDict = (uint16_t)pDataCol->numOfDict;
+    dictLen = pDataCol->len;
+    memcpy(output, pDataCol->pData, dictLen);
+  } else {
+    int16_t slots[TSDB_COL_DICT_HASH_SLOTS];
+    char *  entries[UINT8_MAX + 1];
+
+    memset(slots, -1, sizeof(slots));
+    for (int i = 0; i < rows; i++) {
+      char *   value = (char *)tdGetColDataOfRow(pDataCol, i);
+      int32_t  vlen = varDataTLen(value);
+      uint32_t slot = MurmurHash3_32(value, vlen) & (TSDB_COL_DICT_HASH_SLOTS - 1);
+
+      while (slots[slot] >= 0 && memcmp(entries[slots[slot]], value, vlen) != 0) {
+        slot = (slot + 1) & (TSDB_COL_DICT_HASH_SLOTS - 1);
+      }
+
+      if (slots[slot] < 0) {
+        if (numOfDict >= tListLen(entries)) return -1;
+        slots[slot] = numOfDict;
+        entries[numOfDict++] = POINTER_SHIFT(output, dictLen);
+        memcpy(POINTER_SHIFT(output, dictLen), value, vlen);
+        dictLen += vlen;
+      }
+
+      // the entry index buffer of the column is free in the plain layout
+      pDataCol->dictCode[i] = (uint8_t)slots[slot];
+    }
+  }
+
+  memcpy(POINTER_SHIFT(output, dictLen), pDataCol->dictCode, rows);
+  memcpy(POINTER_SHIFT(output, dictLen + rows), &numOfDict, sizeof(numOfDict));
+
+  return dictLen + rows + (int32_t)sizeof(numOfDict);
+}
+
+/**
+ * Encode the bloom filters of the columns of the filter types with any value to the offset of *ppBuf, with the room
+ * of the checksum left at the end. Return the length of the bloom filter part, or -1 if out of memory.
+ */
+static int32_t tsdbEncodeBlockBloom(SDataCols *pDataCols, int rows, void **ppBuf, uint32_t offset) {
+  int32_t numOfCols = 0;
+  int32_t len = sizeof(SBlockBloomData);
+
+  for (int ncol = 1; ncol < pDataCols->numOfCols; ncol++) {
+    SDataCol *pDataCol = pDataCols->cols + ncol;
+    if (isAllRowsNull(pDataCol) || !TSDB_BLOOM_FILTER_TYPE(pDataCol->type)) continue;
+
+    int numOfKeys = (pDataCol->numOfDict > 0) ? pDataCol->numOfDict : rows;
+    len += sizeof(SBlockBloomCol) + taosBloomFilterSize(numOfKeys, tsdbBloomFilterBits);
+    numOfCols++;
+  }
+
+  if (numOfCols == 0) return 0;
+
+  len += sizeof(TSCKSUM);
+  if (tsdbMakeRoom(ppBuf, offset + len) < 0) return -1;
+
+  SBlockBloomData *pBloom = POINTER_SHIFT(*ppBuf, offset);
+  memset(pBloom, 0, len);
+  pBloom->len = len;
+  pBloom->numOfCols = numOfCols;
+  pBloom->numOfHashes = (uint8_t)taosBloomFilterHashes(tsdbBloomFilterBits);
+
+  uint32_t toffset = (uint32_t)(sizeof(SBlockBloomData) + sizeof(SBlockBloomCol) * numOfCols);
+  int      tcol = 0;
+  for (int ncol = 1; ncol < pDataCols->numOfCols; ncol++) {
+    SDataCol *pDataCol = pDataCols->cols + ncol;
+    if (isAllRowsNull(pDataCol) || !TSDB_BLOOM_FILTER_TYPE(pDataCol->type)) continue;
+
+    SBlockBloomCol *pBloomCol = pBloom->cols + tcol++;
+    int             numOfKeys = (pDataCol->numOfDict > 0) ? pDataCol->numOfDict : rows;
+    uint8_t *       pBits = POINTER_SHIFT(pBloom, toffset);
+
+    pBloomCol->colId = pDataCol->colId;
+    pBloomCol->offset = toffset;
+    pBloomCol->len = taosBloomFilterSize(numOfKeys, tsdbBloomFilterBits);
+
+    // a dictionary column puts each distinct value once
+    const void *value = pDataCol->pData;
+    for (int i = 0; i < numOfKeys; i++) {
+      if (pDataCol->numOfDict == 0) value = tdGetColDataOfRow(pDataCol, i);
+
+      if (!isNull(value, pDataCol->type)) {
+        const void *key = NULL;
+        int32_t     klen = 0;
+        tsdbGetBloomFilterKey(pDataCol->type, value, &key, &klen);
+        taosBloomFilterPut(pBits, pBloomCol->len, pBloom->numOfHashes, key, klen);
+      }
+
+      if (pDataCol->numOfDict > 0) value = POINTER_SHIFT(value, varDataTLen(value));
+    }
+
+    toffset += pBloomCol->len;
+  }
+
+  return len;
+}
+
 static int tsdbWriteBlock(SCommitH *pCommith, SDFile *pDFile, SDataCols *pDataCols, SBlock *pBlock, bool isLast,
                           bool isSuper) {
-  return tsdbWriteBlockImpl(TSDB_COMMIT_REPO(pCommith), TSDB_COMMIT_TABLE(pCommith), pDFile,
-                            isLast ? TSDB_COMMIT_SMAL_FILE(pCommith) : TSDB_COMMIT_SMAD_FILE(pCommith), pDataCols,
-                            pBlock, isLast, isSuper, (void **)(&(TSDB_COMMIT_BUF(pCommith))),
-                            (void **)(&(TSDB_COMMIT_COMP_BUF(pCommith))), (void **)(&(TSDB_COMMIT_EXBUF(pCommith))));
+  SCommitStage *pStage = NULL;
+  SCommitStage *pStageAggr = NULL;
+
+  ASSERT(pDFile == (isLast ? TSDB_COMMIT_LAST_FILE(pCommith) : TSDB_COMMIT_DATA_FILE(pCommith)));
+
+  if (pCommith->stages) {
+    pStage = pCommith->stages + (isLast ? TSDB_FILE_LAST : TSDB_FILE_DATA);
+    pStageAggr = pCommith->stages + (isLast ? TSDB_FILE_SMAL : TSDB_FILE_SMAD);
+  }
+
+  return tsdbWriteBlockImplEx(TSDB_COMMIT_REPO(pCommith), TSDB_COMMIT_TABLE(pCommith), pDFile,
+                              isLast ? TSDB_COMMIT_SMAL_FILE(pCommith) : TSDB_COMMIT_SMAD_FILE(pCommith), pStage,
+                              pStageAggr, pDataCols, pBlock, isLast, isSuper, (void **)(&(TSDB_COMMIT_BUF(pCommith))),
+                              (void **)(&(TSDB_COMMIT_COMP_BUF(pCommith))), (void **)(&(TSDB_COMMIT_EXBUF(pCommith))));
+}
+
+static int tsdbCommitAppend(SDFile *pDFile, SCommitStage *pStage, void *buf, int64_t nbyte, int64_t *offset) {
+  if (pStage == NULL) {
+    return tsdbAppendDFile(pDFile, buf, nbyte, offset);
+  }
+
+  if (tsdbMakeRoom(&(pStage->pBuf), (size_t)(pStage->size + nbyte)) < 0) {
+    return -1;
+  }
+
+  memcpy(POINTER_SHIFT(pStage->pBuf, pStage->size), buf, (size_t)nbyte);
+  if (offset) {
+    *offset = pStage->fsize + pStage->size;
+  }
+  pStage->size += nbyte;
+
+  return (int)nbyte;
+}
+
+static int tsdbCommitUpdateMagic(SDFile *pDFile, SCommitStage *pStage, void *pCksm) {
+  if (pStage == NULL) {
+    tsdbUpdateDFileMagic(pDFile, pCksm);
+    return 0;
+  }
+
+  if (taosArrayPush(pStage->aCksm, pCksm) == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
 }
 
 static int tsdbWriteBlockInfo(SCommitH *pCommih) {
@@ -1262,12 +1670,20 @@ static int tsdbCommitMemData(SCommitH *pCommith, SCommitIter *pIter, TSKEY keyLi
   SBlock     block;
 
   while (true) {
-    tsdbLoadDataFromCache(pIter->pTable, pIter->pIter, keyLimit, defaultRows, pCommith->pDataCols, NULL, 0,
+    TSKEY nextKey = tsdbNextIterKey(pIter->pIter);
+    if (nextKey == TSDB_DATA_TIMESTAMP_NULL || nextKey > keyLimit) break;
+
+    TSKEY blockKeyLimit = tsdbRollupKeyLimit(pCfg->precision, nextKey, keyLimit);
+    tsdbLoadDataFromCache(pIter->pTable, pIter->pIter, blockKeyLimit, defaultRows, pCommith->pDataCols, NULL, 0,
                           pCfg->update, &mInfo);
 
-    if (pCommith->pDataCols->numOfRows <= 0) break;
+    if (pCommith->pDataCols->numOfRows <= 0) continue;
 
-    if (toData || pCommith->pDataCols->numOfRows >= pCfg->minRowsPerFileBlock) {
+    // only the last rows of the table may go to the last file
+    nextKey = tsdbNextIterKey(pIter->pIter);
+    bool isLastRows = (nextKey == TSDB_DATA_TIMESTAMP_NULL || nextKey > keyLimit);
+
+    if (toData || !isLastRows || pCommith->pDataCols->numOfRows >= pCfg->minRowsPerFileBlock) {
       pDFile = TSDB_COMMIT_DATA_FILE(pCommith);
       isLast = false;
     } else {
@@ -1303,7 +1719,7 @@ static int tsdbMergeMemData(SCommitH *pCommith, SCommitIter *pIter, int bidx) {
     keyLimit = pBlock[1].keyFirst - 1;
   }
 
-  SSkipListIterator titer = *(pIter->pIter);
+  STableDataIter titer = *(pIter->pIter);
   if (tsdbLoadBlockDataCols(&(pCommith->readh), pBlock, NULL, &colId, 1) < 0) return -1;
 
   tsdbLoadDataFromCache(pIter->pTable, &titer, keyLimit, INT32_MAX, NULL, pCommith->readh.pDCols[0]->cols[0].pData,
@@ -1417,14 +1833,27 @@ static int tsdbMergeBlockData(SCommitH *pCommith, SCommitIter *pIter, SDataCols
   bool       isLast;
   int32_t    defaultRows = TSDB_COMMIT_DEFAULT_ROWS(pCommith);
 
+  ASSERT(dataColsKeyLast(pDataCols) <= keyLimit);
+
   int biter = 0;
   while (true) {
-    tsdbLoadAndMergeFromCache(pCommith->readh.pDCols[0], &biter, pIter, pCommith->pDataCols, keyLimit, defaultRows,
-                              pCfg->update);
+    TSKEY nextKey = tsdbNextIterKey(pIter->pIter);
+    if (nextKey != TSDB_DATA_TIMESTAMP_NULL && nextKey > keyLimit) nextKey = TSDB_DATA_TIMESTAMP_NULL;
+    if (biter < pDataCols->numOfRows &&
+        (nextKey == TSDB_DATA_TIMESTAMP_NULL || dataColsKeyAt(pDataCols, biter) < nextKey)) {
+      nextKey = dataColsKeyAt(pDataCols, biter);
+    }
+
+    tsdbLoadAndMergeFromCache(pDataCols, &biter, pIter, pCommith->pDataCols,
+                              tsdbRollupKeyLimit(pCfg->precision, nextKey, keyLimit), defaultRows, pCfg->update);
 
     if (pCommith->pDataCols->numOfRows == 0) break;
 
-    if (isLastOneBlock) {
+    // only the last rows of the table may go to the last file
+    TSKEY memKey = tsdbNextIterKey(pIter->pIter);
+    bool  isLastRows = (biter >= pDataCols->numOfRows) && (memKey == TSDB_DATA_TIMESTAMP_NULL || memKey > keyLimit);
+
+    if (isLastOneBlock && isLastRows) {
       if (pCommith->pDataCols->numOfRows < pCfg->minRowsPerFileBlock) {
         pDFile = TSDB_COMMIT_LAST_FILE(pCommith);
         isLast = true;
@@ -1450,11 +1879,15 @@ static void tsdbLoadAndMergeFromCache(SDataCols *pDataCols, int *iter, SCommitIt
   TSKEY     key2 = INT64_MAX;
   STSchema *pSchema = NULL;
 
-  ASSERT(maxRows > 0 && dataColsKeyLast(pDataCols) <= maxKey);
+  ASSERT(maxRows > 0);
   tdResetDataCols(pTarget);
 
   while (true) {
-    key1 = (*iter >= pDataCols->numOfRows) ? INT64_MAX : dataColsKeyAt(pDataCols, *iter);
+    if (*iter >= pDataCols->numOfRows || dataColsKeyAt(pDataCols, *iter) > maxKey) {
+      key1 = INT64_MAX;
+    } else {
+      key1 = dataColsKeyAt(pDataCols, *iter);
+    }
     SMemRow row = tsdbNextIterRow(pCommitIter->pIter);
     if (row == NULL || memRowKey(row) > maxKey) {
       key2 = INT64_MAX;
@@ -1482,7 +1915,7 @@ static void tsdbLoadAndMergeFromCache(SDataCols *pDataCols, int *iter, SCommitIt
 
       tdAppendMemRowToDataCol(row, pSchema, pTarget, true, 0);
 
-      tSkipListIterNext(pCommitIter->pIter);
+      tsdbTableDataIterNext(pCommitIter->pIter);
     } else {
       if (update != TD_ROW_OVERWRITE_UPDATE) {
         //copy disk data
@@ -1506,7 +1939,7 @@ static void tsdbLoadAndMergeFromCache(SDataCols *pDataCols, int *iter, SCommitIt
                                 update != TD_ROW_PARTIAL_UPDATE ? 0 : -1);
       }
       (*iter)++;
-      tSkipListIterNext(pCommitIter->pIter);
+      tsdbTableDataIterNext(pCommitIter->pIter);
     }
 
     if (pTarget->numOfRows >= maxRows) break;
@@ -1739,6 +2172,9 @@ static bool tsdbCanAddSubBlock(SCommitH *pCommith, SBlock *pBlock, SMergeInfo *p
 
   ASSERT(mergeRows > 0);
 
+  // the merged block would cover more than one rollup window
+  if (tsdbRollupWindowLast(pCfg->precision, pInfo->keyFirst) < pInfo->keyLast) return false;
+
   if (pBlock->numOfSubBlocks < TSDB_MAX_SUBBLOCKS && pInfo->nOperations <= pCfg->maxRowsPerFileBlock) {
     if (pBlock->last) {
       if (pCommith->isLFileSame && mergeRows < pCfg->minRowsPerFileBlock) return true;
@@ -1750,6 +2186,203 @@ static bool tsdbCanAddSubBlock(SCommitH *pCommith, SBlock *pBlock, SMergeInfo *p
   return false;
 }
 
+/*
+ * Commit the tables of a file set on the commit workers, in batches of tables taken in tid order. A worker writes the
+ * blocks of a table to its stages, and the commit thread appends the stages of the batch to the files in tid order and
+ * moves the staged offsets to where the bytes end up, so the files are the same as committing the tables one by one.
+ */
+static int tsdbCommitTablesInParallel(SCommitH *pCommith) {
+  int32_t batchTables = TSDB_COMMIT_BATCH_TABLES(pCommith);
+  int     tid = 1;
+
+  while (tid < pCommith->niters) {
+    SCommitBatch batch = {.pCommith = pCommith, .ntables = 0, .next = 0};
+
+    for (; tid < pCommith->niters && batch.ntables < batchTables; tid++) {
+      if (pCommith->iters[tid].pTable == NULL) continue;
+
+      STableCommit *pTCommit = pCommith->tCommits + batch.ntables;
+      pTCommit->tid = tid;
+      pTCommit->code = TSDB_CODE_SUCCESS;
+      for (int ftype = TSDB_FILE_DATA; ftype < TSDB_FILE_MAX; ftype++) {
+        SCommitStage *pStage = pTCommit->stages + ftype;
+
+        pStage->size = 0;
+        pStage->fsize = TSDB_DFILE_IN_SET(TSDB_COMMIT_WRITE_FSET(pCommith), ftype)->info.size;
+        taosArrayClear(pStage->aCksm);
+      }
+      batch.ntables++;
+    }
+
+    if (batch.ntables == 0) break;
+
+    tsdbParallelCommit(tsdbCommitBatchWorker, &batch, MIN(pCommith->nWorkers, batch.ntables));
+
+    for (int i = 0; i < batch.ntables; i++) {
+      if (tsdbMergeTableCommit(pCommith, pCommith->tCommits + i) < 0) {
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static void tsdbCommitBatchWorker(void *param, int32_t idx) {
+  SCommitBatch *pBatch = (SCommitBatch *)param;
+  SCommitH *    pWorker = pBatch->pCommith->workers + idx;
+
+  // the tables a worker takes go up in tid order, as the block index of its read handle is walked forward
+  while (true) {
+    int32_t i = atomic_fetch_add_32(&(pBatch->next), 1);
+    if (i >= pBatch->ntables) break;
+
+    STableCommit *pTCommit = pBatch->pCommith->tCommits + i;
+
+    pWorker->aSupBlk = pTCommit->aSupBlk;
+    pWorker->aSubBlk = pTCommit->aSubBlk;
+    pWorker->stages = pTCommit->stages;
+    pTCommit->code = (tsdbCommitTableData(pWorker, pTCommit->tid) < 0) ? terrno : TSDB_CODE_SUCCESS;
+  }
+}
+
+static void tsdbRelocateBlock(SBlock *pBlock, SCommitStage *stages, int64_t *delta) {
+  int ftype = pBlock->last ? TSDB_FILE_LAST : TSDB_FILE_DATA;
+  int atype = pBlock->last ? TSDB_FILE_SMAL : TSDB_FILE_SMAD;
+
+  // blocks moved as they are keep their offsets in the files
+  if ((int64_t)pBlock->offset >= stages[ftype].fsize) {
+    pBlock->offset += delta[ftype];
+  }
+
+  if (pBlock->aggrStat && (int64_t)pBlock->aggrOffset >= stages[atype].fsize) {
+    pBlock->aggrOffset += delta[atype];
+  }
+}
+
+static int tsdbMergeTableCommit(SCommitH *pCommith, STableCommit *pTCommit) {
+  STable *  pTable = pCommith->iters[pTCommit->tid].pTable;
+  int64_t   delta[TSDB_FILE_MAX] = {0};
+  SBlockIdx blkIdx;
+
+  if (pTCommit->code != TSDB_CODE_SUCCESS) {
+    terrno = pTCommit->code;
+    return -1;
+  }
+
+  for (int ftype = TSDB_FILE_DATA; ftype < TSDB_FILE_MAX; ftype++) {
+    SDFile *      pDFile = TSDB_DFILE_IN_SET(TSDB_COMMIT_WRITE_FSET(pCommith), ftype);
+    SCommitStage *pStage = pTCommit->stages + ftype;
+    size_t        nCksm = taosArrayGetSize(pStage->aCksm);
+
+    delta[ftype] = pDFile->info.size - pStage->fsize;
+
+    for (size_t i = 0; i < nCksm; i++) {
+      tsdbUpdateDFileMagic(pDFile, taosArrayGet(pStage->aCksm, i));
+    }
+
+    if (pStage->size > 0 && tsdbAppendDFile(pDFile, pStage->pBuf, pStage->size, NULL) < pStage->size) {
+      return -1;
+    }
+  }
+
+  // a super block with sub-blocks points to its sub-blocks instead of the file
+  size_t nSupBlocks = taosArrayGetSize(pTCommit->aSupBlk);
+  for (size_t i = 0; i < nSupBlocks; i++) {
+    SBlock *pBlock = taosArrayGet(pTCommit->aSupBlk, i);
+    if (pBlock->numOfSubBlocks == 1) tsdbRelocateBlock(pBlock, pTCommit->stages, delta);
+  }
+
+  size_t nSubBlocks = taosArrayGetSize(pTCommit->aSubBlk);
+  for (size_t i = 0; i < nSubBlocks; i++) {
+    tsdbRelocateBlock(taosArrayGet(pTCommit->aSubBlk, i), pTCommit->stages, delta);
+  }
+
+  if (tsdbWriteBlockInfoImpl(TSDB_COMMIT_HEAD_FILE(pCommith), pTable, pTCommit->aSupBlk, pTCommit->aSubBlk,
+                             (void **)(&(TSDB_COMMIT_BUF(pCommith))), &blkIdx) < 0) {
+    tsdbError("vgId:%d failed to write SBlockInfo part into file %s since %s", TSDB_COMMIT_REPO_ID(pCommith),
+              TSDB_FILE_FULL_NAME(TSDB_COMMIT_HEAD_FILE(pCommith)), tstrerror(terrno));
+    return -1;
+  }
+
+  if (blkIdx.numOfBlocks == 0) {
+    return 0;
+  }
+
+  if (taosArrayPush(pCommith->aBlkIdx, (void *)(&blkIdx)) == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
+}
+
+static int tsdbInitCommitWorkerH(SCommitH *pCommith, STsdbRepo *pRepo, SCommitH *pWorker) {
+  STsdbCfg *pCfg = REPO_CFG(pRepo);
+
+  TSDB_FSET_SET_CLOSED(TSDB_COMMIT_WRITE_FSET(pWorker));
+  pWorker->niters = pCommith->niters;
+  pWorker->iters = pCommith->iters;
+
+  if (tsdbInitReadH(&(pWorker->readh), pRepo) < 0) {
+    return -1;
+  }
+
+  pWorker->pDataCols = tdNewDataCols(0, pCfg->maxRowsPerFileBlock);
+  if (pWorker->pDataCols == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
+}
+
+static void tsdbDestroyCommitWorkerH(SCommitH *pWorker) {
+  pWorker->pDataCols = tdFreeDataCols(pWorker->pDataCols);
+  // the write file set and the iterators belong to the commit handle
+  if (pWorker->readh.pRepo != NULL) {
+    tsdbDestroyReadH(&(pWorker->readh));
+  }
+}
+
+static int tsdbSetCommitWorkerFile(SCommitH *pCommith, SDFileSet *pSet) {
+  for (int i = 0; i < pCommith->nWorkers; i++) {
+    SCommitH *pWorker = pCommith->workers + i;
+
+    pWorker->wSet = pCommith->wSet;
+    pWorker->isDFileSame = pCommith->isDFileSame;
+    pWorker->isLFileSame = pCommith->isLFileSame;
+    pWorker->minKey = pCommith->minKey;
+    pWorker->maxKey = pCommith->maxKey;
+    pWorker->isRFileSet = false;
+
+    if (pCommith->isRFileSet) {
+      if (tsdbSetAndOpenReadFSet(&(pWorker->readh), pSet) < 0) {
+        return -1;
+      }
+
+      pWorker->isRFileSet = true;
+
+      if (tsdbLoadBlockIdx(&(pWorker->readh)) < 0) {
+        return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+static void tsdbCloseCommitWorkerFile(SCommitH *pCommith) {
+  for (int i = 0; i < pCommith->nWorkers; i++) {
+    SCommitH *pWorker = pCommith->workers + i;
+
+    if (pWorker->isRFileSet) {
+      tsdbCloseAndUnsetFSet(&(pWorker->readh));
+      pWorker->isRFileSet = false;
+    }
+  }
+}
+
 int tsdbApplyRtn(STsdbRepo *pRepo) {
   SRtn       rtn;
   SFSIter    fsiter;
@@ -58,8 +58,8 @@ static int  tsdbCacheFSetIndex(SCompactH *pComph);
 static int  tsdbCompactFSetInit(SCompactH *pComph, SDFileSet *pSet);
 static void tsdbCompactFSetEnd(SCompactH *pComph);
 static int  tsdbCompactFSetImpl(SCompactH *pComph);
-static int  tsdbWriteBlockToRightFile(SCompactH *pComph, STable *pTable, SDataCols *pDataCols, void **ppBuf,
-                                      void **ppCBuf, void **ppExBuf);
+static int  tsdbWriteBlockToRightFile(SCompactH *pComph, STable *pTable, SDataCols *pDataCols, bool toData,
+                                      void **ppBuf, void **ppCBuf, void **ppExBuf);
 
 enum { TSDB_NO_COMPACT, TSDB_IN_COMPACT, TSDB_WAITING_COMPACT};
 int tsdbCompact(STsdbRepo *pRepo) { return tsdbAsyncCompact(pRepo); }
@@ -458,8 +458,9 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
         }
 
         // Merge pComph->pDataCols and pReadh->pDCols[0] and write data to file
-        if (pComph->pDataCols->numOfRows == 0 && pBlock->numOfRows >= defaultRows) {
-          if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pReadh->pDCols[0], ppBuf, ppCBuf, ppExBuf) < 0) {
+        if (pComph->pDataCols->numOfRows == 0 && pBlock->numOfRows >= defaultRows &&
+            tsdbRollupWindowLast(pCfg->precision, pBlock->keyFirst) >= pBlock->keyLast) {
+          if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pReadh->pDCols[0], false, ppBuf, ppCBuf, ppExBuf) < 0) {
             return -1;
           }
         } else {
@@ -469,13 +470,27 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
             if (pReadh->pDCols[0]->numOfRows - ridx == 0) break;
             int rowsToMerge = MIN(pReadh->pDCols[0]->numOfRows - ridx, defaultRows - pComph->pDataCols->numOfRows);
 
-            tdMergeDataCols(pComph->pDataCols, pReadh->pDCols[0], rowsToMerge, &ridx, pCfg->update != TD_ROW_PARTIAL_UPDATE);
+            // the rows of the next rollup window go to a block of their own
+            TSKEY firstKey = (pComph->pDataCols->numOfRows > 0) ? dataColsKeyFirst(pComph->pDataCols)
+                                                                 : dataColsKeyAt(pReadh->pDCols[0], ridx);
+            TSKEY windowLast = tsdbRollupWindowLast(pCfg->precision, firstKey);
+            int   rowsInWindow = 0;
+            while (rowsInWindow < rowsToMerge && dataColsKeyAt(pReadh->pDCols[0], ridx + rowsInWindow) <= windowLast) {
+              rowsInWindow++;
+            }
+            bool isWindowEnd = (rowsInWindow < rowsToMerge);
+
+            if (rowsInWindow > 0) {
+              tdMergeDataCols(pComph->pDataCols, pReadh->pDCols[0], rowsInWindow, &ridx,
+                              pCfg->update != TD_ROW_PARTIAL_UPDATE);
+            }
 
-            if (pComph->pDataCols->numOfRows < defaultRows) {
+            if (pComph->pDataCols->numOfRows < defaultRows && !isWindowEnd) {
               break;
             }
 
-            if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pComph->pDataCols, ppBuf, ppCBuf, ppExBuf) < 0) {
+            if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pComph->pDataCols, isWindowEnd, ppBuf, ppCBuf,
+                                          ppExBuf) < 0) {
               return -1;
             }
             tdResetDataCols(pComph->pDataCols);
@@ -484,7 +499,7 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
       }
 
       if (pComph->pDataCols->numOfRows > 0 &&
-          tsdbWriteBlockToRightFile(pComph, pTh->pTable, pComph->pDataCols, ppBuf, ppCBuf, ppExBuf) < 0) {
+          tsdbWriteBlockToRightFile(pComph, pTh->pTable, pComph->pDataCols, false, ppBuf, ppCBuf, ppExBuf) < 0) {
         return -1;
       }
 
@@ -506,8 +521,8 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
     return 0;
   }
 
-  static int tsdbWriteBlockToRightFile(SCompactH *pComph, STable *pTable, SDataCols *pDataCols, void **ppBuf,
-                                       void **ppCBuf, void **ppExBuf) {
+  static int tsdbWriteBlockToRightFile(SCompactH *pComph, STable *pTable, SDataCols *pDataCols, bool toData,
+                                       void **ppBuf, void **ppCBuf, void **ppExBuf) {
     STsdbRepo *pRepo = TSDB_COMPACT_REPO(pComph);
     STsdbCfg * pCfg = REPO_CFG(pRepo);
     SDFile *   pDFile;
@@ -516,7 +531,7 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
 
     ASSERT(pDataCols->numOfRows > 0);
 
-    if (pDataCols->numOfRows < pCfg->minRowsPerFileBlock) {
+    if (!toData && pDataCols->numOfRows < pCfg->minRowsPerFileBlock) {
       pDFile = TSDB_COMPACT_LAST_FILE(pComph);
       isLast = true;
     } else {
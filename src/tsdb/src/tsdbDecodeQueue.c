@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+#include "tsched.h"
+
+#define TSDB_DECODE_QUEUE_SIZE 1024
+#define TSDB_COMMIT_WORKER_QUEUE_SIZE 256
+
+typedef struct {
+  int32_t nthreads;
+  void *  pSched;
+} SDecodeQueue;
+
+typedef struct {
+  __tsdb_batch_fn_t  fp;
+  void *             param;
+  int32_t            num;
+  int32_t            next;  // next index to decode, taken atomically
+  tsem_t             done;  // posted by each helper task when it finishes
+} SDecodeBatch;
+
+static SDecodeQueue tsDecodeQueue = {0};
+// the commit workers have their own threads, since a commit task waits for the decode tasks of its reads
+static SDecodeQueue tsCommitWorkerQueue = {0};
+
+static int  tsdbInitQueue(SDecodeQueue *pQueue, int32_t nthreads, int32_t queueSize, const char *label);
+static void tsdbDestroyQueue(SDecodeQueue *pQueue);
+static void tsdbRunBatch(SDecodeQueue *pQueue, __tsdb_batch_fn_t fp, void *param, int32_t num);
+static void tsdbLoopDecodeBatch(SDecodeBatch *pBatch);
+static void tsdbDecodeHelper(SSchedMsg *pMsg);
+
+int tsdbInitDecodeQueue() {
+  return tsdbInitQueue(&tsDecodeQueue, tsNumOfDecodeThreads, TSDB_DECODE_QUEUE_SIZE, "tsdb-decode");
+}
+
+void tsdbDestroyDecodeQueue() { tsdbDestroyQueue(&tsDecodeQueue); }
+
+int32_t tsdbDecodeThreads() { return tsDecodeQueue.nthreads; }
+
+void tsdbParallelDecode(__tsdb_batch_fn_t fp, void *param, int32_t num) {
+  tsdbRunBatch(&tsDecodeQueue, fp, param, num);
+}
+
+int tsdbInitCommitWorkers() {
+  return tsdbInitQueue(&tsCommitWorkerQueue, tsNumOfCommitWorkers, TSDB_COMMIT_WORKER_QUEUE_SIZE, "tsdb-cworker");
+}
+
+void tsdbDestroyCommitWorkers() { tsdbDestroyQueue(&tsCommitWorkerQueue); }
+
+int32_t tsdbCommitWorkers() { return tsCommitWorkerQueue.nthreads; }
+
+void tsdbParallelCommit(__tsdb_batch_fn_t fp, void *param, int32_t num) {
+  tsdbRunBatch(&tsCommitWorkerQueue, fp, param, num);
+}
+
+static int tsdbInitQueue(SDecodeQueue *pQueue, int32_t nthreads, int32_t queueSize, const char *label) {
+  pQueue->nthreads = nthreads;
+  if (pQueue->nthreads <= 0) {
+    pQueue->nthreads = 0;
+    return 0;
+  }
+
+  pQueue->pSched = taosInitScheduler(queueSize, pQueue->nthreads, label);
+  if (pQueue->pSched == NULL) {
+    pQueue->nthreads = 0;
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
+}
+
+static void tsdbDestroyQueue(SDecodeQueue *pQueue) {
+  if (pQueue->pSched == NULL) return;
+
+  pQueue->nthreads = 0;
+  taosCleanUpScheduler(pQueue->pSched);
+  pQueue->pSched = NULL;
+}
+
+static void tsdbRunBatch(SDecodeQueue *pQueue, __tsdb_batch_fn_t fp, void *param, int32_t num) {
+  SDecodeBatch  batch = {.fp = fp, .param = param, .num = num, .next = 0};
+  int32_t       nhelpers = MIN(num - 1, pQueue->nthreads);
+
+  if (nhelpers <= 0) {
+    tsdbLoopDecodeBatch(&batch);
+    return;
+  }
+
+  tsem_init(&batch.done, 0, 0);
+
+  for (int32_t i = 0; i < nhelpers; i++) {
+    SSchedMsg msg = {.fp = tsdbDecodeHelper, .ahandle = &batch};
+    taosScheduleTask(pQueue->pSched, &msg);
+  }
+
+  // the calling thread takes its part, so the batch goes on even if all the decode threads are busy
+  tsdbLoopDecodeBatch(&batch);
+
+  for (int32_t i = 0; i < nhelpers; i++) {
+    tsem_wait(&batch.done);
+  }
+
+  tsem_destroy(&batch.done);
+}
+
+static void tsdbLoopDecodeBatch(SDecodeBatch *pBatch) {
+  int32_t idx;
+  while ((idx = atomic_fetch_add_32(&pBatch->next, 1)) < pBatch->num) {
+    (*pBatch->fp)(pBatch->param, idx);
+  }
+}
+
+static void tsdbDecodeHelper(SSchedMsg *pMsg) {
+  SDecodeBatch *pBatch = (SDecodeBatch *)pMsg->ahandle;
+
+  tsdbLoopDecodeBatch(pBatch);
+  tsem_post(&pBatch->done);
+}
@@ -392,6 +392,8 @@ int tsdbEndFSTxn(STsdbRepo *pRepo) {
   pfs->nstatus = pStatus;
   tsdbUnLockFS(pfs);
 
+  tsdbInvalidateBlockCache(pRepo->pBlockCache, FS_VERSION(pfs));
+
   // Apply actual change to each file and SDFileSet
   tsdbApplyFSTxnOnDisk(pfs->nstatus, pfs->cstatus);
 
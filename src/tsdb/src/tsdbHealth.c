@@ -33,7 +33,7 @@ int32_t tsdbInsertNewBlock(STsdbRepo * pRepo) {
   int32_t cnt = 0;
 
   if(tsdbAllowNewBlock(pRepo)) {
-    STsdbBufBlock *pBufBlock = tsdbNewBufBlock(pPool->bufBlockSize);
+    STsdbBufBlock *pBufBlock = tsdbNewBufBlock(pPool->bufBlockSize, &pPool->numaNode);
     if (pBufBlock) {
         if (tdListAppend(pPool->bufBlockList, (void *)(&pBufBlock)) < 0) {
           // append error
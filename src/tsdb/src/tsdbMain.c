@@ -200,13 +200,30 @@ int tsdbCheckCommit(STsdbRepo *pRepo) {
   STsdbBufBlock *pBufBlock = tsdbGetCurrBufBlock(pRepo);
   ASSERT(pBufBlock != NULL);
   if ((pRepo->mem->extraBuffList != NULL) ||
-      ((listNEles(pRepo->mem->bufBlockList) >= pCfg->totalBlocks / 3) && (pBufBlock->remain < TSDB_BUFFER_RESERVE))) {
+      ((listNEles(pRepo->mem->bufBlockList) >= pCfg->totalBlocks / 3) && (pBufBlock->remain < TSDB_BUFFER_RESERVE)) ||
+      ((pRepo->mem->pinnedSize > 0) && (tsdbGetMemFill(pRepo) >= 100))) {
     // trigger commit
     if (tsdbAsyncCommit(pRepo) < 0) return -1;
   }
   return 0;
 }
 
+int32_t tsdbGetMemFill(STsdbRepo *pRepo) {
+  STsdbCfg * pCfg = &(pRepo->config);
+  SMemTable *pMem = pRepo->mem;
+
+  if (pMem == NULL || listNEles(pMem->bufBlockList) == 0) return 0;
+  if (pMem->extraBuffList != NULL) return 100;
+
+  // the submit msgs pinned by the memtable take the place of the rows copied into the buffer blocks
+  STsdbBufBlock *pBufBlock = tsdbGetCurrBufBlock(pRepo);
+  int64_t        bufBlockSize = pRepo->pPool->bufBlockSize;
+  int64_t        limit = MAX(pCfg->totalBlocks / 3, 1) * bufBlockSize;
+  int64_t        used = (listNEles(pMem->bufBlockList) - 1) * bufBlockSize + pBufBlock->offset + pMem->pinnedSize;
+
+  return (int32_t)MIN(used * 100 / limit, 100);
+}
+
 STsdbMeta *tsdbGetMeta(STsdbRepo *pRepo) { return pRepo->tsdbMeta; }
 
 STsdbRepoInfo *tsdbGetStatus(STsdbRepo *pRepo) { return NULL; }
@@ -215,6 +232,9 @@ int tsdbGetState(STsdbRepo *repo) { return repo->state; }
 
 int8_t tsdbGetCompactState(STsdbRepo *repo) { return (int8_t)(repo->compactState); }
 
+// numa node the buffer pool is bound to, -1 if it is not bound or binding it failed
+int32_t tsdbGetNumaNode(STsdbRepo *repo) { return repo->pPool->numaNode; }
+
 void tsdbReportStat(void *repo, int64_t *totalPoints, int64_t *totalStorage, int64_t *compStorage) {
   ASSERT(repo != NULL);
   STsdbRepo *pRepo = repo;
@@ -626,11 +646,21 @@ static STsdbRepo *tsdbNewRepo(STsdbCfg *pCfg, STsdbAppH *pAppH) {
     return NULL;
   }
 
+  if (tsQueryBlockCacheSize > 0) {
+    pRepo->pBlockCache = tsdbNewBlockCache((int64_t)tsQueryBlockCacheSize * 1024 * 1024);
+    if (pRepo->pBlockCache == NULL) {
+      tsdbError("vgId:%d failed to create block cache since %s", REPO_ID(pRepo), tstrerror(terrno));
+      tsdbFreeRepo(pRepo);
+      return NULL;
+    }
+  }
+
   return pRepo;
 }
 
 static void tsdbFreeRepo(STsdbRepo *pRepo) {
   if (pRepo) {
+    tsdbFreeBlockCache(pRepo->pBlockCache);
     tsdbFreeFS(pRepo->fs);
     tsdbFreeBufPool(pRepo->pPool);
     tsdbFreeMeta(pRepo->tsdbMeta);
@@ -21,6 +21,8 @@
 
 #define TSDB_DATA_SKIPLIST_LEVEL 5
 #define TSDB_MAX_INSERT_BATCH 512
+#define TSDB_DATA_CHUNK_MIN_ROWS 16
+#define TSDB_DATA_CHUNK_MAX_ROWS 4096
 
 typedef struct {
   int32_t  totalLen;
@@ -35,16 +37,24 @@ typedef struct {
 } SSubmitMsgIter;
 
 static SMemTable *  tsdbNewMemTable(STsdbRepo *pRepo);
+static int          tsdbEnsureMemTable(STsdbRepo *pRepo);
 static void         tsdbFreeMemTable(SMemTable *pMemTable);
 static STableData*  tsdbNewTableData(STsdbCfg *pCfg, STable *pTable);
 static void         tsdbFreeTableData(STableData *pTableData);
+static SSkipList *  tsdbNewTableSkipList(STsdbCfg *pCfg);
+static STableDataChunk *tsdbNewTableDataChunk(STableDataChunk *pPrev);
+static int          tsdbAppendRowsToTableData(STsdbRepo *pRepo, STableData *pTableData, SSubmitBlkIter *pIter, void *pPin,
+                                              int32_t *pPoints, SMemRow *pLastRow);
+static int          tsdbMoveTableDataToSkipList(STsdbCfg *pCfg, STableData *pTableData);
 static char *       tsdbGetTsTupleKey(const void *data);
 static int          tsdbAdjustMemMaxTables(SMemTable *pMemTable, int maxTables);
 static int          tsdbAppendTableRowToCols(STable *pTable, SDataCols *pCols, STSchema **ppSchema, SMemRow row);
 static int          tsdbInitSubmitBlkIter(SSubmitBlk *pBlock, SSubmitBlkIter *pIter);
 static SMemRow      tsdbGetSubmitBlkNext(SSubmitBlkIter *pIter);
 static int          tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg);
-static int          tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *affectedrows);
+static int          tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *affectedrows, void *pPin);
+static int          tsdbPinSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg, void *pPin);
+static void         tsdbUnpinSubmitMsg(STsdbRepo *pRepo, void *pPin);
 static int          tsdbInitSubmitMsgIter(SSubmitMsg *pMsg, SSubmitMsgIter *pIter);
 static int          tsdbGetSubmitMsgNext(SSubmitMsgIter *pIter, SSubmitBlk **pPBlock);
 static int          tsdbCheckTableSchema(STsdbRepo *pRepo, SSubmitBlk *pBlock, STable *pTable);
@@ -53,7 +63,7 @@ static int          tsdbUpdateTableLatestInfo(STsdbRepo *pRepo, STable *pTable,
 static FORCE_INLINE int tsdbCheckRowRange(STsdbRepo *pRepo, STable *pTable, SMemRow row, TSKEY minKey, TSKEY maxKey,
                                           TSKEY now);
 
-int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp) {
+int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp, void *pPin) {
   STsdbRepo *    pRepo = repo;
   SSubmitMsgIter msgIter = {0};
   SSubmitBlk *   pBlock = NULL;
@@ -63,6 +73,14 @@ int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pR
     if (terrno != TSDB_CODE_TDB_TABLE_RECONFIGURE) {
       tsdbError("vgId:%d failed to insert data since %s", REPO_ID(pRepo), tstrerror(terrno));
     }
+    tsdbUnpinSubmitMsg(pRepo, pPin);
+    return -1;
+  }
+
+  // the msg is pinned to the memtable before any of its rows is referenced
+  if (pPin != NULL && tsdbPinSubmitMsg(pRepo, pMsg, pPin) < 0) {
+    tsdbError("vgId:%d failed to pin submit msg since %s", REPO_ID(pRepo), tstrerror(terrno));
+    tsdbUnpinSubmitMsg(pRepo, pPin);
     return -1;
   }
 
@@ -70,7 +88,7 @@ int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pR
   while (true) {
     tsdbGetSubmitMsgNext(&msgIter, &pBlock);
     if (pBlock == NULL) break;
-    if (tsdbInsertDataToTable(pRepo, pBlock, &affectedrows) < 0) {
+    if (tsdbInsertDataToTable(pRepo, pBlock, &affectedrows, pPin) < 0) {
       return -1;
     }
     numOfRows += pBlock->numOfRows;
@@ -136,6 +154,15 @@ int tsdbUnRefMemTable(STsdbRepo *pRepo, SMemTable *pMemTable) {
       }
     }
 
+    if (pMemTable->pinList != NULL) {
+      while ((pNode = tdListPopHead(pMemTable->pinList)) != NULL) {
+        void *pPin = NULL;
+        tdListNodeGetData(pMemTable->pinList, pNode, &pPin);
+        tsdbUnpinSubmitMsg(pRepo, pPin);
+        free(pNode);
+      }
+    }
+
     tdListDiscard(pMemTable->actList);
     tdListDiscard(pMemTable->bufBlockList);
     tsdbFreeMemTable(pMemTable);
@@ -225,11 +252,7 @@ void *tsdbAllocBytes(STsdbRepo *pRepo, int bytes) {
   void *         ptr = NULL;
 
   // Either allocate from buffer blocks or from SYSTEM memory pool
-  if (pRepo->mem == NULL) {
-    SMemTable *pMemTable = tsdbNewMemTable(pRepo);
-    if (pMemTable == NULL) return NULL;
-    pRepo->mem = pMemTable;
-  }
+  if (tsdbEnsureMemTable(pRepo) < 0) return NULL;
 
   ASSERT(pRepo->mem != NULL);
 
@@ -355,7 +378,7 @@ int tsdbSyncCommit(STsdbRepo *repo) {
  * 
  * The function tries to procceed AS MUCH AS POSSIBLE.
  */
-int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey, int maxRowsToRead, SDataCols *pCols,
+int tsdbLoadDataFromCache(STable *pTable, STableDataIter *pIter, TSKEY maxKey, int maxRowsToRead, SDataCols *pCols,
                           TKEY *filterKeys, int nFilterKeys, bool keepDup, SMergeInfo *pMergeInfo) {
   ASSERT(maxRowsToRead > 0 && nFilterKeys >= 0);
   if (pIter == NULL) return 0;
@@ -415,7 +438,7 @@ int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey
         tsdbAppendTableRowToCols(pTable, pCols, &pSchema, row);
       }
 
-      tSkipListIterNext(pIter);
+      tsdbTableDataIterNext(pIter);
       row = tsdbNextIterRow(pIter);
       if (row == NULL || memRowKey(row) > maxKey) {
         rowKey = INT64_MAX;
@@ -445,7 +468,7 @@ int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey
         }
       }
 
-      tSkipListIterNext(pIter);
+      tsdbTableDataIterNext(pIter);
       row = tsdbNextIterRow(pIter);
       if (row == NULL || memRowKey(row) > maxKey) {
         rowKey = INT64_MAX;
@@ -467,7 +490,125 @@ int tsdbLoadDataFromCache(STable *pTable, SSkipListIterator *pIter, TSKEY maxKey
   return 0;
 }
 
+STableDataIter *tsdbCreateTableDataIter(STableData *pTableData, TKEY *pKey, int32_t order) {
+  ASSERT(order == TSDB_ORDER_ASC || order == TSDB_ORDER_DESC);
+
+  STableDataIter *pIter = (STableDataIter *)calloc(1, sizeof(*pIter));
+  if (pIter == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+  pIter->order = order;
+
+  SSkipList *pSkipList = atomic_load_ptr(&pTableData->pData);
+  if (pSkipList != NULL) {
+    SSkipListIterator *pSlIter = tSkipListCreateIterFromVal(pSkipList, (const char *)pKey, TSDB_DATA_TYPE_TIMESTAMP, order);
+    if (pSlIter == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      free(pIter);
+      return NULL;
+    }
+    pIter->slIter = *pSlIter;
+    tSkipListDestroyIter(pSlIter);
+    return pIter;
+  }
+
+  // The writer appends a row before it publishes numOfRows, and fills a chunk before it links the next one, so the
+  // next pointer is loaded before numOfRows
+  pIter->chunked = true;
+  STableDataChunk *pChunk = atomic_load_ptr(&pTableData->pHead);
+  if (pChunk == NULL) return pIter;
+
+  TSKEY key = (pKey == NULL) ? ((order == TSDB_ORDER_ASC) ? INT64_MIN : INT64_MAX) : tdGetKey(*pKey);
+  if (order == TSDB_ORDER_ASC) {
+    // the first chunk with a key not less than the key, or the last chunk
+    while (true) {
+      STableDataChunk *pNext = atomic_load_ptr(&pChunk->next);
+      int32_t          numOfRows = atomic_load_32(&pChunk->numOfRows);
+      if (pNext == NULL || pChunk->keys[numOfRows - 1] >= key) break;
+      pChunk = pNext;
+    }
+
+    int32_t lo = 0, hi = atomic_load_32(&pChunk->numOfRows);
+    while (lo < hi) {
+      int32_t mid = lo + (hi - lo) / 2;
+      if (pChunk->keys[mid] < key) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    pIter->pos = lo - 1;
+  } else {
+    // the last chunk starting with a key not greater than the key
+    while (true) {
+      STableDataChunk *pNext = atomic_load_ptr(&pChunk->next);
+      if (pNext == NULL || pNext->keys[0] > key) break;
+      pChunk = pNext;
+    }
+
+    int32_t lo = 0, hi = atomic_load_32(&pChunk->numOfRows);
+    while (lo < hi) {
+      int32_t mid = lo + (hi - lo) / 2;
+      if (pChunk->keys[mid] <= key) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    pIter->pos = lo;
+  }
+  pIter->pChunk = pChunk;
+
+  return pIter;
+}
+
+bool tsdbTableDataIterNext(STableDataIter *pIter) {
+  if (!pIter->chunked) return tSkipListIterNext(&pIter->slIter);
+
+  STableDataChunk *pChunk = pIter->pChunk;
+  if (pChunk == NULL) return false;
+
+  if (pIter->order == TSDB_ORDER_ASC) {
+    STableDataChunk *pNext = atomic_load_ptr(&pChunk->next);
+    if (pIter->pos + 1 < atomic_load_32(&pChunk->numOfRows)) {
+      pIter->pos++;
+      return true;
+    }
+
+    pIter->pChunk = pNext;
+    pIter->pos = 0;
+  } else {
+    if (pIter->pos > 0) {
+      pIter->pos--;
+      return true;
+    }
+
+    // the chunks before the last one are full and never change
+    pIter->pChunk = pChunk->prev;
+    if (pIter->pChunk != NULL) pIter->pos = pIter->pChunk->numOfRows - 1;
+  }
+
+  return pIter->pChunk != NULL;
+}
+
+void *tsdbDestroyTableDataIter(STableDataIter *pIter) {
+  tfree(pIter);
+  return NULL;
+}
+
 // ---------------- LOCAL FUNCTIONS ----------------
+// Create the memtable the writes go to if there is none, without taking any buffer from it
+static int tsdbEnsureMemTable(STsdbRepo *pRepo) {
+  if (pRepo->mem != NULL) return 0;
+
+  SMemTable *pMemTable = tsdbNewMemTable(pRepo);
+  if (pMemTable == NULL) return -1;
+
+  pRepo->mem = pMemTable;
+  return 0;
+}
+
 static SMemTable* tsdbNewMemTable(STsdbRepo *pRepo) {
   STsdbMeta *pMeta = pRepo->tsdbMeta;
 
@@ -515,6 +656,7 @@ static void tsdbFreeMemTable(SMemTable* pMemTable) {
     ASSERT((pMemTable->actList == NULL) ? true : (listNEles(pMemTable->actList) == 0));
 
     tdListFree(pMemTable->extraBuffList);
+    tdListFree(pMemTable->pinList);
     tdListFree(pMemTable->bufBlockList);
     tdListFree(pMemTable->actList);
     tfree(pMemTable->tData);
@@ -534,19 +676,14 @@ static STableData *tsdbNewTableData(STsdbCfg *pCfg, STable *pTable) {
   pTableData->keyLast = 0;
   pTableData->numOfRows = 0;
 
-  uint8_t skipListCreateFlags;
-  if(pCfg->update == TD_ROW_DISCARD_UPDATE)
-    skipListCreateFlags = SL_DISCARD_DUP_KEY;
-  else
-    skipListCreateFlags = SL_UPDATE_DUP_KEY;
-
-  pTableData->pData =
-      tSkipListCreate(TSDB_DATA_SKIPLIST_LEVEL, TSDB_DATA_TYPE_TIMESTAMP, TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP],
-                      tkeyComparFn, skipListCreateFlags, tsdbGetTsTupleKey);
-  if (pTableData->pData == NULL) {
-    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
-    free(pTableData);
-    return NULL;
+  // in append mode, the skiplist is created on the first row out of order
+  if (!tsdbMemTableAppend) {
+    pTableData->pData = tsdbNewTableSkipList(pCfg);
+    if (pTableData->pData == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      free(pTableData);
+      return NULL;
+    }
   }
 
   T_REF_INC(pTableData);
@@ -559,11 +696,129 @@ static void tsdbFreeTableData(STableData *pTableData) {
     int32_t ref = T_REF_DEC(pTableData);
     if (ref == 0) {
       tSkipListDestroy(pTableData->pData);
+      STableDataChunk *pChunk = pTableData->pHead;
+      while (pChunk != NULL) {
+        STableDataChunk *pNext = pChunk->next;
+        free(pChunk);
+        pChunk = pNext;
+      }
       free(pTableData);
     }
   }
 }
 
+static SSkipList *tsdbNewTableSkipList(STsdbCfg *pCfg) {
+  uint8_t skipListCreateFlags;
+  if(pCfg->update == TD_ROW_DISCARD_UPDATE)
+    skipListCreateFlags = SL_DISCARD_DUP_KEY;
+  else
+    skipListCreateFlags = SL_UPDATE_DUP_KEY;
+
+  return tSkipListCreate(TSDB_DATA_SKIPLIST_LEVEL, TSDB_DATA_TYPE_TIMESTAMP, TYPE_BYTES[TSDB_DATA_TYPE_TIMESTAMP],
+                         tkeyComparFn, skipListCreateFlags, tsdbGetTsTupleKey);
+}
+
+static STableDataChunk *tsdbNewTableDataChunk(STableDataChunk *pPrev) {
+  // chunks grow with the table, so tables with few rows in memory stay small
+  int32_t capacity = (pPrev == NULL) ? TSDB_DATA_CHUNK_MIN_ROWS : MIN(pPrev->capacity * 2, TSDB_DATA_CHUNK_MAX_ROWS);
+
+  STableDataChunk *pChunk =
+      (STableDataChunk *)malloc(sizeof(*pChunk) + (sizeof(TSKEY) + sizeof(SMemRow)) * (size_t)capacity);
+  if (pChunk == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pChunk->prev = pPrev;
+  pChunk->next = NULL;
+  pChunk->capacity = capacity;
+  pChunk->numOfRows = 0;
+  pChunk->keys = (TSKEY *)POINTER_SHIFT(pChunk, sizeof(*pChunk));
+  pChunk->rows = (SMemRow *)POINTER_SHIFT(pChunk->keys, sizeof(TSKEY) * capacity);
+
+  return pChunk;
+}
+
+/**
+ * Append the rows of the submit block to the chunks of the table while their keys keep increasing. It stops at the
+ * first row not greater than the last one, and leaves it in the iterator. The rows are referenced in place if the
+ * submit msg is pinned.
+ */
+static int tsdbAppendRowsToTableData(STsdbRepo *pRepo, STableData *pTableData, SSubmitBlkIter *pIter, void *pPin,
+                                     int32_t *pPoints, SMemRow *pLastRow) {
+  STableDataChunk *pChunk = pTableData->pTail;
+
+  while (pIter->row != NULL) {
+    TSKEY key = memRowKey(pIter->row);
+    if (pChunk != NULL && key <= pChunk->keys[pChunk->numOfRows - 1]) break;
+
+    STableDataChunk *pNew = NULL;
+    if (pChunk == NULL || pChunk->numOfRows >= pChunk->capacity) {
+      pNew = tsdbNewTableDataChunk(pChunk);
+      if (pNew == NULL) return -1;
+    }
+
+    SMemRow row = tsdbGetSubmitBlkNext(pIter);
+    void *  pMem = row;
+    if (pPin == NULL) {
+      pMem = tsdbAllocBytes(pRepo, memRowTLen(row));
+      if (pMem == NULL) {
+        free(pNew);
+        return -1;
+      }
+      memRowCpy(pMem, row);
+    }
+
+    // publish the row before the readers can see it
+    if (pNew != NULL) {
+      pNew->keys[0] = key;
+      pNew->rows[0] = pMem;
+      pNew->numOfRows = 1;
+      if (pChunk == NULL) {
+        atomic_store_ptr(&pTableData->pHead, pNew);
+      } else {
+        atomic_store_ptr(&pChunk->next, pNew);
+      }
+      pChunk = pNew;
+      pTableData->pTail = pNew;
+    } else {
+      pChunk->keys[pChunk->numOfRows] = key;
+      pChunk->rows[pChunk->numOfRows] = pMem;
+      atomic_store_32(&pChunk->numOfRows, pChunk->numOfRows + 1);
+    }
+
+    (*pPoints)++;
+    *pLastRow = pMem;
+  }
+
+  return 0;
+}
+
+static SMemRow tsdbGetTableDataIterNext(STableDataIter *pIter) {
+  if (!tsdbTableDataIterNext(pIter)) return NULL;
+  return tsdbNextIterRow(pIter);
+}
+
+/**
+ * Build the skiplist of the table from its chunks when a row out of order arrives. The chunks are kept until the
+ * table data is freed, since the readers may still iterate them.
+ */
+static int tsdbMoveTableDataToSkipList(STsdbCfg *pCfg, STableData *pTableData) {
+  SSkipList *pSkipList = tsdbNewTableSkipList(pCfg);
+  if (pSkipList == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  if (pTableData->pHead != NULL) {
+    STableDataIter iter = {.chunked = true, .pChunk = pTableData->pHead, .pos = -1, .order = TSDB_ORDER_ASC};
+    tSkipListPutBatchByIter(pSkipList, &iter, (iter_next_fn_t)tsdbGetTableDataIterNext);
+  }
+
+  atomic_store_ptr(&pTableData->pData, pSkipList);
+  return 0;
+}
+
 static char *tsdbGetTsTupleKey(const void *data) { return memRowKeys((SMemRow)data); }
 
 static int tsdbAdjustMemMaxTables(SMemTable *pMemTable, int maxTables) {
@@ -710,10 +965,10 @@ static int tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg) {
   return 0;
 }
 
-//row1 has higher priority
+//row1 has higher priority, and it is referenced in place if the submit msg is pinned
 static SMemRow tsdbInsertDupKeyMerge(SMemRow row1, SMemRow row2, STsdbRepo* pRepo,
                                      STSchema **ppSchema1, STSchema **ppSchema2,
-                                     STable* pTable, int32_t* pPoints, SMemRow* pLastRow) {
+                                     STable* pTable, int32_t* pPoints, SMemRow* pLastRow, void* pPin) {
 
   //for compatiblity, duplicate key inserted when update=0 should be also calculated as affected rows!
   if(row1 == NULL && row2 == NULL && pRepo->config.update == TD_ROW_DISCARD_UPDATE) {
@@ -726,9 +981,12 @@ static SMemRow tsdbInsertDupKeyMerge(SMemRow row1, SMemRow row2, STsdbRepo* pRep
             memRowKey(row1));
 
   if(row2 == NULL || pRepo->config.update != TD_ROW_PARTIAL_UPDATE) {
-    void* pMem = tsdbAllocBytes(pRepo, memRowTLen(row1));
-    if(pMem == NULL) return NULL;
-    memRowCpy(pMem, row1);
+    void* pMem = row1;
+    if(pPin == NULL) {
+      pMem = tsdbAllocBytes(pRepo, memRowTLen(row1));
+      if(pMem == NULL) return NULL;
+      memRowCpy(pMem, row1);
+    }
     (*pPoints)++;
     *pLastRow = pMem;
     return pMem;
@@ -769,10 +1027,10 @@ static SMemRow tsdbInsertDupKeyMerge(SMemRow row1, SMemRow row2, STsdbRepo* pRep
 }
 
 static void* tsdbInsertDupKeyMergePacked(void** args) {
-  return tsdbInsertDupKeyMerge(args[0], args[1], args[2], (STSchema**)&args[3], (STSchema**)&args[4], args[5], args[6], args[7]);
+  return tsdbInsertDupKeyMerge(args[0], args[1], args[2], (STSchema**)&args[3], (STSchema**)&args[4], args[5], args[6], args[7], args[8]);
 }
 
-static void tsdbSetupSkipListHookFns(SSkipList* pSkipList, STsdbRepo *pRepo, STable *pTable, int32_t* pPoints, SMemRow* pLastRow) {
+static void tsdbSetupSkipListHookFns(SSkipList* pSkipList, STsdbRepo *pRepo, STable *pTable, int32_t* pPoints, SMemRow* pLastRow, void* pPin) {
 
   if(pSkipList->insertHandleFn == NULL) {
     tGenericSavedFunc *dupHandleSavedFunc = genericSavedFuncInit((GenericVaFunc)&tsdbInsertDupKeyMergePacked, 9);
@@ -784,9 +1042,10 @@ static void tsdbSetupSkipListHookFns(SSkipList* pSkipList, STsdbRepo *pRepo, STa
   }
   pSkipList->insertHandleFn->args[6] = pPoints;
   pSkipList->insertHandleFn->args[7] = pLastRow;
+  pSkipList->insertHandleFn->args[8] = pPin;
 }
 
-static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *pAffectedRows) {
+static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *pAffectedRows, void *pPin) {
 
   STsdbMeta       *pMeta = pRepo->tsdbMeta;
   int32_t          points = 0;
@@ -800,7 +1059,7 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
   if(blkIter.row == NULL) return 0;
   TSKEY firstRowKey = memRowKey(blkIter.row);
 
-  tsdbAllocBytes(pRepo, 0);
+  if (tsdbEnsureMemTable(pRepo) < 0) return -1;
   pMemTable = pRepo->mem;
 
   ASSERT(pMemTable != NULL);
@@ -839,10 +1098,32 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
   ASSERT((pTableData != NULL) && pTableData->uid == TABLE_UID(pTable));
 
   SMemRow lastRow = NULL;
-  int64_t osize = SL_SIZE(pTableData->pData);
-  tsdbSetupSkipListHookFns(pTableData->pData, pRepo, pTable, &points, &lastRow);
-  tSkipListPutBatchByIter(pTableData->pData, &blkIter, (iter_next_fn_t)tsdbGetSubmitBlkNext);
-  int64_t dsize = SL_SIZE(pTableData->pData) - osize;
+  int64_t dsize = 0;
+  if (pTableData->pData == NULL) {
+    if (tsdbAppendRowsToTableData(pRepo, pTableData, &blkIter, pPin, &points, &lastRow) < 0) {
+      tsdbError("vgId:%d failed to append data to table %s uid %" PRId64 " tid %d since %s", REPO_ID(pRepo),
+                TABLE_CHAR_NAME(pTable), TABLE_UID(pTable), TABLE_TID(pTable), tstrerror(terrno));
+      return -1;
+    }
+    dsize = points;
+
+    if (blkIter.row != NULL) {
+      tsdbDebug("vgId:%d table %s tid %d uid %" PRIu64 " receives a row out of order, move its data to skiplist",
+                REPO_ID(pRepo), TABLE_CHAR_NAME(pTable), TABLE_TID(pTable), TABLE_UID(pTable));
+      if (tsdbMoveTableDataToSkipList(pCfg, pTableData) < 0) {
+        tsdbError("vgId:%d failed to insert data to table %s uid %" PRId64 " tid %d since %s", REPO_ID(pRepo),
+                  TABLE_CHAR_NAME(pTable), TABLE_UID(pTable), TABLE_TID(pTable), tstrerror(terrno));
+        return -1;
+      }
+    }
+  }
+
+  if (blkIter.row != NULL) {
+    int64_t osize = SL_SIZE(pTableData->pData);
+    tsdbSetupSkipListHookFns(pTableData->pData, pRepo, pTable, &points, &lastRow, pPin);
+    tSkipListPutBatchByIter(pTableData->pData, &blkIter, (iter_next_fn_t)tsdbGetSubmitBlkNext);
+    dsize += SL_SIZE(pTableData->pData) - osize;
+  }
   (*pAffectedRows) += points;
 
   if(lastRow != NULL) {
@@ -866,6 +1147,31 @@ static int tsdbInsertDataToTable(STsdbRepo* pRepo, SSubmitBlk* pBlock, int32_t *
   return 0;
 }
 
+static int tsdbPinSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg, void *pPin) {
+  if (tsdbEnsureMemTable(pRepo) < 0) return -1;
+  SMemTable *pMemTable = pRepo->mem;
+
+  if (pMemTable->pinList == NULL) {
+    pMemTable->pinList = tdListNew(sizeof(void *));
+    if (pMemTable->pinList == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  if (tdListAppend(pMemTable->pinList, &pPin) < 0) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  // the pinned bytes count as the memtable size, so that the commit is still triggered in time
+  pMemTable->pinnedSize += pMsg->length;
+  return 0;
+}
+
+static void tsdbUnpinSubmitMsg(STsdbRepo *pRepo, void *pPin) {
+  if (pPin != NULL && pRepo->appH.unpinMsgFunc != NULL) (*pRepo->appH.unpinMsgFunc)(pPin);
+}
 
 static int tsdbInitSubmitMsgIter(SSubmitMsg *pMsg, SSubmitMsgIter *pIter) {
   if (pMsg == NULL) {
@@ -92,8 +92,8 @@ typedef struct STableCheckInfo {
   int32_t       numOfBlocks:29; // number of qualified data blocks not the original blocks
   uint8_t        chosen:2;       // indicate which iterator should move forward
   bool          initBuf;        // whether to initialize the in-memory skip list iterator or not
-  SSkipListIterator* iter;      // mem buffer skip list iterator
-  SSkipListIterator* iiter;     // imem buffer skip list iterator
+  STableDataIter*    iter;      // mem buffer iterator
+  STableDataIter*    iiter;     // imem buffer iterator
 } STableCheckInfo;
 
 typedef struct STableBlockInfo {
@@ -130,6 +130,10 @@ typedef struct STsdbQueryHandle {
   bool           locateStart;
   int32_t        outputCapacity;
   int32_t        realNumOfRows;
+  bool           wholeBlock;       // pColumns holds all rows of rhelper.pDCols[0], in the same order
+  bool           partialBlock;     // only the columns marked in colMask are loaded for current file block
+  int8_t*        colMask;          // columns of pColumns loaded by a column id list, one flag per column
+  int16_t*       loadColIds;       // buffer of the column ids to load part of the columns
   SArray*        pTableCheckInfo;  // SArray<STableCheckInfo>
   int32_t        activeIndex;
   bool           checkFiles;       // check file stage
@@ -152,6 +156,7 @@ typedef struct STsdbQueryHandle {
 
   SArray        *prev;             // previous row which is before than time window
   SArray        *next;             // next row which is after the query time window
+  SArray        *pEqualConds;      // SColumnEqualCond array to check the bloom filters of the file blocks
   SIOCostSummary cost;
 } STsdbQueryHandle;
 
@@ -346,8 +351,8 @@ static void resetCheckInfo(STsdbQueryHandle* pQueryHandle) {
   for (int32_t i = 0; i < numOfTables; ++i) {
     STableCheckInfo* pCheckInfo = (STableCheckInfo*) taosArrayGet(pQueryHandle->pTableCheckInfo, i);
     pCheckInfo->lastKey = pQueryHandle->window.skey;
-    pCheckInfo->iter    = tSkipListDestroyIter(pCheckInfo->iter);
-    pCheckInfo->iiter   = tSkipListDestroyIter(pCheckInfo->iiter);
+    pCheckInfo->iter    = tsdbDestroyTableDataIter(pCheckInfo->iter);
+    pCheckInfo->iiter   = tsdbDestroyTableDataIter(pCheckInfo->iiter);
     pCheckInfo->initBuf = false;
 
     if (ASCENDING_TRAVERSE(pQueryHandle->order)) {
@@ -446,6 +451,8 @@ static STsdbQueryHandle* tsdbQueryTablesImpl(STsdbRepo* tsdb, STsdbQueryCond* pC
   if (tsdbInitReadH(&pQueryHandle->rhelper, (STsdbRepo*)tsdb) != 0) {
     goto _end;
   }
+  pQueryHandle->rhelper.pBlockCache = ((STsdbRepo*)tsdb)->pBlockCache;
+  pQueryHandle->rhelper.mmapRead = (tsQueryMmapRead != 0);
 
   assert(pCond != NULL && pMemRef != NULL);
   setQueryTimewindow(pQueryHandle, pCond);
@@ -457,6 +464,12 @@ static STsdbQueryHandle* tsdbQueryTablesImpl(STsdbRepo* tsdb, STsdbQueryCond* pC
       goto _end;
     }
 
+    pQueryHandle->colMask = calloc(pCond->numOfCols, sizeof(int8_t));
+    pQueryHandle->loadColIds = calloc(pCond->numOfCols + 1, sizeof(int16_t));
+    if (pQueryHandle->colMask == NULL || pQueryHandle->loadColIds == NULL) {
+      goto _end;
+    }
+
     // todo: use list instead of array?
     pQueryHandle->pColumns = taosArrayInit(pCond->numOfCols, sizeof(SColumnInfoData));
     if (pQueryHandle->pColumns == NULL) {
@@ -472,6 +485,15 @@ static STsdbQueryHandle* tsdbQueryTablesImpl(STsdbRepo* tsdb, STsdbQueryCond* pC
         goto _end;
       }
 
+      colInfo.numOfNull = -1;
+      if (!IS_VAR_DATA_TYPE(colInfo.info.type)) {
+        colInfo.nullBitmap = calloc(1, NULL_BITMAP_BYTES(pQueryHandle->outputCapacity));
+        if (colInfo.nullBitmap == NULL) {
+          tfree(colInfo.pData);
+          goto _end;
+        }
+      }
+
       taosArrayPush(pQueryHandle->pColumns, &colInfo);
       pQueryHandle->statis[i].colId = colInfo.info.colId;
     }
@@ -745,8 +767,7 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
     pMem = pMemT->tData[pCheckInfo->tableId.tid];
     if (pMem != NULL && pMem->uid == pCheckInfo->tableId.uid) { // check uid
       TKEY tLastKey = keyToTkey(pCheckInfo->lastKey);
-      pCheckInfo->iter =
-          tSkipListCreateIterFromVal(pMem->pData, (const char*)&tLastKey, TSDB_DATA_TYPE_TIMESTAMP, order);
+      pCheckInfo->iter = tsdbCreateTableDataIter(pMem, &tLastKey, order);
     }
   }
 
@@ -754,8 +775,7 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
     pIMem = pIMemT->tData[pCheckInfo->tableId.tid];
     if (pIMem != NULL && pIMem->uid == pCheckInfo->tableId.uid) { // check uid
       TKEY tLastKey = keyToTkey(pCheckInfo->lastKey);
-      pCheckInfo->iiter =
-          tSkipListCreateIterFromVal(pIMem->pData, (const char*)&tLastKey, TSDB_DATA_TYPE_TIMESTAMP, order);
+      pCheckInfo->iiter = tsdbCreateTableDataIter(pIMem, &tLastKey, order);
     }
   }
 
@@ -764,17 +784,16 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
     return false;
   }
 
-  bool memEmpty  = (pCheckInfo->iter == NULL) || (pCheckInfo->iter != NULL && !tSkipListIterNext(pCheckInfo->iter));
-  bool imemEmpty = (pCheckInfo->iiter == NULL) || (pCheckInfo->iiter != NULL && !tSkipListIterNext(pCheckInfo->iiter));
+  bool memEmpty  = (pCheckInfo->iter == NULL) || (pCheckInfo->iter != NULL && !tsdbTableDataIterNext(pCheckInfo->iter));
+  bool imemEmpty = (pCheckInfo->iiter == NULL) || (pCheckInfo->iiter != NULL && !tsdbTableDataIterNext(pCheckInfo->iiter));
   if (memEmpty && imemEmpty) { // buffer is empty
     return false;
   }
 
   if (!memEmpty) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iter);
-    assert(node != NULL);
+    SMemRow row = tsdbNextIterRow(pCheckInfo->iter);
+    assert(row != NULL);
 
-    SMemRow row = (SMemRow)SL_GET_NODE_DATA(node);
     TSKEY   key = memRowKey(row);  // first timestamp in buffer
     tsdbDebug("%p uid:%" PRId64 ", tid:%d check data in mem from skey:%" PRId64 ", order:%d, ts range in buf:%" PRId64
               "-%" PRId64 ", lastKey:%" PRId64 ", numOfRows:%"PRId64", 0x%"PRIx64,
@@ -793,10 +812,9 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
   }
 
   if (!imemEmpty) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iiter);
-    assert(node != NULL);
+    SMemRow row = tsdbNextIterRow(pCheckInfo->iiter);
+    assert(row != NULL);
 
-    SMemRow row = (SMemRow)SL_GET_NODE_DATA(node);
     TSKEY   key = memRowKey(row);  // first timestamp in buffer
     tsdbDebug("%p uid:%" PRId64 ", tid:%d check data in imem from skey:%" PRId64 ", order:%d, ts range in buf:%" PRId64
               "-%" PRId64 ", lastKey:%" PRId64 ", numOfRows:%"PRId64", 0x%"PRIx64,
@@ -817,24 +835,18 @@ static bool initTableMemIterator(STsdbQueryHandle* pHandle, STableCheckInfo* pCh
 }
 
 static void destroyTableMemIterator(STableCheckInfo* pCheckInfo) {
-  tSkipListDestroyIter(pCheckInfo->iter);
-  tSkipListDestroyIter(pCheckInfo->iiter);
+  tsdbDestroyTableDataIter(pCheckInfo->iter);
+  tsdbDestroyTableDataIter(pCheckInfo->iiter);
 }
 
 static TSKEY extractFirstTraverseKey(STableCheckInfo* pCheckInfo, int32_t order, int32_t update) {
   SMemRow rmem = NULL, rimem = NULL;
   if (pCheckInfo->iter) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iter);
-    if (node != NULL) {
-      rmem = (SMemRow)SL_GET_NODE_DATA(node);
-    }
+    rmem = tsdbNextIterRow(pCheckInfo->iter);
   }
 
   if (pCheckInfo->iiter) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iiter);
-    if (node != NULL) {
-      rimem = (SMemRow)SL_GET_NODE_DATA(node);
-    }
+    rimem = tsdbNextIterRow(pCheckInfo->iiter);
   }
 
   if (rmem == NULL && rimem == NULL) {
@@ -857,12 +869,12 @@ static TSKEY extractFirstTraverseKey(STableCheckInfo* pCheckInfo, int32_t order,
   if (r1 == r2) {
     if(update == TD_ROW_DISCARD_UPDATE){
       pCheckInfo->chosen = CHECKINFO_CHOSEN_IMEM;
-      tSkipListIterNext(pCheckInfo->iter);
+      tsdbTableDataIterNext(pCheckInfo->iter);
       return r2;
     }
     else if(update == TD_ROW_OVERWRITE_UPDATE) {
       pCheckInfo->chosen = CHECKINFO_CHOSEN_MEM;
-      tSkipListIterNext(pCheckInfo->iiter);
+      tsdbTableDataIterNext(pCheckInfo->iiter);
       return r1;
     } else {
       pCheckInfo->chosen = CHECKINFO_CHOSEN_BOTH;
@@ -892,17 +904,11 @@ static TSKEY extractFirstTraverseKey(STableCheckInfo* pCheckInfo, int32_t order,
 static SMemRow getSMemRowInTableMem(STableCheckInfo* pCheckInfo, int32_t order, int32_t update, SMemRow* extraRow) {
   SMemRow rmem = NULL, rimem = NULL;
   if (pCheckInfo->iter) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iter);
-    if (node != NULL) {
-      rmem = (SMemRow)SL_GET_NODE_DATA(node);
-    }
+    rmem = tsdbNextIterRow(pCheckInfo->iter);
   }
 
   if (pCheckInfo->iiter) {
-    SSkipListNode* node = tSkipListIterGet(pCheckInfo->iiter);
-    if (node != NULL) {
-      rimem = (SMemRow)SL_GET_NODE_DATA(node);
-    }
+    rimem = tsdbNextIterRow(pCheckInfo->iiter);
   }
 
   if (rmem == NULL && rimem == NULL) {
@@ -924,11 +930,11 @@ static SMemRow getSMemRowInTableMem(STableCheckInfo* pCheckInfo, int32_t order,
 
   if (r1 == r2) {
     if (update == TD_ROW_DISCARD_UPDATE) {
-      tSkipListIterNext(pCheckInfo->iter);
+      tsdbTableDataIterNext(pCheckInfo->iter);
       pCheckInfo->chosen = CHECKINFO_CHOSEN_IMEM;
       return rimem;
     } else if(update == TD_ROW_OVERWRITE_UPDATE){
-      tSkipListIterNext(pCheckInfo->iiter);
+      tsdbTableDataIterNext(pCheckInfo->iiter);
       pCheckInfo->chosen = CHECKINFO_CHOSEN_MEM;
       return rmem;
     } else {
@@ -961,7 +967,7 @@ static bool moveToNextRowInMem(STableCheckInfo* pCheckInfo) {
   bool hasNext = false;
   if (pCheckInfo->chosen == CHECKINFO_CHOSEN_MEM) {
     if (pCheckInfo->iter != NULL) {
-      hasNext = tSkipListIterNext(pCheckInfo->iter);
+      hasNext = tsdbTableDataIterNext(pCheckInfo->iter);
     }
 
     if (hasNext) {
@@ -969,11 +975,11 @@ static bool moveToNextRowInMem(STableCheckInfo* pCheckInfo) {
     }
 
     if (pCheckInfo->iiter != NULL) {
-      return tSkipListIterGet(pCheckInfo->iiter) != NULL;
+      return tsdbNextIterRow(pCheckInfo->iiter) != NULL;
     }
   } else if (pCheckInfo->chosen == CHECKINFO_CHOSEN_IMEM){
     if (pCheckInfo->iiter != NULL) {
-      hasNext = tSkipListIterNext(pCheckInfo->iiter);
+      hasNext = tsdbTableDataIterNext(pCheckInfo->iiter);
     }
 
     if (hasNext) {
@@ -981,14 +987,14 @@ static bool moveToNextRowInMem(STableCheckInfo* pCheckInfo) {
     }
 
     if (pCheckInfo->iter != NULL) {
-      return tSkipListIterGet(pCheckInfo->iter) != NULL;
+      return tsdbNextIterRow(pCheckInfo->iter) != NULL;
     }
   } else {
     if (pCheckInfo->iter != NULL) {
-      hasNext = tSkipListIterNext(pCheckInfo->iter);
+      hasNext = tsdbTableDataIterNext(pCheckInfo->iter);
     }
     if (pCheckInfo->iiter != NULL) {
-      hasNext = tSkipListIterNext(pCheckInfo->iiter) || hasNext;
+      hasNext = tsdbTableDataIterNext(pCheckInfo->iiter) || hasNext;
     }
   }
 
@@ -1421,9 +1427,12 @@ static int32_t getFileCompInfo(STsdbQueryHandle* pQueryHandle, int32_t* numOfBlo
   return code;
 }
 
-static int32_t doLoadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo, int32_t slotIndex) {
+static int32_t doLoadFileDataBlockCols(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo,
+                                       int32_t slotIndex, int16_t* colIds, int32_t numOfCols) {
   int64_t st = taosGetTimestampUs();
 
+  pQueryHandle->partialBlock = false;
+
   STSchema *pSchema = tsdbGetTableSchema(pCheckInfo->pTableObj);
   int32_t   code = tdInitDataCols(pQueryHandle->pDataCols, pSchema);
   if (code != TSDB_CODE_SUCCESS) {
@@ -1446,9 +1455,7 @@ static int32_t doLoadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBloc
     goto _error;
   }
 
-  int16_t* colIds = pQueryHandle->defaultLoadColumn->pData;
-
-  int32_t ret = tsdbLoadBlockDataCols(&(pQueryHandle->rhelper), pBlock, pCheckInfo->pCompInfo, colIds, (int)(QH_GET_NUM_OF_COLS(pQueryHandle)));
+  int32_t ret = tsdbLoadBlockDataCols(&(pQueryHandle->rhelper), pBlock, pCheckInfo->pCompInfo, colIds, numOfCols);
   if (ret != TSDB_CODE_SUCCESS) {
     int32_t c = terrno;
     assert(c != TSDB_CODE_SUCCESS);
@@ -1477,8 +1484,8 @@ static int32_t doLoadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBloc
   int64_t elapsedTime = (taosGetTimestampUs() - st);
   pQueryHandle->cost.blockLoadTime += elapsedTime;
 
-  tsdbDebug("%p load file block into buffer, index:%d, brange:%"PRId64"-%"PRId64", rows:%d, elapsed time:%"PRId64 " us, 0x%"PRIx64,
-      pQueryHandle, slotIndex, pBlock->keyFirst, pBlock->keyLast, pBlock->numOfRows, elapsedTime, pQueryHandle->qId);
+  tsdbDebug("%p load file block into buffer, index:%d, brange:%"PRId64"-%"PRId64", rows:%d, cols:%d, elapsed time:%"PRId64 " us, 0x%"PRIx64,
+      pQueryHandle, slotIndex, pBlock->keyFirst, pBlock->keyLast, pBlock->numOfRows, numOfCols, elapsedTime, pQueryHandle->qId);
   return TSDB_CODE_SUCCESS;
 
 _error:
@@ -1489,12 +1496,88 @@ _error:
   return terrno;
 }
 
+static int32_t doLoadFileDataBlock(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo, int32_t slotIndex) {
+  return doLoadFileDataBlockCols(pQueryHandle, pBlock, pCheckInfo, slotIndex, pQueryHandle->defaultLoadColumn->pData,
+                                 (int32_t)QH_GET_NUM_OF_COLS(pQueryHandle));
+}
+
 static int32_t getEndPosInDataBlock(STsdbQueryHandle* pQueryHandle, SDataBlockInfo* pBlockInfo);
 static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t capacity, int32_t numOfRows, int32_t start, int32_t end);
 static void moveDataToFront(STsdbQueryHandle* pQueryHandle, int32_t numOfRows, int32_t numOfCols);
 static void doCheckGeneratedBlockRange(STsdbQueryHandle* pQueryHandle);
 static void copyAllRemainRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, STableCheckInfo* pCheckInfo, SDataBlockInfo* pBlockInfo, int32_t endPos);
 
+// check the bloom filters of a file block against the equal conditions of the query, the rows of a block with
+// sub-blocks all come from the sub-blocks, so it is skipped if each sub-block is
+static bool fileBlockMayMatchEqualConds(STsdbQueryHandle* pQueryHandle, STableCheckInfo* pCheckInfo, SBlock* pBlock) {
+  SBlock* pSubBlocks = pBlock;
+  int32_t numOfSubBlocks = 1;
+  if (pBlock->numOfSubBlocks > 1) {
+    pSubBlocks = (SBlock*)POINTER_SHIFT(pCheckInfo->pCompInfo, pBlock->offset);
+    numOfSubBlocks = pBlock->numOfSubBlocks;
+  }
+
+  size_t num = taosArrayGetSize(pQueryHandle->pEqualConds);
+  for (int32_t j = 0; j < numOfSubBlocks; ++j) {
+    // no bloom filters, or failed to load them, leave the block to the query
+    if (tsdbLoadBlockBloom(&pQueryHandle->rhelper, pSubBlocks + j) != TSDB_STATIS_OK) {
+      return true;
+    }
+
+    int32_t i = 0;
+    while (i < num) {
+      SColumnEqualCond* pCond = taosArrayGet(pQueryHandle->pEqualConds, i);
+      if (!tsdbBlockBloomMayContain(&pQueryHandle->rhelper, pCond->colId, pCond->type, pCond->pVal)) {
+        break;
+      }
+      ++i;
+    }
+
+    if (i == num) {
+      return true;
+    }
+  }
+
+  pQueryHandle->rhelper.readCost.numOfBloomSkipBlocks += 1;
+  return false;
+}
+
+/*
+ * A file block that would be handed to the query as a whole, since it is in the query range and no rows in memory fall
+ * into its range, is skipped by the iterator when its bloom filters exclude one of the equal conditions. So neither the
+ * statistics nor the data of the block are loaded by the query.
+ */
+static bool fileBlockSkippedByBloom(STsdbQueryHandle* pQueryHandle, STableBlockInfo* pBlockInfo) {
+  if (pQueryHandle->pEqualConds == NULL) {
+    return false;
+  }
+
+  SBlock*          pBlock = pBlockInfo->compBlock;
+  STableCheckInfo* pCheckInfo = pBlockInfo->pTableCheckInfo;
+  bool             asc = ASCENDING_TRAVERSE(pQueryHandle->order);
+
+  if (asc && (pQueryHandle->window.ekey < pBlock->keyLast || pCheckInfo->lastKey > pBlock->keyFirst)) {
+    return false;
+  } else if (!asc && (pQueryHandle->window.ekey > pBlock->keyFirst || pCheckInfo->lastKey < pBlock->keyLast)) {
+    return false;
+  }
+
+  initTableMemIterator(pQueryHandle, pCheckInfo);
+  TSKEY key = extractFirstTraverseKey(pCheckInfo, pQueryHandle->order, pQueryHandle->pTsdb->config.update);
+  if (key != TSKEY_INITIAL_VAL && ((asc && key <= pBlock->keyLast) || (!asc && key >= pBlock->keyFirst))) {
+    return false;
+  }
+
+  if (fileBlockMayMatchEqualConds(pQueryHandle, pCheckInfo, pBlock)) {
+    return false;
+  }
+
+  tsdbDebug("%p file block skipped by bloom filters, brange:%"PRId64"-%"PRId64", rows:%d, tid:%d, 0x%"PRIx64,
+            pQueryHandle, pBlock->keyFirst, pBlock->keyLast, pBlock->numOfRows, pCheckInfo->tableId.tid,
+            pQueryHandle->qId);
+  return true;
+}
+
 static int32_t handleDataMergeIfNeeded(STsdbQueryHandle* pQueryHandle, SBlock* pBlock, STableCheckInfo* pCheckInfo){
   SQueryFilePos* cur = &pQueryHandle->cur;
   STsdbCfg*      pCfg = &pQueryHandle->pTsdb->config;
@@ -1703,7 +1786,9 @@ static int doBinarySearchKey(TSKEY* keyList, int num, int pos, TSKEY key, int or
     }
 }
 
-static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t capacity, int32_t numOfRows, int32_t start, int32_t end) {
+// pColMask marks the columns of pColumns to copy, NULL for all of them
+static int32_t doCopyColsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t capacity, int32_t numOfRows, int32_t start,
+                                       int32_t end, const int8_t* pColMask) {
   char* pData = NULL;
   int32_t step = ASCENDING_TRAVERSE(pQueryHandle->order)? 1 : -1;
 
@@ -1730,6 +1815,11 @@ static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t c
       continue;
     }
 
+    if (pColMask != NULL && !pColMask[i]) {
+      i++;
+      continue;
+    }
+
     int32_t bytes = pColInfo->info.bytes;
 
     if (ASCENDING_TRAVERSE(pQueryHandle->order)) {
@@ -1771,6 +1861,11 @@ static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t c
 
   while (i < requiredNumOfCols) { // the remain columns are all null data
     SColumnInfoData* pColInfo = taosArrayGet(pQueryHandle->pColumns, i);
+    if (pColMask != NULL && !pColMask[i]) {
+      i++;
+      continue;
+    }
+
     if (ASCENDING_TRAVERSE(pQueryHandle->order)) {
       pData = (char*)pColInfo->pData + numOfRows * pColInfo->info.bytes;
     } else {
@@ -1797,6 +1892,10 @@ static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t c
   return numOfRows + num;
 }
 
+static int32_t doCopyRowsFromFileBlock(STsdbQueryHandle* pQueryHandle, int32_t capacity, int32_t numOfRows, int32_t start, int32_t end) {
+  return doCopyColsFromFileBlock(pQueryHandle, capacity, numOfRows, start, end, NULL);
+}
+
 // Note: row1 always has high priority
 static void mergeTwoRowFromMem(STsdbQueryHandle* pQueryHandle, int32_t capacity, int32_t numOfRows,
                                SMemRow row1, SMemRow row2, int32_t numOfCols, STable* pTable,
@@ -2564,9 +2663,11 @@ static int32_t getDataBlockRv(STsdbQueryHandle* pQueryHandle, STableBlockInfo* p
   SQueryFilePos* cur = &pQueryHandle->cur;
 
   while(1) {
-    int32_t code = loadFileDataBlock(pQueryHandle, pNext->compBlock, pNext->pTableCheckInfo, exists);
-    if (code != TSDB_CODE_SUCCESS || *exists) {
-      return code;
+    if (!fileBlockSkippedByBloom(pQueryHandle, pNext)) {
+      int32_t code = loadFileDataBlock(pQueryHandle, pNext->compBlock, pNext->pTableCheckInfo, exists);
+      if (code != TSDB_CODE_SUCCESS || *exists) {
+        return code;
+      }
     }
 
     if ((cur->slot == pQueryHandle->numOfBlocks - 1 && ASCENDING_TRAVERSE(pQueryHandle->order)) ||
@@ -3698,12 +3799,78 @@ int32_t tsdbRetrieveDataBlockStatisInfo(TsdbQueryHandleT* pQueryHandle, SDataSta
   return TSDB_CODE_SUCCESS;
 }
 
-SArray* tsdbRetrieveDataBlock(TsdbQueryHandleT* pQueryHandle, SArray* pIdList) {
+// load the columns of current file block marked in pColMask into pColumns, or all of them if pColMask is NULL
+static int32_t doRetrieveFileBlockCols(STsdbQueryHandle* pHandle, STableBlockInfo* pBlockInfo, const int8_t* pColMask) {
+  SBlock*  pBlock = pBlockInfo->compBlock;
+  int16_t* colIds = pHandle->defaultLoadColumn->pData;
+  int32_t  numOfCols = (int32_t)QH_GET_NUM_OF_COLS(pHandle);
+
+  if (pColMask != NULL) {
+    int32_t num = 0;
+    colIds = pHandle->loadColIds;
+    colIds[num++] = PRIMARYKEY_TIMESTAMP_COL_INDEX;
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      SColumnInfoData* pColInfo = taosArrayGet(pHandle->pColumns, i);
+      if (pColMask[i] && pColInfo->info.colId != PRIMARYKEY_TIMESTAMP_COL_INDEX) {
+        colIds[num++] = pColInfo->info.colId;
+      }
+    }
+    numOfCols = num;
+  }
+
+  int32_t code = doLoadFileDataBlockCols(pHandle, pBlock, pBlockInfo->pTableCheckInfo, pHandle->cur.slot, colIds, numOfCols);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // todo refactor
+  int32_t numOfRows = doCopyColsFromFileBlock(pHandle, pHandle->outputCapacity, 0, 0, pBlock->numOfRows - 1, pColMask);
+
+  // if the buffer is not full in case of descending order query, move the data in the front of the buffer
+  if (!ASCENDING_TRAVERSE(pHandle->order) && numOfRows < pHandle->outputCapacity) {
+    int32_t emptySize = pHandle->outputCapacity - numOfRows;
+    int32_t reqNumOfCols = (int32_t)taosArrayGetSize(pHandle->pColumns);
+
+    for(int32_t i = 0; i < reqNumOfCols; ++i) {
+      if (pColMask != NULL && !pColMask[i]) {
+        continue;
+      }
+
+      SColumnInfoData* pColInfo = taosArrayGet(pHandle->pColumns, i);
+      memmove((char*)pColInfo->pData, (char*)pColInfo->pData + emptySize * pColInfo->info.bytes, numOfRows * pColInfo->info.bytes);
+    }
+  }
+
+  pHandle->wholeBlock = true;
+  return TSDB_CODE_SUCCESS;
+}
+
+// mark the columns of pColumns in the id list, return false if all columns are in it
+static bool setLoadColumnMask(STsdbQueryHandle* pHandle, SArray* pIdList) {
+  int32_t numOfCols = (int32_t)QH_GET_NUM_OF_COLS(pHandle);
+  int32_t numOfIds = (int32_t)taosArrayGetSize(pIdList);
+  bool    partial = false;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pColInfo = taosArrayGet(pHandle->pColumns, i);
+    pHandle->colMask[i] = (pColInfo->info.colId == PRIMARYKEY_TIMESTAMP_COL_INDEX);
+
+    for (int32_t j = 0; j < numOfIds && !pHandle->colMask[i]; ++j) {
+      pHandle->colMask[i] = (*(int16_t*)taosArrayGet(pIdList, j) == pColInfo->info.colId);
+    }
+
+    partial |= (!pHandle->colMask[i]);
+  }
+
+  return partial;
+}
+
+static SArray* doRetrieveDataBlock(STsdbQueryHandle* pHandle, SArray* pIdList) {
   /**
    * In the following two cases, the data has been loaded to SColumnInfoData.
    * 1. data is from cache, 2. data block is not completed qualified to query time range
    */
-  STsdbQueryHandle* pHandle = (STsdbQueryHandle*)pQueryHandle;
+  pHandle->wholeBlock = false;
 
   if (pHandle->cur.fid == INT32_MIN) {
     return pHandle->pColumns;
@@ -3722,31 +3889,101 @@ SArray* tsdbRetrieveDataBlock(TsdbQueryHandleT* pQueryHandle, SArray* pIdList) {
 
       if (pBlockLoadInfo->slot == pHandle->cur.slot && pBlockLoadInfo->fileGroup->fid == pHandle->cur.fid &&
           pBlockLoadInfo->tid == pCheckInfo->pTableObj->tableId.tid) {
+        if (pHandle->partialBlock && pIdList == NULL) {
+          // load the columns left by the previous retrieve with a column id list
+          int32_t numOfCols = (int32_t)QH_GET_NUM_OF_COLS(pHandle);
+          for (int32_t i = 0; i < numOfCols; ++i) {
+            pHandle->colMask[i] = !pHandle->colMask[i];
+          }
+
+          if (doRetrieveFileBlockCols(pHandle, pBlockInfo, pHandle->colMask) != TSDB_CODE_SUCCESS) {
+            return NULL;
+          }
+        }
+
         return pHandle->pColumns;
       } else {  // only load the file block
-        SBlock* pBlock = pBlockInfo->compBlock;
-        if (doLoadFileDataBlock(pHandle, pBlock, pCheckInfo, pHandle->cur.slot) != TSDB_CODE_SUCCESS) {
+        bool partial = (pIdList != NULL) && setLoadColumnMask(pHandle, pIdList);
+        if (doRetrieveFileBlockCols(pHandle, pBlockInfo, partial ? pHandle->colMask : NULL) != TSDB_CODE_SUCCESS) {
           return NULL;
         }
 
-        // todo refactor
-        int32_t numOfRows = doCopyRowsFromFileBlock(pHandle, pHandle->outputCapacity, 0, 0, pBlock->numOfRows - 1);
+        pHandle->partialBlock = partial;
+        return pHandle->pColumns;
+      }
+    }
+  }
+}
 
-        // if the buffer is not full in case of descending order query, move the data in the front of the buffer
-        if (!ASCENDING_TRAVERSE(pHandle->order) && numOfRows < pHandle->outputCapacity) {
-          int32_t emptySize = pHandle->outputCapacity - numOfRows;
-          int32_t reqNumOfCols = (int32_t)taosArrayGetSize(pHandle->pColumns);
+/**
+ * Mark the null rows of the current block in the bitmaps of pColumns. The bitmaps built when the file block was decoded
+ * are copied if pColumns holds the whole block, the others are built from the values in pColumns.
+ */
+static void setColumnNullBitmap(STsdbQueryHandle* pHandle) {
+  SDataCols* pCols = pHandle->wholeBlock ? pHandle->rhelper.pDCols[0] : NULL;
+  int32_t    numOfRows = pHandle->cur.rows;
+  int32_t    numOfCols = (int32_t)QH_GET_NUM_OF_COLS(pHandle);
+  int32_t    j = 0;
 
-          for(int32_t i = 0; i < reqNumOfCols; ++i) {
-            SColumnInfoData* pColInfo = taosArrayGet(pHandle->pColumns, i);
-            memmove((char*)pColInfo->pData, (char*)pColInfo->pData + emptySize * pColInfo->info.bytes, numOfRows * pColInfo->info.bytes);
-          }
-        }
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pColInfo = taosArrayGet(pHandle->pColumns, i);
+    if (pColInfo->nullBitmap == NULL) {
+      continue;
+    }
 
-        return pHandle->pColumns;
+    SDataCol* pCol = NULL;
+    while (pCols != NULL && j < pCols->numOfCols && pCols->cols[j].colId <= pColInfo->info.colId) {
+      if (pCols->cols[j].colId == pColInfo->info.colId) {
+        pCol = &pCols->cols[j];
       }
+      j++;
+    }
+
+    if (pCol != NULL && dataColHasNullBitmap(pCol) && pCols->numOfRows == numOfRows) {
+      memcpy(pColInfo->nullBitmap, pCol->nullBitmap, NULL_BITMAP_BYTES(numOfRows));
+      pColInfo->numOfNull = pCol->numOfNull;
+    } else {
+      pColInfo->numOfNull = buildNullBitmap(pColInfo->pData, pColInfo->info.type, numOfRows, pColInfo->nullBitmap);
+    }
+  }
+}
+
+SArray* tsdbRetrieveDataBlock(TsdbQueryHandleT* pQueryHandle, SArray* pIdList) {
+  STsdbQueryHandle* pHandle = (STsdbQueryHandle*)pQueryHandle;
+
+  SArray* pColumns = doRetrieveDataBlock(pHandle, pIdList);
+  if (pColumns != NULL) {
+    setColumnNullBitmap(pHandle);
+  }
+
+  return pColumns;
+}
+
+bool tsdbRetrieveDataBlockDict(TsdbQueryHandleT* pQueryHandle, int16_t colId, SColumnDict* pDict) {
+  STsdbQueryHandle* pHandle = (STsdbQueryHandle*)pQueryHandle;
+  if (!pHandle->wholeBlock) {
+    return false;
+  }
+
+  SDataCols* pCols = pHandle->rhelper.pDCols[0];
+  for (int32_t i = 0; i < pCols->numOfCols; ++i) {
+    SDataCol* pCol = &pCols->cols[i];
+    if (pCol->colId != colId) {
+      continue;
+    }
+
+    if (pCol->numOfDict <= 0) {
+      return false;
     }
+
+    pDict->numOfEntries = pCol->numOfDict;
+    pDict->numOfRows = pCols->numOfRows;
+    pDict->pEntries = pCol->pData;
+    pDict->codes = pCol->dictCode;
+    return true;
   }
+
+  return false;
 }
 
 void filterPrepare(void* expr, void* param) {
@@ -4131,6 +4368,7 @@ static void* doFreeColumnInfoData(SArray* pColumnInfoData) {
   for (int32_t i = 0; i < cols; ++i) {
     SColumnInfoData* pColInfo = taosArrayGet(pColumnInfoData, i);
     tfree(pColInfo->pData);
+    tfree(pColInfo->nullBitmap);
   }
 
   taosArrayDestroy(&pColumnInfoData);
@@ -4161,6 +4399,9 @@ void tsdbCleanupQueryHandle(TsdbQueryHandleT queryHandle) {
   taosArrayDestroy(&pQueryHandle->defaultLoadColumn);
   tfree(pQueryHandle->pDataBlockInfo);
   tfree(pQueryHandle->statis);
+  tfree(pQueryHandle->colMask);
+  tfree(pQueryHandle->loadColIds);
+  taosArrayDestroy(&pQueryHandle->pEqualConds);
 
   if (!emptyQueryTimewindow(pQueryHandle)) {
     tsdbMayUnTakeMemSnapshot(pQueryHandle);
@@ -4569,6 +4810,35 @@ end:
 }
 
 // obtain queryHandle attribute
+void tsdbGetReadCost(TsdbQueryHandleT queryHandle, STsdbReadCost* pCost) {
+  STsdbQueryHandle* pQueryHandle = (STsdbQueryHandle*)queryHandle;
+  if (pQueryHandle == NULL) {
+    return;
+  }
+
+  STsdbReadCost* pReadCost = &pQueryHandle->rhelper.readCost;
+  pCost->numOfReads += pReadCost->numOfReads;
+  pCost->readSize += pReadCost->readSize;
+  pCost->readTime += pReadCost->readTime;
+  pCost->numOfDecodeBlocks += pReadCost->numOfDecodeBlocks;
+  pCost->numOfDecodeCols += pReadCost->numOfDecodeCols;
+  pCost->decodeTime += pReadCost->decodeTime;
+  pCost->numOfBloomSkipBlocks += pReadCost->numOfBloomSkipBlocks;
+  pCost->numOfMappedCols += pReadCost->numOfMappedCols;
+}
+
+void tsdbSetQueryEqualConds(TsdbQueryHandleT queryHandle, SArray* pConds) {
+  STsdbQueryHandle* pQueryHandle = (STsdbQueryHandle*)queryHandle;
+  if (pQueryHandle == NULL) {
+    return;
+  }
+
+  taosArrayDestroy(&pQueryHandle->pEqualConds);
+  if (pConds != NULL && taosArrayGetSize(pConds) > 0) {
+    pQueryHandle->pEqualConds = taosArrayDup(pConds);
+  }
+}
+
 int64_t tsdbSkipOffset(TsdbQueryHandleT queryHandle) {
   STsdbQueryHandle* pQueryHandle = (STsdbQueryHandle*)queryHandle;
   if (pQueryHandle) {
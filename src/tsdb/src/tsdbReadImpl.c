@@ -16,18 +16,63 @@
 #include "tsdbint.h"
 
 #define TSDB_KEY_COL_OFFSET 0
+// fewer values are decoded faster than the decode threads are dispatched
+#define TSDB_PARALLEL_DECODE_MIN_POINTS 8192
+// columns apart by no more than this are read by one syscall, the bytes between them are discarded
+#define TSDB_READ_MAX_GAP 4096
+#define TSDB_READ_MAX_IOVS 64
+
+typedef struct {
+  SBlockCol blockCol;
+  SDataCol *pDataCol;
+  void *    content;
+  char *    buffer;
+  int32_t   bufferSize;
+  int32_t   code;
+  bool      inCaller;  // decoded by the calling thread after the others
+} SColDecodeTask;
+
+typedef struct {
+  SBlock *        pBlock;
+  int             maxPoints;
+  SColDecodeTask *tasks;
+} SBlockDecodeParam;
 
 static void tsdbResetReadTable(SReadH *pReadh);
 static void tsdbResetReadFile(SReadH *pReadh);
 static int  tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols);
-static int  tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, int numOfRows,
-                                         int maxPoints, char *buffer, int bufferSize);
+static int  tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, uint8_t encode,
+                                         int numOfRows, int maxPoints, char *buffer, int bufferSize);
 static int  tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols, int16_t *colIds,
                                       int numOfColIds);
-static int  tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBlockCol *pBlockCol, SDataCol *pDataCol);
+static int  tsdbLoadColsData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SColDecodeTask *tasks, int numOfTasks);
+static int  tsdbReadColsData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SColDecodeTask *tasks, int numOfTasks);
+static int  tsdbMapColsData(SReadH *pReadh, SDFileMap *pMap, SDFile *pDFile, SBlock *pBlock, SColDecodeTask *tasks,
+                            int numOfTasks);
+static void tsdbMapReadFSet(SReadH *pReadh);
+static void tsdbUnmapReadFSet(SReadH *pReadh);
+static void *tsdbLoadDFilePart(SReadH *pReadh, SDFile *pDFile, int64_t offset, int64_t nbyte, void **ppBuf,
+                               const char *part);
+static void tsdbDecodeColTask(void *param, int32_t idx);
 static int  tsdbLoadBlockStatisFromDFile(SReadH *pReadh, SBlock *pBlock);
 static int  tsdbLoadBlockStatisFromAggr(SReadH *pReadh, SBlock *pBlock);
 
+static FORCE_INLINE int64_t tsdbGetColDataOffset(SBlock *pBlock, SBlockCol *pBlockCol) {
+  return pBlock->offset + tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer) +
+         tsdbGetBlockColOffset(pBlockCol);
+}
+
+static FORCE_INLINE SDFileMap *tsdbGetDFileMap(SReadH *pReadh, SDFile *pDFile) {
+  SDFileMap *pMap = pReadh->maps + (pDFile - TSDB_READ_FSET(pReadh)->files);
+  return (pMap->pAddr != NULL) ? pMap : NULL;
+}
+
+static FORCE_INLINE SBlockCacheKey tsdbGetBlockCacheKey(SReadH *pReadh, SBlock *pBlock, int16_t colId) {
+  SBlockCacheKey key = {
+      .fid = TSDB_FSET_FID(TSDB_READ_FSET(pReadh)), .colId = colId, .last = (int8_t)pBlock->last, .offset = pBlock->offset};
+  return key;
+}
+
 int tsdbInitReadH(SReadH *pReadh, STsdbRepo *pRepo) {
   ASSERT(pReadh != NULL && pRepo != NULL);
 
@@ -64,13 +109,20 @@ int tsdbInitReadH(SReadH *pReadh, STsdbRepo *pRepo) {
 void tsdbDestroyReadH(SReadH *pReadh) {
   if (pReadh == NULL) return;
   pReadh->pExBuf = taosTZfree(pReadh->pExBuf);
+  pReadh->pDecTasks = taosTZfree(pReadh->pDecTasks);
   pReadh->pCBuf = taosTZfree(pReadh->pCBuf);
   pReadh->pBuf = taosTZfree(pReadh->pBuf);
   pReadh->pDCols[0] = tdFreeDataCols(pReadh->pDCols[0]);
   pReadh->pDCols[1] = tdFreeDataCols(pReadh->pDCols[1]);
-  pReadh->pAggrBlkData = taosTZfree(pReadh->pAggrBlkData);
-  pReadh->pBlkData = taosTZfree(pReadh->pBlkData);
-  pReadh->pBlkInfo = taosTZfree(pReadh->pBlkInfo);
+  tsdbUnmapReadFSet(pReadh);
+  pReadh->pAggrBlkData = NULL;
+  pReadh->pBlkBloom = NULL;
+  pReadh->pBlkData = NULL;
+  pReadh->pBlkInfo = NULL;
+  pReadh->pAggrBuf = taosTZfree(pReadh->pAggrBuf);
+  pReadh->pBloomBuf = taosTZfree(pReadh->pBloomBuf);
+  pReadh->pBlkDataBuf = taosTZfree(pReadh->pBlkDataBuf);
+  pReadh->pBlkInfoBuf = taosTZfree(pReadh->pBlkInfoBuf);
   pReadh->cidx = 0;
   pReadh->pBlkIdx = NULL;
   pReadh->pTable = NULL;
@@ -84,6 +136,7 @@ int tsdbSetAndOpenReadFSet(SReadH *pReadh, SDFileSet *pSet) {
   tsdbResetReadFile(pReadh);
 
   pReadh->rSet = *pSet;
+  pReadh->fsVersion = FS_VERSION(REPO_FS(TSDB_READ_REPO(pReadh)));
   TSDB_FSET_SET_CLOSED(TSDB_READ_FSET(pReadh));
   if (tsdbOpenDFileSet(TSDB_READ_FSET(pReadh), O_RDONLY) < 0) {
     tsdbError("vgId:%d failed to open file set %d since %s", TSDB_READ_REPO_ID(pReadh), TSDB_FSET_FID(pSet),
@@ -91,6 +144,8 @@ int tsdbSetAndOpenReadFSet(SReadH *pReadh, SDFileSet *pSet) {
     return -1;
   }
 
+  if (pReadh->mmapRead) tsdbMapReadFSet(pReadh);
+
   return 0;
 }
 
@@ -105,40 +160,20 @@ int tsdbLoadBlockIdx(SReadH *pReadh) {
   // No data at all, just return
   if (pHeadf->info.offset <= 0) return 0;
 
-  if (tsdbSeekDFile(pHeadf, pHeadf->info.offset, SEEK_SET) < 0) {
-    tsdbError("vgId:%d failed to load SBlockIdx part while seek file %s since %s, offset:%u len :%u",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pHeadf), tstrerror(terrno), pHeadf->info.offset,
-              pHeadf->info.len);
-    return -1;
-  }
-
-  if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), pHeadf->info.len) < 0) return -1;
-
-  int64_t nread = tsdbReadDFile(pHeadf, TSDB_READ_BUF(pReadh), pHeadf->info.len);
-  if (nread < 0) {
-    tsdbError("vgId:%d failed to load SBlockIdx part while read file %s since %s, offset:%u len :%u",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pHeadf), tstrerror(terrno), pHeadf->info.offset,
-              pHeadf->info.len);
-    return -1;
-  }
-
-  if (nread < pHeadf->info.len) {
-    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
-    tsdbError("vgId:%d SBlockIdx part in file %s is corrupted, offset:%u expected bytes:%u read bytes: %" PRId64,
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pHeadf), pHeadf->info.offset, pHeadf->info.len, nread);
-    return -1;
-  }
+  void *pBuf = tsdbLoadDFilePart(pReadh, pHeadf, pHeadf->info.offset, pHeadf->info.len,
+                                 (void **)(&TSDB_READ_BUF(pReadh)), "SBlockIdx");
+  if (pBuf == NULL) return -1;
 
-  if (!taosCheckChecksumWhole((uint8_t *)TSDB_READ_BUF(pReadh), pHeadf->info.len)) {
+  if (!taosCheckChecksumWhole((uint8_t *)pBuf, pHeadf->info.len)) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d SBlockIdx part in file %s is corrupted since wrong checksum, offset:%u len :%u",
               TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pHeadf), pHeadf->info.offset, pHeadf->info.len);
     return -1;
   }
 
-  void *ptr = TSDB_READ_BUF(pReadh);
+  void *ptr = pBuf;
   int   tsize = 0;
-  while (POINTER_DISTANCE(ptr, TSDB_READ_BUF(pReadh)) < (pHeadf->info.len - sizeof(TSCKSUM))) {
+  while (POINTER_DISTANCE(ptr, pBuf) < (pHeadf->info.len - sizeof(TSCKSUM))) {
     ptr = tsdbDecodeSBlockIdx(ptr, &blkIdx);
     ASSERT(ptr != NULL);
 
@@ -269,7 +304,8 @@ static FORCE_INLINE size_t tsdbSizeOfSBlock(int32_t sBlkVer) {
   }
 }
 
-static int tsdbSBlkInfoRefactor(SDFile *pHeadf, SBlockInfo **pDstBlkInfo, SBlockIdx *pBlkIdx, uint32_t *dstBlkInfoLen) {
+static int tsdbSBlkInfoRefactor(SDFile *pHeadf, SBlockInfo **pDstBlkInfo, void **ppBuf, SBlockIdx *pBlkIdx,
+                                uint32_t *dstBlkInfoLen) {
   int sBlkVer = tsdbGetSBlockVer(pHeadf->info.fver);
   if (sBlkVer > TSDB_SBLK_VER_0) {
     *dstBlkInfoLen = pBlkIdx->len;
@@ -303,7 +339,8 @@ static int tsdbSBlkInfoRefactor(SDFile *pHeadf, SBlockInfo **pDstBlkInfo, SBlock
     // TODO: update the fields if the SBlock definition change later
   }
 
-  taosTZfree(*pDstBlkInfo);
+  taosTZfree(*ppBuf);
+  *ppBuf = tmpBlkInfo;
   *pDstBlkInfo = tmpBlkInfo;
 
   return TSDB_CODE_SUCCESS;
@@ -315,27 +352,9 @@ int tsdbLoadBlockInfo(SReadH *pReadh, void **pTarget, uint32_t *extendedLen) {
   SDFile *    pHeadf = TSDB_READ_HEAD_FILE(pReadh);
   SBlockIdx * pBlkIdx = pReadh->pBlkIdx;
 
-  if (tsdbSeekDFile(pHeadf, pBlkIdx->offset, SEEK_SET) < 0) {
-    tsdbError("vgId:%d failed to load SBlockInfo part while seek file %s since %s, offset:%u len:%u",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pHeadf), tstrerror(terrno), pBlkIdx->offset, pBlkIdx->len);
-    return -1;
-  }
-
-  if (tsdbMakeRoom((void **)(&pReadh->pBlkInfo), pBlkIdx->len) < 0) return -1;
-
-  int64_t nread = tsdbReadDFile(pHeadf, (void *)(pReadh->pBlkInfo), pBlkIdx->len);
-  if (nread < 0) {
-    tsdbError("vgId:%d failed to load SBlockInfo part while read file %s since %s, offset:%u len :%u",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pHeadf), tstrerror(terrno), pBlkIdx->offset, pBlkIdx->len);
-    return -1;
-  }
-
-  if (nread < pBlkIdx->len) {
-    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
-    tsdbError("vgId:%d SBlockInfo part in file %s is corrupted, offset:%u expected bytes:%u read bytes:%" PRId64,
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pHeadf), pBlkIdx->offset, pBlkIdx->len, nread);
-    return -1;
-  }
+  pReadh->pBlkInfo = tsdbLoadDFilePart(pReadh, pHeadf, pBlkIdx->offset, pBlkIdx->len, &(pReadh->pBlkInfoBuf),
+                                       "SBlockInfo");
+  if (pReadh->pBlkInfo == NULL) return -1;
 
   if (!taosCheckChecksumWhole((uint8_t *)(pReadh->pBlkInfo), pBlkIdx->len)) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
@@ -347,7 +366,7 @@ int tsdbLoadBlockInfo(SReadH *pReadh, void **pTarget, uint32_t *extendedLen) {
   ASSERT(pBlkIdx->tid == pReadh->pBlkInfo->tid && pBlkIdx->uid == pReadh->pBlkInfo->uid);
 
   uint32_t dstBlkInfoLen = 0;
-  if (tsdbSBlkInfoRefactor(pHeadf, &(pReadh->pBlkInfo), pBlkIdx, &dstBlkInfoLen) < 0) {
+  if (tsdbSBlkInfoRefactor(pHeadf, &(pReadh->pBlkInfo), &(pReadh->pBlkInfoBuf), pBlkIdx, &dstBlkInfoLen) < 0) {
     return -1;
   }
 
@@ -425,29 +444,10 @@ int tsdbLoadBlockDataCols(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo,
 
 static int tsdbLoadBlockStatisFromDFile(SReadH *pReadh, SBlock *pBlock) {
   SDFile *pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
-  if (tsdbSeekDFile(pDFile, pBlock->offset, SEEK_SET) < 0) {
-    tsdbError("vgId:%d failed to load block statis part while seek file %s to offset %" PRId64 " since %s",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), (int64_t)pBlock->offset, tstrerror(terrno));
-    return -1;
-  }
+  size_t  size = tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer);
 
-  size_t size = tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer);
-  if (tsdbMakeRoom((void **)(&(pReadh->pBlkData)), size) < 0) return -1;
-
-  int64_t nread = tsdbReadDFile(pDFile, (void *)(pReadh->pBlkData), size);
-  if (nread < 0) {
-    tsdbError("vgId:%d failed to load block statis part while read file %s since %s, offset:%" PRId64 " len :%" PRIzu,
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), tstrerror(terrno), (int64_t)pBlock->offset, size);
-    return -1;
-  }
-
-  if (nread < size) {
-    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
-    tsdbError("vgId:%d block statis part in file %s is corrupted, offset:%" PRId64 " expected bytes:%" PRIzu
-              " read bytes: %" PRId64,
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), (int64_t)pBlock->offset, size, nread);
-    return -1;
-  }
+  pReadh->pBlkData = tsdbLoadDFilePart(pReadh, pDFile, pBlock->offset, size, &(pReadh->pBlkDataBuf), "block statis");
+  if (pReadh->pBlkData == NULL) return -1;
 
   if (!taosCheckChecksumWhole((uint8_t *)(pReadh->pBlkData), (uint32_t)size)) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
@@ -462,32 +462,11 @@ static int tsdbLoadBlockStatisFromAggr(SReadH *pReadh, SBlock *pBlock) {
   ASSERT((pBlock->blkVer > TSDB_SBLK_VER_0) && (pBlock->aggrStat));  // TODO: remove after pass all the test
   SDFile *pDFileAggr = pBlock->last ? TSDB_READ_SMAL_FILE(pReadh) : TSDB_READ_SMAD_FILE(pReadh);
 
-  if (tsdbSeekDFile(pDFileAggr, pBlock->aggrOffset, SEEK_SET) < 0) {
-    tsdbError("vgId:%d failed to load block aggr part while seek file %s to offset %" PRIu64 " since %s",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFileAggr), (uint64_t)pBlock->aggrOffset,
-              tstrerror(terrno));
-    return -1;
-  }
-
   size_t sizeAggr = tsdbBlockAggrSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer);
-  if (tsdbMakeRoom((void **)(&(pReadh->pAggrBlkData)), sizeAggr) < 0) return -1;
-
-  int64_t nreadAggr = tsdbReadDFile(pDFileAggr, (void *)(pReadh->pAggrBlkData), sizeAggr);
-  if (nreadAggr < 0) {
-    tsdbError("vgId:%d failed to load block aggr part while read file %s since %s, offset:%" PRIu64 " len :%" PRIzu,
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFileAggr), tstrerror(terrno),
-              (uint64_t)pBlock->aggrOffset, sizeAggr);
-    return -1;
-  }
 
-  if (nreadAggr < sizeAggr) {
-    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
-    tsdbError("vgId:%d block aggr part in file %s is corrupted, offset:%" PRIu64 " expected bytes:%" PRIzu
-              " read bytes: %" PRId64,
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFileAggr), (uint64_t)pBlock->aggrOffset, sizeAggr,
-              nreadAggr);
-    return -1;
-  }
+  pReadh->pAggrBlkData =
+      tsdbLoadDFilePart(pReadh, pDFileAggr, pBlock->aggrOffset, sizeAggr, &(pReadh->pAggrBuf), "block aggr");
+  if (pReadh->pAggrBlkData == NULL) return -1;
 
   if (!taosCheckChecksumWhole((uint8_t *)(pReadh->pAggrBlkData), (uint32_t)sizeAggr)) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
@@ -515,6 +494,65 @@ int tsdbLoadBlockOffset(SReadH *pReadh, SBlock *pBlock) {
   return tsdbLoadBlockStatisFromDFile(pReadh, pBlock);
 }
 
+int tsdbLoadBlockBloom(SReadH *pReadh, SBlock *pBlock) {
+  ASSERT(pBlock->numOfSubBlocks <= 1);
+
+  if (pBlock->blkVer < TSDB_SBLK_VER_2 || !pBlock->aggrStat) {
+    return TSDB_STATIS_NONE;
+  }
+
+  SDFile *pDFileAggr = pBlock->last ? TSDB_READ_SMAL_FILE(pReadh) : TSDB_READ_SMAD_FILE(pReadh);
+  int64_t offset = pBlock->aggrOffset + tsdbBlockAggrSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer);
+
+  // the head tells the size of the whole part
+  size_t size = sizeof(SBlockBloomData);
+  pReadh->pBlkBloom = tsdbLoadDFilePart(pReadh, pDFileAggr, offset, size, &(pReadh->pBloomBuf), "block bloom");
+  if (pReadh->pBlkBloom == NULL) return -1;
+
+  size_t len = pReadh->pBlkBloom->len;
+  if (len < size + sizeof(TSCKSUM)) {
+    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+    tsdbError("vgId:%d block bloom part in file %s is corrupted, offset:%" PRId64 " len:%" PRIzu,
+              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFileAggr), offset, len);
+    return -1;
+  }
+
+  pReadh->pBlkBloom = tsdbLoadDFilePart(pReadh, pDFileAggr, offset, len, &(pReadh->pBloomBuf), "block bloom");
+  if (pReadh->pBlkBloom == NULL) return -1;
+
+  if (!taosCheckChecksumWhole((uint8_t *)(pReadh->pBlkBloom), (uint32_t)len)) {
+    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+    tsdbError("vgId:%d block bloom part in file %s is corrupted since wrong checksum, offset:%" PRId64 " len :%" PRIzu,
+              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFileAggr), offset, len);
+    return -1;
+  }
+
+  return TSDB_STATIS_OK;
+}
+
+// check a value against the bloom filters loaded by tsdbLoadBlockBloom
+bool tsdbBlockBloomMayContain(SReadH *pReadh, int16_t colId, int8_t type, const void *pVal) {
+  SBlockBloomData *pBloom = pReadh->pBlkBloom;
+
+  if (colId == PRIMARYKEY_TIMESTAMP_COL_INDEX || !TSDB_BLOOM_FILTER_TYPE(type)) return true;
+
+  for (int i = 0; i < pBloom->numOfCols; i++) {
+    SBlockBloomCol *pBloomCol = pBloom->cols + i;
+    if (pBloomCol->colId == colId) {
+      const void *key = NULL;
+      int32_t     len = 0;
+      tsdbGetBloomFilterKey(type, pVal, &key, &len);
+      return taosBloomFilterMayContain(POINTER_SHIFT(pBloom, pBloomCol->offset), pBloomCol->len, pBloom->numOfHashes,
+                                       key, len);
+    } else if (pBloomCol->colId > colId) {
+      break;
+    }
+  }
+
+  // no filter of a column of the filter types, all of its values are NULL in the block
+  return false;
+}
+
 int tsdbEncodeSBlockIdx(void **buf, SBlockIdx *pIdx) {
   int tlen = 0;
 
@@ -616,43 +654,111 @@ static void tsdbResetReadTable(SReadH *pReadh) {
 static void tsdbResetReadFile(SReadH *pReadh) {
   tsdbResetReadTable(pReadh);
   taosArrayClear(pReadh->aBlkIdx);
+  tsdbUnmapReadFSet(pReadh);
   tsdbCloseDFileSet(TSDB_READ_FSET(pReadh));
 }
 
-static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols) {
-  ASSERT(pBlock->numOfSubBlocks == 0 || pBlock->numOfSubBlocks == 1);
+/*
+ * The mappings share the lifetime of the file descriptors of the reader. A file set swapped out by a commit or a
+ * compaction is only unlinked, so the mapped pages stay valid until the reader moves on to the next file set. The
+ * files are mapped up to the sizes recorded in the file set, so bytes appended by a commit later are never touched.
+ */
+static void tsdbMapReadFSet(SReadH *pReadh) {
+  SDFileSet *pSet = TSDB_READ_FSET(pReadh);
 
-  SDFile *pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+  for (TSDB_FILE_T ftype = 0; ftype < tsdbGetNFiles(pSet); ftype++) {
+    SDFile *   pDFile = TSDB_DFILE_IN_SET(pSet, ftype);
+    SDFileMap *pMap = pReadh->maps + ftype;
+    struct stat st;
 
-  tdResetDataCols(pDataCols);
-  if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), pBlock->len) < 0) return -1;
+    if (fstat(TSDB_FILE_FD(pDFile), &st) < 0) {
+      tsdbWarn("vgId:%d failed to stat file %s to map since %s", TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile),
+               strerror(errno));
+      continue;
+    }
 
-  SBlockData *pBlockData = (SBlockData *)TSDB_READ_BUF(pReadh);
+    int64_t size = MIN((int64_t)pDFile->info.size, (int64_t)st.st_size);
+    if (size <= 0) continue;
 
-  if (tsdbSeekDFile(pDFile, pBlock->offset, SEEK_SET) < 0) {
-    tsdbError("vgId:%d failed to load block data part while seek file %s to offset %" PRId64 " since %s",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), (int64_t)pBlock->offset, tstrerror(terrno));
-    return -1;
+    pMap->pAddr = taosMmapReadOnly(TSDB_FILE_FD(pDFile), size);
+    if (pMap->pAddr == NULL) {
+      tsdbWarn("vgId:%d failed to map file %s since %s, read it instead", TSDB_READ_REPO_ID(pReadh),
+               TSDB_FILE_FULL_NAME(pDFile), strerror(errno));
+      continue;
+    }
+    pMap->size = size;
   }
+}
+
+static void tsdbUnmapReadFSet(SReadH *pReadh) {
+  for (TSDB_FILE_T ftype = 0; ftype < TSDB_FILE_MAX; ftype++) {
+    SDFileMap *pMap = pReadh->maps + ftype;
+    if (pMap->pAddr != NULL) {
+      taosMunmap(pMap->pAddr, pMap->size);
+      pMap->pAddr = NULL;
+      pMap->size = 0;
+    }
+  }
+
+  // the parts may point into the mappings
+  pReadh->pBlkInfo = pReadh->pBlkInfoBuf;
+  pReadh->pBlkData = pReadh->pBlkDataBuf;
+  pReadh->pAggrBlkData = pReadh->pAggrBuf;
+  pReadh->pBlkBloom = pReadh->pBloomBuf;
+}
+
+// Get the nbyte bytes at the offset of the file, from its mapping if it is mapped, or read into *ppBuf otherwise
+static void *tsdbLoadDFilePart(SReadH *pReadh, SDFile *pDFile, int64_t offset, int64_t nbyte, void **ppBuf,
+                               const char *part) {
+  SDFileMap *pMap = tsdbGetDFileMap(pReadh, pDFile);
+  if (pMap != NULL) {
+    if (offset < 0 || offset + nbyte > pMap->size) {
+      terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+      tsdbError("vgId:%d %s part in file %s is corrupted, offset:%" PRId64 " len:%" PRId64 " file size:%" PRId64,
+                TSDB_READ_REPO_ID(pReadh), part, TSDB_FILE_FULL_NAME(pDFile), offset, nbyte, pMap->size);
+      return NULL;
+    }
+    return POINTER_SHIFT(pMap->pAddr, offset);
+  }
+
+  if (tsdbSeekDFile(pDFile, offset, SEEK_SET) < 0) {
+    tsdbError("vgId:%d failed to load %s part while seek file %s to offset %" PRId64 " since %s",
+              TSDB_READ_REPO_ID(pReadh), part, TSDB_FILE_FULL_NAME(pDFile), offset, tstrerror(terrno));
+    return NULL;
+  }
+
+  if (tsdbMakeRoom(ppBuf, (size_t)nbyte) < 0) return NULL;
 
-  int64_t nread = tsdbReadDFile(pDFile, TSDB_READ_BUF(pReadh), pBlock->len);
+  int64_t nread = tsdbReadDFile(pDFile, *ppBuf, nbyte);
   if (nread < 0) {
-    tsdbError("vgId:%d failed to load block data part while read file %s since %s, offset:%" PRId64 " len :%d",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), tstrerror(terrno), (int64_t)pBlock->offset,
-              pBlock->len);
-    return -1;
+    tsdbError("vgId:%d failed to load %s part while read file %s since %s, offset:%" PRId64 " len:%" PRId64,
+              TSDB_READ_REPO_ID(pReadh), part, TSDB_FILE_FULL_NAME(pDFile), tstrerror(terrno), offset, nbyte);
+    return NULL;
   }
 
-  if (nread < pBlock->len) {
+  if (nread < nbyte) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
-    tsdbError("vgId:%d block data part in file %s is corrupted, offset:%" PRId64
-              " expected bytes:%d read bytes: %" PRId64,
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), (int64_t)pBlock->offset, pBlock->len, nread);
-    return -1;
+    tsdbError("vgId:%d %s part in file %s is corrupted, offset:%" PRId64 " expected bytes:%" PRId64
+              " read bytes:%" PRId64,
+              TSDB_READ_REPO_ID(pReadh), part, TSDB_FILE_FULL_NAME(pDFile), offset, nbyte, nread);
+    return NULL;
   }
 
+  return *ppBuf;
+}
+
+static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols) {
+  ASSERT(pBlock->numOfSubBlocks == 0 || pBlock->numOfSubBlocks == 1);
+
+  SDFile *pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+
+  tdResetDataCols(pDataCols);
+  SBlockData *pBlockData =
+      tsdbLoadDFilePart(pReadh, pDFile, pBlock->offset, pBlock->len, (void **)(&TSDB_READ_BUF(pReadh)), "block data");
+  if (pBlockData == NULL) return -1;
+
   int32_t tsize = (int32_t)tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer);
-  if (!taosCheckChecksumWhole((uint8_t *)TSDB_READ_BUF(pReadh), tsize)) {
+  if (!taosCheckChecksumWhole((uint8_t *)pBlockData, tsize)) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     tsdbError("vgId:%d block statis part in file %s is corrupted since wrong checksum, offset:%" PRId64 " len :%d",
               TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), (int64_t)pBlock->offset, tsize);
@@ -681,6 +787,7 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
     int16_t  tcolId = 0;
     uint32_t toffset = TSDB_KEY_COL_OFFSET;
     int32_t  tlen = pBlock->keyLen;
+    uint8_t  tencode = TSDB_COL_ENCODE_PLAIN;
 
 
     if (dcol != 0) {
@@ -688,18 +795,20 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
       tcolId = pBlockCol->colId;
       toffset = tsdbGetBlockColOffset(pBlockCol);
       tlen = pBlockCol->len;
+      tencode = pBlockCol->encode;
     } else {
       ASSERT(pDataCol->colId == tcolId);
     }
 
     if (tcolId == pDataCol->colId) {
-      if (pBlock->algorithm == TWO_STAGE_COMP) {
+      int8_t algorithm = tsdbGetColAlgorithm(pBlock->algorithm, tencode);
+      if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
         int zsize = pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
         if (tsdbMakeRoom((void **)(&TSDB_READ_COMP_BUF(pReadh)), zsize) < 0) return -1;
       }
 
-      if (tsdbCheckAndDecodeColumnData(pDataCol, POINTER_SHIFT(pBlockData, tsize + toffset), tlen, pBlock->algorithm,
-                                       pBlock->numOfRows, pDataCols->maxPoints, TSDB_READ_COMP_BUF(pReadh),
+      if (tsdbCheckAndDecodeColumnData(pDataCol, POINTER_SHIFT(pBlockData, tsize + toffset), tlen, algorithm,
+                                       tencode, pBlock->numOfRows, pDataCols->maxPoints, TSDB_READ_COMP_BUF(pReadh),
                                        (int)taosTSizeof(TSDB_READ_COMP_BUF(pReadh))) < 0) {
         tsdbError("vgId:%d file %s is broken at column %d block offset %" PRId64 " column offset %u",
                   TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), tcolId, (int64_t)pBlock->offset, toffset);
@@ -722,14 +831,15 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
   return 0;
 }
 
-static int tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, int numOfRows,
-                                        int maxPoints, char *buffer, int bufferSize) {
+static int tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, uint8_t encode,
+                                        int numOfRows, int maxPoints, char *buffer, int bufferSize) {
   if (!taosCheckChecksumWhole((uint8_t *)content, len)) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     return -1;
   }
 
   tdAllocMemForCol(pDataCol, maxPoints);
+  pDataCol->numOfDict = 0;
 
   // Decode the data
   if (comp) {
@@ -749,8 +859,28 @@ static int tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32
     memcpy(pDataCol->pData, content, pDataCol->len);
   }
 
-  if (IS_VAR_DATA_TYPE(pDataCol->type)) {
+  if (TSDB_COL_ENCODE(encode) == TSDB_COL_ENCODE_DICT) {
+    // Keep the distinct values only and point each row to its dictionary entry, the strings are not materialized
+    uint16_t numOfDict = 0;
+    int32_t  dictLen = pDataCol->len - numOfRows - (int32_t)sizeof(numOfDict);
+    if (!IS_VAR_DATA_TYPE(pDataCol->type) || dictLen <= 0) {
+      terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+      return -1;
+    }
+
+    memcpy(&numOfDict, POINTER_SHIFT(pDataCol->pData, pDataCol->len - sizeof(numOfDict)), sizeof(numOfDict));
+    memcpy(pDataCol->dictCode, POINTER_SHIFT(pDataCol->pData, dictLen), numOfRows);
+    pDataCol->len = dictLen;
+    if (dataColSetDict(pDataCol, numOfDict, numOfRows) < 0) {
+      tsdbError("Failed to decode column dictionary, file corrupted, len:%d numOfDict:%d numOfRows:%d", dictLen,
+                numOfDict, numOfRows);
+      terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+      return -1;
+    }
+  } else if (IS_VAR_DATA_TYPE(pDataCol->type)) {
     dataColSetOffset(pDataCol, numOfRows);
+  } else {
+    dataColSetNullBitmap(pDataCol, numOfRows);
   }
   return 0;
 }
@@ -770,6 +900,11 @@ static int tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *
 
   pDataCols->numOfRows = pBlock->numOfRows;
 
+  // collect the columns first, then read and decode them all together
+  if (tsdbMakeRoom(&(pReadh->pDecTasks), sizeof(SColDecodeTask) * numOfColIds) < 0) return -1;
+  SColDecodeTask *tasks = (SColDecodeTask *)pReadh->pDecTasks;
+  int             numOfTasks = 0;
+
   int dcol = 0;
   int ccol = 0;
   for (int i = 0; i < numOfColIds; i++) {
@@ -828,51 +963,199 @@ static int tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *
       ASSERT(pBlockCol->colId == pDataCol->colId);
     }
 
-    if (tsdbLoadColData(pReadh, pDFile, pBlock, pBlockCol, pDataCol) < 0) return -1;
+    SColDecodeTask *pTask = tasks + numOfTasks++;
+    pTask->blockCol = *pBlockCol;
+    pTask->pDataCol = pDataCol;
   }
 
-  return 0;
+  return tsdbLoadColsData(pReadh, pDFile, pBlock, tasks, numOfTasks);
 }
 
-static int tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBlockCol *pBlockCol, SDataCol *pDataCol) {
-  ASSERT(pDataCol->colId == pBlockCol->colId);
-
+static int tsdbLoadColsData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SColDecodeTask *tasks, int numOfTasks) {
   STsdbRepo *pRepo = TSDB_READ_REPO(pReadh);
   STsdbCfg * pCfg = REPO_CFG(pRepo);
-  int        tsize = pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
 
-  if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), pBlockCol->len) < 0) return -1;
-  if (tsdbMakeRoom((void **)(&TSDB_READ_COMP_BUF(pReadh)), tsize) < 0) return -1;
+  // take the cached columns, the others are moved ahead to be read
+  if (pReadh->pBlockCache != NULL) {
+    int numOfMissed = 0;
+    for (int i = 0; i < numOfTasks; i++) {
+      SBlockCacheKey key = tsdbGetBlockCacheKey(pReadh, pBlock, tasks[i].blockCol.colId);
+      if (!tsdbGetBlockCacheCol(pReadh->pBlockCache, pReadh->fsVersion, &key, tasks[i].pDataCol, pBlock->numOfRows,
+                                pCfg->maxRowsPerFileBlock)) {
+        tasks[numOfMissed++] = tasks[i];
+      }
+    }
 
-  int64_t offset = pBlock->offset + tsdbBlockStatisSize(pBlock->numOfCols, (uint32_t)pBlock->blkVer) +
-                   tsdbGetBlockColOffset(pBlockCol);
-  if (tsdbSeekDFile(pDFile, offset, SEEK_SET) < 0) {
-    tsdbError("vgId:%d failed to load block column data while seek file %s to offset %" PRId64 " since %s",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), offset, tstrerror(terrno));
-    return -1;
+    numOfTasks = numOfMissed;
+    if (numOfTasks == 0) return 0;
   }
 
-  int64_t nread = tsdbReadDFile(pDFile, TSDB_READ_BUF(pReadh), pBlockCol->len);
-  if (nread < 0) {
-    tsdbError("vgId:%d failed to load block column data while read file %s since %s, offset:%" PRId64 " len :%d",
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), tstrerror(terrno), offset, pBlockCol->len);
-    return -1;
+  SDFileMap *pMap = tsdbGetDFileMap(pReadh, pDFile);
+  bool       parallel = numOfTasks > 1 && tsdbDecodeThreads() > 0 &&
+                  pBlock->numOfRows * numOfTasks >= TSDB_PARALLEL_DECODE_MIN_POINTS;
+  size_t     rsize = TSDB_READ_MAX_GAP;  // the gaps between the columns are read to the head of the read buffer
+  size_t     csize = 0;
+
+  // each column gets its own slice of the read buffer, and of the compression buffer if decoded in parallel
+  for (int i = 0; i < numOfTasks; i++) {
+    size_t tsize = tasks[i].pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
+    rsize += ALIGN8(tasks[i].blockCol.len);
+    csize = parallel ? (csize + ALIGN8(tsize)) : MAX(csize, tsize);
   }
 
-  if (nread < pBlockCol->len) {
-    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
-    tsdbError("vgId:%d block column data in file %s is corrupted, offset:%" PRId64 " expected bytes:%d" PRIzu
-              " read bytes: %" PRId64,
-              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), offset, pBlockCol->len, nread);
-    return -1;
+  // the columns are decoded off the mapping directly
+  if (pMap == NULL && tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), rsize) < 0) return -1;
+  if (tsdbMakeRoom((void **)(&TSDB_READ_COMP_BUF(pReadh)), csize) < 0) return -1;
+
+  rsize = TSDB_READ_MAX_GAP;
+  csize = 0;
+  for (int i = 0; i < numOfTasks; i++) {
+    SColDecodeTask *pTask = tasks + i;
+    pTask->content = (pMap == NULL) ? POINTER_SHIFT(TSDB_READ_BUF(pReadh), rsize) : NULL;
+    pTask->buffer = POINTER_SHIFT(TSDB_READ_COMP_BUF(pReadh), csize);
+    pTask->bufferSize = pTask->pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
+    pTask->code = TSDB_CODE_SUCCESS;
+    pTask->inCaller = !parallel;
+    rsize += ALIGN8(pTask->blockCol.len);
+    if (parallel) csize += ALIGN8(pTask->bufferSize);
   }
 
-  if (tsdbCheckAndDecodeColumnData(pDataCol, pReadh->pBuf, pBlockCol->len, pBlock->algorithm, pBlock->numOfRows,
-                                   pCfg->maxRowsPerFileBlock, pReadh->pCBuf, (int32_t)taosTSizeof(pReadh->pCBuf)) < 0) {
-    tsdbError("vgId:%d file %s is broken at column %d offset %" PRId64, REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile),
-              pBlockCol->colId, offset);
+  if (pMap != NULL) {
+    if (tsdbMapColsData(pReadh, pMap, pDFile, pBlock, tasks, numOfTasks) < 0) return -1;
+  } else if (tsdbReadColsData(pReadh, pDFile, pBlock, tasks, numOfTasks) < 0) {
     return -1;
   }
 
+  SBlockDecodeParam param = {.pBlock = pBlock, .maxPoints = pCfg->maxRowsPerFileBlock, .tasks = tasks};
+
+  if (parallel) {
+#ifdef TD_TSZ
+    // the lossy decoder is not reentrant
+    for (int i = 0; i < numOfTasks; i++) {
+      int8_t type = tasks[i].pDataCol->type;
+      if ((type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) &&
+          tsdbGetColAlgorithm(pBlock->algorithm, tasks[i].blockCol.encode) != NO_COMPRESSION &&
+          HEAD_ALGO(((char *)tasks[i].content)[0]) == ALGO_SZ_LOSSY) {
+        tasks[i].inCaller = true;
+      }
+    }
+#endif
+
+    int64_t st = taosGetTimestampUs();
+    tsdbParallelDecode(tsdbDecodeColTask, &param, numOfTasks);
+
+    pReadh->readCost.numOfDecodeBlocks++;
+    pReadh->readCost.numOfDecodeCols += numOfTasks;
+    pReadh->readCost.decodeTime += taosGetTimestampUs() - st;
+  }
+
+  for (int i = 0; i < numOfTasks; i++) {
+    SColDecodeTask *pTask = tasks + i;
+    if (pTask->inCaller) {
+      pTask->inCaller = false;
+      tsdbDecodeColTask(&param, i);
+    }
+
+    if (pTask->code != TSDB_CODE_SUCCESS) {
+      terrno = pTask->code;
+      tsdbError("vgId:%d file %s is broken at column %d offset %" PRId64, REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile),
+                pTask->blockCol.colId, tsdbGetColDataOffset(pBlock, &(pTask->blockCol)));
+      return -1;
+    }
+
+    if (pReadh->pBlockCache != NULL) {
+      SBlockCacheKey key = tsdbGetBlockCacheKey(pReadh, pBlock, pTask->blockCol.colId);
+      tsdbPutBlockCacheCol(pReadh->pBlockCache, pReadh->fsVersion, &key, pTask->pDataCol, pBlock->numOfRows);
+    }
+  }
+
+  return 0;
+}
+
+// read the columns by vectored reads, each one covering a run of columns with small gaps only between them
+static int tsdbReadColsData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SColDecodeTask *tasks, int numOfTasks) {
+  struct iovec iov[TSDB_READ_MAX_IOVS];
+
+  for (int i = 0; i < numOfTasks;) {
+    int64_t offset = tsdbGetColDataOffset(pBlock, &(tasks[i].blockCol));
+    int64_t end = offset;
+    int     niov = 0;
+
+    for (; i < numOfTasks; i++) {
+      SColDecodeTask *pTask = tasks + i;
+      int64_t         coffset = tsdbGetColDataOffset(pBlock, &(pTask->blockCol));
+      if (coffset < end || coffset - end > TSDB_READ_MAX_GAP || niov + 2 > TSDB_READ_MAX_IOVS) break;
+
+      if (coffset > end) {
+        iov[niov].iov_base = TSDB_READ_BUF(pReadh);
+        iov[niov].iov_len = (size_t)(coffset - end);
+        niov++;
+      }
+
+      iov[niov].iov_base = pTask->content;
+      iov[niov].iov_len = pTask->blockCol.len;
+      niov++;
+      end = coffset + pTask->blockCol.len;
+    }
+
+    int64_t st = taosGetTimestampUs();
+    int64_t nread = tsdbPReadvDFile(pDFile, iov, niov, offset);
+    pReadh->readCost.numOfReads++;
+    pReadh->readCost.readTime += taosGetTimestampUs() - st;
+
+    if (nread < 0) {
+      tsdbError("vgId:%d failed to load block column data while read file %s since %s, offset:%" PRId64
+                " len:%" PRId64,
+                TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), tstrerror(terrno), offset, end - offset);
+      return -1;
+    }
+
+    pReadh->readCost.readSize += nread;
+    if (nread < end - offset) {
+      terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+      tsdbError("vgId:%d block column data in file %s is corrupted, offset:%" PRId64 " expected bytes:%" PRId64
+                " read bytes: %" PRId64,
+                TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), offset, end - offset, nread);
+      return -1;
+    }
+  }
+
   return 0;
 }
+
+// point the columns to where they are in the mapping of the file
+static int tsdbMapColsData(SReadH *pReadh, SDFileMap *pMap, SDFile *pDFile, SBlock *pBlock, SColDecodeTask *tasks,
+                           int numOfTasks) {
+  for (int i = 0; i < numOfTasks; i++) {
+    SColDecodeTask *pTask = tasks + i;
+    int64_t         offset = tsdbGetColDataOffset(pBlock, &(pTask->blockCol));
+
+    if (offset + pTask->blockCol.len > pMap->size) {
+      terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+      tsdbError("vgId:%d block column data in file %s is corrupted, offset:%" PRId64 " len:%d file size:%" PRId64,
+                TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), offset, pTask->blockCol.len, pMap->size);
+      return -1;
+    }
+
+    pTask->content = POINTER_SHIFT(pMap->pAddr, offset);
+  }
+
+  pReadh->readCost.numOfMappedCols += numOfTasks;
+  return 0;
+}
+
+// runs on a decode thread, terrno is thread local so the error code is kept in the task
+static void tsdbDecodeColTask(void *param, int32_t idx) {
+  SBlockDecodeParam *pParam = (SBlockDecodeParam *)param;
+  SColDecodeTask *   pTask = pParam->tasks + idx;
+  SBlock *           pBlock = pParam->pBlock;
+
+  if (pTask->inCaller) return;
+
+  if (tsdbCheckAndDecodeColumnData(pTask->pDataCol, pTask->content, pTask->blockCol.len,
+                                   tsdbGetColAlgorithm(pBlock->algorithm, pTask->blockCol.encode),
+                                   pTask->blockCol.encode, pBlock->numOfRows, pParam->maxPoints, pTask->buffer,
+                                   pTask->bufferSize) < 0) {
+    pTask->code = terrno;
+  }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TBLOOMFILTER_H
+#define TDENGINE_TBLOOMFILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+/*
+ * Bloom filters stored as plain bit arrays, so they can be written to files as they are. The probes of a key are
+ * derived from one murmur hash by double hashing, and the hash function must never change once filters are persisted.
+ */
+
+#define TSDB_BLOOM_FILTER_MIN_BYTES 8
+
+/**
+ * bytes of a filter for the given number of keys
+ * @param numOfKeys
+ * @param bitsPerKey  larger values lower the false positive rate, 10 bits per key gives about 1%
+ */
+int32_t taosBloomFilterSize(int32_t numOfKeys, int32_t bitsPerKey);
+
+/**
+ * number of probes minimizing the false positive rate for the given bits per key
+ */
+int32_t taosBloomFilterHashes(int32_t bitsPerKey);
+
+void taosBloomFilterPut(uint8_t *pBits, int32_t size, int32_t numOfHashes, const void *key, int32_t len);
+
+/**
+ * @return false if the key is definitely not put into the filter
+ */
+bool taosBloomFilterMayContain(const uint8_t *pBits, int32_t size, int32_t numOfHashes, const void *key, int32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_TBLOOMFILTER_H
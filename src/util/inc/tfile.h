@@ -32,11 +32,13 @@ int64_t tfOpen(const char *pathname, int32_t flags);
 int64_t tfOpenM(const char *pathname, int32_t flags, mode_t mode);
 int64_t tfClose(int64_t tfd);
 int64_t tfWrite(int64_t tfd, void *buf, int64_t count);
+int64_t tfPWrite(int64_t tfd, void *buf, int64_t count, int64_t offset);
 int64_t tfRead(int64_t tfd, void *buf, int64_t count);
 int32_t tfFsync(int64_t tfd);
 bool    tfValid(int64_t tfd);
 int64_t tfLseek(int64_t tfd, int64_t offset, int32_t whence);
 int32_t tfFtruncate(int64_t tfd, int64_t length);
+int32_t tfFallocate(int64_t tfd, int64_t offset, int64_t len);
 int32_t tfStat(int64_t tfd, struct stat *pFstat);
 
 #ifdef __cplusplus
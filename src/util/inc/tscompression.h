@@ -34,6 +34,10 @@ extern "C" {
 #define ONE_STAGE_COMP 1
 #define TWO_STAGE_COMP 2
 
+// lossless float/double data is encoded by chimp bit packing instead of byte aligned xor, or-ed into the stage
+#define COMP_FLOAT_CHIMP 0x10
+#define COMP_STAGE(algorithm) ((algorithm) & 0x0F)
+
 //
 // compressed data first byte foramt
 //   ------ 7 bit ---- | ---- 1 bit ----
@@ -62,11 +66,17 @@ extern int tsCompressDoubleImp(const char *const input, const int nelements, cha
 extern int tsDecompressDoubleImp(const char *const input, const int nelements, char *const output);
 extern int tsCompressFloatImp(const char *const input, const int nelements, char *const output);
 extern int tsDecompressFloatImp(const char *const input, const int nelements, char *const output);
+extern int tsCompressDoubleChimpImp(const char *const input, const int nelements, char *const output);
+extern int tsDecompressDoubleChimpImp(const char *const input, int compressedSize, const int nelements, char *const output);
+extern int tsCompressFloatChimpImp(const char *const input, const int nelements, char *const output);
+extern int tsDecompressFloatChimpImp(const char *const input, int compressedSize, const int nelements, char *const output);
 // lossy
 extern int tsCompressFloatLossyImp(const char * input, const int nelements, char *const output);
 extern int tsDecompressFloatLossyImp(const char * input, int compressedSize, const int nelements, char *const output);
 extern int tsCompressDoubleLossyImp(const char * input, const int nelements, char *const output);
 extern int tsDecompressDoubleLossyImp(const char * input, int compressedSize, const int nelements, char *const output);
+// pick the decode kernels matching the cpu, return true if the simd ones are used
+extern bool tsResolveDecompress(bool enableSimd);
 
 #ifdef TD_TSZ
 extern bool lossyFloat;
@@ -79,9 +89,9 @@ void tsCompressExit();
 
 static FORCE_INLINE int tsCompressTinyint(const char *const input, int inputSize, const int nelements, char *const output, int outputSize, char algorithm,
                       char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_TINYINT);
     return tsCompressStringImp(buffer, len, output, outputSize);
   } else {
@@ -92,9 +102,9 @@ static FORCE_INLINE int tsCompressTinyint(const char *const input, int inputSize
 
 static FORCE_INLINE int tsDecompressTinyint(const char *const input, int compressedSize, const int nelements, char *const output,
                         int outputSize, char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_TINYINT);
   } else {
@@ -105,9 +115,9 @@ static FORCE_INLINE int tsDecompressTinyint(const char *const input, int compres
 
 static FORCE_INLINE int tsCompressSmallint(const char *const input, int inputSize, const int nelements, char *const output, int outputSize, char algorithm,
                        char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_SMALLINT);
     return tsCompressStringImp(buffer, len, output, outputSize);
   } else {
@@ -118,9 +128,9 @@ static FORCE_INLINE int tsCompressSmallint(const char *const input, int inputSiz
 
 static FORCE_INLINE int tsDecompressSmallint(const char *const input, int compressedSize, const int nelements, char *const output,
                          int outputSize, char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_SMALLINT);
   } else {
@@ -131,9 +141,9 @@ static FORCE_INLINE int tsDecompressSmallint(const char *const input, int compre
 
 static FORCE_INLINE int tsCompressInt(const char *const input, int inputSize, const int nelements, char *const output, int outputSize, char algorithm,
                   char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_INT);
     return tsCompressStringImp(buffer, len, output, outputSize);
   } else {
@@ -144,9 +154,9 @@ static FORCE_INLINE int tsCompressInt(const char *const input, int inputSize, co
 
 static FORCE_INLINE int tsDecompressInt(const char *const input, int compressedSize, const int nelements, char *const output,
                     int outputSize, char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_INT);
   } else {
@@ -157,9 +167,9 @@ static FORCE_INLINE int tsDecompressInt(const char *const input, int compressedS
 
 static FORCE_INLINE int tsCompressBigint(const char *const input, int inputSize, const int nelements, char *const output, int outputSize,
                      char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     int len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_BIGINT);
     return tsCompressStringImp(buffer, len, output, outputSize);
   } else {
@@ -170,9 +180,9 @@ static FORCE_INLINE int tsCompressBigint(const char *const input, int inputSize,
 
 static FORCE_INLINE int tsDecompressBigint(const char *const input, int compressedSize, const int nelements, char *const output,
                        int outputSize, char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_BIGINT);
   } else {
@@ -183,9 +193,9 @@ static FORCE_INLINE int tsDecompressBigint(const char *const input, int compress
 
 static FORCE_INLINE int tsCompressBool(const char *const input, int inputSize, const int nelements, char *const output, int outputSize, 
                    char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsCompressBoolImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     int len = tsCompressBoolImp(input, nelements, buffer);
     return tsCompressStringImp(buffer, len, output, outputSize);
   } else {
@@ -196,9 +206,9 @@ static FORCE_INLINE int tsCompressBool(const char *const input, int inputSize, c
 
 static FORCE_INLINE int tsDecompressBool(const char *const input, int compressedSize, const int nelements, char *const output,
                      int outputSize, char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsDecompressBoolImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressBoolImp(buffer, nelements, output);
   } else {
@@ -217,6 +227,30 @@ static FORCE_INLINE int tsDecompressString(const char *const input, int compress
   return tsDecompressStringImp(input, compressedSize, output, outputSize);
 }
 
+static FORCE_INLINE int tsCompressFloatLosslessImp(const char *const input, const int nelements, char *const output,
+                                                  char algorithm) {
+  if (algorithm & COMP_FLOAT_CHIMP) return tsCompressFloatChimpImp(input, nelements, output);
+  return tsCompressFloatImp(input, nelements, output);
+}
+
+static FORCE_INLINE int tsDecompressFloatLosslessImp(const char *const input, int compressedSize, const int nelements,
+                                                    char *const output, char algorithm) {
+  if (algorithm & COMP_FLOAT_CHIMP) return tsDecompressFloatChimpImp(input, compressedSize, nelements, output);
+  return tsDecompressFloatImp(input, nelements, output);
+}
+
+static FORCE_INLINE int tsCompressDoubleLosslessImp(const char *const input, const int nelements, char *const output,
+                                                   char algorithm) {
+  if (algorithm & COMP_FLOAT_CHIMP) return tsCompressDoubleChimpImp(input, nelements, output);
+  return tsCompressDoubleImp(input, nelements, output);
+}
+
+static FORCE_INLINE int tsDecompressDoubleLosslessImp(const char *const input, int compressedSize, const int nelements,
+                                                     char *const output, char algorithm) {
+  if (algorithm & COMP_FLOAT_CHIMP) return tsDecompressDoubleChimpImp(input, compressedSize, nelements, output);
+  return tsDecompressDoubleImp(input, nelements, output);
+}
+
 static FORCE_INLINE int tsCompressFloat(const char *const input, int inputSize, const int nelements, char *const output, int outputSize,
                     char algorithm, char *const buffer, int bufferSize) {
 #ifdef TD_TSZ
@@ -226,10 +260,10 @@ static FORCE_INLINE int tsCompressFloat(const char *const input, int inputSize,
   // lossless mode  
   } else {
 #endif    
-    if (algorithm == ONE_STAGE_COMP) {
-      return tsCompressFloatImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
-      int len = tsCompressFloatImp(input, nelements, buffer);
+    if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
+      return tsCompressFloatLosslessImp(input, nelements, output, algorithm);
+    } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
+      int len = tsCompressFloatLosslessImp(input, nelements, buffer, algorithm);
       return tsCompressStringImp(buffer, len, output, outputSize);
     } else {
       assert(0);
@@ -249,11 +283,12 @@ static FORCE_INLINE int tsDecompressFloat(const char *const input, int compresse
   } else {
 #endif    
     // decompress lossless
-    if (algorithm == ONE_STAGE_COMP) {
-      return tsDecompressFloatImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
-      if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
-      return tsDecompressFloatImp(buffer, nelements, output);
+    if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
+      return tsDecompressFloatLosslessImp(input, compressedSize, nelements, output, algorithm);
+    } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
+      int len = tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
+      if (len < 0) return -1;
+      return tsDecompressFloatLosslessImp(buffer, len, nelements, output, algorithm);
     } else {
       assert(0);
       return -1;
@@ -273,10 +308,10 @@ static FORCE_INLINE int tsCompressDouble(const char *const input, int inputSize,
   } else {
 #endif    
     // lossless mode
-    if (algorithm == ONE_STAGE_COMP) {
-      return tsCompressDoubleImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
-      int len = tsCompressDoubleImp(input, nelements, buffer);
+    if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
+      return tsCompressDoubleLosslessImp(input, nelements, output, algorithm);
+    } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
+      int len = tsCompressDoubleLosslessImp(input, nelements, buffer, algorithm);
       return tsCompressStringImp(buffer, len, output, outputSize);
     } else {
       assert(0);
@@ -296,11 +331,12 @@ static FORCE_INLINE int tsDecompressDouble(const char *const input, int compress
   } else {
   #endif  
     // decompress lossless
-    if (algorithm == ONE_STAGE_COMP) {
-      return tsDecompressDoubleImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
-      if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
-      return tsDecompressDoubleImp(buffer, nelements, output);
+    if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
+      return tsDecompressDoubleLosslessImp(input, compressedSize, nelements, output, algorithm);
+    } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
+      int len = tsDecompressStringImp(input, compressedSize, buffer, bufferSize);
+      if (len < 0) return -1;
+      return tsDecompressDoubleLosslessImp(buffer, len, nelements, output, algorithm);
     } else {
       assert(0);
       return -1;
@@ -338,9 +374,9 @@ static FORCE_INLINE int tsDecompressDoubleLossy(const char *const input, int com
 
 static FORCE_INLINE int tsCompressTimestamp(const char *const input, int inputSize, const int nelements, char *const output, int outputSize,
                         char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsCompressTimestampImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     int len = tsCompressTimestampImp(input, nelements, buffer);
     return tsCompressStringImp(buffer, len, output, outputSize);
   } else {
@@ -351,9 +387,9 @@ static FORCE_INLINE int tsCompressTimestamp(const char *const input, int inputSi
 
 static FORCE_INLINE int tsDecompressTimestamp(const char *const input, int compressedSize, const int nelements, char *const output,
                           int outputSize, char algorithm, char *const buffer, int bufferSize) {
-  if (algorithm == ONE_STAGE_COMP) {
+  if (COMP_STAGE(algorithm) == ONE_STAGE_COMP) {
     return tsDecompressTimestampImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (COMP_STAGE(algorithm) == TWO_STAGE_COMP) {
     if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
     return tsDecompressTimestampImp(buffer, nelements, output);
   } else {
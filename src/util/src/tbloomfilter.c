@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "hashfunc.h"
+#include "tbloomfilter.h"
+
+#define TSDB_BLOOM_FILTER_MAX_HASHES 30
+
+int32_t taosBloomFilterSize(int32_t numOfKeys, int32_t bitsPerKey) {
+  int64_t bits = (int64_t)numOfKeys * bitsPerKey;
+  int32_t size = (int32_t)((bits + 7) / 8);
+  return (size < TSDB_BLOOM_FILTER_MIN_BYTES) ? TSDB_BLOOM_FILTER_MIN_BYTES : size;
+}
+
+int32_t taosBloomFilterHashes(int32_t bitsPerKey) {
+  // bitsPerKey * ln(2)
+  int32_t numOfHashes = (int32_t)(bitsPerKey * 0.69);
+  if (numOfHashes < 1) numOfHashes = 1;
+  if (numOfHashes > TSDB_BLOOM_FILTER_MAX_HASHES) numOfHashes = TSDB_BLOOM_FILTER_MAX_HASHES;
+  return numOfHashes;
+}
+
+void taosBloomFilterPut(uint8_t *pBits, int32_t size, int32_t numOfHashes, const void *key, int32_t len) {
+  uint32_t numOfBits = (uint32_t)size * 8;
+  uint32_t h = MurmurHash3_32((const char *)key, (uint32_t)len);
+  uint32_t delta = (h >> 17) | (h << 15);
+
+  for (int32_t i = 0; i < numOfHashes; ++i) {
+    uint32_t pos = h % numOfBits;
+    pBits[pos / 8] |= (uint8_t)(1u << (pos % 8));
+    h += delta;
+  }
+}
+
+bool taosBloomFilterMayContain(const uint8_t *pBits, int32_t size, int32_t numOfHashes, const void *key, int32_t len) {
+  uint32_t numOfBits = (uint32_t)size * 8;
+  uint32_t h = MurmurHash3_32((const char *)key, (uint32_t)len);
+  uint32_t delta = (h >> 17) | (h << 15);
+
+  for (int32_t i = 0; i < numOfHashes; ++i) {
+    uint32_t pos = h % numOfBits;
+    if ((pBits[pos / 8] & (1u << (pos % 8))) == 0) {
+      return false;
+    }
+    h += delta;
+  }
+
+  return true;
+}
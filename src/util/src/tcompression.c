@@ -232,6 +232,315 @@ int tsCompressINTImp(const char *const input, const int nelements, char *const o
   return opos;
 }
 
+/*
+ * Decompress Integer (Simple8B).
+ *
+ * Every type has its own decode kernel, so the inner loop neither switches on the type nor on the
+ * selector of each element. On x86_64 an AVX2 version of the kernels is picked at runtime by
+ * tsResolveDecompress(), otherwise the scalar version (compiled with the baseline -msse4.2) is used.
+ */
+static const int32_t simple8bBitPerInt[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int32_t simple8bSelectorElems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+#define SIMPLE8B_DECODE_SCALAR(T, _name)                                              \
+  static void _name(const char *ip, const int nelements, T *ostream) {                \
+    int64_t prev_value = 0;                                                            \
+    int     count = 0;                                                                 \
+                                                                                       \
+    while (count < nelements) {                                                        \
+      uint64_t w = 0;                                                                  \
+      memcpy(&w, ip, LONG_BYTES);                                                      \
+      ip += LONG_BYTES;                                                                \
+                                                                                       \
+      int selector = (int)(w & INT64MASK(4));                                          \
+      int elems = MIN(simple8bSelectorElems[selector], nelements - count);             \
+      if (selector <= 1) {                                                             \
+        /* all the zigzag values are 0, so the previous value repeats */               \
+        for (int i = 0; i < elems; i++) ostream[count + i] = (T)prev_value;            \
+      } else {                                                                         \
+        int      bit = simple8bBitPerInt[selector];                                    \
+        uint64_t mask = INT64MASK(bit);                                                \
+        w >>= 4;                                                                       \
+        for (int i = 0; i < elems; i++) {                                              \
+          uint64_t zigzag_value = w & mask;                                            \
+          w >>= bit;                                                                   \
+          prev_value = (int64_t)((uint64_t)prev_value + (uint64_t)(ZIGZAG_DECODE(int64_t, zigzag_value))); \
+          ostream[count + i] = (T)prev_value;                                          \
+        }                                                                              \
+      }                                                                                \
+      count += elems;                                                                  \
+    }                                                                                  \
+  }
+
+SIMPLE8B_DECODE_SCALAR(int8_t, decodeSimple8BI8)
+SIMPLE8B_DECODE_SCALAR(int16_t, decodeSimple8BI16)
+SIMPLE8B_DECODE_SCALAR(int32_t, decodeSimple8BI32)
+SIMPLE8B_DECODE_SCALAR(int64_t, decodeSimple8BI64)
+
+/*
+ * Decode the delta-of-delta stream of timestamps. Regular timestamps make long runs of zero flag
+ * bytes, in which the delta does not change, so a run is expanded as an arithmetic progression
+ * instead of being decoded flag by flag.
+ */
+static FORCE_INLINE uint64_t decodeTimestampDod(const char *const input, int ipos, int nbytes) {
+  uint64_t dd = 0;
+  if (nbytes == 0) return 0;
+
+  if (is_bigendian()) {
+    memcpy(((char *)(&dd)) + LONG_BYTES - nbytes, input + ipos, nbytes);
+  } else {
+    memcpy(&dd, input + ipos, nbytes);
+  }
+  return (uint64_t)(ZIGZAG_DECODE(int64_t, dd));
+}
+
+static FORCE_INLINE uint64_t fillTimestampScalar(int64_t *ostream, int num, uint64_t value, uint64_t delta) {
+  for (int k = 0; k < num; k++) {
+    value += delta;
+    ostream[k] = (int64_t)value;
+  }
+  return value;
+}
+
+#define TIMESTAMP_DECODE(_name, _fill, _attr)                                             \
+  static _attr void _name(const char *const input, const int nelements, int64_t *ostream) { \
+    uint8_t  flags = input[1];                                                           \
+    int      ipos = 2;                                                                   \
+    int      opos = 0;                                                                   \
+    int      nbytes = flags & INT8MASK(4);                                               \
+                                                                                         \
+    /* the first delta of delta is the first value itself */                             \
+    uint64_t value = decodeTimestampDod(input, ipos, nbytes);                            \
+    uint64_t delta = 0;                                                                  \
+    ostream[opos++] = (int64_t)value;                                                    \
+    ipos += nbytes;                                                                      \
+    if (opos == nelements) return;                                                       \
+                                                                                         \
+    nbytes = (flags >> 4) & INT8MASK(4);                                                 \
+    delta += decodeTimestampDod(input, ipos, nbytes);                                    \
+    value += delta;                                                                      \
+    ostream[opos++] = (int64_t)value;                                                    \
+    ipos += nbytes;                                                                      \
+                                                                                         \
+    while (opos < nelements) {                                                           \
+      flags = input[ipos];                                                               \
+      if (flags == 0) {                                                                  \
+        /* each flag byte covers two values, never scan beyond the last one */           \
+        int maxRun = (nelements - opos + 1) / 2;                                         \
+        int run = 1;                                                                     \
+        while (run < maxRun && input[ipos + run] == 0) run++;                            \
+        int num = MIN(run * 2, nelements - opos);                                        \
+        value = _fill(ostream + opos, num, value, delta);                                \
+        ipos += run;                                                                     \
+        opos += num;                                                                     \
+        continue;                                                                        \
+      }                                                                                  \
+                                                                                         \
+      ipos++;                                                                            \
+      nbytes = flags & INT8MASK(4);                                                      \
+      delta += decodeTimestampDod(input, ipos, nbytes);                                  \
+      value += delta;                                                                    \
+      ostream[opos++] = (int64_t)value;                                                  \
+      ipos += nbytes;                                                                    \
+      if (opos == nelements) break;                                                      \
+                                                                                         \
+      nbytes = (flags >> 4) & INT8MASK(4);                                               \
+      delta += decodeTimestampDod(input, ipos, nbytes);                                  \
+      value += delta;                                                                    \
+      ostream[opos++] = (int64_t)value;                                                  \
+      ipos += nbytes;                                                                    \
+    }                                                                                    \
+  }
+
+TIMESTAMP_DECODE(decodeTimestampScalar, fillTimestampScalar, )
+
+#if !defined(_TD_ARM_) && !defined(_TD_MIPS_) && !defined(WINDOWS) && defined(__x86_64__)
+#define SIMPLE8B_AVX2
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define TD_TARGET_AVX2 __attribute__((target("avx2")))
+
+// the AVX2 kernels first unpack the deltas of a chunk of words, then run the prefix sum over them
+#define SIMPLE8B_CHUNK_ELEMS 1024
+#define SIMPLE8B_CHUNK_PAD   (240 + 4)
+
+// inclusive prefix sum of the four 64 bits lanes
+static FORCE_INLINE TD_TARGET_AVX2 __m256i prefixSumI64x4(__m256i v) {
+  __m256i zero = _mm256_setzero_si256();
+  v = _mm256_add_epi64(v, _mm256_blend_epi32(zero, _mm256_permute4x64_epi64(v, 0x90), 0xFC));
+  v = _mm256_add_epi64(v, _mm256_blend_epi32(zero, _mm256_permute4x64_epi64(v, 0x40), 0xF0));
+  return v;
+}
+
+/*
+ * Unpack the zigzag decoded deltas of whole words until at least limit ones are out. Four
+ * elements of a word are extracted at a time with variable shifts, so up to three garbage
+ * values may be written after the last one.
+ */
+static FORCE_INLINE TD_TARGET_AVX2 int unpackSimple8BAvx2(const char **ip, int limit, int64_t *diffs) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi64x(1);
+  int           n = 0;
+
+  while (n < limit) {
+    uint64_t w = 0;
+    memcpy(&w, *ip, LONG_BYTES);
+    *ip += LONG_BYTES;
+
+    int selector = (int)(w & INT64MASK(4));
+    int elems = simple8bSelectorElems[selector];
+    if (selector <= 1) {
+      for (int i = 0; i < elems; i += 4) _mm256_storeu_si256((__m256i *)(diffs + n + i), zero);
+    } else {
+      int     bit = simple8bBitPerInt[selector];
+      __m256i vw = _mm256_set1_epi64x((int64_t)(w >> 4));
+      __m256i vmask = _mm256_set1_epi64x((int64_t)INT64MASK(bit));
+      __m256i vshift = _mm256_setr_epi64x(0, bit, 2 * bit, 3 * bit);
+      __m256i vstep = _mm256_set1_epi64x(4 * bit);
+      for (int i = 0; i < elems; i += 4) {
+        __m256i z = _mm256_and_si256(_mm256_srlv_epi64(vw, vshift), vmask);
+        __m256i d = _mm256_xor_si256(_mm256_srli_epi64(z, 1), _mm256_sub_epi64(zero, _mm256_and_si256(z, one)));
+        _mm256_storeu_si256((__m256i *)(diffs + n + i), d);
+        vshift = _mm256_add_epi64(vshift, vstep);
+      }
+    }
+    n += elems;
+  }
+
+  return n;
+}
+
+static FORCE_INLINE TD_TARGET_AVX2 int64_t scanSimple8BI64Avx2(const int64_t *diffs, int num, int64_t *ostream,
+                                                             int64_t prev_value) {
+  __m256i vprev = _mm256_set1_epi64x(prev_value);
+  int     i = 0;
+  for (; i + 4 <= num; i += 4) {
+    __m256i v = _mm256_add_epi64(prefixSumI64x4(_mm256_loadu_si256((const __m256i *)(diffs + i))), vprev);
+    _mm256_storeu_si256((__m256i *)(ostream + i), v);
+    vprev = _mm256_permute4x64_epi64(v, 0xFF);
+  }
+
+  prev_value = _mm256_extract_epi64(vprev, 0);
+  for (; i < num; i++) {
+    prev_value = (int64_t)((uint64_t)prev_value + (uint64_t)diffs[i]);
+    ostream[i] = prev_value;
+  }
+  return prev_value;
+}
+
+static FORCE_INLINE TD_TARGET_AVX2 int64_t scanSimple8BI32Avx2(const int64_t *diffs, int num, int32_t *ostream,
+                                                             int64_t prev_value) {
+  const __m256i vnarrow = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  __m256i       vprev = _mm256_set1_epi64x(prev_value);
+  int           i = 0;
+  for (; i + 4 <= num; i += 4) {
+    __m256i v = _mm256_add_epi64(prefixSumI64x4(_mm256_loadu_si256((const __m256i *)(diffs + i))), vprev);
+    _mm_storeu_si128((__m128i *)(ostream + i), _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(v, vnarrow)));
+    vprev = _mm256_permute4x64_epi64(v, 0xFF);
+  }
+
+  prev_value = _mm256_extract_epi64(vprev, 0);
+  for (; i < num; i++) {
+    prev_value = (int64_t)((uint64_t)prev_value + (uint64_t)diffs[i]);
+    ostream[i] = (int32_t)prev_value;
+  }
+  return prev_value;
+}
+
+#define SIMPLE8B_SCAN_NARROW(T, _name)                                                               \
+  static FORCE_INLINE int64_t _name(const int64_t *diffs, int num, T *ostream, int64_t prev_value) { \
+    for (int i = 0; i < num; i++) {                                                                  \
+      prev_value = (int64_t)((uint64_t)prev_value + (uint64_t)diffs[i]);                             \
+      ostream[i] = (T)prev_value;                                                                    \
+    }                                                                                                \
+    return prev_value;                                                                               \
+  }
+
+SIMPLE8B_SCAN_NARROW(int8_t, scanSimple8BI8)
+SIMPLE8B_SCAN_NARROW(int16_t, scanSimple8BI16)
+
+#define SIMPLE8B_DECODE_AVX2(T, _name, _scan)                                                   \
+  static TD_TARGET_AVX2 void _name(const char *ip, const int nelements, T *ostream) {          \
+    int64_t diffs[SIMPLE8B_CHUNK_ELEMS + SIMPLE8B_CHUNK_PAD];                                   \
+    int64_t prev_value = 0;                                                                     \
+    int     count = 0;                                                                          \
+                                                                                                \
+    while (count < nelements) {                                                                 \
+      int num = unpackSimple8BAvx2(&ip, MIN(SIMPLE8B_CHUNK_ELEMS, nelements - count), diffs);   \
+      num = MIN(num, nelements - count);                                                        \
+      prev_value = _scan(diffs, num, ostream + count, prev_value);                              \
+      count += num;                                                                             \
+    }                                                                                           \
+  }
+
+SIMPLE8B_DECODE_AVX2(int8_t, decodeSimple8BI8Avx2, scanSimple8BI8)
+SIMPLE8B_DECODE_AVX2(int16_t, decodeSimple8BI16Avx2, scanSimple8BI16)
+SIMPLE8B_DECODE_AVX2(int32_t, decodeSimple8BI32Avx2, scanSimple8BI32Avx2)
+SIMPLE8B_DECODE_AVX2(int64_t, decodeSimple8BI64Avx2, scanSimple8BI64Avx2)
+
+static FORCE_INLINE TD_TARGET_AVX2 uint64_t fillTimestampAvx2(int64_t *ostream, int num, uint64_t value,
+                                                            uint64_t delta) {
+  int k = 0;
+  if (num >= 4) {
+    __m256i vstep = _mm256_set1_epi64x((int64_t)(delta * 4));
+    __m256i v = _mm256_setr_epi64x((int64_t)(value + delta), (int64_t)(value + delta * 2),
+                                   (int64_t)(value + delta * 3), (int64_t)(value + delta * 4));
+    for (; k + 4 <= num; k += 4) {
+      _mm256_storeu_si256((__m256i *)(ostream + k), v);
+      v = _mm256_add_epi64(v, vstep);
+    }
+    value += delta * k;
+  }
+
+  return fillTimestampScalar(ostream + k, num - k, value, delta);
+}
+
+TIMESTAMP_DECODE(decodeTimestampAvx2, fillTimestampAvx2, TD_TARGET_AVX2)
+
+static bool tsCpuSupportAvx2() {
+  uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+
+  // the OS must save the ymm registers on context switch
+  if (((ecx >> 27) & 1) == 0 || ((ecx >> 28) & 1) == 0) return false;
+  uint32_t xcr0 = 0, xcr0Hi = 0;
+  __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(xcr0Hi) : "c"(0));
+  if ((xcr0 & 6) != 6) return false;
+
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+  return ((ebx >> 5) & 1) != 0;
+}
+#endif  // SIMPLE8B_AVX2
+
+static void (*tsDecodeSimple8BI8)(const char *, const int, int8_t *) = decodeSimple8BI8;
+static void (*tsDecodeSimple8BI16)(const char *, const int, int16_t *) = decodeSimple8BI16;
+static void (*tsDecodeSimple8BI32)(const char *, const int, int32_t *) = decodeSimple8BI32;
+static void (*tsDecodeSimple8BI64)(const char *, const int, int64_t *) = decodeSimple8BI64;
+static void (*tsDecodeTimestamp)(const char *const, const int, int64_t *) = decodeTimestampScalar;
+
+bool tsResolveDecompress(bool enableSimd) {
+  tsDecodeSimple8BI8 = decodeSimple8BI8;
+  tsDecodeSimple8BI16 = decodeSimple8BI16;
+  tsDecodeSimple8BI32 = decodeSimple8BI32;
+  tsDecodeSimple8BI64 = decodeSimple8BI64;
+  tsDecodeTimestamp = decodeTimestampScalar;
+
+#ifdef SIMPLE8B_AVX2
+  if (enableSimd && tsCpuSupportAvx2()) {
+    tsDecodeSimple8BI8 = decodeSimple8BI8Avx2;
+    tsDecodeSimple8BI16 = decodeSimple8BI16Avx2;
+    tsDecodeSimple8BI32 = decodeSimple8BI32Avx2;
+    tsDecodeSimple8BI64 = decodeSimple8BI64Avx2;
+    tsDecodeTimestamp = decodeTimestampAvx2;
+    return true;
+  }
+#endif
+
+  return false;
+}
+
 int tsDecompressINTImp(const char *const input, const int nelements, char *const output, const char type) {
   int word_length = 0;
   switch (type) {
@@ -258,63 +567,19 @@ int tsDecompressINTImp(const char *const input, const int nelements, char *const
     return nelements * word_length;
   }
 
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int  selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-
-  const char *ip = input + 1;
-  int         count = 0;
-  int         _pos = 0;
-  int64_t     prev_value = 0;
-
-  while (1) {
-    if (count == nelements) break;
-
-    uint64_t w = 0;
-    memcpy(&w, ip, LONG_BYTES);
-
-    char selector = (char)(w & INT64MASK(4));  // selector = 4
-    char bit = bit_per_integer[(int)selector];      // bit = 3
-    int  elems = selector_to_elems[(int)selector];
-
-    for (int i = 0; i < elems; i++) {
-      uint64_t zigzag_value;
-
-      if (selector == 0 || selector == 1) {
-        zigzag_value = 0;
-      } else {
-        zigzag_value = ((w >> (4 + bit * i)) & INT64MASK(bit));
-      }
-      int64_t diff = ZIGZAG_DECODE(int64_t, zigzag_value);
-      int64_t curr_value = diff + prev_value;
-      prev_value = curr_value;
-
-      switch (type) {
-        case TSDB_DATA_TYPE_BIGINT:
-          *((int64_t *)output + _pos) = (int64_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_INT:
-          *((int32_t *)output + _pos) = (int32_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          *((int16_t *)output + _pos) = (int16_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_TINYINT:
-          *((int8_t *)output + _pos) = (int8_t)curr_value;
-          _pos++;
-          break;
-        default:
-          perror("Wrong integer types.\n");
-          return -1;
-      }
-      count++;
-      if (count == nelements) break;
-    }
-    ip += LONG_BYTES;
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      (*tsDecodeSimple8BI64)(input + 1, nelements, (int64_t *)output);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      (*tsDecodeSimple8BI32)(input + 1, nelements, (int32_t *)output);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      (*tsDecodeSimple8BI16)(input + 1, nelements, (int16_t *)output);
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      (*tsDecodeSimple8BI8)(input + 1, nelements, (int8_t *)output);
+      break;
   }
 
   return nelements * word_length;
@@ -575,67 +840,14 @@ int tsDecompressTimestampImp(const char *const input, const int nelements, char
     memcpy(output, input + 1, nelements * LONG_BYTES);
     return nelements * LONG_BYTES;
   } else if (input[0] == 1) {  // Decompress
-    int64_t *ostream = (int64_t *)output;
-
-    int     ipos = 1, opos = 0;
-    int8_t  nbytes = 0;
-    int64_t prev_value = 0;
-    int64_t prev_delta = 0;
-    int64_t delta_of_delta = 0;
-
-    while (1) {
-      uint8_t flags = input[ipos++];
-      // Decode dd1
-      uint64_t dd1 = 0;
-      nbytes = flags & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
-      } else {
-        if (is_bigendian()) {
-          memcpy(((char *)(&dd1)) + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd1, input + ipos, nbytes);
-        }
-        delta_of_delta = ZIGZAG_DECODE(int64_t, dd1);
-      }
-      ipos += nbytes;
-      if (opos == 0) {
-        prev_value = delta_of_delta;
-        prev_delta = 0;
-        ostream[opos++] = delta_of_delta;
-      } else {
-        prev_delta = delta_of_delta + prev_delta;
-        prev_value = prev_value + prev_delta;
-        ostream[opos++] = prev_value;
-      }
-      if (opos == nelements) return nelements * LONG_BYTES;
-
-      // Decode dd2
-      uint64_t dd2 = 0;
-      nbytes = (flags >> 4) & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
-      } else {
-        if (is_bigendian()) {
-          memcpy(((char *)(&dd2)) + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd2, input + ipos, nbytes);
-        }
-        // zigzag_decoding
-        delta_of_delta = ZIGZAG_DECODE(int64_t, dd2);
-      }
-      ipos += nbytes;
-      prev_delta = delta_of_delta + prev_delta;
-      prev_value = prev_value + prev_delta;
-      ostream[opos++] = prev_value;
-      if (opos == nelements) return nelements * LONG_BYTES;
-    }
-
+    (*tsDecodeTimestamp)(input, nelements, (int64_t *)output);
+    return nelements * LONG_BYTES;
   } else {
     assert(0);
     return -1;
   }
 }
+
 /* --------------------------------------------Double Compression
  * ---------------------------------------------- */
 void encodeDoubleValue(uint64_t diff, uint8_t flag, char *const output, int *const pos) {
@@ -930,6 +1142,251 @@ int tsDecompressFloatImp(const char *const input, const int nelements, char *con
   return nelements * FLOAT_BYTES;
 }
 
+/* --------------------------------------------Chimp Compression
+ * ---------------------------------------------- */
+// Float and double values are XOR-ed with the previous one and bit packed as in Chimp: a 2 bits flag per value tells
+// if the xor is zero (00), keeps its center bits only (01), reuses the previous leading zeros (10) or stores new
+// leading zeros (11). Bits are packed from the least significant bit of each byte.
+#define CHIMP_LEAD_CODE_BITS 3
+
+static const uint8_t chimpLeadRound[] = {0, 8, 12, 16, 18, 20, 22, 24};
+
+typedef struct {
+  char *   output;
+  int      pos;
+  uint64_t buf;
+  int      nbits;
+} SChimpWriter;
+
+typedef struct {
+  const char *input;
+  int         pos;
+  int         size;
+  uint64_t    buf;
+  int         nbits;
+  bool        overflow;
+} SChimpReader;
+
+// nbits no more than 56
+static FORCE_INLINE void chimpWriteBits(SChimpWriter *pWriter, uint64_t value, int nbits) {
+  pWriter->buf |= value << pWriter->nbits;
+  pWriter->nbits += nbits;
+  while (pWriter->nbits >= BITS_PER_BYTE) {
+    pWriter->output[pWriter->pos++] = (char)pWriter->buf;
+    pWriter->buf >>= BITS_PER_BYTE;
+    pWriter->nbits -= BITS_PER_BYTE;
+  }
+}
+
+static FORCE_INLINE void chimpWriteLongBits(SChimpWriter *pWriter, uint64_t value, int nbits) {
+  if (nbits > (LONG_BYTES - 1) * BITS_PER_BYTE) {
+    chimpWriteBits(pWriter, value & INT64MASK(32), 32);
+    value >>= 32;
+    nbits -= 32;
+  }
+  chimpWriteBits(pWriter, value, nbits);
+}
+
+// nbits no more than 56
+static FORCE_INLINE uint64_t chimpReadBits(SChimpReader *pReader, int nbits) {
+  if (pReader->nbits < nbits) {
+    if (pReader->pos + LONG_BYTES <= pReader->size) {
+      // the bits loaded beyond the whole bytes are loaded again with the same value by the next refill
+      uint64_t word;
+      memcpy(&word, pReader->input + pReader->pos, LONG_BYTES);
+      int nbytes = (LONG_BYTES * BITS_PER_BYTE - 1 - pReader->nbits) / BITS_PER_BYTE;
+      pReader->buf |= word << pReader->nbits;
+      pReader->pos += nbytes;
+      pReader->nbits += nbytes * BITS_PER_BYTE;
+    } else {
+      while (pReader->nbits <= (LONG_BYTES - 1) * BITS_PER_BYTE && pReader->pos < pReader->size) {
+        pReader->buf |= ((uint64_t)(uint8_t)pReader->input[pReader->pos++]) << pReader->nbits;
+        pReader->nbits += BITS_PER_BYTE;
+      }
+      if (pReader->nbits < nbits) {
+        pReader->overflow = true;
+        pReader->nbits = nbits;
+      }
+    }
+  }
+
+  uint64_t value = pReader->buf & INT64MASK(nbits);
+  pReader->buf >>= nbits;
+  pReader->nbits -= nbits;
+  return value;
+}
+
+static FORCE_INLINE uint64_t chimpReadLongBits(SChimpReader *pReader, int nbits) {
+  if (nbits > (LONG_BYTES - 1) * BITS_PER_BYTE) {
+    uint64_t low = chimpReadBits(pReader, 32);
+    return low | (chimpReadBits(pReader, nbits - 32) << 32);
+  }
+  return chimpReadBits(pReader, nbits);
+}
+
+static FORCE_INLINE uint64_t chimpGetValue(const char *const input, int i, int bytes) {
+  if (bytes == DOUBLE_BYTES) {
+    uint64_t value;
+    memcpy(&value, input + i * DOUBLE_BYTES, DOUBLE_BYTES);
+    return value;
+  } else {
+    uint32_t value;
+    memcpy(&value, input + i * FLOAT_BYTES, FLOAT_BYTES);
+    return value;
+  }
+}
+
+static FORCE_INLINE void chimpPutValue(char *const output, int i, int bytes, uint64_t value) {
+  if (bytes == DOUBLE_BYTES) {
+    memcpy(output + i * DOUBLE_BYTES, &value, DOUBLE_BYTES);
+  } else {
+    uint32_t bits = (uint32_t)value;
+    memcpy(output + i * FLOAT_BYTES, &bits, FLOAT_BYTES);
+  }
+}
+
+static FORCE_INLINE int chimpLeadCode(int leadingZeros) {
+  if (leadingZeros < 8) return 0;
+  if (leadingZeros < 12) return 1;
+  if (leadingZeros < 16) return 2;
+  return MIN(3 + (leadingZeros - 16) / 2, 7);
+}
+
+static FORCE_INLINE int tsCompressChimpImp(const char *const input, const int nelements, char *const output,
+                                           const int bytes) {
+  const int width = bytes * BITS_PER_BYTE;
+  // center bits only pay off above this number of trailing zeros
+  const int threshold = (bytes == DOUBLE_BYTES) ? 6 : 5;
+  const int centerBits = (bytes == DOUBLE_BYTES) ? 6 : 5;
+  int       byte_limit = nelements * bytes + 1;
+
+  if (nelements <= 0) {
+    output[0] = 0;
+    return 1;
+  }
+
+  SChimpWriter writer = {.output = output, .pos = 1, .buf = 0, .nbits = 0};
+
+  uint64_t prev_value = chimpGetValue(input, 0, bytes);
+  int      prev_lead = width + 1;
+  chimpWriteLongBits(&writer, prev_value, width);
+
+  for (int i = 1; i < nelements; i++) {
+    // a value never takes more than 2 + 3 + 64 bits
+    if (writer.pos + 9 >= byte_limit) {
+      output[0] = 1;
+      memcpy(output + 1, input, byte_limit - 1);
+      return byte_limit;
+    }
+
+    uint64_t value = chimpGetValue(input, i, bytes);
+    uint64_t diff = value ^ prev_value;
+    prev_value = value;
+
+    if (diff == 0) {
+      chimpWriteBits(&writer, 0, 2);
+      continue;
+    }
+
+    int code = chimpLeadCode(BUILDIN_CLZL(diff) - (LONG_BYTES * BITS_PER_BYTE - width));
+    int lead = chimpLeadRound[code];
+    int trail = BUILDIN_CTZL(diff);
+
+    if (trail > threshold) {
+      int center = width - lead - trail;
+      chimpWriteBits(&writer, 1 | (code << 2) | (center << (2 + CHIMP_LEAD_CODE_BITS)),
+                     2 + CHIMP_LEAD_CODE_BITS + centerBits);
+      chimpWriteLongBits(&writer, diff >> trail, center);
+      prev_lead = width + 1;
+    } else if (lead == prev_lead) {
+      chimpWriteBits(&writer, 2, 2);
+      chimpWriteLongBits(&writer, diff, width - lead);
+    } else {
+      chimpWriteBits(&writer, 3 | (code << 2), 2 + CHIMP_LEAD_CODE_BITS);
+      chimpWriteLongBits(&writer, diff, width - lead);
+      prev_lead = lead;
+    }
+  }
+
+  if (writer.nbits > 0) {
+    output[writer.pos++] = (char)writer.buf;
+  }
+
+  output[0] = 0;
+  return writer.pos;
+}
+
+static FORCE_INLINE int tsDecompressChimpImp(const char *const input, int compressedSize, const int nelements,
+                                             char *const output, const int bytes) {
+  const int width = bytes * BITS_PER_BYTE;
+  const int centerBits = (bytes == DOUBLE_BYTES) ? 6 : 5;
+
+  if (input[0] == 1) {
+    if (compressedSize < nelements * bytes + 1) return -1;
+    memcpy(output, input + 1, nelements * bytes);
+    return nelements * bytes;
+  }
+
+  if (nelements <= 0) return 0;
+
+  SChimpReader reader = {.input = input, .pos = 1, .size = compressedSize, .buf = 0, .nbits = 0, .overflow = false};
+
+  uint64_t prev_value = chimpReadLongBits(&reader, width);
+  int      prev_lead = 0;
+  chimpPutValue(output, 0, bytes, prev_value);
+
+  for (int i = 1; i < nelements; i++) {
+    uint64_t diff = 0;
+
+    switch (chimpReadBits(&reader, 2)) {
+      case 1: {
+        uint64_t head = chimpReadBits(&reader, CHIMP_LEAD_CODE_BITS + centerBits);
+        int      lead = chimpLeadRound[head & INT64MASK(CHIMP_LEAD_CODE_BITS)];
+        int      center = (int)(head >> CHIMP_LEAD_CODE_BITS);
+        int      trail = width - lead - center;
+        if (center == 0 || trail < 0) return -1;
+        diff = chimpReadLongBits(&reader, center) << trail;
+        break;
+      }
+      case 2:
+        diff = chimpReadLongBits(&reader, width - prev_lead);
+        break;
+      case 3:
+        prev_lead = chimpLeadRound[chimpReadBits(&reader, CHIMP_LEAD_CODE_BITS)];
+        diff = chimpReadLongBits(&reader, width - prev_lead);
+        break;
+      default:
+        break;
+    }
+
+    prev_value ^= diff;
+    chimpPutValue(output, i, bytes, prev_value);
+  }
+
+  if (reader.overflow) {
+    uError("Failed to decompress chimp encoded data, compressed size:%d elements:%d", compressedSize, nelements);
+    return -1;
+  }
+
+  return nelements * bytes;
+}
+
+int tsCompressDoubleChimpImp(const char *const input, const int nelements, char *const output) {
+  return tsCompressChimpImp(input, nelements, output, DOUBLE_BYTES);
+}
+
+int tsDecompressDoubleChimpImp(const char *const input, int compressedSize, const int nelements, char *const output) {
+  return tsDecompressChimpImp(input, compressedSize, nelements, output, DOUBLE_BYTES);
+}
+
+int tsCompressFloatChimpImp(const char *const input, const int nelements, char *const output) {
+  return tsCompressChimpImp(input, nelements, output, FLOAT_BYTES);
+}
+
+int tsDecompressFloatChimpImp(const char *const input, int compressedSize, const int nelements, char *const output) {
+  return tsDecompressChimpImp(input, compressedSize, nelements, output, FLOAT_BYTES);
+}
+
 #ifdef TD_TSZ  
 //
 //   ----------  float double lossy  -----------
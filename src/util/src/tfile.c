@@ -80,6 +80,19 @@ int64_t tfWrite(int64_t tfd, void *buf, int64_t count) {
   return ret;
 }
 
+int64_t tfPWrite(int64_t tfd, void *buf, int64_t count, int64_t offset) {
+  void *p = taosAcquireRef(tsFileRsetId, tfd);
+  if (p == NULL) return -1;
+
+  int32_t fd = (int32_t)(uintptr_t)p;
+
+  int64_t ret = taosPWrite(fd, buf, count, offset);
+  if (ret < 0) terrno = TAOS_SYSTEM_ERROR(errno);
+
+  taosReleaseRef(tsFileRsetId, tfd);
+  return ret;
+}
+
 int64_t tfRead(int64_t tfd, void *buf, int64_t count) {
   void *p = taosAcquireRef(tsFileRsetId, tfd);
   if (p == NULL) return -1;
@@ -134,6 +147,17 @@ int32_t tfFtruncate(int64_t tfd, int64_t length) {
   return code;
 }
 
+int32_t tfFallocate(int64_t tfd, int64_t offset, int64_t len) {
+  void *p = taosAcquireRef(tsFileRsetId, tfd);
+  if (p == NULL) return -1;
+
+  int32_t fd = (int32_t)(uintptr_t)p;
+  int32_t code = taosFallocate(fd, offset, len);
+
+  taosReleaseRef(tsFileRsetId, tfd);
+  return code;
+}
+
 int32_t tfStat(int64_t tfd, struct stat *pFstat) {
   void *p = taosAcquireRef(tsFileRsetId, tfd);
   if (p == NULL) return -1;
@@ -18,8 +18,15 @@
 #include "taoserror.h"
 #include "tqueue.h"
 
+// The producers append the items to a queue with one atomic exchange of its tail and never take a lock. The
+// consumers, serialized by the queue mutex, follow the links from the head and take all the items linked so far in
+// one go. A stub node stays in the queue so that the last item can be taken while the producers keep appending. A
+// qset reader only sleeps on the semaphore once no queue has items, and a producer posts the semaphore only for a
+// sleeping reader.
+
 typedef struct STaosQnode {
-  int                 type;
+  int32_t             type;
+  int32_t             pool;    // size class the node is allocated from, -1 if it is not pooled
   struct STaosQnode  *next;
   char                item[];
 } STaosQnode;
@@ -27,12 +34,13 @@ typedef struct STaosQnode {
 typedef struct STaosQueue {
   int32_t             itemSize;
   int32_t             numOfItems;
-  struct STaosQnode  *head;
-  struct STaosQnode  *tail;
+  struct STaosQnode  *head;    // read by the consumers
+  struct STaosQnode  *tail;    // appended by the producers
+  struct STaosQnode  *stub;
   struct STaosQueue  *next;    // for queue set
   struct STaosQset   *qset;    // for queue set
   void               *ahandle; // for queue set
-  pthread_mutex_t     mutex;  
+  pthread_mutex_t     mutex;   // serializes the consumers
 } STaosQueue;
 
 typedef struct STaosQset {
@@ -40,7 +48,8 @@ typedef struct STaosQset {
   STaosQueue        *current;
   pthread_mutex_t    mutex;
   int32_t            numOfQueues;
-  int32_t            numOfItems;
+  int32_t            numOfWaiters;
+  int32_t            numOfResumes;
   tsem_t             sem;
 } STaosQset;
 
@@ -50,7 +59,177 @@ typedef struct STaosQall {
   int32_t       itemSize;
   int32_t       numOfItems;
 } STaosQall; 
-  
+
+// the freed nodes are kept by size classes, every 16 bytes up to 1KB as malloc rounds the sizes anyway, then four
+// classes for each power of two up to 64KB. Each class caches up to 1MB of nodes.
+#define QNODE_POOL_ALIGN     16
+#define QNODE_POOL_SMALL     1024
+#define QNODE_POOL_MAX_SHIFT 16
+#define QNODE_POOL_SMALL_CLASSES (QNODE_POOL_SMALL / QNODE_POOL_ALIGN)
+#define QNODE_POOL_CLASSES   (QNODE_POOL_SMALL_CLASSES + (QNODE_POOL_MAX_SHIFT - 10) * 4)
+#define QNODE_POOL_BYTES     (1024 * 1024)
+
+typedef struct {
+  STaosQnode *head;  // pushed with a CAS, popped under the lock so that a popped node is never pushed back meanwhile
+  int32_t     numOfNodes;
+  int32_t     lock;
+} SQnodePool;
+
+static SQnodePool tsQnodePool[QNODE_POOL_CLASSES];
+
+static int32_t taosGetQnodeClass(int64_t size) {
+  if (size <= QNODE_POOL_SMALL) return (int32_t)((size + QNODE_POOL_ALIGN - 1) / QNODE_POOL_ALIGN) - 1;
+  if (size > ((int64_t)1 << QNODE_POOL_MAX_SHIFT)) return -1;
+
+  int32_t shift = 10;
+  while (size > ((int64_t)2 << shift)) shift++;
+
+  int64_t step = (int64_t)1 << (shift - 2);
+  int32_t sub = (int32_t)((size - ((int64_t)1 << shift) + step - 1) / step);
+  return QNODE_POOL_SMALL_CLASSES + (shift - 10) * 4 + sub - 1;
+}
+
+static int64_t taosGetQnodeClassSize(int32_t c) {
+  if (c < QNODE_POOL_SMALL_CLASSES) return (int64_t)(c + 1) * QNODE_POOL_ALIGN;
+
+  int32_t shift = 10 + (c - QNODE_POOL_SMALL_CLASSES) / 4;
+  int32_t sub = (c - QNODE_POOL_SMALL_CLASSES) % 4 + 1;
+  return ((int64_t)1 << shift) + sub * ((int64_t)1 << (shift - 2));
+}
+
+static STaosQnode *taosPopQnode(int32_t c) {
+  SQnodePool *pPool = tsQnodePool + c;
+  if (atomic_load_ptr(&pPool->head) == NULL) return NULL;
+
+  // another thread is taking a node, just allocate a new one instead of waiting
+  if (atomic_val_compare_exchange_32(&pPool->lock, 0, 1) != 0) return NULL;
+
+  STaosQnode *pNode = atomic_load_ptr(&pPool->head);
+  while (pNode != NULL) {
+    STaosQnode *pOld = atomic_val_compare_exchange_ptr(&pPool->head, pNode, pNode->next);
+    if (pOld == pNode) break;
+    pNode = pOld;
+  }
+
+  atomic_store_32(&pPool->lock, 0);
+
+  if (pNode != NULL) atomic_sub_fetch_32(&pPool->numOfNodes, 1);
+  return pNode;
+}
+
+static void taosPushQnode(STaosQnode *pNode) {
+  int32_t c = pNode->pool;
+  if (c < 0) {
+    free(pNode);
+    return;
+  }
+
+  SQnodePool *pPool = tsQnodePool + c;
+  int64_t     classSize = taosGetQnodeClassSize(c);
+  if (atomic_load_32(&pPool->numOfNodes) * classSize >= QNODE_POOL_BYTES) {
+    free(pNode);
+    return;
+  }
+
+  if (atomic_add_fetch_32(&pPool->numOfNodes, 1) * classSize > QNODE_POOL_BYTES) {
+    atomic_sub_fetch_32(&pPool->numOfNodes, 1);
+    free(pNode);
+    return;
+  }
+
+  STaosQnode *pHead = atomic_load_ptr(&pPool->head);
+  while (1) {
+    pNode->next = pHead;
+    STaosQnode *pOld = atomic_val_compare_exchange_ptr(&pPool->head, pHead, pNode);
+    if (pOld == pHead) break;
+    pHead = pOld;
+  }
+}
+
+static void taosAppendQnode(STaosQueue *queue, STaosQnode *pNode) {
+  atomic_store_ptr(&pNode->next, NULL);
+  STaosQnode *pPrev = atomic_exchange_ptr(&queue->tail, pNode);
+  atomic_store_ptr(&pPrev->next, pNode);
+}
+
+// take up to maxNum items linked so far into a list ended by NULL, the queue mutex shall be held. An item whose
+// producer has not linked it yet is left to the next call.
+static int32_t taosTakeQnodes(STaosQueue *queue, int32_t maxNum, STaosQnode **ppFirst) {
+  STaosQnode *pFirst = NULL;
+  STaosQnode *pLast = NULL;
+  int32_t     num = 0;
+
+  while (num < maxNum) {
+    STaosQnode *pNode = queue->head;
+    STaosQnode *pNext = atomic_load_ptr(&pNode->next);
+
+    if (pNode == queue->stub) {
+      if (pNext == NULL) break;
+      queue->head = pNext;
+      continue;
+    }
+
+    if (pNext == NULL) {
+      // the node is the tail, put the stub behind it so that it can be taken
+      if (atomic_load_ptr(&queue->tail) != pNode) break;
+      taosAppendQnode(queue, queue->stub);
+      pNext = atomic_load_ptr(&pNode->next);
+      if (pNext == NULL) break;
+    }
+
+    queue->head = pNext;
+    if (pLast) {
+      if (pLast->next != pNode) pLast->next = pNode;  // the stub was skipped
+    } else {
+      pFirst = pNode;
+    }
+    pLast = pNode;
+    num++;
+  }
+
+  if (pLast) pLast->next = NULL;
+  *ppFirst = pFirst;
+
+  if (num > 0) {
+    atomic_sub_fetch_32(&queue->numOfItems, num);
+  }
+
+  return num;
+}
+
+static bool taosQueueHasItems(STaosQueue *queue) { return atomic_load_32(&queue->numOfItems) > 0; }
+
+// read all the items out into qall, the queue mutex shall be held
+static int32_t taosTakeQall(STaosQueue *queue, STaosQall *qall) {
+  STaosQnode *pFirst = NULL;
+  int32_t     num = taosTakeQnodes(queue, INT32_MAX, &pFirst);
+  if (num == 0) return 0;
+
+  qall->current = pFirst;
+  qall->start = pFirst;
+  qall->numOfItems = num;
+  qall->itemSize = queue->itemSize;
+
+  return num;
+}
+
+static bool taosTakeQsetWaiter(STaosQset *qset) {
+  int32_t waiters = atomic_load_32(&qset->numOfWaiters);
+  while (waiters > 0) {
+    int32_t old = atomic_val_compare_exchange_32(&qset->numOfWaiters, waiters, waiters - 1);
+    if (old == waiters) return true;
+    waiters = old;
+  }
+
+  return false;
+}
+
+// a writer posts the semaphore only for a reader registered as waiter and takes the registration, so a sleeping
+// reader is woken once instead of once for each item written
+static void taosWakeQset(STaosQset *qset) {
+  if (taosTakeQsetWaiter(qset)) tsem_post(&qset->sem);
+}
+
 taos_queue taosOpenQueue() {
   
   STaosQueue *queue = (STaosQueue *) calloc(sizeof(STaosQueue), 1);
@@ -59,6 +238,15 @@ taos_queue taosOpenQueue() {
     return NULL;
   }
 
+  queue->stub = (STaosQnode *)calloc(sizeof(STaosQnode), 1);
+  if (queue->stub == NULL) {
+    free(queue);
+    terrno = TSDB_CODE_COM_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  queue->head = queue->stub;
+  queue->tail = queue->stub;
   pthread_mutex_init(&queue->mutex, NULL);
 
   uTrace("queue:%p is opened", queue);
@@ -69,11 +257,11 @@ void taosCloseQueue(taos_queue param) {
   if (param == NULL) return;
   STaosQueue *queue = (STaosQueue *)param;
   STaosQnode *pTemp;
+  STaosQnode *pNode;
   STaosQset  *qset;
 
   pthread_mutex_lock(&queue->mutex);
-  STaosQnode *pNode = queue->head;  
-  queue->head = NULL;
+  taosTakeQnodes(queue, INT32_MAX, &pNode);
   qset = queue->qset;
   pthread_mutex_unlock(&queue->mutex);
 
@@ -82,19 +270,32 @@ void taosCloseQueue(taos_queue param) {
   while (pNode) {
     pTemp = pNode;
     pNode = pNode->next;
-    free (pTemp);
+    taosPushQnode(pTemp);
   }
 
   pthread_mutex_destroy(&queue->mutex);
+  free(queue->stub);
   free(queue);
 
   uTrace("queue:%p is closed", queue);
 }
 
 void *taosAllocateQitem(int size) {
-  STaosQnode *pNode = (STaosQnode *)calloc(sizeof(STaosQnode) + size, 1);
-  
+  int64_t     nodeSize = sizeof(STaosQnode) + (int64_t)size;
+  int32_t     c = taosGetQnodeClass(nodeSize);
+  STaosQnode *pNode = NULL;
+
+  if (c >= 0) {
+    // the node is rounded up to its size class, only the part asked for is cleared
+    pNode = taosPopQnode(c);
+    if (pNode == NULL) pNode = (STaosQnode *)malloc(taosGetQnodeClassSize(c));
+    if (pNode != NULL) memset(pNode, 0, nodeSize);
+  } else {
+    pNode = (STaosQnode *)calloc(nodeSize, 1);
+  }
+
   if (pNode == NULL) return NULL;
+  pNode->pool = c;
   uTrace("item:%p, node:%p is allocated", pNode->item, pNode);
   return (void *)pNode->item;
 }
@@ -105,32 +306,23 @@ void taosFreeQitem(void *param) {
   char *temp = (char *)param;
   temp -= sizeof(STaosQnode);
   uTrace("item:%p, node:%p is freed", param, temp);
-  free(temp);
+  taosPushQnode((STaosQnode *)temp);
 }
 
 int taosWriteQitem(taos_queue param, int type, void *item) {
   STaosQueue *queue = (STaosQueue *)param;
   STaosQnode *pNode = (STaosQnode *)(((char *)item) - sizeof(STaosQnode));
   pNode->type = type;
-  pNode->next = NULL;
-
-  pthread_mutex_lock(&queue->mutex);
-
-  if (queue->tail) {
-    queue->tail->next = pNode;
-    queue->tail = pNode;
-  } else {
-    queue->head = pNode;
-    queue->tail = pNode; 
-  }
 
-  queue->numOfItems++;
-  if (queue->qset) atomic_add_fetch_32(&queue->qset->numOfItems, 1);
-  uTrace("item:%p is put into queue:%p, type:%d items:%d", item, queue, type, queue->numOfItems);
+  // count the item before it is visible, so that the counter never goes below zero. The qset is loaded after it, so
+  // either the item is counted before the queue is moved into another qset or the new qset is woken.
+  int32_t    numOfItems = atomic_add_fetch_32(&queue->numOfItems, 1);
+  STaosQset *qset = atomic_load_ptr(&queue->qset);
 
-  pthread_mutex_unlock(&queue->mutex);
+  taosAppendQnode(queue, pNode);
+  uTrace("item:%p is put into queue:%p, type:%d items:%d", item, queue, type, numOfItems);
 
-  if (queue->qset) tsem_post(&queue->qset->sem);
+  if (qset) taosWakeQset(qset);
 
   return 0;
 }
@@ -140,17 +332,13 @@ int taosReadQitem(taos_queue param, int *type, void **pitem) {
   STaosQnode *pNode = NULL;
   int         code = 0;
 
+  if (!taosQueueHasItems(queue)) return 0;
+
   pthread_mutex_lock(&queue->mutex);
 
-  if (queue->head) {
-      pNode = queue->head;
+  if (taosTakeQnodes(queue, 1, &pNode) > 0) {
       *pitem = pNode->item;
       *type = pNode->type;
-      queue->head = pNode->next;
-      if (queue->head == NULL) 
-        queue->tail = NULL;
-      queue->numOfItems--;
-      if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, 1);
       code = 1;
       uDebug("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, *type, queue->numOfItems);
   } 
@@ -173,29 +361,15 @@ int taosReadAllQitems(taos_queue param, taos_qall p2) {
   STaosQueue *queue = (STaosQueue *)param;
   STaosQall  *qall = (STaosQall *)p2;
   int         code = 0;
-  bool        empty;
 
-  pthread_mutex_lock(&queue->mutex);
-
-  empty = queue->head == NULL;
-  if (!empty) {
-    memset(qall, 0, sizeof(STaosQall));
-    qall->current = queue->head;
-    qall->start = queue->head;
-    qall->numOfItems = queue->numOfItems;
-    qall->itemSize = queue->itemSize;
-    code = qall->numOfItems;
-
-    queue->head = NULL;
-    queue->tail = NULL;
-    queue->numOfItems = 0;
-    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, qall->numOfItems);
+  if (taosQueueHasItems(queue)) {
+    pthread_mutex_lock(&queue->mutex);
+    code = taosTakeQall(queue, qall);
+    pthread_mutex_unlock(&queue->mutex);
   }
 
-  pthread_mutex_unlock(&queue->mutex);
-
   // if source queue is empty, we set destination qall to empty too.
-  if (empty) {
+  if (code == 0) {
     qall->current = NULL;
     qall->start = NULL;
     qall->numOfItems = 0;
@@ -265,10 +439,11 @@ void taosCloseQset(taos_qset param) {
 
 // tsem_post 'qset->sem', so that reader threads waiting for it
 // resumes execution and return, should only be used to signal the
-// thread to exit.
+// thread to exit. Each call makes one reader return once the qset is empty.
 void taosQsetThreadResume(taos_qset param) {
   STaosQset *qset = (STaosQset *)param;
   uDebug("qset:%p, it will exit", qset);
+  atomic_add_fetch_32(&qset->numOfResumes, 1);
   tsem_post(&qset->sem);
 }
 
@@ -286,12 +461,14 @@ int taosAddIntoQset(taos_qset p1, taos_queue p2, void *ahandle) {
   qset->numOfQueues++;
 
   pthread_mutex_lock(&queue->mutex);
-  atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
-  queue->qset = qset;
+  atomic_store_ptr(&queue->qset, qset);
   pthread_mutex_unlock(&queue->mutex);
 
   pthread_mutex_unlock(&qset->mutex);
 
+  // the queue may be moved from another qset with items in it
+  if (taosQueueHasItems(queue)) taosWakeQset(qset);
+
   uTrace("queue:%p is added into qset:%p", queue, qset);
   return 0;
 }
@@ -328,8 +505,7 @@ void taosRemoveFromQset(taos_qset p1, taos_queue p2) {
       qset->numOfQueues--;
 
       pthread_mutex_lock(&queue->mutex);
-      atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
-      queue->qset = NULL;
+      atomic_store_ptr(&queue->qset, NULL);
       queue->next = NULL;
       pthread_mutex_unlock(&queue->mutex);
     }
@@ -340,6 +516,49 @@ void taosRemoveFromQset(taos_qset p1, taos_queue p2) {
   uTrace("queue:%p is removed from qset:%p", queue, qset);
 }
 
+// pick the next queue in turn, the qset mutex shall be held
+static STaosQueue *taosGetQsetQueue(STaosQset *qset) {
+  if (qset->current == NULL) qset->current = qset->head;
+  STaosQueue *queue = qset->current;
+  if (queue) qset->current = queue->next;
+  return queue;
+}
+
+static bool taosQsetHasItems(STaosQset *qset) {
+  bool has = false;
+
+  pthread_mutex_lock(&qset->mutex);
+  for (STaosQueue *queue = qset->head; queue && !has; queue = queue->next) {
+    has = taosQueueHasItems(queue);
+  }
+  pthread_mutex_unlock(&qset->mutex);
+
+  return has;
+}
+
+// wait until an item may be written, return -1 if the reader shall exit instead. The waiter is counted before the
+// queues are checked and a writer checks the waiters after the item is counted, so one of them sees the other.
+static int32_t taosWaitQset(STaosQset *qset) {
+  int32_t resumes = atomic_load_32(&qset->numOfResumes);
+  while (resumes > 0) {
+    int32_t old = atomic_val_compare_exchange_32(&qset->numOfResumes, resumes, resumes - 1);
+    if (old == resumes) return -1;
+    resumes = old;
+  }
+
+  atomic_add_fetch_32(&qset->numOfWaiters, 1);
+
+  // no need to sleep, unless a writer has taken the registration already and posted for it. The items counted may
+  // not be linked yet by their writers, give them a chance to run.
+  if (taosQsetHasItems(qset) && taosTakeQsetWaiter(qset)) {
+    sched_yield();
+    return 0;
+  }
+
+  tsem_wait(&qset->sem);
+  return 0;
+}
+
 int taosGetQueueNumber(taos_qset param) {
   return ((STaosQset *)param)->numOfQueues;
 }
@@ -347,43 +566,32 @@ int taosGetQueueNumber(taos_qset param) {
 int taosReadQitemFromQset(taos_qset param, int *type, void **pitem, void **phandle) {
   STaosQset  *qset = (STaosQset *)param;
   STaosQnode *pNode = NULL;
-  int         code = 0;
    
-  tsem_wait(&qset->sem);
-
-  pthread_mutex_lock(&qset->mutex);
+  while (1) {
+    pthread_mutex_lock(&qset->mutex);
 
-  for(int i=0; i<qset->numOfQueues; ++i) {
-    if (qset->current == NULL) 
-      qset->current = qset->head;   
-    STaosQueue *queue = qset->current;
-    if (queue) qset->current = queue->next;
-    if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+    for (int i = 0; i < qset->numOfQueues && pNode == NULL; ++i) {
+      STaosQueue *queue = taosGetQsetQueue(qset);
+      if (queue == NULL) break;
+      if (!taosQueueHasItems(queue)) continue;
 
-    pthread_mutex_lock(&queue->mutex);
+      pthread_mutex_lock(&queue->mutex);
 
-    if (queue->head) {
-        pNode = queue->head;
+      if (taosTakeQnodes(queue, 1, &pNode) > 0) {
         *pitem = pNode->item;
         if (type) *type = pNode->type;
         if (phandle) *phandle = queue->ahandle;
-        queue->head = pNode->next;
-        if (queue->head == NULL) 
-          queue->tail = NULL;
-        queue->numOfItems--;
-        atomic_sub_fetch_32(&qset->numOfItems, 1);
-        code = 1;
         uTrace("item:%p is read out from queue:%p, type:%d items:%d", *pitem, queue, pNode->type, queue->numOfItems);
-    } 
+      }
 
-    pthread_mutex_unlock(&queue->mutex);
-    if (pNode) break;
-  }
+      pthread_mutex_unlock(&queue->mutex);
+    }
 
-  pthread_mutex_unlock(&qset->mutex);
+    pthread_mutex_unlock(&qset->mutex);
 
-  return code; 
+    if (pNode) return 1;
+    if (taosWaitQset(qset) != 0) return 0;
+  }
 }
 
 int taosReadAllQitemsFromQset(taos_qset param, taos_qall p2, void **phandle) {
@@ -392,52 +600,32 @@ int taosReadAllQitemsFromQset(taos_qset param, taos_qall p2, void **phandle) {
   STaosQall  *qall = (STaosQall *)p2;
   int         code = 0;
 
-  tsem_wait(&qset->sem);
-  pthread_mutex_lock(&qset->mutex);
+  while (1) {
+    pthread_mutex_lock(&qset->mutex);
 
-  for(int i=0; i<qset->numOfQueues; ++i) {
-    if (qset->current == NULL) 
-      qset->current = qset->head;   
-    queue = qset->current;
-    if (queue) qset->current = queue->next;
-    if (queue == NULL) break;
-    if (queue->head == NULL) continue;
-
-    pthread_mutex_lock(&queue->mutex);
+    for (int i = 0; i < qset->numOfQueues && code == 0; ++i) {
+      queue = taosGetQsetQueue(qset);
+      if (queue == NULL) break;
+      if (!taosQueueHasItems(queue)) continue;
 
-    if (queue->head) {
-      qall->current = queue->head;
-      qall->start = queue->head;
-      qall->numOfItems = queue->numOfItems;
-      qall->itemSize = queue->itemSize;
-      code = qall->numOfItems;
-      *phandle = queue->ahandle;
-          
-      queue->head = NULL;
-      queue->tail = NULL;
-      queue->numOfItems = 0;
-      atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
-      for (int j=1; j<qall->numOfItems; ++j) tsem_wait(&qset->sem);
-    } 
+      pthread_mutex_lock(&queue->mutex);
+      code = taosTakeQall(queue, qall);
+      if (code != 0) *phandle = queue->ahandle;
+      pthread_mutex_unlock(&queue->mutex);
+    }
 
-    pthread_mutex_unlock(&queue->mutex);
+    pthread_mutex_unlock(&qset->mutex);
 
-    if (code != 0) break;  
+    if (code != 0) return code;
+    if (taosWaitQset(qset) != 0) return 0;
   }
-
-  pthread_mutex_unlock(&qset->mutex);
-  return code;
 }
 
 int taosGetQueueItemsNumber(taos_queue param) {
   STaosQueue *queue = (STaosQueue *)param;
   if (!queue) return 0;
 
-  int num;
-  pthread_mutex_lock(&queue->mutex);
-  num = queue->numOfItems;
-  pthread_mutex_unlock(&queue->mutex);
-  return num;
+  return atomic_load_32(&queue->numOfItems);
 }
 
 int taosGetQsetItemsNumber(taos_qset param) {
@@ -446,7 +634,9 @@ int taosGetQsetItemsNumber(taos_qset param) {
 
   int num = 0;
   pthread_mutex_lock(&qset->mutex);
-  num = qset->numOfItems;
+  for (STaosQueue *queue = qset->head; queue; queue = queue->next) {
+    num += atomic_load_32(&queue->numOfItems);
+  }
   pthread_mutex_unlock(&qset->mutex);
   return num;
 }
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "os.h"
+#include "tbloomfilter.h"
+
+TEST(bloomFilterTest, no_false_negative) {
+  int32_t              numOfKeys = 4096;
+  int32_t              size = taosBloomFilterSize(numOfKeys, 10);
+  int32_t              numOfHashes = taosBloomFilterHashes(10);
+  std::vector<uint8_t> bits(size);
+
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    std::string key = "device-" + std::to_string(i * 7);
+    taosBloomFilterPut(bits.data(), size, numOfHashes, key.c_str(), (int32_t)key.size());
+  }
+
+  for (int32_t i = 0; i < numOfKeys; ++i) {
+    std::string key = "device-" + std::to_string(i * 7);
+    ASSERT_TRUE(taosBloomFilterMayContain(bits.data(), size, numOfHashes, key.c_str(), (int32_t)key.size()));
+  }
+}
+
+TEST(bloomFilterTest, false_positive_rate) {
+  int32_t              numOfKeys = 4096;
+  int32_t              size = taosBloomFilterSize(numOfKeys, 10);
+  int32_t              numOfHashes = taosBloomFilterHashes(10);
+  std::vector<uint8_t> bits(size);
+
+  for (int64_t i = 0; i < numOfKeys; ++i) {
+    taosBloomFilterPut(bits.data(), size, numOfHashes, &i, sizeof(i));
+  }
+
+  int32_t numOfHits = 0;
+  for (int64_t i = numOfKeys; i < numOfKeys * 11; ++i) {
+    numOfHits += taosBloomFilterMayContain(bits.data(), size, numOfHashes, &i, sizeof(i));
+  }
+
+  // about 1% with 10 bits per key
+  ASSERT_LT(numOfHits, numOfKeys * 10 / 50);
+}
+
+TEST(bloomFilterTest, small_filter) {
+  ASSERT_EQ(taosBloomFilterSize(0, 10), TSDB_BLOOM_FILTER_MIN_BYTES);
+  ASSERT_EQ(taosBloomFilterSize(1, 1), TSDB_BLOOM_FILTER_MIN_BYTES);
+  ASSERT_EQ(taosBloomFilterHashes(0), 1);
+
+  std::vector<uint8_t> bits(TSDB_BLOOM_FILTER_MIN_BYTES);
+  taosBloomFilterPut(bits.data(), (int32_t)bits.size(), 1, "", 0);
+  ASSERT_TRUE(taosBloomFilterMayContain(bits.data(), (int32_t)bits.size(), 1, "", 0));
+}
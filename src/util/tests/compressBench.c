@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "os.h"
+#include "taosdef.h"
+#include "tscompression.h"
+
+// rows of one tsdb block by default
+#define BENCH_ELEMS  4096
+#define BENCH_ROUNDS 20000
+
+typedef struct {
+  const char *name;
+  int8_t      type;
+  int         bytes;
+} SBenchType;
+
+static SBenchType benchTypes[] = {
+    {"tinyint", TSDB_DATA_TYPE_TINYINT, CHAR_BYTES},
+    {"smallint", TSDB_DATA_TYPE_SMALLINT, SHORT_BYTES},
+    {"int", TSDB_DATA_TYPE_INT, INT_BYTES},
+    {"bigint", TSDB_DATA_TYPE_BIGINT, LONG_BYTES},
+    {"timestamp", TSDB_DATA_TYPE_TIMESTAMP, LONG_BYTES},
+};
+
+// slowly changing sensor like values with a few jumps
+static void genData(SBenchType *pType, char *data, int nelements) {
+  int64_t v = 0;
+  int64_t ts = 1609430400000;
+  for (int i = 0; i < nelements; i++) {
+    v += (random() % 16 == 0) ? (random() % 64 - 32) : (random() % 3 - 1);
+    ts += 1000 + ((random() % 32 == 0) ? random() % 10 : 0);
+    switch (pType->type) {
+      case TSDB_DATA_TYPE_TINYINT:
+        ((int8_t *)data)[i] = (int8_t)v;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        ((int16_t *)data)[i] = (int16_t)v;
+        break;
+      case TSDB_DATA_TYPE_INT:
+        ((int32_t *)data)[i] = (int32_t)v;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        ((int64_t *)data)[i] = v;
+        break;
+      case TSDB_DATA_TYPE_TIMESTAMP:
+        ((int64_t *)data)[i] = ts;
+        break;
+    }
+  }
+}
+
+static int compressData(SBenchType *pType, char *data, int nelements, char *output) {
+  if (pType->type == TSDB_DATA_TYPE_TIMESTAMP) return tsCompressTimestampImp(data, nelements, output);
+  return tsCompressINTImp(data, nelements, output, pType->type);
+}
+
+static int decompressData(SBenchType *pType, char *input, int nelements, char *output) {
+  if (pType->type == TSDB_DATA_TYPE_TIMESTAMP) return tsDecompressTimestampImp(input, nelements, output);
+  return tsDecompressINTImp(input, nelements, output, pType->type);
+}
+
+typedef struct {
+  const char *name;
+  int         bytes;
+  int (*compFunc)(const char *const input, const int nelements, char *const output);
+  int (*decompFunc)(const char *const input, int compressedSize, const int nelements, char *const output);
+} SFloatCodec;
+
+static int decompressDoubleXor(const char *const input, int compressedSize, const int nelements, char *const output) {
+  return tsDecompressDoubleImp(input, nelements, output);
+}
+
+static int decompressFloatXor(const char *const input, int compressedSize, const int nelements, char *const output) {
+  return tsDecompressFloatImp(input, nelements, output);
+}
+
+static SFloatCodec floatCodecs[] = {
+    {"double-xor", DOUBLE_BYTES, tsCompressDoubleImp, decompressDoubleXor},
+    {"double-chimp", DOUBLE_BYTES, tsCompressDoubleChimpImp, tsDecompressDoubleChimpImp},
+    {"float-xor", FLOAT_BYTES, tsCompressFloatImp, decompressFloatXor},
+    {"float-chimp", FLOAT_BYTES, tsCompressFloatChimpImp, tsDecompressFloatChimpImp},
+};
+
+// sensor like readings with a fixed number of decimals
+static void genSensorData(double *data, int nelements) {
+  double v = 20.0;
+  for (int i = 0; i < nelements; i++) {
+    v += (random() % 201 - 100) / 1000.0;
+    data[i] = (double)(int64_t)(v * 1000000) / 1000000;
+  }
+}
+
+// the last field of each line of a csv file, as the humidity of importSampleData/data/sensor_info.csv
+static int loadSampleData(const char *file, double *data, int nelements) {
+  FILE *fp = fopen(file, "r");
+  if (fp == NULL) {
+    printf("failed to open %s\n", file);
+    return -1;
+  }
+
+  char line[1024];
+  int  num = 0;
+  while (num < nelements && fgets(line, sizeof(line), fp) != NULL) {
+    char *p = strrchr(line, ',');
+    char *end = NULL;
+    if (p == NULL) continue;
+    double v = strtod(p + 1, &end);
+    if (end == p + 1) continue;  // header
+    data[num++] = v;
+  }
+  fclose(fp);
+
+  // repeat the samples to fill a block
+  for (int i = num; num > 0 && i < nelements; i++) {
+    data[i] = data[i % num];
+  }
+  return num;
+}
+
+static int benchFloatCodecs(const double *sample, int nelements, int rounds, char *comp, char *output) {
+  char *data = malloc(nelements * DOUBLE_BYTES);
+  int   code = 0;
+
+  printf("%-12s %10s %8s %14s\n", "codec", "elements", "ratio", "decode(GB/s)");
+  for (int c = 0; c < tListLen(floatCodecs); c++) {
+    SFloatCodec *pCodec = floatCodecs + c;
+    for (int i = 0; i < nelements; i++) {
+      if (pCodec->bytes == DOUBLE_BYTES) {
+        ((double *)data)[i] = sample[i];
+      } else {
+        ((float *)data)[i] = (float)sample[i];
+      }
+    }
+
+    int len = (*pCodec->compFunc)(data, nelements, comp);
+
+    int64_t st = taosGetTimestampUs();
+    for (int i = 0; i < rounds; i++) {
+      (*pCodec->decompFunc)(comp, len, nelements, output);
+    }
+    int64_t et = taosGetTimestampUs();
+
+    if (memcmp(data, output, nelements * pCodec->bytes) != 0) {
+      printf("%s: result mismatch\n", pCodec->name);
+      code = 1;
+    }
+
+    printf("%-12s %10d %8.2f %14.3f\n", pCodec->name, nelements, (double)nelements * pCodec->bytes / len,
+           ((double)nelements * pCodec->bytes * rounds) / ((et - st) * 1000.0));
+  }
+
+  free(data);
+  return code;
+}
+
+static double benchDecompress(SBenchType *pType, char *comp, int nelements, char *output, int rounds) {
+  int64_t st = taosGetTimestampUs();
+  for (int i = 0; i < rounds; i++) {
+    decompressData(pType, comp, nelements, output);
+  }
+  int64_t et = taosGetTimestampUs();
+
+  // GB/s of decoded data
+  return ((double)nelements * pType->bytes * rounds) / ((et - st) * 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+  int nelements = BENCH_ELEMS;
+  int rounds = BENCH_ROUNDS;
+  int code = 0;
+
+  if (argc > 1) nelements = atoi(argv[1]);
+  if (argc > 2) rounds = atoi(argv[2]);
+  if (nelements <= 0 || rounds <= 0) {
+    printf("usage: %s [elements] [rounds] [sample csv]\n", argv[0]);
+    return 1;
+  }
+
+  char *data = malloc(nelements * LONG_BYTES);
+  char *comp = malloc(nelements * LONG_BYTES + COMP_OVERFLOW_BYTES + 1);
+  char *scalar = malloc(nelements * LONG_BYTES);
+  char *simd = malloc(nelements * LONG_BYTES);
+
+  srandom(0);
+  printf("%-10s %10s %8s %14s %14s\n", "type", "elements", "ratio", "scalar(GB/s)", "simd(GB/s)");
+  for (int t = 0; t < tListLen(benchTypes); t++) {
+    SBenchType *pType = benchTypes + t;
+    genData(pType, data, nelements);
+    int len = compressData(pType, data, nelements, comp);
+
+    tsResolveDecompress(false);
+    double scalarSpeed = benchDecompress(pType, comp, nelements, scalar, rounds);
+
+    double simdSpeed = 0;
+    if (tsResolveDecompress(true)) {
+      simdSpeed = benchDecompress(pType, comp, nelements, simd, rounds);
+      if (memcmp(scalar, simd, nelements * pType->bytes) != 0) {
+        printf("%s: simd result mismatch\n", pType->name);
+        code = 1;
+      }
+    }
+
+    if (memcmp(data, scalar, nelements * pType->bytes) != 0) {
+      printf("%s: scalar result mismatch\n", pType->name);
+      code = 1;
+    }
+
+    printf("%-10s %10d %8.2f %14.3f %14.3f\n", pType->name, nelements, (double)nelements * pType->bytes / len,
+           scalarSpeed, simdSpeed);
+  }
+
+  double *sample = (double *)data;
+  if (argc > 3) {
+    if (loadSampleData(argv[3], sample, nelements) <= 0) {
+      printf("no sample data in %s\n", argv[3]);
+      code = 1;
+      nelements = 0;
+    }
+  } else {
+    genSensorData(sample, nelements);
+  }
+
+  if (nelements > 0) {
+    printf("\n");
+    code |= benchFloatCodecs(sample, nelements, rounds, comp, scalar);
+  }
+
+  free(data);
+  free(comp);
+  free(scalar);
+  free(simd);
+  return code;
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <limits>
+#include <random>
+
+#include "os.h"
+#include "taosdef.h"
+#include "tscompression.h"
+
+namespace {
+
+template <typename T>
+void checkIntRoundTrip(const std::vector<T>& data, char type, bool simd) {
+  int               nelements = (int)data.size();
+  std::vector<char> comp(nelements * sizeof(T) + COMP_OVERFLOW_BYTES + 1);
+  std::vector<T>    decoded(nelements);
+
+  tsResolveDecompress(simd);
+  int len = tsCompressINTImp((const char*)data.data(), nelements, comp.data(), type);
+  ASSERT_GT(len, 0);
+  ASSERT_EQ(tsDecompressINTImp(comp.data(), nelements, (char*)decoded.data(), type), nelements * (int)sizeof(T));
+  ASSERT_EQ(0, memcmp(data.data(), decoded.data(), nelements * sizeof(T)));
+}
+
+void checkTimestampRoundTrip(const std::vector<int64_t>& data, bool simd) {
+  int               nelements = (int)data.size();
+  std::vector<char> comp(nelements * sizeof(int64_t) + COMP_OVERFLOW_BYTES + 1);
+  std::vector<int64_t> decoded(nelements);
+
+  tsResolveDecompress(simd);
+  int len = tsCompressTimestampImp((const char*)data.data(), nelements, comp.data());
+  ASSERT_GT(len, 0);
+  ASSERT_EQ(tsDecompressTimestampImp(comp.data(), nelements, (char*)decoded.data()), nelements * (int)sizeof(int64_t));
+  ASSERT_EQ(0, memcmp(data.data(), decoded.data(), nelements * sizeof(int64_t)));
+}
+
+// values walk with steps of the given bit width, so every simple8b selector shows up
+template <typename T>
+std::vector<T> genIntData(std::mt19937_64& gen, int nelements, int maxBits) {
+  std::vector<T> data(nelements);
+  int64_t        v = 0;
+  for (int i = 0; i < nelements; i++) {
+    int bits = gen() % (maxBits + 1);
+    if (bits > 0 && gen() % 4 != 0) {
+      int64_t step = (int64_t)(gen() & ((((uint64_t)1) << (bits - 1)) - 1));
+      v = (gen() % 2) ? v + step : v - step;
+    }
+    data[i] = (T)v;
+  }
+  return data;
+}
+
+// go through the column wrappers as a data block does, with and without the chimp flag
+template <typename T>
+void checkFloatRoundTrip(const std::vector<T>& data, char algorithm) {
+  int               nelements = (int)data.size();
+  int               size = nelements * sizeof(T) + COMP_OVERFLOW_BYTES;
+  std::vector<char> comp(size + 1);
+  std::vector<char> buffer(size + 1);
+  std::vector<T>    decoded(nelements);
+
+  int len;
+  if (sizeof(T) == DOUBLE_BYTES) {
+    len = tsCompressDouble((const char*)data.data(), nelements * sizeof(T), nelements, comp.data(), size, algorithm,
+                           buffer.data(), size);
+    ASSERT_GT(len, 0);
+    ASSERT_EQ(tsDecompressDouble(comp.data(), len, nelements, (char*)decoded.data(), nelements * sizeof(T), algorithm,
+                                 buffer.data(), size),
+              nelements * (int)sizeof(T));
+  } else {
+    len = tsCompressFloat((const char*)data.data(), nelements * sizeof(T), nelements, comp.data(), size, algorithm,
+                          buffer.data(), size);
+    ASSERT_GT(len, 0);
+    ASSERT_EQ(tsDecompressFloat(comp.data(), len, nelements, (char*)decoded.data(), nelements * sizeof(T), algorithm,
+                                buffer.data(), size),
+              nelements * (int)sizeof(T));
+  }
+  ASSERT_LE(len, size);
+  // compare the bits, NaN never equals itself
+  ASSERT_EQ(0, memcmp(data.data(), decoded.data(), nelements * sizeof(T)));
+}
+
+template <typename T>
+std::vector<std::vector<T>> genFloatData(std::mt19937_64& gen, int nelements) {
+  std::vector<std::vector<T>> cases(4, std::vector<T>(nelements));
+  double                      v = 20.0;
+  for (int i = 0; i < nelements; i++) {
+    v += (int)(gen() % 201 - 100) / 1000.0;
+    cases[0][i] = (T)3.25;
+    cases[1][i] = (T)((double)(int64_t)(v * 1000) / 1000);
+    uint64_t bits = gen();
+    memcpy(&cases[2][i], &bits, sizeof(T));
+  }
+
+  T special[] = {(T)0, (T)-0.0, std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+                 std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::max(), std::numeric_limits<T>::min(),
+                 std::numeric_limits<T>::denorm_min()};
+  for (int i = 0; i < nelements; i++) {
+    cases[3][i] = (gen() % 2) ? special[gen() % tListLen(special)] : cases[1][i];
+  }
+  return cases;
+}
+
+}  // namespace
+
+TEST(compressTest, simple8b_round_trip) {
+  std::mt19937_64 gen(1);
+  int             sizes[] = {1, 3, 4, 7, 239, 240, 241, 1000, 4096};
+
+  for (int simd = 0; simd < 2; simd++) {
+    for (int n : sizes) {
+      for (int bits = 0; bits <= 8; bits++) {
+        checkIntRoundTrip(genIntData<int8_t>(gen, n, bits), TSDB_DATA_TYPE_TINYINT, simd);
+      }
+      for (int bits = 0; bits <= 16; bits += 2) {
+        checkIntRoundTrip(genIntData<int16_t>(gen, n, bits), TSDB_DATA_TYPE_SMALLINT, simd);
+      }
+      for (int bits = 0; bits <= 32; bits += 4) {
+        checkIntRoundTrip(genIntData<int32_t>(gen, n, bits), TSDB_DATA_TYPE_INT, simd);
+      }
+      for (int bits = 0; bits <= 60; bits += 6) {
+        checkIntRoundTrip(genIntData<int64_t>(gen, n, bits), TSDB_DATA_TYPE_BIGINT, simd);
+      }
+    }
+  }
+}
+
+TEST(compressTest, simple8b_overflow_round_trip) {
+  // differences out of the 60 bits range are stored without compression
+  std::vector<int64_t> data = {0, INT64_MAX, INT64_MIN, 1, -1, INT64_MAX};
+  checkIntRoundTrip(data, TSDB_DATA_TYPE_BIGINT, false);
+  checkIntRoundTrip(data, TSDB_DATA_TYPE_BIGINT, true);
+}
+
+TEST(compressTest, timestamp_round_trip) {
+  std::mt19937_64 gen(2);
+  int             sizes[] = {1, 2, 3, 4, 5, 8, 1000, 4097};
+
+  for (int simd = 0; simd < 2; simd++) {
+    for (int n : sizes) {
+      std::vector<int64_t> data(n);
+      int64_t              ts = 1609430400000;
+      for (int i = 0; i < n; i++) {
+        ts += (gen() % 8 == 0) ? (int64_t)(gen() % 100000) : 1000;
+        data[i] = ts;
+      }
+      checkTimestampRoundTrip(data, simd);
+    }
+  }
+
+  tsResolveDecompress(true);
+}
+
+TEST(compressTest, float_chimp_round_trip) {
+  std::mt19937_64 gen(3);
+  int             sizes[] = {1, 2, 3, 63, 64, 1000, 4096};
+  char            algorithms[] = {ONE_STAGE_COMP, TWO_STAGE_COMP, ONE_STAGE_COMP | COMP_FLOAT_CHIMP,
+                       TWO_STAGE_COMP | COMP_FLOAT_CHIMP};
+
+  for (char algorithm : algorithms) {
+    for (int n : sizes) {
+      for (auto& data : genFloatData<double>(gen, n)) {
+        checkFloatRoundTrip(data, algorithm);
+      }
+      for (auto& data : genFloatData<float>(gen, n)) {
+        checkFloatRoundTrip(data, algorithm);
+      }
+    }
+  }
+}
+
+TEST(compressTest, float_chimp_ratio) {
+  // slowly changing values must compress better than the byte aligned xor
+  std::mt19937_64     gen(4);
+  std::vector<double> data = genFloatData<double>(gen, 4096)[1];
+  std::vector<char>   xorOut(data.size() * DOUBLE_BYTES + COMP_OVERFLOW_BYTES);
+  std::vector<char>   chimpOut(data.size() * DOUBLE_BYTES + COMP_OVERFLOW_BYTES);
+
+  int xorLen = tsCompressDoubleImp((const char*)data.data(), (int)data.size(), xorOut.data());
+  int chimpLen = tsCompressDoubleChimpImp((const char*)data.data(), (int)data.size(), chimpOut.data());
+  ASSERT_LT(chimpLen, xorLen);
+}
+
+TEST(compressTest, float_chimp_corrupted) {
+  std::vector<double> data(100, 1.5);
+  data[50] = 2.75;
+  std::vector<char>   comp(data.size() * DOUBLE_BYTES + COMP_OVERFLOW_BYTES);
+  std::vector<double> decoded(data.size());
+
+  int len = tsCompressDoubleChimpImp((const char*)data.data(), (int)data.size(), comp.data());
+  ASSERT_GT(len, 1);
+  // a truncated stream must not be read beyond its size
+  ASSERT_LT(tsDecompressDoubleChimpImp(comp.data(), 9, (int)data.size(), (char*)decoded.data()), 0);
+}
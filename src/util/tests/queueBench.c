@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// producers write items into the queues of a qset the way the rpc threads dispatch messages to the vnodes, one
+// consumer reads them out in batches the way a vnode write worker does. Each run is repeated with a reference queue,
+// which takes a mutex per queue and per qset and a semaphore per item and callocs each node, as taos_queue did before.
+
+#include "os.h"
+#include "tutil.h"
+#include "tqueue.h"
+
+typedef struct SRefNode {
+  struct SRefNode *next;
+  char             item[];
+} SRefNode;
+
+typedef struct SRefQueue {
+  SRefNode        *head;
+  SRefNode        *tail;
+  int32_t          numOfItems;
+  struct SRefQset *qset;
+  pthread_mutex_t  mutex;
+} SRefQueue;
+
+typedef struct SRefQset {
+  SRefQueue      **queues;
+  int32_t          numOfQueues;
+  int32_t          current;
+  pthread_mutex_t  mutex;
+  tsem_t           sem;
+} SRefQset;
+
+static void *refAllocate(int size) {
+  SRefNode *pNode = calloc(sizeof(SRefNode) + size, 1);
+  return pNode ? pNode->item : NULL;
+}
+
+static void refFree(void *item) { free((char *)item - sizeof(SRefNode)); }
+
+static void refWrite(SRefQueue *queue, void *item) {
+  SRefNode *pNode = (SRefNode *)((char *)item - sizeof(SRefNode));
+  pNode->next = NULL;
+
+  pthread_mutex_lock(&queue->mutex);
+  if (queue->tail) {
+    queue->tail->next = pNode;
+  } else {
+    queue->head = pNode;
+  }
+  queue->tail = pNode;
+  queue->numOfItems++;
+  pthread_mutex_unlock(&queue->mutex);
+
+  tsem_post(&queue->qset->sem);
+}
+
+static int32_t refReadAll(SRefQset *qset, SRefNode **pList) {
+  int32_t num = 0;
+
+  tsem_wait(&qset->sem);
+  pthread_mutex_lock(&qset->mutex);
+
+  for (int32_t i = 0; i < qset->numOfQueues && num == 0; ++i) {
+    SRefQueue *queue = qset->queues[qset->current];
+    qset->current = (qset->current + 1) % qset->numOfQueues;
+
+    pthread_mutex_lock(&queue->mutex);
+    if (queue->head) {
+      *pList = queue->head;
+      num = queue->numOfItems;
+      queue->head = NULL;
+      queue->tail = NULL;
+      queue->numOfItems = 0;
+      for (int32_t j = 1; j < num; ++j) tsem_wait(&qset->sem);
+    }
+    pthread_mutex_unlock(&queue->mutex);
+  }
+
+  pthread_mutex_unlock(&qset->mutex);
+  return num;
+}
+
+typedef struct {
+  int32_t  ref;
+  int32_t  id;
+  int32_t  numOfItems;
+  int32_t  size;
+  void    *queue;
+} SProducer;
+
+static void *produce(void *param) {
+  SProducer *pProducer = param;
+
+  for (int32_t i = 0; i < pProducer->numOfItems; ++i) {
+    if (pProducer->ref) {
+      int64_t *pItem = refAllocate(pProducer->size);
+      *pItem = i;
+      refWrite(pProducer->queue, pItem);
+    } else {
+      int64_t *pItem = taosAllocateQitem(pProducer->size);
+      *pItem = i;
+      taosWriteQitem(pProducer->queue, pProducer->id, pItem);
+    }
+  }
+
+  return NULL;
+}
+
+static void runBench(int32_t ref, int32_t numOfProducers, int32_t numOfQueues, int32_t total, int32_t size) {
+  taos_qset  qset = NULL;
+  taos_qall  qall = NULL;
+  void     **queues = calloc(numOfQueues, sizeof(void *));
+  SRefQset   refQset = {0};
+
+  if (ref) {
+    refQset.queues = (SRefQueue **)queues;
+    refQset.numOfQueues = numOfQueues;
+    pthread_mutex_init(&refQset.mutex, NULL);
+    tsem_init(&refQset.sem, 0, 0);
+    for (int32_t q = 0; q < numOfQueues; ++q) {
+      SRefQueue *queue = calloc(1, sizeof(SRefQueue));
+      pthread_mutex_init(&queue->mutex, NULL);
+      queue->qset = &refQset;
+      queues[q] = queue;
+    }
+  } else {
+    qset = taosOpenQset();
+    qall = taosAllocateQall();
+    for (int32_t q = 0; q < numOfQueues; ++q) {
+      queues[q] = taosOpenQueue();
+      taosAddIntoQset(qset, queues[q], NULL);
+    }
+  }
+
+  SProducer *producers = calloc(numOfProducers, sizeof(SProducer));
+  pthread_t *threads = calloc(numOfProducers, sizeof(pthread_t));
+  int32_t    perProducer = total / numOfProducers;
+  int64_t    start = taosGetTimestampUs();
+
+  for (int32_t i = 0; i < numOfProducers; ++i) {
+    producers[i].ref = ref;
+    producers[i].id = i;
+    producers[i].numOfItems = perProducer;
+    producers[i].size = size;
+    producers[i].queue = queues[i % numOfQueues];
+    pthread_create(threads + i, NULL, produce, producers + i);
+  }
+
+  int64_t expected = (int64_t)perProducer * numOfProducers;
+  int64_t received = 0;
+  int64_t batches = 0;
+
+  while (received < expected) {
+    if (ref) {
+      SRefNode *pNode = NULL;
+      int32_t   num = refReadAll(&refQset, &pNode);
+      for (int32_t j = 0; j < num; ++j) {
+        SRefNode *pNext = pNode->next;
+        refFree(pNode->item);
+        pNode = pNext;
+      }
+      received += num;
+    } else {
+      void   *ahandle = NULL;
+      void   *pItem = NULL;
+      int32_t type = 0;
+      int32_t num = taosReadAllQitemsFromQset(qset, qall, &ahandle);
+      for (int32_t j = 0; j < num; ++j) {
+        taosGetQitem(qall, &type, &pItem);
+        taosFreeQitem(pItem);
+      }
+      received += num;
+    }
+    batches++;
+  }
+
+  int64_t elapsed = taosGetTimestampUs() - start;
+  if (elapsed <= 0) elapsed = 1;
+
+  for (int32_t i = 0; i < numOfProducers; ++i) pthread_join(threads[i], NULL);
+
+  printf("%-9s producers:%-3d items:%" PRId64 " elapsed:%.3fs items/s:%.0f items/batch:%.1f\n", ref ? "reference" : "mpsc",
+         numOfProducers, received, elapsed / 1000000.0, received * 1000000.0 / elapsed, (double)received / batches);
+
+  if (ref) {
+    for (int32_t q = 0; q < numOfQueues; ++q) {
+      pthread_mutex_destroy(&((SRefQueue *)queues[q])->mutex);
+      free(queues[q]);
+    }
+    pthread_mutex_destroy(&refQset.mutex);
+    tsem_destroy(&refQset.sem);
+  } else {
+    for (int32_t q = 0; q < numOfQueues; ++q) taosCloseQueue(queues[q]);
+    taosFreeQall(qall);
+    taosCloseQset(qset);
+  }
+
+  free(threads);
+  free(producers);
+  free(queues);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t total = 2000000;
+  int32_t numOfQueues = 4;
+  int32_t size = 256;
+  int32_t producers[] = {1, 8, 32};
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      total = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-q") == 0 && i < argc - 1) {
+      numOfQueues = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0 && i < argc - 1) {
+      size = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-n total]: total items of each run, default is:%d\n", total);
+      printf("  [-q queues]: queues in the qset, default is:%d\n", numOfQueues);
+      printf("  [-s size]: bytes of an item, default is:%d\n", size);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  if (total <= 0 || numOfQueues <= 0 || size < (int32_t)sizeof(int64_t)) {
+    printf("invalid options\n");
+    exit(-1);
+  }
+
+  for (int32_t i = 0; i < tListLen(producers); ++i) {
+    runBench(1, producers[i], numOfQueues, total, size);
+    runBench(0, producers[i], numOfQueues, total, size);
+  }
+
+  return 0;
+}
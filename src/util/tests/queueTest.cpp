@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <vector>
+
+#include "os.h"
+#include "tqueue.h"
+
+namespace {
+
+const int32_t numOfProducers = 8;
+const int32_t numOfItemsPerProducer = 20000;
+
+struct SQueueItem {
+  int32_t producer;
+  int32_t seq;
+};
+
+struct SProducer {
+  taos_queue queue;
+  int32_t    id;
+};
+
+void *produce(void *param) {
+  SProducer *pProducer = (SProducer *)param;
+  for (int32_t i = 0; i < numOfItemsPerProducer; ++i) {
+    SQueueItem *pItem = (SQueueItem *)taosAllocateQitem(sizeof(SQueueItem));
+    pItem->producer = pProducer->id;
+    pItem->seq = i;
+    taosWriteQitem(pProducer->queue, pProducer->id, pItem);
+  }
+  return NULL;
+}
+
+}  // namespace
+
+TEST(queueTest, fifo) {
+  taos_queue queue = taosOpenQueue();
+  for (int32_t i = 0; i < 100; ++i) {
+    int32_t *pItem = (int32_t *)taosAllocateQitem(sizeof(int32_t));
+    *pItem = i;
+    taosWriteQitem(queue, i % 3, pItem);
+  }
+  ASSERT_EQ(taosGetQueueItemsNumber(queue), 100);
+
+  int32_t type = 0;
+  void   *pItem = NULL;
+  for (int32_t i = 0; i < 50; ++i) {
+    ASSERT_EQ(taosReadQitem(queue, &type, &pItem), 1);
+    ASSERT_EQ(*(int32_t *)pItem, i);
+    ASSERT_EQ(type, i % 3);
+    taosFreeQitem(pItem);
+  }
+
+  taos_qall qall = taosAllocateQall();
+  ASSERT_EQ(taosReadAllQitems(queue, qall), 50);
+  for (int32_t i = 50; i < 100; ++i) {
+    ASSERT_EQ(taosGetQitem(qall, &type, &pItem), 1);
+    ASSERT_EQ(*(int32_t *)pItem, i);
+    taosFreeQitem(pItem);
+  }
+  ASSERT_EQ(taosGetQitem(qall, &type, &pItem), 0);
+  ASSERT_EQ(taosReadAllQitems(queue, qall), 0);
+  ASSERT_EQ(taosGetQueueItemsNumber(queue), 0);
+
+  taosFreeQall(qall);
+  taosCloseQueue(queue);
+}
+
+TEST(queueTest, pooled_item_is_zeroed) {
+  for (int32_t round = 0; round < 2; ++round) {
+    char *pItem = (char *)taosAllocateQitem(200);
+    for (int32_t i = 0; i < 200; ++i) ASSERT_EQ(pItem[i], 0);
+    memset(pItem, 0xff, 200);
+    taosFreeQitem(pItem);
+  }
+
+  // too large to be pooled
+  char *pItem = (char *)taosAllocateQitem(1024 * 1024);
+  ASSERT_TRUE(pItem != NULL);
+  taosFreeQitem(pItem);
+}
+
+TEST(queueTest, multi_producer_order) {
+  taos_qset qset = taosOpenQset();
+  taos_queue queues[2];
+  for (int32_t q = 0; q < 2; ++q) {
+    queues[q] = taosOpenQueue();
+    taosAddIntoQset(qset, queues[q], queues[q]);
+  }
+
+  std::vector<SProducer> producers(numOfProducers);
+  std::vector<pthread_t> threads(numOfProducers);
+  for (int32_t i = 0; i < numOfProducers; ++i) {
+    producers[i].queue = queues[i % 2];
+    producers[i].id = i;
+    pthread_create(&threads[i], NULL, produce, &producers[i]);
+  }
+
+  std::vector<int32_t> next(numOfProducers, 0);
+  taos_qall            qall = taosAllocateQall();
+  int32_t              total = 0;
+  while (total < numOfProducers * numOfItemsPerProducer) {
+    void   *ahandle = NULL;
+    int32_t num = taosReadAllQitemsFromQset(qset, qall, &ahandle);
+    ASSERT_GT(num, 0);
+
+    int32_t     type = 0;
+    SQueueItem *pItem = NULL;
+    while (taosGetQitem(qall, &type, (void **)&pItem)) {
+      ASSERT_EQ(type, pItem->producer);
+      ASSERT_TRUE(ahandle == queues[pItem->producer % 2]);
+      ASSERT_EQ(pItem->seq, next[pItem->producer]);
+      next[pItem->producer]++;
+      taosFreeQitem(pItem);
+      total++;
+    }
+  }
+
+  for (int32_t i = 0; i < numOfProducers; ++i) {
+    pthread_join(threads[i], NULL);
+    ASSERT_EQ(next[i], numOfItemsPerProducer);
+  }
+  ASSERT_EQ(taosGetQsetItemsNumber(qset), 0);
+
+  // a resumed reader returns once the qset is empty
+  void *pItem = NULL;
+  taosQsetThreadResume(qset);
+  ASSERT_EQ(taosReadQitemFromQset(qset, NULL, &pItem, NULL), 0);
+
+  taosFreeQall(qall);
+  for (int32_t q = 0; q < 2; ++q) taosCloseQueue(queues[q]);
+  taosCloseQset(qset);
+}
+
+TEST(queueTest, move_between_qsets) {
+  taos_qset  from = taosOpenQset();
+  taos_qset  to = taosOpenQset();
+  taos_queue queue = taosOpenQueue();
+  taosAddIntoQset(from, queue, queue);
+
+  for (int32_t i = 0; i < 10; ++i) {
+    int32_t *pItem = (int32_t *)taosAllocateQitem(sizeof(int32_t));
+    *pItem = i;
+    taosWriteQitem(queue, 0, pItem);
+  }
+  ASSERT_EQ(taosGetQsetItemsNumber(from), 10);
+
+  // the items queued before the move are read from the new qset
+  taosRemoveFromQset(from, queue);
+  taosAddIntoQset(to, queue, queue);
+  ASSERT_EQ(taosGetQsetItemsNumber(from), 0);
+  ASSERT_EQ(taosGetQsetItemsNumber(to), 10);
+
+  taos_qall qall = taosAllocateQall();
+  void     *ahandle = NULL;
+  ASSERT_EQ(taosReadAllQitemsFromQset(to, qall, &ahandle), 10);
+  ASSERT_TRUE(ahandle == queue);
+
+  int32_t type = 0;
+  void   *pItem = NULL;
+  for (int32_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(taosGetQitem(qall, &type, &pItem), 1);
+    ASSERT_EQ(*(int32_t *)pItem, i);
+    taosFreeQitem(pItem);
+  }
+
+  taosFreeQall(qall);
+  taosCloseQueue(queue);
+  taosCloseQset(from);
+  taosCloseQset(to);
+}
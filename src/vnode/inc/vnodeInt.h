@@ -41,7 +41,12 @@ typedef struct {
   int64_t  queuedWMsgSize;
   int32_t  queuedWMsg;
   int32_t  queuedRMsg;
+  int32_t  numaNode;  // numa node the memory and the workers are bound to, -1 if not bound
   int32_t  flowctrlLevel;
+  int32_t  throttleLevel;  // write admission level from the memory pressure, 0 if the writes are admitted at once
+  int32_t  walSizeMB;      // wal size sampled by the admission control
+  uint32_t admitCheckVer;  // submit msg version for the lazy check of the wal size
+  int64_t  admitTime;      // us, when the admission bucket drains, advanced by each throttled submit
   int8_t   preClose;  // drop and close switch
   int8_t   reserved[3];
   int64_t  sequence;  // for topic
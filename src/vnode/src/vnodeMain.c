@@ -28,6 +28,7 @@
 #include "vnodeMgmt.h"
 #include "vnodeWorker.h"
 #include "vnodeBackup.h"
+#include "vnodeWrite.h"
 #include "vnodeMain.h"
 
 static int32_t vnodeProcessTsdbStatus(void *arg, int32_t status, int32_t eno);
@@ -248,6 +249,17 @@ static void vnodeFindWalRootDir(int32_t vgId, char *walRootDir) {
   tfsClosedir(tdir);
 }
 
+// the dnode reports its vnodes to the mnode only after all of them are opened, so the wal replay is reported as a
+// startup step, which taos -n startup shows
+static void vnodeReportRestore(void *ahandle, int64_t offset, int64_t size) {
+  SVnodeObj *pVnode = ahandle;
+  char       stepDesc[TSDB_STEP_DESC_LEN] = {0};
+
+  snprintf(stepDesc, TSDB_STEP_DESC_LEN, "vgId:%d, replay wal, %" PRId64 " of %" PRId64 " KB", pVnode->vgId,
+           offset >> 10, size >> 10);
+  dnodeReportStep("open-vnodes", stepDesc, 0);
+}
+
 int32_t vnodeOpen(int32_t vgId) {
   char temp[TSDB_FILENAME_LEN * 3];
   char rootDir[TSDB_FILENAME_LEN * 2];
@@ -266,6 +278,8 @@ int32_t vnodeOpen(int32_t vgId) {
   pVnode->fversion = 0;
   pVnode->version  = 0;  
   pVnode->tsdbCfg.tsdbId = pVnode->vgId;
+  pVnode->numaNode = (tsNumaBind && tsNumOfNumaNodes > 0) ? (vgId % tsNumOfNumaNodes) : -1;
+  pVnode->tsdbCfg.numaNode = pVnode->numaNode;
   pVnode->rootDir = strdup(rootDir);
   pVnode->accessState = TSDB_VN_ALL_ACCCESS;
   tsem_init(&pVnode->sem, 0, 0);
@@ -320,6 +334,7 @@ int32_t vnodeOpen(int32_t vgId) {
   appH.cqH = pVnode->cq;
   appH.cqCreateFunc = cqCreate;
   appH.cqDropFunc = cqDrop;
+  appH.unpinMsgFunc = vnodeUnpinWMsg;
 
   terrno = 0;
   pVnode->tsdb = tsdbOpenRepo(&(pVnode->tsdbCfg), &appH);
@@ -354,13 +369,16 @@ int32_t vnodeOpen(int32_t vgId) {
 
   sprintf(temp, "%s/wal", walRootDir);
   pVnode->walCfg.vgId = pVnode->vgId;
+  pVnode->walCfg.groupCommit = tsWalGroupCommit;
+  pVnode->walCfg.directIO = tsWalDirectIO;
+  pVnode->walCfg.preallocSize = tsWalPreallocSize;
   pVnode->wal = walOpen(temp, &pVnode->walCfg);
   if (pVnode->wal == NULL) { 
     vnodeCleanUp(pVnode);
     return terrno;
   }
 
-  walRestore(pVnode->wal, pVnode, vnodeProcessWrite);
+  walRestore(pVnode->wal, pVnode, vnodeProcessWrite, vnodeReportRestore);
   if (pVnode->version == 0) {
     pVnode->fversion = 0;
     pVnode->version = walGetVersion(pVnode->wal);
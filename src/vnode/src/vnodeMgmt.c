@@ -35,7 +35,9 @@ static SStep tsVnodeSteps[] = {
   {"vnode-write",  vnodeInitWrite,      vnodeCleanupWrite},
   {"vnode-read",   vnodeInitRead,       vnodeCleanupRead},
   {"vnode-hash",   vnodeInitHash,       vnodeCleanupHash},
-  {"tsdb-queue",   tsdbInitCommitQueue, tsdbDestroyCommitQueue}
+  {"tsdb-queue",   tsdbInitCommitQueue, tsdbDestroyCommitQueue},
+  {"tsdb-decode",  tsdbInitDecodeQueue, tsdbDestroyDecodeQueue},
+  {"tsdb-cworker", tsdbInitCommitWorkers, tsdbDestroyCommitWorkers}
 };
 
 int32_t vnodeInitMgmt() {
@@ -70,6 +72,10 @@ void *vnodeGetWal(void *pVnode) {
   return ((SVnodeObj *)pVnode)->wal;
 }
 
+int32_t vnodeGetNumaNode(void *pVnode) {
+  return ((SVnodeObj *)pVnode)->numaNode;
+}
+
 void vnodeAddIntoHash(SVnodeObj *pVnode) {
   taosHashPut(tsVnodesHash, &pVnode->vgId, sizeof(int32_t), &pVnode, sizeof(SVnodeObj *));
 }
@@ -163,6 +169,7 @@ static void vnodeBuildVloadMsg(SVnodeObj *pVnode, SStatusMsg *pStatus) {
   pLoad->role = pVnode->role;
   pLoad->replica = pVnode->syncCfg.replica;  
   pLoad->compact = (pVnode->tsdb != NULL) ? tsdbGetCompactState(pVnode->tsdb) : 0; 
+  pLoad->numaNode = (pVnode->tsdb != NULL) ? (int8_t)tsdbGetNumaNode(pVnode->tsdb) : -1;
 }
 
 int32_t vnodeGetVnodeList(int32_t vnodeList[], int32_t *numOfVnodes) {
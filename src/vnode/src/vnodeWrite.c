@@ -23,23 +23,28 @@
 #include "ttimer.h"
 #include "dnode.h"
 #include "vnodeStatus.h"
+#include "vnodeWrite.h"
 
 #define MAX_QUEUED_MSG_NUM 100000
 #define MAX_QUEUED_MSG_SIZE 1024*1024*1024  //1GB
+#define MAX_ADMIT_BURST_US 100000   // bytes worth of 100ms are admitted at once
+#define MAX_ADMIT_DELAY_MS 1000
 
 static int64_t tsSubmitReqSucNum = 0;
 static int64_t tsSubmitRowNum = 0;
 static int64_t tsSubmitRowSucNum = 0;
 
 extern void *  tsDnodeTmr;
-static int32_t (*vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_MAX])(SVnodeObj *, void *pCont, SRspRet *);
-static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
-static int32_t vnodeProcessCreateTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
-static int32_t vnodeProcessDropTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
-static int32_t vnodeProcessAlterTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
-static int32_t vnodeProcessDropStableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
-static int32_t vnodeProcessUpdateTagValMsg(SVnodeObj *pVnode, void *pCont, SRspRet *);
+static int32_t (*vnodeProcessWriteMsgFp[TSDB_MSG_TYPE_MAX])(SVnodeObj *, void *pCont, SRspRet *, SVWriteMsg *);
+static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *, SVWriteMsg *);
+static int32_t vnodeProcessCreateTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *, SVWriteMsg *);
+static int32_t vnodeProcessDropTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *, SVWriteMsg *);
+static int32_t vnodeProcessAlterTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *, SVWriteMsg *);
+static int32_t vnodeProcessDropStableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *, SVWriteMsg *);
+static int32_t vnodeProcessUpdateTagValMsg(SVnodeObj *pVnode, void *pCont, SRspRet *, SVWriteMsg *);
 static int32_t vnodePerformFlowCtrl(SVWriteMsg *pWrite);
+static int32_t vnodePerformAdmission(SVWriteMsg *pWrite);
+static void    vnodeUpdateThrottleLevel(SVnodeObj *pVnode);
 static int32_t vnodeCheckWal(SVnodeObj *pVnode);
 
 int32_t vnodeInitWrite(void) {
@@ -114,7 +119,7 @@ int32_t vnodeProcessWrite(void *vparam, void *wparam, int32_t qtype, void *rpara
   pVnode->version = pHead->version;
 
   // write data locally
-  code = (*vnodeProcessWriteMsgFp[pHead->msgType])(pVnode, pHead->cont, pRspRet);
+  code = (*vnodeProcessWriteMsgFp[pHead->msgType])(pVnode, pHead->cont, pRspRet, pWrite);
   if (code < 0) {
     if (syncCode > 0) atomic_sub_fetch_32(&pWrite->processedCount, 1);
     return code;
@@ -150,7 +155,7 @@ static int32_t vnodeCheckWrite(SVnodeObj *pVnode) {
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
+static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet, SVWriteMsg *pWrite) {
   int32_t code = TSDB_CODE_SUCCESS;
 
   vTrace("vgId:%d, submit msg is processed", pVnode->vgId);
@@ -167,13 +172,23 @@ static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pR
     pRsp = pRet->rsp;
   }
 
-  if (tsdbInsertData(pVnode->tsdb, pCont, pRsp) < 0) {
+  // the memtable references the rows in the msg instead of copying them, the msg is pinned until it is freed
+  void *pPin = NULL;
+  if (tsdbMemTableZeroCopy && pWrite != NULL) {
+    atomic_add_fetch_32(&pWrite->refCount, 1);
+    pPin = pWrite;
+  }
+
+  if (tsdbInsertData(pVnode->tsdb, pCont, pRsp, pPin) < 0) {
     code = terrno;
   } else {
     if (pRsp != NULL) atomic_fetch_add_64(&tsSubmitReqSucNum, 1);
   }
 
+  vnodeUpdateThrottleLevel(pVnode);
+
   if (pRsp) {
+    pRsp->throttle = (int8_t)pVnode->throttleLevel;
     atomic_fetch_add_64(&tsSubmitRowNum, ntohl(pRsp->numOfRows));
     atomic_fetch_add_64(&tsSubmitRowSucNum, ntohl(pRsp->affectedRows));
   }
@@ -181,6 +196,39 @@ static int32_t vnodeProcessSubmitMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pR
   return code;
 }
 
+/*
+ * The throttle level goes up as the memtable fills while the last commit is still going on, since the writes stall on
+ * the cache once the memtable is full again, and when the wal grows far beyond the flush size.
+ */
+static void vnodeUpdateThrottleLevel(SVnodeObj *pVnode) {
+  if (tsWriteAdmissionRate <= 0) return;
+
+  if (((++pVnode->admitCheckVer) & 63) == 0) {  // lazy check
+    pVnode->walSizeMB = (int32_t)(walGetFSize(pVnode->wal) >> 20);
+  }
+
+  int32_t fill = tsdbGetMemFill(pVnode->tsdb);
+  int32_t level = 0;
+
+  if (pVnode->isCommiting) {
+    if (fill >= 90) {
+      level = 3;
+    } else if (fill >= 75) {
+      level = 2;
+    } else if (fill >= 50) {
+      level = 1;
+    }
+  }
+
+  if (level == 0 && pVnode->walSizeMB > 2 * tsdbWalFlushSize) level = 1;
+
+  if (pVnode->throttleLevel != level) {
+    vDebug("vgId:%d, set throttle level from %d to %d, mem fill:%d%% wal:%dMB commiting:%d", pVnode->vgId,
+           pVnode->throttleLevel, level, fill, pVnode->walSizeMB, pVnode->isCommiting);
+    atomic_store_32(&pVnode->throttleLevel, level);
+  }
+}
+
 static int32_t vnodeCheckWal(SVnodeObj *pVnode) {
   if (pVnode->isCommiting == 0) {
     return tsdbCheckWal(pVnode->tsdb, (uint32_t)(walGetFSize(pVnode->wal) >> 20));
@@ -188,7 +236,7 @@ static int32_t vnodeCheckWal(SVnodeObj *pVnode) {
   return 0;
 }
 
-static int32_t vnodeProcessCreateTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
+static int32_t vnodeProcessCreateTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet, SVWriteMsg *pWrite) {
   int code = TSDB_CODE_SUCCESS;
 
   STableCfg *pCfg = tsdbCreateTableCfgFromMsg((SMDCreateTableMsg *)pCont);
@@ -210,7 +258,7 @@ static int32_t vnodeProcessCreateTableMsg(SVnodeObj *pVnode, void *pCont, SRspRe
   return code;
 }
 
-static int32_t vnodeProcessDropTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
+static int32_t vnodeProcessDropTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet, SVWriteMsg *pWrite) {
   SMDDropTableMsg *pTable = pCont;
   int32_t          code = TSDB_CODE_SUCCESS;
 
@@ -222,7 +270,7 @@ static int32_t vnodeProcessDropTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet
   return code;
 }
 
-static int32_t vnodeProcessAlterTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
+static int32_t vnodeProcessAlterTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet, SVWriteMsg *pWrite) {
   // TODO: disposed in tsdb
   // STableCfg *pCfg = tsdbCreateTableCfgFromMsg((SMDCreateTableMsg *)pCont);
   // if (pCfg == NULL) return terrno;
@@ -233,7 +281,7 @@ static int32_t vnodeProcessAlterTableMsg(SVnodeObj *pVnode, void *pCont, SRspRet
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t vnodeProcessDropStableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
+static int32_t vnodeProcessDropStableMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet, SVWriteMsg *pWrite) {
   SDropSTableMsg *pTable = pCont;
   int32_t         code = TSDB_CODE_SUCCESS;
 
@@ -248,7 +296,7 @@ static int32_t vnodeProcessDropStableMsg(SVnodeObj *pVnode, void *pCont, SRspRet
   return code;
 }
 
-static int32_t vnodeProcessUpdateTagValMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet) {
+static int32_t vnodeProcessUpdateTagValMsg(SVnodeObj *pVnode, void *pCont, SRspRet *pRet, SVWriteMsg *pWrite) {
   if (tsdbUpdateTableTagValue(pVnode->tsdb, (SUpdateTableTagValMsg *)pCont) < 0) {
     return terrno;
   }
@@ -276,6 +324,7 @@ static SVWriteMsg *vnodeBuildVWriteMsg(SVnodeObj *pVnode, SWalHead *pHead, int32
   memcpy(&pWrite->walHead, pHead, sizeof(SWalHead) + pHead->len);
   pWrite->pVnode = pVnode;
   pWrite->qtype = qtype;
+  pWrite->refCount = 1;
 
   atomic_add_fetch_32(&pVnode->refCount, 1);
 
@@ -355,6 +404,9 @@ int32_t vnodeWriteToWQueue(void *vparam, void *wparam, int32_t qtype, void *rpar
   int32_t code = vnodePerformFlowCtrl(pWrite);
   if (code != 0) return 0;
 
+  code = vnodePerformAdmission(pWrite);
+  if (code != 0) return 0;
+
   return vnodeWriteToWQueueImp(pWrite);
 }
 
@@ -368,10 +420,18 @@ void vnodeFreeFromWQueue(void *vparam, SVWriteMsg *pWrite) {
            pWrite->rpcMsg.ahandle, queued, queuedSize);
   }
 
-  taosFreeQitem(pWrite);
+  vnodeUnpinWMsg(pWrite);
   vnodeRelease(pVnode);
 }
 
+// the msg may outlive its vnode while a memtable still references its rows, so the vnode is not touched here
+void vnodeUnpinWMsg(void *param) {
+  SVWriteMsg *pWrite = param;
+  if (atomic_sub_fetch_32(&pWrite->refCount, 1) == 0) {
+    taosFreeQitem(pWrite);
+  }
+}
+
 static void vnodeFlowCtrlMsgToWQueue(void *param, void *tmrId) {
   SVWriteMsg *pWrite = param;
   SVnodeObj * pVnode = pWrite->pVnode;
@@ -427,6 +487,54 @@ static int32_t vnodePerformFlowCtrl(SVWriteMsg *pWrite) {
   }
 }
 
+static void vnodeAdmitMsgToWQueue(void *param, void *tmrId) {
+  SVWriteMsg *pWrite = param;
+  SVnodeObj * pVnode = pWrite->pVnode;
+  void *      handle = pWrite->rpcMsg.handle;
+
+  vTrace("vgId:%d, msg:%p, app:%p, write into vwqueue after admission delay", pVnode->vgId, pWrite,
+         pWrite->rpcMsg.ahandle);
+
+  int32_t code = vnodeWriteToWQueueImp(pWrite);
+  if (code != TSDB_CODE_SUCCESS) {
+    SRpcMsg rpcRsp = {.handle = handle, .code = code};
+    rpcSendResponse(&rpcRsp);
+  }
+}
+
+/*
+ * Delay the submits of a throttled vnode by a token bucket, whose rate is writeAdmissionRate MB/s halved at each level
+ * above 1. The bucket is kept as the time it drains, so the dispatching threads take their tokens with a CAS.
+ */
+static int32_t vnodePerformAdmission(SVWriteMsg *pWrite) {
+  SVnodeObj *pVnode = pWrite->pVnode;
+  int32_t    level = atomic_load_32(&pVnode->throttleLevel);
+
+  if (pWrite->qtype != TAOS_QTYPE_RPC || pWrite->walHead.msgType != TSDB_MSG_TYPE_SUBMIT) return 0;
+  if (tsWriteAdmissionRate <= 0 || level <= 0) return 0;
+
+  // 1MB/s is about one byte per us
+  int64_t cost = ((int64_t)pWrite->walHead.len << (level - 1)) / tsWriteAdmissionRate;
+  int64_t now = taosGetTimestampUs();
+  int64_t drainTime, admitTime;
+
+  do {
+    drainTime = atomic_load_64(&pVnode->admitTime);
+    admitTime = MAX(drainTime, now) + cost;
+  } while (atomic_val_compare_exchange_64(&pVnode->admitTime, drainTime, admitTime) != drainTime);
+
+  int32_t ms = (int32_t)((admitTime - now - MAX_ADMIT_BURST_US) / 1000);
+  if (ms <= 0) return 0;
+  if (ms > MAX_ADMIT_DELAY_MS) ms = MAX_ADMIT_DELAY_MS;
+
+  vTrace("vgId:%d, msg:%p, app:%p, throttle level:%d, delay admission for %d ms", pVnode->vgId, pWrite,
+         pWrite->rpcMsg.ahandle, level, ms);
+
+  void *unUsedTimerId = NULL;
+  taosTmrReset(vnodeAdmitMsgToWQueue, ms, pWrite, tsDnodeTmr, &unUsedTimerId);
+  return TSDB_CODE_VND_ACTION_IN_PROGRESS;
+}
+
 void vnodeWaitWriteCompleted(SVnodeObj *pVnode) {
   int32_t extraSleep = 0;
   while (pVnode->queuedWMsg > 0) {
@@ -444,6 +552,7 @@ SVnodeStatisInfo vnodeGetStatisInfo() {
   info.submitReqSucNum = atomic_exchange_64(&tsSubmitReqSucNum, 0);
   info.submitRowNum = atomic_exchange_64(&tsSubmitRowNum, 0);
   info.submitRowSucNum = atomic_exchange_64(&tsSubmitRowSucNum, 0);
+  tsdbGetBlockCacheStatis(&info.blockCacheHits, &info.blockCacheMisses, &info.blockCacheSize);
 
   return info;
 }
@@ -39,6 +39,11 @@ extern int32_t wDebugFlag;
 #define WAL_PATH_LEN   (TSDB_FILENAME_LEN + 12)
 #define WAL_FILE_LEN   (WAL_PATH_LEN + 32)
 #define WAL_FILE_NUM   1 // 3
+#define WAL_ALIGN      4096
+#define WAL_BUF_SIZE   (256 * 1024)
+#define WAL_RESTORE_READ_SIZE (1024 * 1024)
+#define WAL_RESTORE_BATCHES   2
+#define WAL_PROGRESS_MS       5000
 
 typedef struct {
   uint64_t version;
@@ -51,7 +56,17 @@ typedef struct {
   int32_t  fsyncPeriod;
   int32_t  fsyncSeq;
   int8_t   stop;
-  int8_t   reserved[3];
+  int8_t   groupCommit;
+  int8_t   directIO;
+  int8_t   reserved[1];
+  int64_t  offset;     // bytes of the records written out to the file
+  int64_t  allocSize;  // bytes reserved on disk for the file
+  int64_t  preallocSize;
+  char *   buffer;     // records of the group commit, aligned for direct io
+  char *   bufMem;
+  int32_t  bufSize;
+  int32_t  bufLen;
+  int32_t  bufDone;    // bytes at the head of buffer already on disk, the unaligned tail of direct io
   char     path[WAL_PATH_LEN];
   char     name[WAL_FILE_LEN];
   pthread_mutex_t mutex;
@@ -60,6 +75,7 @@ typedef struct {
 int32_t walGetNextFile(SWal *pWal, int64_t *nextFileId);
 int32_t walGetOldFile(SWal *pWal, int64_t curFileId, int32_t minDiff, int64_t *oldFileId);
 int32_t walGetNewFile(SWal *pWal, int64_t *newFileId);
+void    walCloseFile(SWal *pWal);
 
 #ifdef __cplusplus
 }
@@ -75,7 +75,14 @@ void *walOpen(char *path, SWalCfg *pCfg) {
   pWal->level = pCfg->walLevel;
   pWal->keep = pCfg->keep;
   pWal->fsyncPeriod = pCfg->fsyncPeriod;
+  pWal->preallocSize = (int64_t)pCfg->preallocSize << 20;
   tstrncpy(pWal->path, path, sizeof(pWal->path));
+
+  // a kept wal is appended across the restarts, it is written record by record
+  if (pCfg->keep != TAOS_WAL_KEEP) {
+    pWal->groupCommit = pCfg->groupCommit;
+    pWal->directIO = pCfg->groupCommit ? pCfg->directIO : 0;
+  }
   pthread_mutex_init(&pWal->mutex, NULL);
 
   pWal->fsyncSeq = pCfg->fsyncPeriod / 1000;
@@ -92,7 +99,8 @@ void *walOpen(char *path, SWalCfg *pCfg) {
     return NULL;
   }
 
-  wDebug("vgId:%d, wal:%p is opened, level:%d fsyncPeriod:%d", pWal->vgId, pWal, pWal->level, pWal->fsyncPeriod);
+  wDebug("vgId:%d, wal:%p is opened, level:%d fsyncPeriod:%d groupCommit:%d directIO:%d", pWal->vgId, pWal,
+         pWal->level, pWal->fsyncPeriod, pWal->groupCommit, pWal->directIO);
 
   return pWal;
 }
@@ -133,7 +141,7 @@ void walClose(void *handle) {
 
   SWal *pWal = handle;
   pthread_mutex_lock(&pWal->mutex);
-  tfClose(pWal->tfd);
+  walCloseFile(pWal);
   pthread_mutex_unlock(&pWal->mutex);
   taosRemoveRef(tsWal.refId, pWal->rid);
 }
@@ -154,6 +162,7 @@ static void walFreeObj(void *wal) {
 
   tfClose(pWal->tfd);
   pthread_mutex_destroy(&pWal->mutex);
+  tfree(pWal->bufMem);
   tfree(pWal);
 }
 
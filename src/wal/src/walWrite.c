@@ -14,6 +14,7 @@
  */
 
 #define _DEFAULT_SOURCE
+#define _GNU_SOURCE
 #define TAOS_RANDOM_FILE_FAIL_TEST
 #include "os.h"
 #include "taoserror.h"
@@ -23,7 +24,128 @@
 #include "twal.h"
 #include "walInt.h"
 
-static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, char *name, int64_t fileId);
+static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, FWalProgress progressFp, char *name,
+                                 int64_t fileId);
+
+static void walPreallocFile(SWal *pWal, int64_t end) {
+  if (pWal->preallocSize <= 0 || end <= pWal->allocSize) return;
+
+  int64_t size = pWal->allocSize;
+  while (size < end) size += pWal->preallocSize;
+
+  if (tfFallocate(pWal->tfd, pWal->allocSize, size - pWal->allocSize) != 0) {
+    wWarn("vgId:%d, file:%s, failed to preallocate since %s, stop preallocation", pWal->vgId, pWal->name,
+          strerror(errno));
+    pWal->preallocSize = 0;
+    return;
+  }
+
+  pWal->allocSize = size;
+}
+
+static int32_t walResizeBuffer(SWal *pWal, int32_t size) {
+  if (size <= pWal->bufSize) return TSDB_CODE_SUCCESS;
+
+  int32_t bufSize = MAX(WAL_BUF_SIZE, ALIGN_NUM(size, WAL_ALIGN));
+  char *  bufMem = tmalloc(bufSize + WAL_ALIGN);
+  if (bufMem == NULL) return TAOS_SYSTEM_ERROR(ENOMEM);
+
+  char *buffer = (char *)ALIGN_NUM((uintptr_t)bufMem, WAL_ALIGN);
+  if (pWal->bufLen > 0) memcpy(buffer, pWal->buffer, pWal->bufLen);
+
+  tfree(pWal->bufMem);
+  pWal->bufMem = bufMem;
+  pWal->buffer = buffer;
+  pWal->bufSize = bufSize;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// write out the buffered records with one call, direct io writes whole blocks from an aligned offset, so the
+// unaligned tail is zero padded on disk and kept in the buffer to be written again with the following records
+static int32_t walFlushBuffer(SWal *pWal) {
+  if (pWal->bufLen <= pWal->bufDone) return TSDB_CODE_SUCCESS;
+
+  int64_t base = pWal->offset - pWal->bufDone;
+  int32_t len = pWal->bufLen;
+  if (pWal->directIO) {
+    len = ALIGN_NUM(len, WAL_ALIGN);
+    memset(pWal->buffer + pWal->bufLen, 0, len - pWal->bufLen);
+  }
+
+  walPreallocFile(pWal, base + len);
+
+  if (tfPWrite(pWal->tfd, pWal->buffer, len, base) != len) {
+    int32_t code = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%s, failed to write %d bytes at offset:%" PRId64 " since %s", pWal->vgId, pWal->name, len,
+           base, strerror(errno));
+    return code;
+  }
+
+  wTrace("vgId:%d, file:%s, %d bytes are written at offset:%" PRId64, pWal->vgId, pWal->name,
+         pWal->bufLen - pWal->bufDone, pWal->offset);
+
+  pWal->offset = base + pWal->bufLen;
+
+  int32_t tail = pWal->directIO ? pWal->bufLen % WAL_ALIGN : 0;
+  if (tail > 0 && pWal->bufLen > tail) memmove(pWal->buffer, pWal->buffer + pWal->bufLen - tail, tail);
+  pWal->bufLen = tail;
+  pWal->bufDone = tail;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t walBufferRecord(SWal *pWal, SWalHead *pHead, int32_t contLen) {
+  if (pWal->bufLen + contLen > pWal->bufSize) {
+    int32_t code = walFlushBuffer(pWal);
+    if (code != TSDB_CODE_SUCCESS) return code;
+
+    code = walResizeBuffer(pWal, pWal->bufLen + contLen);
+    if (code != TSDB_CODE_SUCCESS) return code;
+  }
+
+  // the record is copied since the message is converted in place once it is applied
+  memcpy(pWal->buffer + pWal->bufLen, pHead, contLen);
+  pWal->bufLen += contLen;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void walCloseFile(SWal *pWal) {
+  if (!tfValid(pWal->tfd)) return;
+
+  if (pWal->groupCommit) {
+    walFlushBuffer(pWal);
+
+    // cut off the zero padding of direct io and the space reserved but not used
+    if (pWal->directIO || pWal->allocSize > pWal->offset) tfFtruncate(pWal->tfd, pWal->offset);
+  }
+
+  tfClose(pWal->tfd);
+
+  pWal->offset = 0;
+  pWal->allocSize = 0;
+  pWal->bufLen = 0;
+  pWal->bufDone = 0;
+}
+
+static int64_t walOpenFile(SWal *pWal) {
+  int32_t flags = O_WRONLY | O_CREAT;
+#ifdef O_DIRECT
+  if (pWal->directIO) flags |= O_DIRECT;
+#else
+  pWal->directIO = 0;
+#endif
+
+  int64_t tfd = tfOpenM(pWal->name, flags, S_IRWXU | S_IRWXG | S_IRWXO);
+  if (!tfValid(tfd) && pWal->directIO && errno == EINVAL) {
+    wWarn("vgId:%d, file:%s, direct io is not supported, write by the page cache", pWal->vgId, pWal->name);
+    pWal->directIO = 0;
+    tfd = tfOpenM(pWal->name, O_WRONLY | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
+  }
+
+  return tfd;
+}
 
 int32_t walRenew(void *handle) {
   if (handle == NULL) return 0;
@@ -39,7 +161,7 @@ int32_t walRenew(void *handle) {
   pthread_mutex_lock(&pWal->mutex);
 
   if (tfValid(pWal->tfd)) {
-    tfClose(pWal->tfd);
+    walCloseFile(pWal);
     wDebug("vgId:%d, file:%s, it is closed while renew", pWal->vgId, pWal->name);
   }
 
@@ -51,12 +173,13 @@ int32_t walRenew(void *handle) {
   }
 
   snprintf(pWal->name, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, pWal->fileId);
-  pWal->tfd = tfOpenM(pWal->name, O_WRONLY | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
+  pWal->tfd = walOpenFile(pWal);
 
   if (!tfValid(pWal->tfd)) {
     code = TAOS_SYSTEM_ERROR(errno);
     wError("vgId:%d, file:%s, failed to open since %s", pWal->vgId, pWal->name, strerror(errno));
   } else {
+    walPreallocFile(pWal, 1);
     wDebug("vgId:%d, file:%s, it is created and open while renew", pWal->vgId, pWal->name);
   }
 
@@ -97,7 +220,7 @@ void walRemoveAllOldFiles(void *handle) {
 
   pthread_mutex_lock(&pWal->mutex);
   
-  tfClose(pWal->tfd);
+  walCloseFile(pWal);
   wDebug("vgId:%d, file:%s, it is closed before remove all wals", pWal->vgId, pWal->name);
 
   while (walGetNextFile(pWal, &fileId) >= 0) {
@@ -157,9 +280,19 @@ int32_t walWrite(void *handle, SWalHead *pHead) {
 
   pthread_mutex_lock(&pWal->mutex);
 
-  if (tfWrite(pWal->tfd, pHead, contLen) != contLen) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, file:%s, failed to write since %s", pWal->vgId, pWal->name, strerror(errno));
+  if (pWal->groupCommit) {
+    code = walBufferRecord(pWal, pHead, contLen);
+  } else {
+    walPreallocFile(pWal, pWal->offset + contLen);
+    if (tfWrite(pWal->tfd, pHead, contLen) != contLen) {
+      code = TAOS_SYSTEM_ERROR(errno);
+    } else {
+      pWal->offset += contLen;
+    }
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    wError("vgId:%d, file:%s, failed to write since %s", pWal->vgId, pWal->name, tstrerror(code));
   } else {
     wTrace("vgId:%d, write wal, fileId:%" PRId64 " tfd:%" PRId64 " hver:%" PRId64 " wver:%" PRIu64 " len:%d", pWal->vgId,
            pWal->fileId, pWal->tfd, pHead->version, pWal->version, pHead->len);
@@ -173,19 +306,30 @@ int32_t walWrite(void *handle, SWalHead *pHead) {
   return code;
 }
 
-void walFsync(void *handle, bool forceFsync) {
+int32_t walFsync(void *handle, bool forceFsync) {
   SWal *pWal = handle;
-  if (pWal == NULL || !tfValid(pWal->tfd)) return;
+  if (pWal == NULL || !tfValid(pWal->tfd)) return TSDB_CODE_SUCCESS;
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pWal->groupCommit) {
+    pthread_mutex_lock(&pWal->mutex);
+    code = walFlushBuffer(pWal);
+    pthread_mutex_unlock(&pWal->mutex);
+    if (code != TSDB_CODE_SUCCESS) return code;
+  }
 
   if (forceFsync || (pWal->level == TAOS_WAL_FSYNC && pWal->fsyncPeriod == 0)) {
     wTrace("vgId:%d, fileId:%" PRId64 ", do fsync", pWal->vgId, pWal->fileId);
     if (tfFsync(pWal->tfd) < 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
       wError("vgId:%d, fileId:%" PRId64 ", fsync failed since %s", pWal->vgId, pWal->fileId, strerror(errno));
     }
   }
+
+  return code;
 }
 
-int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
+int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp, FWalProgress progressFp) {
   if (handle == NULL) return -1;
 
   SWal *  pWal = handle;
@@ -200,7 +344,7 @@ int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
     snprintf(walName, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, fileId);
 
     wInfo("vgId:%d, file:%s, will be restored", pWal->vgId, walName);
-    code = walRestoreWalFile(pWal, pVnode, writeFp, walName, fileId);
+    code = walRestoreWalFile(pWal, pVnode, writeFp, progressFp, walName, fileId);
     if (code != TSDB_CODE_SUCCESS) {
       wError("vgId:%d, file:%s, failed to restore since %s", pWal->vgId, walName, tstrerror(code));
       continue;
@@ -225,6 +369,12 @@ int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
       wError("vgId:%d, file:%s, failed to open since %s", pWal->vgId, pWal->name, strerror(errno));
       return TAOS_SYSTEM_ERROR(errno);
     }
+
+    struct stat fstat;
+    if (tfStat(pWal->tfd, &fstat) == 0) {
+      pWal->offset = fstat.st_size;
+      pWal->allocSize = fstat.st_size;
+    }
     wDebug("vgId:%d, file:%s, it is created and open while restore", pWal->vgId, pWal->name);
   }
 
@@ -251,22 +401,104 @@ int32_t walGetWalFile(void *handle, char *fileName, int64_t *fileId) {
   return code;
 }
 
+// the wal file is read by large sequential reads, records are copied out of the read buffer
+typedef struct {
+  int64_t tfd;
+  char *  buffer;
+  int32_t size;
+  int32_t len;     // bytes in buffer
+  int32_t pos;     // read position in buffer
+  int64_t offset;  // file offset of buffer[0]
+} SWalReader;
+
+// records decoded and validated, waiting to be applied
+typedef struct {
+  char *  data;
+  int32_t size;
+  int32_t len;
+  int64_t offset;  // file offset after the last record
+} SWalBatch;
+
+typedef struct {
+  SWal *          pWal;
+  char *          name;
+  int64_t         fileId;
+  int64_t         fsize;
+  SWalReader      reader;
+  SWalBatch       batches[WAL_RESTORE_BATCHES];
+  int32_t         head;    // the first batch ready to apply
+  int32_t         count;   // batches ready to apply
+  int8_t          done;    // the decoder reaches the end of file or fails
+  int32_t         code;
+  pthread_t       thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+} SWalRestore;
+
+static int32_t walReadReader(SWalReader *pReader, void *buf, int32_t count) {
+  int32_t nread = 0;
+
+  while (nread < count) {
+    if (pReader->pos >= pReader->len) {
+      pReader->offset += pReader->len;
+      pReader->pos = 0;
+      pReader->len = 0;
+
+      int64_t ret = tfRead(pReader->tfd, pReader->buffer, pReader->size);
+      if (ret < 0) return -1;
+      if (ret == 0) break;
+      pReader->len = (int32_t)ret;
+    }
+
+    int32_t bytes = MIN(count - nread, pReader->len - pReader->pos);
+    memcpy((char *)buf + nread, pReader->buffer + pReader->pos, bytes);
+    pReader->pos += bytes;
+    nread += bytes;
+  }
+
+  return nread;
+}
+
+static int32_t walSeekReader(SWalReader *pReader, int64_t offset) {
+  if (offset >= pReader->offset && offset <= pReader->offset + pReader->len) {
+    pReader->pos = (int32_t)(offset - pReader->offset);
+    return 0;
+  }
+
+  if (tfLseek(pReader->tfd, offset, SEEK_SET) < 0) return -1;
+
+  pReader->offset = offset;
+  pReader->len = 0;
+  pReader->pos = 0;
+  return 0;
+}
+
 static void walFtruncate(SWal *pWal, int64_t tfd, int64_t offset) {
   tfFtruncate(tfd, offset);
   tfFsync(tfd);
 }
 
-static int32_t walSkipCorruptedRecord(SWal *pWal, SWalHead *pHead, int64_t tfd, int64_t *offset) {
+// the tail of the last block written by direct io is zero padded
+static bool walIsZeroHead(SWalHead *pHead) {
+  char *p = (char *)pHead;
+  for (int32_t i = 0; i < sizeof(SWalHead); ++i) {
+    if (p[i] != 0) return false;
+  }
+
+  return true;
+}
+
+static int32_t walSkipCorruptedRecord(SWal *pWal, SWalHead *pHead, SWalReader *pReader, int64_t *offset) {
   int64_t pos = *offset;
   while (1) {
     pos++;
 
-    if (tfLseek(tfd, pos, SEEK_SET) < 0) {
+    if (walSeekReader(pReader, pos) < 0) {
       wError("vgId:%d, failed to seek from corrupted wal file since %s", pWal->vgId, strerror(errno));
       return TSDB_CODE_WAL_FILE_CORRUPTED;
     }
 
-    if (tfRead(tfd, pHead, sizeof(SWalHead)) <= 0) {
+    if (walReadReader(pReader, pHead, sizeof(SWalHead)) <= 0) {
       wError("vgId:%d, read to end of corrupted wal file, offset:%" PRId64, pWal->vgId, pos);
       return TSDB_CODE_WAL_FILE_CORRUPTED;
     }
@@ -283,7 +515,7 @@ static int32_t walSkipCorruptedRecord(SWal *pWal, SWalHead *pHead, int64_t tfd,
     }
 
     if (pHead->sver >= 1) {
-      if (tfRead(tfd, pHead->cont, pHead->len) < pHead->len) {
+      if (walReadReader(pReader, pHead->cont, pHead->len) < pHead->len) {
 	wError("vgId:%d, read to end of corrupted wal file, offset:%" PRId64, pWal->vgId, pos);
 	return TSDB_CODE_WAL_FILE_CORRUPTED;
       }
@@ -417,29 +649,58 @@ static int walSMemRowCheck(SWalHead *pHead) {
   return 0;
 }
 
-static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, char *name, int64_t fileId) {
-  int32_t size = WAL_MAX_SIZE;
-  void *  buffer = tmalloc(size);
-  if (buffer == NULL) {
-    wError("vgId:%d, file:%s, failed to open for restore since %s", pWal->vgId, name, strerror(errno));
-    return TAOS_SYSTEM_ERROR(errno);
+// the decoder marks the batch filled ready and waits for a free one
+static void walHandOverBatch(SWalRestore *pRestore, SWalBatch **ppBatch) {
+  pthread_mutex_lock(&pRestore->mutex);
+
+  pRestore->count++;
+  pthread_cond_broadcast(&pRestore->cond);
+  while (pRestore->count >= WAL_RESTORE_BATCHES) {
+    pthread_cond_wait(&pRestore->cond, &pRestore->mutex);
   }
 
-  int64_t tfd = tfOpen(name, O_RDWR);
-  if (!tfValid(tfd)) {
-    wError("vgId:%d, file:%s, failed to open for restore since %s", pWal->vgId, name, strerror(errno));
-    tfree(buffer);
-    return TAOS_SYSTEM_ERROR(errno);
-  } else {
-    wDebug("vgId:%d, file:%s, open for restore", pWal->vgId, name);
+  *ppBatch = &pRestore->batches[(pRestore->head + pRestore->count) % WAL_RESTORE_BATCHES];
+  (*ppBatch)->len = 0;
+
+  pthread_mutex_unlock(&pRestore->mutex);
+}
+
+static int32_t walPutRestoreRecord(SWalRestore *pRestore, SWalBatch **ppBatch, SWalHead *pHead, int64_t offset) {
+  SWalBatch *pBatch = *ppBatch;
+  int32_t    contLen = ALIGN8(sizeof(SWalHead) + pHead->len);
+
+  if (pBatch->len > 0 && pBatch->len + contLen > pBatch->size) {
+    walHandOverBatch(pRestore, ppBatch);
+    pBatch = *ppBatch;
+  }
+
+  if (contLen > pBatch->size) {
+    char *data = realloc(pBatch->data, contLen);
+    if (data == NULL) return TAOS_SYSTEM_ERROR(ENOMEM);
+    pBatch->data = data;
+    pBatch->size = contLen;
   }
 
-  int32_t   code = TSDB_CODE_SUCCESS;
-  int64_t   offset = 0;
-  SWalHead *pHead = buffer;
+  memcpy(pBatch->data + pBatch->len, pHead, sizeof(SWalHead) + pHead->len);
+  pBatch->len += contLen;
+  pBatch->offset = offset;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// read and validate the records ahead of the applier
+static int32_t walDecodeWalFile(SWalRestore *pRestore, void *buffer) {
+  SWal *     pWal = pRestore->pWal;
+  char *     name = pRestore->name;
+  int64_t    fileId = pRestore->fileId;
+  int32_t    size = WAL_MAX_SIZE;
+  int32_t    code = TSDB_CODE_SUCCESS;
+  int64_t    offset = 0;
+  SWalHead * pHead = buffer;
+  SWalBatch *pBatch = &pRestore->batches[0];
 
   while (1) {
-    int32_t ret = (int32_t)tfRead(tfd, pHead, sizeof(SWalHead));
+    int32_t ret = (int32_t)walReadReader(&pRestore->reader, pHead, sizeof(SWalHead));
     if (ret == 0) break;
 
     if (ret < 0) {
@@ -450,7 +711,13 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
 
     if (ret < sizeof(SWalHead)) {
       wError("vgId:%d, file:%s, failed to read wal head, ret is %d", pWal->vgId, name, ret);
-      walFtruncate(pWal, tfd, offset);
+      walFtruncate(pWal, pRestore->reader.tfd, offset);
+      break;
+    }
+
+    if (walIsZeroHead(pHead)) {
+      wInfo("vgId:%d, file:%s, read to the zero padding, offset:%" PRId64, pWal->vgId, name, offset);
+      walFtruncate(pWal, pRestore->reader.tfd, offset);
       break;
     }
 
@@ -458,9 +725,9 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
     if ((pHead->sver == 0 && !walValidateChecksum(pHead)) || pHead->sver < 0 || pHead->sver > 2) {
       wError("vgId:%d, file:%s, wal head cksum is messed up, hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, name,
              pHead->version, pHead->len, offset);
-      code = walSkipCorruptedRecord(pWal, pHead, tfd, &offset);
+      code = walSkipCorruptedRecord(pWal, pHead, &pRestore->reader, &offset);
       if (code != TSDB_CODE_SUCCESS) {
-        walFtruncate(pWal, tfd, offset);
+        walFtruncate(pWal, pRestore->reader.tfd, offset);
         break;
       }
     }
@@ -468,14 +735,14 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
     if (pHead->len < 0 || pHead->len > size - sizeof(SWalHead)) {
       wError("vgId:%d, file:%s, wal head len out of range, hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, name,
              pHead->version, pHead->len, offset);
-      code = walSkipCorruptedRecord(pWal, pHead, tfd, &offset);
+      code = walSkipCorruptedRecord(pWal, pHead, &pRestore->reader, &offset);
       if (code != TSDB_CODE_SUCCESS) {
-        walFtruncate(pWal, tfd, offset);
+        walFtruncate(pWal, pRestore->reader.tfd, offset);
         break;
       }
     }
 
-    ret = (int32_t)tfRead(tfd, pHead->cont, pHead->len);
+    ret = (int32_t)walReadReader(&pRestore->reader, pHead->cont, pHead->len);
     if (ret < 0) {
       wError("vgId:%d, file:%s, failed to read wal body since %s", pWal->vgId, name, strerror(errno));
       code = TAOS_SYSTEM_ERROR(errno);
@@ -491,9 +758,9 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
     if ((pHead->sver >= 1) && !walValidateChecksum(pHead)) {
       wError("vgId:%d, file:%s, wal whole cksum is messed up, hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, name,
              pHead->version, pHead->len, offset);
-      code = walSkipCorruptedRecord(pWal, pHead, tfd, &offset);
+      code = walSkipCorruptedRecord(pWal, pHead, &pRestore->reader, &offset);
       if (code != TSDB_CODE_SUCCESS) {
-        walFtruncate(pWal, tfd, offset);
+        walFtruncate(pWal, pRestore->reader.tfd, offset);
         break;
       }
     }
@@ -502,9 +769,9 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
     if (!taosCheckChecksumWhole((uint8_t *)pHead, sizeof(SWalHead))) {
       wError("vgId:%d, file:%s, wal head cksum is messed up, hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, name,
              pHead->version, pHead->len, offset);
-      code = walSkipCorruptedRecord(pWal, pHead, tfd, &offset);
+      code = walSkipCorruptedRecord(pWal, pHead, &pRestore->reader, &offset);
       if (code != TSDB_CODE_SUCCESS) {
-        walFtruncate(pWal, tfd, offset);
+        walFtruncate(pWal, pRestore->reader.tfd, offset);
         break;
       }
     }
@@ -512,14 +779,14 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
     if (pHead->len < 0 || pHead->len > size - sizeof(SWalHead)) {
       wError("vgId:%d, file:%s, wal head len out of range, hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, name,
              pHead->version, pHead->len, offset);
-      code = walSkipCorruptedRecord(pWal, pHead, tfd, &offset);
+      code = walSkipCorruptedRecord(pWal, pHead, &pRestore->reader, &offset);
       if (code != TSDB_CODE_SUCCESS) {
-        walFtruncate(pWal, tfd, offset);
+        walFtruncate(pWal, pRestore->reader.tfd, offset);
         break;
       }
     }
 
-    ret = (int32_t)tfRead(tfd, pHead->cont, pHead->len);
+    ret = (int32_t)walReadReader(&pRestore->reader, pHead->cont, pHead->len);
     if (ret < 0) {
       wError("vgId:%d, file:%s, failed to read wal body since %s", pWal->vgId, name, strerror(errno));
       code = TAOS_SYSTEM_ERROR(errno);
@@ -535,26 +802,158 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
 #endif
     offset = offset + sizeof(SWalHead) + pHead->len;
 
-    wTrace("vgId:%d, restore wal, fileId:%" PRId64 " hver:%" PRIu64 " wver:%" PRIu64 " len:%d offset:%" PRId64,
-           pWal->vgId, fileId, pHead->version, pWal->version, pHead->len, offset);
+    if (0 != walSMemRowCheck(pHead)) {
+      wError("vgId:%d, restore wal, fileId:%" PRId64 " hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, fileId,
+             pHead->version, pHead->len, offset);
+      code = TAOS_SYSTEM_ERROR(errno);
+      break;
+    }
+
+    code = walPutRestoreRecord(pRestore, &pBatch, pHead, offset);
+    if (code != TSDB_CODE_SUCCESS) break;
+  }
+
+  // the last batch is handed over without waiting for a free one
+  pthread_mutex_lock(&pRestore->mutex);
+  if (pBatch->len > 0) pRestore->count++;
+  pRestore->done = 1;
+  pthread_cond_broadcast(&pRestore->cond);
+  pthread_mutex_unlock(&pRestore->mutex);
+
+  return code;
+}
+
+static void *walDecodeThreadFunc(void *param) {
+  SWalRestore *pRestore = param;
+  setThreadName("walDecode");
+
+  void *buffer = tmalloc(WAL_MAX_SIZE);
+  if (buffer == NULL) {
+    pRestore->code = TAOS_SYSTEM_ERROR(ENOMEM);
+  } else {
+    pRestore->code = walDecodeWalFile(pRestore, buffer);
+    tfree(buffer);
+  }
+
+  pthread_mutex_lock(&pRestore->mutex);
+  pRestore->done = 1;
+  pthread_cond_broadcast(&pRestore->cond);
+  pthread_mutex_unlock(&pRestore->mutex);
+
+  return NULL;
+}
+
+static void walApplyBatch(SWalRestore *pRestore, SWalBatch *pBatch, void *pVnode, FWalWrite writeFp,
+                          int64_t *records) {
+  SWal *  pWal = pRestore->pWal;
+  int32_t pos = 0;
+
+  while (pos < pBatch->len) {
+    SWalHead *pHead = (SWalHead *)(pBatch->data + pos);
+    pos += ALIGN8(sizeof(SWalHead) + pHead->len);
+
+    wTrace("vgId:%d, restore wal, fileId:%" PRId64 " hver:%" PRIu64 " wver:%" PRIu64 " len:%d", pWal->vgId,
+           pRestore->fileId, pHead->version, pWal->version, pHead->len);
 
     pWal->version = pHead->version;
+    (*writeFp)(pVnode, pHead, TAOS_QTYPE_WAL, NULL);
+    (*records)++;
+  }
+}
 
-    // wInfo("writeFp: %ld", offset);
-    if (0 != walSMemRowCheck(pHead)) {
-      wError("vgId:%d, restore wal, fileId:%" PRId64 " hver:%" PRIu64 " wver:%" PRIu64 " len:%d offset:%" PRId64,
-             pWal->vgId, fileId, pHead->version, pWal->version, pHead->len, offset);
-      tfClose(tfd);
-      tfree(buffer);
-      return TAOS_SYSTEM_ERROR(errno);
+static void walCleanupRestore(SWalRestore *pRestore) {
+  for (int32_t i = 0; i < WAL_RESTORE_BATCHES; ++i) {
+    tfree(pRestore->batches[i].data);
+  }
+
+  tfree(pRestore->reader.buffer);
+  tfClose(pRestore->reader.tfd);
+  pthread_cond_destroy(&pRestore->cond);
+  pthread_mutex_destroy(&pRestore->mutex);
+}
+
+// a decoder thread reads and checks the records while the caller applies those decoded, the apply stays serial
+// since the records of a vnode shall be written in the order of versions
+static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, FWalProgress progressFp, char *name,
+                                 int64_t fileId) {
+  SWalRestore restore = {.pWal = pWal, .name = name, .fileId = fileId};
+  SWalRestore *pRestore = &restore;
+
+  pthread_mutex_init(&pRestore->mutex, NULL);
+  pthread_cond_init(&pRestore->cond, NULL);
+
+  pRestore->reader.tfd = tfOpen(name, O_RDWR);
+  if (!tfValid(pRestore->reader.tfd)) {
+    wError("vgId:%d, file:%s, failed to open for restore since %s", pWal->vgId, name, strerror(errno));
+    int32_t code = TAOS_SYSTEM_ERROR(errno);
+    walCleanupRestore(pRestore);
+    return code;
+  } else {
+    wDebug("vgId:%d, file:%s, open for restore", pWal->vgId, name);
+  }
+
+  struct stat fstat;
+  if (tfStat(pRestore->reader.tfd, &fstat) == 0) pRestore->fsize = fstat.st_size;
+
+  pRestore->reader.size = WAL_RESTORE_READ_SIZE;
+  pRestore->reader.buffer = tmalloc(pRestore->reader.size);
+  for (int32_t i = 0; i < WAL_RESTORE_BATCHES; ++i) {
+    pRestore->batches[i].size = WAL_RESTORE_READ_SIZE;
+    pRestore->batches[i].data = tmalloc(pRestore->batches[i].size);
+    if (pRestore->batches[i].data == NULL) pRestore->reader.size = 0;
+  }
+
+  if (pRestore->reader.buffer == NULL || pRestore->reader.size == 0) {
+    wError("vgId:%d, file:%s, failed to open for restore since %s", pWal->vgId, name, strerror(ENOMEM));
+    walCleanupRestore(pRestore);
+    return TAOS_SYSTEM_ERROR(ENOMEM);
+  }
+
+  if (pthread_create(&pRestore->thread, NULL, walDecodeThreadFunc, pRestore) != 0) {
+    wError("vgId:%d, file:%s, failed to create decode thread since %s", pWal->vgId, name, strerror(errno));
+    int32_t code = TAOS_SYSTEM_ERROR(errno);
+    walCleanupRestore(pRestore);
+    return code;
+  }
+
+  int64_t records = 0;
+  int64_t startMs = taosGetTimestampMs();
+  int64_t reportMs = startMs;
+
+  while (1) {
+    pthread_mutex_lock(&pRestore->mutex);
+    while (pRestore->count == 0 && !pRestore->done) {
+      pthread_cond_wait(&pRestore->cond, &pRestore->mutex);
     }
-    (*writeFp)(pVnode, pHead, TAOS_QTYPE_WAL, NULL);
+    SWalBatch *pBatch = (pRestore->count > 0) ? &pRestore->batches[pRestore->head] : NULL;
+    pthread_mutex_unlock(&pRestore->mutex);
+
+    if (pBatch == NULL) break;
+
+    walApplyBatch(pRestore, pBatch, pVnode, writeFp, &records);
+    if (progressFp) (*progressFp)(pVnode, pBatch->offset, pRestore->fsize);
+
+    int64_t nowMs = taosGetTimestampMs();
+    if (nowMs - reportMs >= WAL_PROGRESS_MS) {
+      wInfo("vgId:%d, file:%s, restored %" PRId64 " of %" PRId64 " bytes, records:%" PRId64 " in %" PRId64 "ms",
+            pWal->vgId, name, pBatch->offset, pRestore->fsize, records, nowMs - startMs);
+      reportMs = nowMs;
+    }
+
+    pthread_mutex_lock(&pRestore->mutex);
+    pRestore->head = (pRestore->head + 1) % WAL_RESTORE_BATCHES;
+    pRestore->count--;
+    pthread_cond_broadcast(&pRestore->cond);
+    pthread_mutex_unlock(&pRestore->mutex);
   }
 
-  tfClose(tfd);
-  tfree(buffer);
+  pthread_join(pRestore->thread, NULL);
 
-  wDebug("vgId:%d, file:%s, it is closed after restore", pWal->vgId, name);
+  int32_t code = pRestore->code;
+  walCleanupRestore(pRestore);
+
+  wDebug("vgId:%d, file:%s, it is closed after restore, records:%" PRId64 " in %" PRId64 "ms", pWal->vgId, name,
+         records, taosGetTimestampMs() - startMs);
   return code;
 }
 
@@ -581,6 +980,8 @@ void walResetVersion(twalh param, uint64_t newVer) {
 int64_t walGetFSize(twalh handle) {
   SWal *pWal = handle;
   if (pWal == NULL) return 0;
+  if (pWal->groupCommit) return pWal->offset + pWal->bufLen - pWal->bufDone;
+
   struct stat _fstat;
   if (tfStat(pWal->tfd, &_fstat) == 0) {
     return _fstat.st_size;
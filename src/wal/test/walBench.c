@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// writes the records the way a vnode write worker does, a batch of walWrite followed by one walFsync, and reports
+// the throughput and the latency of a record from its walWrite to the walFsync after which it could be acked, then
+// optionally replays the written file the way a vnode restores it at startup
+
+#include "os.h"
+#include "tutil.h"
+#include "tglobal.h"
+#include "tlog.h"
+#include "twal.h"
+#include "tfile.h"
+
+static int64_t restored = 0;
+
+static int32_t countRecord(void *pVnode, void *data, int32_t qtype, void *pMsg) {
+  restored++;
+  return 0;
+}
+
+static int compareLatency(const void *a, const void *b) {
+  int64_t x = *(int64_t *)a;
+  int64_t y = *(int64_t *)b;
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+int main(int argc, char *argv[]) {
+  char path[128] = "/tmp/walBench";
+  int  level = 2;
+  int  total = 200000;
+  int  batch = 100;
+  int  size = 512;
+  int  group = 1;
+  int  direct = 0;
+  int  prealloc = 0;
+  int  replay = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-p") == 0 && i < argc - 1) {
+      tstrncpy(path, argv[++i], sizeof(path));
+    } else if (strcmp(argv[i], "-l") == 0 && i < argc - 1) {
+      level = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      total = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0 && i < argc - 1) {
+      batch = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0 && i < argc - 1) {
+      size = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-g") == 0 && i < argc - 1) {
+      group = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-o") == 0 && i < argc - 1) {
+      direct = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-a") == 0 && i < argc - 1) {
+      prealloc = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0 && i < argc - 1) {
+      replay = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-p path]: wal file path, default is:%s\n", path);
+      printf("  [-l level]: wal level, 1 for write and 2 for fsync, default is:%d\n", level);
+      printf("  [-n total]: total records, default is:%d\n", total);
+      printf("  [-b batch]: records written before each fsync, default is:%d\n", batch);
+      printf("  [-s size]: bytes of the record body, default is:%d\n", size);
+      printf("  [-g group]: group commit, default is:%d\n", group);
+      printf("  [-o direct]: direct io of the group commit, default is:%d\n", direct);
+      printf("  [-a prealloc]: MB preallocated each time the file grows, default is:%d\n", prealloc);
+      printf("  [-r replay]: replay the records written, default is:%d\n", replay);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  if (total <= 0 || batch <= 0 || size <= 0) {
+    printf("invalid options\n");
+    exit(-1);
+  }
+
+  taosInitLog("walBench.log", 100000, 10);
+  tfInit();
+  walInit();
+
+  SWalCfg walCfg = {0};
+  walCfg.walLevel = level;
+  walCfg.keep = TAOS_WAL_NOT_KEEP;
+  walCfg.groupCommit = group;
+  walCfg.directIO = direct;
+  walCfg.preallocSize = prealloc;
+
+  void *pWal = walOpen(path, &walCfg);
+  if (pWal == NULL) {
+    printf("failed to open wal\n");
+    exit(-1);
+  }
+
+  walRemoveAllOldFiles(pWal);
+  if (walRenew(pWal) != 0) {
+    printf("failed to create wal file\n");
+    exit(-1);
+  }
+
+  int       contLen = sizeof(SWalHead) + size;
+  SWalHead *pHead = calloc(1, contLen);
+  int64_t * latency = calloc(total, sizeof(int64_t));
+  int64_t   ver = 0;
+
+  int64_t start = taosGetTimestampUs();
+
+  for (int i = 0; i < total; i += batch) {
+    int num = MIN(batch, total - i);
+
+    for (int k = 0; k < num; ++k) {
+      latency[i + k] = taosGetTimestampUs();
+      pHead->version = ++ver;
+      pHead->len = size;
+      if (walWrite(pWal, pHead) != 0) {
+        printf("failed to write wal, ver:%" PRId64 "\n", ver);
+        exit(-1);
+      }
+    }
+
+    if (walFsync(pWal, false) != 0) {
+      printf("failed to fsync wal, ver:%" PRId64 "\n", ver);
+      exit(-1);
+    }
+
+    int64_t acked = taosGetTimestampUs();
+    for (int k = 0; k < num; ++k) {
+      latency[i + k] = acked - latency[i + k];
+    }
+  }
+
+  int64_t elapsed = taosGetTimestampUs() - start;
+  if (elapsed <= 0) elapsed = 1;
+
+  qsort(latency, total, sizeof(int64_t), compareLatency);
+
+  printf("level:%d batch:%d size:%d group:%d direct:%d prealloc:%d\n", level, batch, size, group, direct, prealloc);
+  printf("records:%d elapsed:%.3fs records/s:%.0f MB/s:%.2f\n", total, elapsed / 1000000.0,
+         total * 1000000.0 / elapsed, (double)total * contLen / elapsed);
+  printf("latency(us) p50:%" PRId64 " p99:%" PRId64 " max:%" PRId64 "\n", latency[total / 2],
+         latency[(int64_t)total * 99 / 100], latency[total - 1]);
+
+  free(latency);
+  free(pHead);
+
+  if (replay) {
+    walClose(pWal);
+    pWal = walOpen(path, &walCfg);
+    if (pWal == NULL) {
+      printf("failed to open wal\n");
+      exit(-1);
+    }
+
+    start = taosGetTimestampUs();
+    if (walRestore(pWal, NULL, countRecord, NULL) != 0) {
+      printf("failed to restore wal\n");
+      exit(-1);
+    }
+
+    elapsed = taosGetTimestampUs() - start;
+    if (elapsed <= 0) elapsed = 1;
+    printf("replay records:%" PRId64 " elapsed:%.3fs records/s:%.0f\n", restored, elapsed / 1000000.0,
+           restored * 1000000.0 / elapsed);
+  }
+
+  walRemoveAllOldFiles(pWal);
+  walClose(pWal);
+  walCleanUp();
+  tfCleanup();
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import re
+import sys
+import time
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    updatecfgDict = {'bloomFilterBits': 10}
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getLogFile(self):
+        return tdDnodes.getDnodesRootDir() + "/dnode1/log/taosdlog.0"
+
+    # load counters of the cost summary that taosd logs for a query
+    def queryCost(self, sql):
+        with open(self.getLogFile()) as f:
+            pos = len(f.read())
+
+        tdSql.query(sql)
+
+        for i in range(50):
+            time.sleep(0.1)
+            with open(self.getLogFile()) as f:
+                log = f.read()[pos:]
+            load = re.search(r"load block statis:(\d+), load data block:(\d+)", log)
+            bloom = re.search(r"bloom filter out blocks:(\d+)", log)
+            if load is not None and bloom is not None:
+                return int(load.group(1)), int(load.group(2)), int(bloom.group(1))
+
+        tdLog.exit("no cost summary of sql:%s in %s" % (sql, self.getLogFile()))
+
+    def checkCost(self, sql, statis, blocks, bloom):
+        cost = self.queryCost(sql)
+        if cost != (statis, blocks, bloom):
+            tdLog.exit("sql:%s load block statis, load data block, bloom filter out blocks:%s != expect:%s" %
+                       (sql, cost, (statis, blocks, bloom)))
+        tdLog.info("sql:%s load block statis, load data block, bloom filter out blocks:%s" % (sql, cost))
+
+    def run(self):
+        tdLog.printNoPrefix("==========step1:create table && insert data in three runs of values")
+        tdSql.execute("drop database if exists bf")
+        tdSql.execute("create database bf minrows 10 maxrows 200")
+        tdSql.execute("use bf")
+        tdSql.execute("create table t (ts timestamp, c int, v double)")
+        for b in range(3):
+            values = " ".join("(%d, %d, %d)" % (1600000000000 + b * 300000 + i * 1000, b + 1, i) for i in range(300))
+            tdSql.execute("insert into t values %s" % values)
+
+        tdLog.printNoPrefix("==========step2:commit the data to the files")
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        tdSql.execute("use bf")
+
+        tdLog.printNoPrefix("==========step3:blocks excluded by the bloom filters are not loaded")
+        tdSql.query("select count(*) from t")
+        tdSql.checkData(0, 0, 900)
+
+        # no block has the value, nothing is loaded
+        self.checkCost("select count(*), c from t where c = 4 group by c", 0, 0, 6)
+        tdSql.checkRows(0)
+        self.checkCost("select count(*) from t where c = 4 interval(1m)", 0, 0, 6)
+        tdSql.checkRows(0)
+        self.checkCost("select count(*) from t where c = 4 session(ts, 10s)", 0, 0, 6)
+        tdSql.checkRows(0)
+
+        # only the blocks of the last run are loaded
+        self.checkCost("select count(*), c from t where c = 3 group by c", 3, 3, 3)
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 0, 300)
+        # the blocks that only have the value are aggregated by their statistics
+        self.checkCost("select count(*) from t where c = 3 interval(1h)", 3, 1, 3)
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 1, 300)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,126 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import re
+import sys
+import time
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    updatecfgDict = {'rollupInterval': 60}
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+
+    def getLogFile(self):
+        return tdDnodes.getDnodesRootDir() + "/dnode1/log/taosdlog.0"
+
+    # load counters of the cost summary that taosd logs for a query
+    def queryCost(self, sql):
+        with open(self.getLogFile()) as f:
+            pos = len(f.read())
+
+        tdSql.query(sql)
+
+        for i in range(50):
+            time.sleep(0.1)
+            with open(self.getLogFile()) as f:
+                log = f.read()[pos:]
+            load = re.search(r"load block statis:(\d+), load data block:(\d+)", log)
+            if load is not None:
+                return int(load.group(1)), int(load.group(2))
+
+        tdLog.exit("no cost summary of sql:%s in %s" % (sql, self.getLogFile()))
+
+    def restart(self):
+        tdDnodes.stop(1)
+        tdDnodes.start(1)
+        tdSql.execute("use rollup")
+
+    # each file block is inside a rollup window, so every window of a minute is answered from the block statistics
+    def checkBlocks(self):
+        tdSql.query("select count(*) from t")
+        tdSql.checkData(0, 0, 610)
+
+        statis, blocks = self.queryCost("select count(*), sum(v), min(v), max(v) from t interval(1m)")
+        tdSql.checkRows(26)
+        if statis == 0 or blocks != 0:
+            tdLog.exit("load block statis:%d, load data block:%d, some blocks cross the rollup windows" %
+                       (statis, blocks))
+        tdLog.info("load block statis:%d, load data block:%d" % (statis, blocks))
+
+        tdSql.checkData(0, 1, 9)
+        tdSql.checkData(0, 2, 12)
+        tdSql.checkData(1, 1, 24)
+        tdSql.checkData(1, 2, 228)
+        tdSql.checkData(3, 1, 25)
+        tdSql.checkData(3, 3, 1)
+        tdSql.checkData(25, 1, 16)
+        tdSql.checkData(25, 4, 299)
+
+        # a block has the rows of one window at most
+        tdSql.query("select _block_dist() from t")
+        maxRows = int(re.search(r"Max=\[(\d+)\(Rows\)\]", tdSql.getData(0, 0)).group(1))
+        if maxRows > 25:
+            tdLog.exit("a block has %d rows, more than the rows of a window" % maxRows)
+
+    def run(self):
+        tdLog.printNoPrefix("==========step1:commit the rows of a table across the window boundaries in three runs")
+        tdSql.execute("drop database if exists rollup")
+        tdSql.execute("create database rollup minrows 10 maxrows 200")
+        tdSql.execute("use rollup")
+        tdSql.execute("create table t (ts timestamp, v int)")
+
+        # the windows of a minute start 20 seconds after 1600000000000
+        values = " ".join("(%d, %d)" % (1600000000000 + i * 5000, i) for i in range(300))
+        tdSql.execute("insert into t values %s" % values)
+        self.restart()
+
+        # the rows in between merge with the blocks in the files
+        values = " ".join("(%d, %d)" % (1600000002500 + i * 5000, i) for i in range(300))
+        tdSql.execute("insert into t values %s" % values)
+        self.restart()
+
+        values = " ".join("(%d, %d)" % (1600000001000 + i * 150000, i) for i in range(10))
+        tdSql.execute("insert into t values %s" % values)
+        self.restart()
+
+        tdLog.printNoPrefix("==========step2:the blocks are cut at the windows")
+        self.checkBlocks()
+
+        tdLog.printNoPrefix("==========step3:compaction keeps the cuts")
+        tdSql.query("show vgroups")
+        vgId = tdSql.getData(0, 0)
+        tdSql.execute("compact vnodes in(%d)" % vgId)
+        for i in range(100):
+            time.sleep(0.1)
+            tdSql.query("show vgroups")
+            if tdSql.getData(0, 6) == 0:
+                break
+        else:
+            tdLog.exit("compaction of vgroup %d is not done" % vgId)
+
+        self.restart()
+        self.checkBlocks()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
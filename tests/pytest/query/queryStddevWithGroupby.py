@@ -35,6 +35,24 @@ class TDTestCase:
         tdSql.query("select stddev(c2) from t10")
         tdSql.checkData(0, 0, 0.5)
 
+        # several group by columns with a binary one, in another order in the select list
+        tdSql.query("select stddev(v), c1, c2 from stb2 group by c1, c2")
+        tdSql.checkRows(3)
+        tdSql.checkData(0, 0, 2.494438258)
+        tdSql.checkData(0, 1, "a")
+        tdSql.checkData(0, 2, 1)
+        tdSql.checkData(1, 0, 47.5)
+        tdSql.checkData(1, 1, "a")
+        tdSql.checkData(1, 2, 2)
+        tdSql.checkData(2, 0, 12.472191289)
+        tdSql.checkData(2, 1, "bb")
+        tdSql.checkData(2, 2, 1)
+        tdSql.query("select stddev(v), c2, c1 from stb2 group by c1, c2")
+        tdSql.checkRows(3)
+        tdSql.checkData(0, 0, 2.494438258)
+        tdSql.checkData(1, 0, 47.5)
+        tdSql.checkData(2, 0, 12.472191289)
+
     def run(self):
         tdSql.execute("drop database if exists db")
         tdSql.execute("create database  if not exists db keep 36500")
@@ -50,6 +68,14 @@ class TDTestCase:
         tdSql.execute("insert into t10 values ('2021-04-06 00:00:00.000', 5,2)")
         tdSql.execute("insert into t10 values (now+1d,6,2)")
 
+        tdSql.execute("create stable stb2 (ts timestamp, v double, c1 binary(10), c2 int) tags(t1 int)")
+        tdSql.execute("create table t20 using stb2 tags(1)")
+        tdSql.execute("create table t21 using stb2 tags(2)")
+        tdSql.execute("insert into t20 values (1600000000000, 1, 'a', 1) (1600000000001, 3, 'a', 1) "
+                      "(1600000000002, 10, 'bb', 1) (1600000000003, 20, 'bb', 1) (1600000000004, 5, 'a', 2)")
+        tdSql.execute("insert into t21 values (1600000000000, 7, 'a', 1) (1600000000001, 40, 'bb', 1) "
+                      "(1600000000002, 100, 'a', 2)")
+
         tdLog.printNoPrefix("==========step2:query and check")
         self.querysqls()
 